@@ -5,6 +5,8 @@
 
 #include <clientversion.h>
 #include <common/args.h>
+#include <crypto/groestl.h>
+#include <crypto/scrypt.h>
 #include <crypto/sha256.h>
 #include <util/fs.h>
 #include <util/strencodings.h>
@@ -61,6 +63,8 @@ int main(int argc, char** argv)
     ArgsManager argsman;
     SetupBenchArgs(argsman);
     SHA256AutoDetect();
+    ScryptAutoDetect();
+    GroestlAutoDetect();
     std::string error;
     if (!argsman.ParseParameters(argc, argv, error)) {
         tfm::format(std::cerr, "Error parsing command line arguments: %s\n", error);
@@ -3,8 +3,10 @@
 
 
 #include <bench/bench.h>
+#include <crypto/groestl.h>
 #include <crypto/muhash.h>
 #include <crypto/ripemd160.h>
+#include <crypto/scrypt.h>
 #include <crypto/sha1.h>
 #include <crypto/sha256.h>
 #include <crypto/sha3.h>
@@ -186,6 +188,97 @@ static void SHA512(benchmark::Bench& bench)
     });
 }
 
+static void GROESTL_STANDARD(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' Groestl implementation", __func__, GroestlAutoDetect(groestl_implementation::STANDARD)));
+    uint8_t hash[CGroestl::OUTPUT_SIZE];
+    std::vector<uint8_t> in(BUFFER_SIZE,0);
+    bench.batch(in.size()).unit("byte").run([&] {
+        CGroestl().Write(in.data(), in.size()).Finalize(hash);
+    });
+    GroestlAutoDetect();
+}
+
+static void GROESTL_AESNI(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' Groestl implementation", __func__, GroestlAutoDetect(groestl_implementation::USE_AESNI)));
+    uint8_t hash[CGroestl::OUTPUT_SIZE];
+    std::vector<uint8_t> in(BUFFER_SIZE,0);
+    bench.batch(in.size()).unit("byte").run([&] {
+        CGroestl().Write(in.data(), in.size()).Finalize(hash);
+    });
+    GroestlAutoDetect();
+}
+
+static void GROESTL_80b_STANDARD(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' Groestl implementation", __func__, GroestlAutoDetect(groestl_implementation::STANDARD)));
+    uint8_t hash[CGroestl::OUTPUT_SIZE];
+    std::vector<uint8_t> in(80, 0);
+    bench.unit("hash").run([&] {
+        CGroestl().Write(in.data(), in.size()).Finalize(hash);
+        ++in[76];
+    });
+    GroestlAutoDetect();
+}
+
+static void GROESTL_80b_AESNI(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' Groestl implementation", __func__, GroestlAutoDetect(groestl_implementation::USE_AESNI)));
+    uint8_t hash[CGroestl::OUTPUT_SIZE];
+    std::vector<uint8_t> in(80, 0);
+    bench.unit("hash").run([&] {
+        CGroestl().Write(in.data(), in.size()).Finalize(hash);
+        ++in[76];
+    });
+    GroestlAutoDetect();
+}
+
+static void Scrypt_80b_STANDARD(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' scrypt implementation", __func__, ScryptAutoDetect(scrypt_implementation::STANDARD)));
+    uint8_t hash[CScrypt::OUTPUT_SIZE];
+    std::vector<uint8_t> in(80, 0);
+    bench.unit("hash").run([&] {
+        CScrypt::Hash(in.data(), in.size(), hash);
+        ++in[76];
+    });
+    ScryptAutoDetect();
+}
+
+static void ScryptBatch_64x80b_STANDARD(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' scrypt implementation", __func__, ScryptAutoDetect(scrypt_implementation::STANDARD)));
+    std::vector<uint8_t> in(80 * 64, 0);
+    std::vector<uint8_t> out(CScrypt::OUTPUT_SIZE * 64);
+    bench.batch(64).unit("hash").run([&] {
+        ScryptHashBatch(out.data(), in.data(), 80, 64);
+    });
+    ScryptAutoDetect();
+}
+
+static void ScryptBatch_64x80b_SSE2(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' scrypt implementation", __func__, ScryptAutoDetect(scrypt_implementation::USE_SSE2)));
+    std::vector<uint8_t> in(80 * 64, 0);
+    std::vector<uint8_t> out(CScrypt::OUTPUT_SIZE * 64);
+    bench.batch(64).unit("hash").run([&] {
+        ScryptHashBatch(out.data(), in.data(), 80, 64);
+    });
+    ScryptAutoDetect();
+}
+
+static void ScryptBatch_64x80b_AVX2(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' scrypt implementation", __func__, ScryptAutoDetect(scrypt_implementation::USE_ALL)));
+    std::vector<uint8_t> in(80 * 64, 0);
+    std::vector<uint8_t> out(CScrypt::OUTPUT_SIZE * 64);
+    bench.batch(64).unit("hash").run([&] {
+        ScryptHashBatch(out.data(), in.data(), 80, 64);
+    });
+    ScryptAutoDetect();
+}
+
 static void SipHash_32b(benchmark::Bench& bench)
 {
     uint256 x;
@@ -263,12 +356,20 @@ BENCHMARK(SHA256_AVX2, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256_SHANI, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA512, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA3_256_1M, benchmark::PriorityLevel::HIGH);
+BENCHMARK(GROESTL_STANDARD, benchmark::PriorityLevel::HIGH);
+BENCHMARK(GROESTL_AESNI, benchmark::PriorityLevel::HIGH);
 
 BENCHMARK(SHA256_32b_STANDARD, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256_32b_SSE4, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256_32b_AVX2, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256_32b_SHANI, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SipHash_32b, benchmark::PriorityLevel::HIGH);
+BENCHMARK(GROESTL_80b_STANDARD, benchmark::PriorityLevel::HIGH);
+BENCHMARK(GROESTL_80b_AESNI, benchmark::PriorityLevel::HIGH);
+BENCHMARK(Scrypt_80b_STANDARD, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ScryptBatch_64x80b_STANDARD, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ScryptBatch_64x80b_SSE2, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ScryptBatch_64x80b_AVX2, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_STANDARD, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_SSE4, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_AVX2, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,94 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <dex/amm.h>
+#include <dex/dex_state.h>
+#include <dex/route.h>
+#include <random.h>
+
+#include <vector>
+
+static void DEXQuoteSwaps(benchmark::Bench& bench)
+{
+    constexpr size_t NUM_SWAPS{1000};
+    const AMMReserves snapshot{1'000'000'000'000, 3'000'000'000'000};
+
+    // Mixed directions and a share of swaps that miss their minimum, as an
+    // aggregator sees when quoting many candidate orders against one pool.
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<AMMSwap> swaps(NUM_SWAPS);
+    for (auto& swap : swaps) {
+        swap.a_to_b = rng.randbool();
+        swap.amount_in = 1 + rng.randrange(1'000'000'000);
+        swap.min_amount_out = rng.randrange(2'000'000'000);
+    }
+    std::vector<uint64_t> amounts_out(NUM_SWAPS);
+
+    bench.batch(NUM_SWAPS).unit("swap").run([&] {
+        const AMMReserves reserves{QuoteSwaps(snapshot, swaps, amounts_out, DEX_SWAP_FEE_BPS)};
+        ankerl::nanobench::doNotOptimizeAway(reserves.reserve_a);
+    });
+}
+
+static void DEXSettleSwaps(benchmark::Bench& bench)
+{
+    constexpr size_t NUM_SWAPS{1000};
+    const AMMReserves snapshot{1'000'000'000'000, 3'000'000'000'000};
+
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<AMMSwap> swaps(NUM_SWAPS);
+    for (auto& swap : swaps) {
+        swap.a_to_b = rng.randbool();
+        swap.amount_in = 1 + rng.randrange(1'000'000'000);
+        swap.min_amount_out = 0;
+    }
+    std::vector<uint64_t> amounts_out(NUM_SWAPS);
+
+    bench.batch(NUM_SWAPS).unit("swap").run([&] {
+        const AMMReserves reserves{SettleSwaps(snapshot, swaps, amounts_out, DEX_SWAP_FEE_BPS)};
+        ankerl::nanobench::doNotOptimizeAway(reserves.reserve_a);
+    });
+}
+
+static void DEXPriceImpact(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const uint64_t reserve_in{1'000'000'000'000}, reserve_out{3'000'000'000'000};
+    uint64_t amount_in{rng.rand64() >> 24};
+    bench.unit("quote").run([&] {
+        ankerl::nanobench::doNotOptimizeAway(GetPriceImpactBps(amount_in, reserve_in, reserve_out, DEX_SWAP_FEE_BPS));
+        amount_in = (amount_in * 6364136223846793005ULL + 1) >> 24;
+    });
+}
+
+static void DEXFindBestRoute(benchmark::Bench& bench)
+{
+    constexpr uint64_t NUM_TOKENS{100};
+    constexpr size_t NUM_POOLS{1000};
+
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<uint256> tokens(NUM_TOKENS);
+    for (auto& token : tokens) token = rng.rand256();
+    std::vector<std::pair<uint256, std::optional<DEXPool>>> pools;
+    for (size_t i = 0; i < NUM_POOLS; ++i) {
+        const uint256& a{tokens[rng.randrange(NUM_TOKENS)]};
+        const uint256& b{tokens[rng.randrange(NUM_TOKENS)]};
+        if (a == b) continue;
+        const DEXPool pool{std::min(a, b), std::max(a, b), 1'000'000 + rng.randrange(1'000'000'000), 1'000'000 + rng.randrange(1'000'000'000), 1};
+        pools.emplace_back(GetDEXPoolId(a, b), pool);
+    }
+    DEXRouteGraph graph;
+    graph.Update(pools);
+
+    bench.unit("quote").run([&] {
+        const auto route{graph.FindBestRoute(tokens[rng.randrange(NUM_TOKENS)], tokens[rng.randrange(NUM_TOKENS)],
+                                             1'000'000, DEXRouteGraph::MAX_HOPS, DEX_SWAP_FEE_BPS)};
+        ankerl::nanobench::doNotOptimizeAway(route);
+    });
+}
+
+BENCHMARK(DEXQuoteSwaps, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DEXSettleSwaps, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DEXPriceImpact, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DEXFindBestRoute, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,71 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <policy/script_pattern.h>
+#include <pubkey.h>
+#include <random.h>
+#include <script/script.h>
+
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Scripts of a mempool-sized corpus of transactions: mostly P2PKH and P2WPKH
+// outputs, with P2PKH-style inputs and some OP_RETURN outputs.
+static std::vector<CScript> CreateScriptCorpus()
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<CScript> scripts;
+    for (int tx = 0; tx < 5000; ++tx) {
+        std::vector<unsigned char> sig(72), pubkey(CPubKey::COMPRESSED_SIZE);
+        scripts.push_back(CScript() << sig << pubkey);
+        for (int out = 0; out < 2; ++out) {
+            const std::vector<unsigned char> hash{rng.randbytes(20)};
+            scripts.push_back(rng.randbool() ? CScript() << OP_DUP << OP_HASH160 << hash << OP_EQUALVERIFY << OP_CHECKSIG :
+                                               CScript() << OP_0 << hash);
+        }
+        if (tx % 10 == 0) scripts.push_back(CScript() << OP_RETURN << std::vector<unsigned char>(40));
+    }
+    return scripts;
+}
+
+static void ScriptPatternStringSet(benchmark::Bench& bench)
+{
+    // The string-based matching this automaton replaced in the honeypot filter
+    const std::set<std::string> patterns{"OP_VERIFY OP_VERIFY", "OP_IF OP_VERIFY OP_ENDIF", "OP_DUP OP_DUP OP_DUP", "OP_HASH160 OP_HASH160"};
+    const std::vector<CScript> scripts{CreateScriptCorpus()};
+    bench.batch(scripts.size()).unit("script").run([&] {
+        size_t matches{0};
+        for (const CScript& script : scripts) {
+            std::stringstream ss;
+            for (const auto& op : script) {
+                if (op <= OP_PUSHDATA4) ss << "OP_" << GetOpName(opcodetype(op)) << " ";
+            }
+            matches += patterns.count(ss.str());
+        }
+        ankerl::nanobench::doNotOptimizeAway(matches);
+    });
+}
+
+static void ScriptPatternAutomaton(benchmark::Bench& bench)
+{
+    ScriptPatternMatcher matcher;
+    matcher.AddPattern({OP_VERIFY, OP_VERIFY}, ScriptPatternMatcher::Anchor::WHOLE_SCRIPT);
+    matcher.AddPattern({OP_IF, OP_VERIFY, OP_ENDIF}, ScriptPatternMatcher::Anchor::WHOLE_SCRIPT);
+    matcher.AddPattern({OP_DUP, OP_DUP, OP_DUP}, ScriptPatternMatcher::Anchor::WHOLE_SCRIPT);
+    matcher.AddPattern({OP_HASH160, OP_HASH160}, ScriptPatternMatcher::Anchor::WHOLE_SCRIPT);
+    matcher.Compile();
+    const std::vector<CScript> scripts{CreateScriptCorpus()};
+    bench.batch(scripts.size()).unit("script").run([&] {
+        size_t matches{0};
+        for (const CScript& script : scripts) {
+            matches += matcher.MatchPushBytes(script).has_value();
+        }
+        ankerl::nanobench::doNotOptimizeAway(matches);
+    });
+}
+
+BENCHMARK(ScriptPatternStringSet, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ScriptPatternAutomaton, benchmark::PriorityLevel::HIGH);
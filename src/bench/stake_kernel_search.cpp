@@ -0,0 +1,46 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <arith_uint256.h>
+#include <bench/bench.h>
+#include <random.h>
+#include <stake/kernel_search.h>
+
+#include <cassert>
+
+static void StakeKernelSearchSlot(benchmark::Bench& bench)
+{
+    constexpr size_t NUM_CANDIDATES{100'000};
+    constexpr uint32_t MAX_AGE{90 * 86400};
+    const uint32_t now{1'700'000'000 & ~STAKE_TIMESTAMP_MASK};
+
+    StakeKernelSearch::Options options;
+    options.min_age = 3600;
+    options.max_age = MAX_AGE;
+    options.min_amount = 333 * COIN;
+    StakeKernelSearch search{options};
+
+    FastRandomContext rng{/*fDeterministic=*/true};
+    for (size_t i = 0; i < NUM_CANDIDATES; ++i) {
+        StakeCandidate candidate;
+        candidate.prevout = COutPoint(rng.rand256(), 0);
+        candidate.amount = options.min_amount + rng.randrange(1000 * COIN);
+        candidate.time = now - options.min_age - rng.randrange(MAX_AGE - 2 * options.min_age);
+        candidate.height = rng.rand32();
+        search.Add(candidate);
+    }
+    search.SetStakeModifier(rng.rand64());
+
+    // No kernel meets the target, so every slot hashes all candidates.
+    const uint32_t target_bits{arith_uint256{1}.GetCompact()};
+    uint32_t time{now};
+    bench.batch(NUM_CANDIDATES).unit("kernel").run([&] {
+        uint64_t hashes;
+        const auto result{search.Search(time, target_bits, hashes)};
+        assert(!result && hashes == NUM_CANDIDATES);
+        time += STAKE_TIMESTAMP_MASK + 1;
+        if (time - now > options.min_age) time = now;
+    });
+}
+
+BENCHMARK(StakeKernelSearchSlot, benchmark::PriorityLevel::HIGH);
@@ -88,42 +88,92 @@ int static inline GetSkipHeight(int height) {
     return (height & 1) ? InvertLowestOne(InvertLowestOne(height - 1)) + 1 : InvertLowestOne(height);
 }
 
-const CBlockIndex* CBlockIndex::GetAncestor(int height) const
+/**
+ * Walk back to the ancestor at the given height along the skip list formed by
+ * the prev and skip members, with heights taken from the height member. Used
+ * both for the skip list over all ancestors and for the one over the ancestors
+ * mined with the same algorithm.
+ */
+static inline const CBlockIndex* WalkSkipList(const CBlockIndex* pindexWalk, int height,
+                                              int CBlockIndex::*height_member,
+                                              CBlockIndex* CBlockIndex::*prev_member,
+                                              CBlockIndex* CBlockIndex::*skip_member)
 {
-    if (height > nHeight || height < 0) {
+    if (height > pindexWalk->*height_member || height < 0) {
         return nullptr;
     }
 
-    const CBlockIndex* pindexWalk = this;
-    int heightWalk = nHeight;
+    int heightWalk = pindexWalk->*height_member;
     while (heightWalk > height) {
         int heightSkip = GetSkipHeight(heightWalk);
         int heightSkipPrev = GetSkipHeight(heightWalk - 1);
-        if (pindexWalk->pskip != nullptr &&
+        if (pindexWalk->*skip_member != nullptr &&
             (heightSkip == height ||
              (heightSkip > height && !(heightSkipPrev < heightSkip - 2 &&
                                        heightSkipPrev >= height)))) {
             // Only follow pskip if pprev->pskip isn't better than pskip->pprev.
-            pindexWalk = pindexWalk->pskip;
+            pindexWalk = pindexWalk->*skip_member;
             heightWalk = heightSkip;
         } else {
-            assert(pindexWalk->pprev);
-            pindexWalk = pindexWalk->pprev;
+            assert(pindexWalk->*prev_member);
+            pindexWalk = pindexWalk->*prev_member;
             heightWalk--;
         }
     }
     return pindexWalk;
 }
 
+const CBlockIndex* CBlockIndex::GetAncestor(int height) const
+{
+    return WalkSkipList(this, height, &CBlockIndex::nHeight, &CBlockIndex::pprev, &CBlockIndex::pskip);
+}
+
 CBlockIndex* CBlockIndex::GetAncestor(int height)
 {
     return const_cast<CBlockIndex*>(static_cast<const CBlockIndex*>(this)->GetAncestor(height));
 }
 
+const CBlockIndex* CBlockIndex::GetAlgoAncestor(int algo_height) const
+{
+    return WalkSkipList(this, algo_height, &CBlockIndex::nAlgoHeight, &CBlockIndex::pprevSameAlgo, &CBlockIndex::pskipSameAlgo);
+}
+
+CBlockIndex* CBlockIndex::GetAlgoAncestor(int algo_height)
+{
+    return const_cast<CBlockIndex*>(static_cast<const CBlockIndex*>(this)->GetAlgoAncestor(algo_height));
+}
+
+const CBlockIndex* CBlockIndex::GetLastOfAlgo(AlgoType algo) const
+{
+    if (GetAlgoType() == algo) return this;
+    const size_t slot{static_cast<size_t>(algo)};
+    return slot < pprevOfAlgo.size() ? pprevOfAlgo[slot] : nullptr;
+}
+
+CBlockIndex* CBlockIndex::GetLastOfAlgo(AlgoType algo)
+{
+    return const_cast<CBlockIndex*>(static_cast<const CBlockIndex*>(this)->GetLastOfAlgo(algo));
+}
+
 void CBlockIndex::BuildSkip()
 {
-    if (pprev)
-        pskip = pprev->GetAncestor(GetSkipHeight(nHeight));
+    if (!pprev) return;
+    pskip = pprev->GetAncestor(GetSkipHeight(nHeight));
+
+    // The nearest predecessor of each algorithm is pprev's, or pprev itself for its own
+    pprevOfAlgo = pprev->pprevOfAlgo;
+    const size_t prev_slot{static_cast<size_t>(pprev->GetAlgoType())};
+    if (prev_slot < pprevOfAlgo.size()) pprevOfAlgo[prev_slot] = pprev;
+
+    const size_t slot{static_cast<size_t>(GetAlgoType())};
+    pprevSameAlgo = slot < pprevOfAlgo.size() ? pprevOfAlgo[slot] : nullptr;
+    if (pprevSameAlgo) {
+        nAlgoHeight = pprevSameAlgo->nAlgoHeight + 1;
+        pskipSameAlgo = pprevSameAlgo->GetAlgoAncestor(GetSkipHeight(nAlgoHeight));
+    } else {
+        nAlgoHeight = 0;
+        pskipSameAlgo = nullptr;
+    }
 }
 
 arith_uint256 GetBlockProof(const CBlockIndex& block)
@@ -13,6 +13,7 @@
 #include <uint256.h>
 #include <util/time.h>
 
+#include <array>
 #include <vector>
 
 /**
@@ -151,9 +152,21 @@ public:
     //! pointer to the index of some further predecessor of this block
     CBlockIndex* pskip{nullptr};
 
+    //! pointer to the index of the nearest predecessor mined with the same algorithm
+    CBlockIndex* pprevSameAlgo{nullptr};
+
+    //! pointer to the index of some further predecessor mined with the same algorithm
+    CBlockIndex* pskipSameAlgo{nullptr};
+
+    //! (memory only) pointers to the index of the nearest predecessor mined with each algorithm
+    std::array<CBlockIndex*, ALGO_TYPE_COUNT> pprevOfAlgo{};
+
     //! height of the entry in the chain. The genesis block has height 0
     int nHeight{0};
 
+    //! (memory only) number of predecessors mined with the same algorithm as this block
+    int nAlgoHeight{0};
+
     //! Which # file this block is stored in (blk?????.dat)
     int nFile GUARDED_BY(::cs_main){0};
 
@@ -166,6 +179,18 @@ public:
     //! (memory only) Total amount of work (expected number of hashes) in the chain up to and including this block
     arith_uint256 nChainWork{};
 
+    //! (memory only) LWMA retarget sums over the last min(nAlgoHeight, nLWMAWindow) blocks of
+    //! this block's algorithm up to and including this one: solve times, solve times weighted
+    //! 1..n from oldest to newest, and targets divided by nLWMAWindow. See UpdateLWMASums.
+    int64_t nLWMASolveTimeSum{0};
+    int64_t nLWMAWeightedSolveTimeSum{0};
+    arith_uint256 nLWMATargetSum{};
+
+    //! Stake modifier after this block, folded from the predecessor's and this block's hash
+    //! by ComputeStakeModifier when the block is connected. Persisted with the index entry;
+    //! zero for blocks that were never connected.
+    uint64_t nStakeModifier{0};
+
     //! Number of transactions in this block.
     //! Note: in a potential headers-first mode, this number cannot be relied upon
     //! Note: this value is faked during UTXO snapshot load to ensure that
@@ -340,13 +365,25 @@ public:
         return false;
     }
 
-    //! Build the skiplist pointer for this entry.
+    //! Hybrid consensus mining algorithm of this block, see AlgoFromVersion.
+    AlgoType GetAlgoType() const { return AlgoFromVersion(nVersion); }
+
+    //! Build the skiplist pointers for this entry, both over all ancestors and
+    //! over the ancestors mined with the same algorithm. Requires pprev to be set.
     void BuildSkip();
 
     //! Efficiently find an ancestor of this block.
     CBlockIndex* GetAncestor(int height);
     const CBlockIndex* GetAncestor(int height) const;
 
+    //! Efficiently find the same-algorithm ancestor of this block with the given nAlgoHeight.
+    CBlockIndex* GetAlgoAncestor(int algo_height);
+    const CBlockIndex* GetAlgoAncestor(int algo_height) const;
+
+    //! Return this block or its nearest ancestor mined with algo, or nullptr if there is none.
+    CBlockIndex* GetLastOfAlgo(AlgoType algo);
+    const CBlockIndex* GetLastOfAlgo(AlgoType algo) const;
+
     CBlockIndex() = default;
     ~CBlockIndex() = default;
 
@@ -384,6 +421,9 @@ class CDiskBlockIndex : public CBlockIndex
      **/
     static constexpr int DUMMY_VERSION = 259900;
 
+    /** Entries written with at least this version are followed by the stake modifier. */
+    static constexpr int STAKE_MODIFIER_VERSION = 259901;
+
 public:
     uint256 hashPrev;
 
@@ -400,7 +440,7 @@ public:
     SERIALIZE_METHODS(CDiskBlockIndex, obj)
     {
         LOCK(::cs_main);
-        int _nVersion = DUMMY_VERSION;
+        int _nVersion = STAKE_MODIFIER_VERSION;
         READWRITE(VARINT_MODE(_nVersion, VarIntMode::NONNEGATIVE_SIGNED));
 
         READWRITE(VARINT_MODE(obj.nHeight, VarIntMode::NONNEGATIVE_SIGNED));
@@ -417,6 +457,8 @@ public:
         READWRITE(obj.nTime);
         READWRITE(obj.nshahbits);
         READWRITE(obj.nNonce);
+
+        if (_nVersion >= STAKE_MODIFIER_VERSION) READWRITE(obj.nStakeModifier);
     }
 
     uint256 ConstructBlockHash() const
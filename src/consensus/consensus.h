@@ -47,7 +47,7 @@ static const int POS_DIFFICULTY_ADJUSTMENT_INTERVAL = 2016; // PoS difficulty ad
 
 /** SHAHCOIN Core Token Creation parameters */
 static const int64_t TOKEN_CREATION_FEE = 100 * 100000000; // 100 SHAH token creation fee (in shahi)
-static const int64_t MAX_TOKEN_SUPPLY = 1000000000 * 100000000; // 1 billion max token supply (in shahi)
+static const int64_t MAX_TOKEN_SUPPLY = int64_t{1000000000} * 100000000; // 1 billion max token supply (in shahi)
 static const int MAX_TOKEN_DECIMALS = 18; // Maximum token decimals
 static const int MAX_TOKEN_NAME_LENGTH = 32; // Maximum token name length
 static const int MAX_TOKEN_SYMBOL_LENGTH = 8; // Maximum token symbol length
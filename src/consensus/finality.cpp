@@ -6,7 +6,6 @@
 #include <chainparams.h>
 #include <logging.h>
 #include <util/time.h>
-#include <validation.h>
 
 #include <algorithm>
 
@@ -16,6 +15,7 @@ std::unique_ptr<CFinalityManager> g_finalityManager = std::make_unique<CFinality
 // CFinalityManager implementation
 CFinalityManager::CFinalityManager()
 {
+    LOCK(m_stats_mutex);
     m_stats = {0, 0, 0, 0, 0, GetTime()};
 }
 
@@ -35,17 +35,7 @@ FinalityStatus CFinalityManager::GetBlockFinalityStatus(const CBlockIndex* pinde
         return FinalityStatus::PENDING;
     }
     
-    // Check cache first
-    auto it = m_finalityCache.find(pindex);
-    if (it != m_finalityCache.end()) {
-        return it->second;
-    }
-    
-    // Calculate and cache status
-    FinalityStatus status = CalculateFinalityStatus(pindex);
-    m_finalityCache[pindex] = status;
-    
-    return status;
+    return CalculateFinalityStatus(pindex);
 }
 
 bool CFinalityManager::IsBlockFinal(const CBlockIndex* pindex) const
@@ -77,6 +67,58 @@ bool CFinalityManager::CanReorganize(const CBlockIndex* pindex) const
     return !IsBlockFinal(pindex);
 }
 
+void CFinalityManager::BlockConnected(const CChain& chain, const CBlockIndex* pindex)
+{
+    if (!pindex) {
+        return;
+    }
+    m_chain = &chain;
+    
+    // Each connected block moves one block across each finality threshold.
+    const auto crossed = [&](int confirmations) {
+        return confirmations > 0 && pindex->nHeight - confirmations + 1 >= 0;
+    };
+    {
+        LOCK(m_stats_mutex);
+        if (pindex->nHeight > m_stats_height) {
+            m_stats_height = pindex->nHeight;
+            m_stats.totalBlocks++;
+            if (crossed(m_config.softFinalityConfirmations)) m_stats.softFinalBlocks++;
+            if (crossed(m_config.hardFinalityConfirmations)) m_stats.hardFinalBlocks++;
+            if (crossed(m_config.irreversibleConfirmations)) m_stats.irreversibleBlocks++;
+        }
+        m_stats.lastCheckTime = GetTime();
+    }
+    
+    if (!crossed(m_config.softFinalityConfirmations)) {
+        return;
+    }
+    const CBlockIndex* finalized = pindex->GetAncestor(pindex->nHeight - m_config.softFinalityConfirmations + 1);
+    const CBlockIndex* previous = m_finalized.load();
+    // The watermark only moves forward; reorganizations past it are rejected.
+    if (!previous || finalized->nHeight > previous->nHeight) {
+        m_finalized.store(finalized);
+    }
+}
+
+void CFinalityManager::Reset()
+{
+    m_chain = nullptr;
+    m_finalized.store(nullptr);
+    LOCK(m_stats_mutex);
+    m_stats_height = -1;
+}
+
+const CBlockIndex* CFinalityManager::GetIrreversibleBlock() const
+{
+    LOCK(::cs_main);
+    if (!m_chain || !m_config.enableFinalityRules) {
+        return nullptr;
+    }
+    
+    return (*m_chain)[m_chain->Height() - m_config.irreversibleConfirmations + 1];
+}
+
 bool CFinalityManager::ValidateReorganization(const CBlockIndex* pindexOld, const CBlockIndex* pindexNew) const
 {
     if (!m_config.enableFinalityRules) {
@@ -87,10 +129,8 @@ bool CFinalityManager::ValidateReorganization(const CBlockIndex* pindexOld, cons
         return false;
     }
     
-    // Check if old chain is finalized
-    if (IsBlockFinal(pindexOld)) {
-        LogPrint(BCLog::CONSENSUS, "Reorganization blocked: old chain is finalized\n");
-        m_stats.blockedReorganizations++;
+    // The new chain must contain every finalized block
+    if (ConflictsWithFinalized(pindexNew)) {
         return false;
     }
     
@@ -99,6 +139,7 @@ bool CFinalityManager::ValidateReorganization(const CBlockIndex* pindexOld, cons
     if (reorgDepth > m_config.maxReorgDepth) {
         LogPrint(BCLog::CONSENSUS, "Reorganization blocked: depth %d exceeds maximum %d\n", 
                 reorgDepth, m_config.maxReorgDepth);
+        LOCK(m_stats_mutex);
         m_stats.blockedReorganizations++;
         return false;
     }
@@ -122,14 +163,15 @@ int CFinalityManager::GetFinalityDepth(const CBlockIndex* pindex) const
 
 std::vector<const CBlockIndex*> CFinalityManager::GetFinalizedBlocks() const
 {
+    LOCK(::cs_main);
     std::vector<const CBlockIndex*> finalizedBlocks;
+    if (!m_chain || !m_config.enableFinalityRules) {
+        return finalizedBlocks;
+    }
     
-    const CBlockIndex* pindex = ::ChainActive().Tip();
-    while (pindex && pindex->pprev) {
-        if (IsBlockFinal(pindex)) {
-            finalizedBlocks.push_back(pindex);
-        }
-        pindex = pindex->pprev;
+    // Newest first, down to but excluding the genesis block
+    for (int height = m_chain->Height() - m_config.softFinalityConfirmations + 1; height > 0; --height) {
+        finalizedBlocks.push_back((*m_chain)[height]);
     }
     
     return finalizedBlocks;
@@ -137,14 +179,14 @@ std::vector<const CBlockIndex*> CFinalityManager::GetFinalizedBlocks() const
 
 std::vector<const CBlockIndex*> CFinalityManager::GetIrreversibleBlocks() const
 {
+    LOCK(::cs_main);
     std::vector<const CBlockIndex*> irreversibleBlocks;
+    if (!m_chain || !m_config.enableFinalityRules) {
+        return irreversibleBlocks;
+    }
     
-    const CBlockIndex* pindex = ::ChainActive().Tip();
-    while (pindex && pindex->pprev) {
-        if (IsBlockIrreversible(pindex)) {
-            irreversibleBlocks.push_back(pindex);
-        }
-        pindex = pindex->pprev;
+    for (int height = m_chain->Height() - m_config.irreversibleConfirmations + 1; height > 0; --height) {
+        irreversibleBlocks.push_back((*m_chain)[height]);
     }
     
     return irreversibleBlocks;
@@ -152,11 +194,13 @@ std::vector<const CBlockIndex*> CFinalityManager::GetIrreversibleBlocks() const
 
 CFinalityManager::FinalityStats CFinalityManager::GetStats() const
 {
+    LOCK(m_stats_mutex);
     return m_stats;
 }
 
 void CFinalityManager::ResetStats()
 {
+    LOCK(m_stats_mutex);
     m_stats = {0, 0, 0, 0, 0, GetTime()};
     LogPrint(BCLog::CONSENSUS, "Finality statistics reset\n");
 }
@@ -194,6 +238,7 @@ void CFinalityManager::LogReorganizationAttempt(const CBlockIndex* pindexOld, co
 
 void CFinalityManager::LogFinalityStats()
 {
+    LOCK(m_stats_mutex);
     LogPrint(BCLog::CONSENSUS, "Finality statistics:\n");
     LogPrint(BCLog::CONSENSUS, "  Total blocks: %d\n", m_stats.totalBlocks);
     LogPrint(BCLog::CONSENSUS, "  Soft final blocks: %d\n", m_stats.softFinalBlocks);
@@ -204,40 +249,12 @@ void CFinalityManager::LogFinalityStats()
 
 int CFinalityManager::CalculateConfirmations(const CBlockIndex* pindex) const
 {
-    if (!pindex) {
-        return 0;
-    }
-    
-    const CBlockIndex* pindexTip = ::ChainActive().Tip();
-    if (!pindexTip) {
+    LOCK(::cs_main);
+    if (!pindex || !m_chain || !m_chain->Contains(pindex)) {
         return 0;
     }
     
-    // Check if block is in main chain
-    if (!IsBlockInMainChain(pindex)) {
-        return 0;
-    }
-    
-    return pindexTip->nHeight - pindex->nHeight + 1;
-}
-
-bool CFinalityManager::IsBlockInMainChain(const CBlockIndex* pindex) const
-{
-    if (!pindex) {
-        return false;
-    }
-    
-    const CBlockIndex* pindexTip = ::ChainActive().Tip();
-    if (!pindexTip) {
-        return false;
-    }
-    
-    // Check if block is in the main chain
-    while (pindexTip && pindexTip != pindex) {
-        pindexTip = pindexTip->pprev;
-    }
-    
-    return pindexTip == pindex;
+    return m_chain->Height() - pindex->nHeight + 1;
 }
 
 int CFinalityManager::GetReorganizationDepth(const CBlockIndex* pindexOld, const CBlockIndex* pindexNew) const
@@ -246,109 +263,58 @@ int CFinalityManager::GetReorganizationDepth(const CBlockIndex* pindexOld, const
         return 0;
     }
     
-    // Find common ancestor
-    const CBlockIndex* pindexCommon = pindexOld;
-    while (pindexCommon && !IsBlockInMainChain(pindexCommon)) {
-        pindexCommon = pindexCommon->pprev;
-    }
+    // Find common ancestor: against the active chain when reorganizing away from
+    // its tip, otherwise through skip pointers
+    LOCK(::cs_main);
+    const CBlockIndex* pindexCommon = m_chain && m_chain->Contains(pindexOld) ?
+        m_chain->FindFork(pindexNew) : LastCommonAncestor(pindexOld, pindexNew);
     
     if (!pindexCommon) {
         return 0;
     }
     
-    // Calculate depth from common ancestor to old tip
-    int depth = 0;
-    const CBlockIndex* pindex = pindexOld;
-    while (pindex && pindex != pindexCommon) {
-        depth++;
-        pindex = pindex->pprev;
-    }
-    
-    return depth;
+    // Number of blocks disconnected from the old chain
+    return std::max(0, pindexOld->nHeight - pindexCommon->nHeight);
 }
 
-void CFinalityManager::UpdateFinalityCache(const CBlockIndex* pindex) const
+bool CFinalityManager::ConflictsWithFinalized(const CBlockIndex* pindexNew) const
 {
-    if (!pindex) {
-        return;
+    const CBlockIndex* finalized = m_finalized.load();
+    if (!m_config.enableFinalityRules || !finalized || !pindexNew) {
+        return false;
     }
     
-    FinalityStatus status = CalculateFinalityStatus(pindex);
-    m_finalityCache[pindex] = status;
-    
-    // Update statistics
-    m_stats.totalBlocks++;
-    switch (status) {
-        case FinalityStatus::SOFT_FINAL:
-            m_stats.softFinalBlocks++;
-            break;
-        case FinalityStatus::HARD_FINAL:
-            m_stats.hardFinalBlocks++;
-            break;
-        case FinalityStatus::IRREVERSIBLE:
-            m_stats.irreversibleBlocks++;
-            break;
-        default:
-            break;
+    const int height = std::min(finalized->nHeight, pindexNew->nHeight);
+    if (pindexNew->GetAncestor(height) == finalized->GetAncestor(height)) {
+        return false;
     }
-}
-
-void CFinalityManager::CleanupFinalityCache()
-{
-    // Remove entries for blocks that are no longer in memory
-    // This is a simplified cleanup - in practice, you might want more sophisticated cache management
-    m_finalityCache.clear();
+    LogPrint(BCLog::CONSENSUS, "Reorganization blocked: new chain conflicts with finalized block at height %d\n",
+            finalized->nHeight);
+    LOCK(m_stats_mutex);
+    m_stats.blockedReorganizations++;
+    return true;
 }
 
 FinalityStatus CFinalityManager::CalculateFinalityStatus(const CBlockIndex* pindex) const
 {
-    if (!pindex) {
+    const int confirmations = CalculateConfirmations(pindex);
+    if (confirmations == 0) {
         return FinalityStatus::PENDING;
     }
     
-    int confirmations = CalculateConfirmations(pindex);
-    
-    if (MeetsIrreversibleCriteria(pindex)) {
+    const CBlockIndex* finalized = m_finalized.load();
+    if (confirmations >= m_config.irreversibleConfirmations) {
         return FinalityStatus::IRREVERSIBLE;
-    } else if (MeetsHardFinalityCriteria(pindex)) {
+    } else if (confirmations >= m_config.hardFinalityConfirmations) {
         return FinalityStatus::HARD_FINAL;
-    } else if (MeetsSoftFinalityCriteria(pindex)) {
+    } else if (confirmations >= m_config.softFinalityConfirmations ||
+               (finalized && pindex->nHeight <= finalized->nHeight)) {
         return FinalityStatus::SOFT_FINAL;
     } else {
         return FinalityStatus::PENDING;
     }
 }
 
-bool CFinalityManager::MeetsSoftFinalityCriteria(const CBlockIndex* pindex) const
-{
-    if (!pindex) {
-        return false;
-    }
-    
-    int confirmations = CalculateConfirmations(pindex);
-    return confirmations >= m_config.softFinalityConfirmations;
-}
-
-bool CFinalityManager::MeetsHardFinalityCriteria(const CBlockIndex* pindex) const
-{
-    if (!pindex) {
-        return false;
-    }
-    
-    int confirmations = CalculateConfirmations(pindex);
-    return confirmations >= m_config.hardFinalityConfirmations;
-}
-
-bool CFinalityManager::MeetsIrreversibleCriteria(const CBlockIndex* pindex) const
-{
-    if (!pindex) {
-        return false;
-    }
-    
-    int confirmations = CalculateConfirmations(pindex);
-    return confirmations >= m_config.irreversibleConfirmations;
-}
-
 // Utility functions implementation
 namespace FinalityUtils {
     bool InitializeFinalitySystem()
@@ -387,6 +353,15 @@ namespace FinalityUtils {
         return g_finalityManager->IsReorganizationAllowed(pindexOld, pindexNew);
     }
     
+    bool ConflictsWithFinalized(const CBlockIndex* pindexNew)
+    {
+        if (!g_finalityManager) {
+            return false;
+        }
+        
+        return g_finalityManager->ConflictsWithFinalized(pindexNew);
+    }
+    
     std::string GetFinalityStatusName(FinalityStatus status)
     {
         switch (status) {
@@ -7,11 +7,12 @@
 #include <primitives/block.h>
 #include <chain.h>
 #include <chainparams.h>
+#include <kernel/cs_main.h>
 #include <logging.h>
+#include <sync.h>
 #include <util/time.h>
 
-#include <map>
-#include <set>
+#include <atomic>
 #include <vector>
 
 class CBlockIndex;
@@ -48,6 +49,13 @@ struct FinalityConfig {
 /**
  * Finality Manager
  * Manages block finality and reorganization protection
+ *
+ * Finality is driven by a watermark: the most recent block of the active chain
+ * with softFinalityConfirmations confirmations, advanced as blocks are
+ * connected and never moved back. A block is classified by its height relative
+ * to the active tip after an O(1) CChain::Contains check, and a reorganization
+ * is checked by comparing the new chain's ancestor at the watermark height
+ * with the watermark block, so no check walks the chain.
  */
 class CFinalityManager
 {
@@ -65,14 +73,28 @@ public:
     bool IsBlockIrreversible(const CBlockIndex* pindex) const;
     bool CanReorganize(const CBlockIndex* pindex) const;
     
+    // Advance the finality watermark after pindex was connected to the tip of chain,
+    // the active chain. Chain queries below read it, so callers hold cs_main.
+    void BlockConnected(const CChain& chain, const CBlockIndex* pindex);
+    // Most recent finalized block, or nullptr
+    const CBlockIndex* GetFinalizedBlock() const { return m_finalized.load(); }
+    // Forget the active chain and the watermark. Called by ChainstateManager before
+    // the chainstates and block index they point into are destroyed.
+    void Reset();
+    // Most recent irreversible block of the active chain, or nullptr
+    const CBlockIndex* GetIrreversibleBlock() const;
+    
     // Reorganization protection
     bool ValidateReorganization(const CBlockIndex* pindexOld, const CBlockIndex* pindexNew) const;
     bool IsReorganizationAllowed(const CBlockIndex* pindexOld, const CBlockIndex* pindexNew) const;
+    // Whether making pindexNew the tip would disconnect a finalized block; such a
+    // reorganization is counted as blocked
+    bool ConflictsWithFinalized(const CBlockIndex* pindexNew) const EXCLUSIVE_LOCKS_REQUIRED(!m_stats_mutex);
     
     // Chain analysis
     int GetFinalityDepth(const CBlockIndex* pindex) const;
-    std::vector<const CBlockIndex*> GetFinalizedBlocks() const;
-    std::vector<const CBlockIndex*> GetIrreversibleBlocks() const;
+    std::vector<const CBlockIndex*> GetFinalizedBlocks() const EXCLUSIVE_LOCKS_REQUIRED(!::cs_main);
+    std::vector<const CBlockIndex*> GetIrreversibleBlocks() const EXCLUSIVE_LOCKS_REQUIRED(!::cs_main);
     
     // Statistics and monitoring
     struct FinalityStats {
@@ -84,33 +106,33 @@ public:
         int64_t lastCheckTime;
     };
     
-    FinalityStats GetStats() const;
-    void ResetStats();
+    FinalityStats GetStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_stats_mutex);
+    void ResetStats() EXCLUSIVE_LOCKS_REQUIRED(!m_stats_mutex);
     
     // Logging
     void LogFinalityStatus(const CBlockIndex* pindex);
     void LogReorganizationAttempt(const CBlockIndex* pindexOld, const CBlockIndex* pindexNew);
-    void LogFinalityStats();
+    void LogFinalityStats() EXCLUSIVE_LOCKS_REQUIRED(!m_stats_mutex);
 
 private:
     FinalityConfig m_config;
-    FinalityStats m_stats;
+    mutable Mutex m_stats_mutex;
+    mutable FinalityStats m_stats GUARDED_BY(m_stats_mutex);
+    // Highest block height counted in m_stats, so that blocks reconnected by a
+    // reorganization are not counted twice
+    int m_stats_height GUARDED_BY(m_stats_mutex){-1};
     
-    // Cached finality status
-    mutable std::map<const CBlockIndex*, FinalityStatus> m_finalityCache;
+    // Active chain, set by BlockConnected
+    const CChain* m_chain{nullptr};
+    // Finality watermark: the highest block ever finalized on the active chain
+    std::atomic<const CBlockIndex*> m_finalized{nullptr};
     
     // Helper functions
     int CalculateConfirmations(const CBlockIndex* pindex) const;
-    bool IsBlockInMainChain(const CBlockIndex* pindex) const;
     int GetReorganizationDepth(const CBlockIndex* pindexOld, const CBlockIndex* pindexNew) const;
-    void UpdateFinalityCache(const CBlockIndex* pindex) const;
-    void CleanupFinalityCache();
     
     // Finality calculation
     FinalityStatus CalculateFinalityStatus(const CBlockIndex* pindex) const;
-    bool MeetsSoftFinalityCriteria(const CBlockIndex* pindex) const;
-    bool MeetsHardFinalityCriteria(const CBlockIndex* pindex) const;
-    bool MeetsIrreversibleCriteria(const CBlockIndex* pindex) const;
 };
 
 // Global finality manager instance
@@ -129,6 +151,7 @@ namespace FinalityUtils {
     
     // Check if reorganization is allowed
     bool IsReorganizationAllowed(const CBlockIndex* pindexOld, const CBlockIndex* pindexNew);
+    bool ConflictsWithFinalized(const CBlockIndex* pindexNew);
     
     // Get human-readable finality status
     std::string GetFinalityStatusName(FinalityStatus status);
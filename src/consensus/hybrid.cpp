@@ -1,6 +1,11 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "consensus/hybrid.h"
 
+#include <arith_uint256.h>
+
+#include <algorithm>
+#include <cassert>
+
 AlgoType SelectNextAlgo(int height) {
     // 33/33/34 rotation for SHA256d/Scrypt/Groestl. PoS interleave to be handled elsewhere.
     int m = height % 3;
@@ -9,6 +14,23 @@ AlgoType SelectNextAlgo(int height) {
     return AlgoType::GROESTL;
 }
 
+AlgoType AlgoFromVersion(int32_t version) {
+    if ((version & HYBRID_VERSION_TOP_MASK) == HYBRID_VERSION_TOP_BITS) {
+        return static_cast<AlgoType>((version & HYBRID_VERSION_ALGO_MASK) >> HYBRID_VERSION_ALGO_SHIFT);
+    }
+    // Legacy blocks don't carry an explicit algorithm
+    return AlgoType::SHA256D;
+}
+
+bool IsValidAlgoVersion(int32_t version) {
+    return static_cast<size_t>(AlgoFromVersion(version)) < ALGO_TYPE_COUNT;
+}
+
+int32_t VersionWithAlgo(int32_t version, AlgoType algo) {
+    version &= ~(HYBRID_VERSION_TOP_MASK | HYBRID_VERSION_ALGO_MASK);
+    return version | HYBRID_VERSION_TOP_BITS | (int32_t(algo) << HYBRID_VERSION_ALGO_SHIFT);
+}
+
 const char* AlgoName(AlgoType a) {
     switch (a) {
         case AlgoType::SHA256D: return "sha256d";
@@ -19,135 +41,33 @@ const char* AlgoName(AlgoType a) {
     return "unknown";
 }
 
-// LWMA (Linear Weighted Moving Average) difficulty adjustment
-// This provides better responsiveness to hash rate changes
-
-unsigned int GetNextWorkRequiredSHA256(int height) {
-    // LWMA difficulty adjustment for SHA256d
-    const int N = 144; // 24 hours worth of blocks
-    const int T = 600; // 10 minute target spacing
-    
-    if (height < N) return 0x1d00ffff; // Genesis difficulty
-    
-    // Calculate weighted average of solve times
-    uint64_t weightedSum = 0;
-    uint64_t weightSum = 0;
-    
-    for (int i = 0; i < N; i++) {
-        int weight = N - i;
-        // TODO: Get actual solve time from block at height - i
-        uint64_t solveTime = T; // Placeholder
-        weightedSum += solveTime * weight;
-        weightSum += weight;
-    }
-    
-    uint64_t avgSolveTime = weightedSum / weightSum;
-    uint64_t targetSpacing = T;
-    
-    // Adjust difficulty based on solve time ratio
-    uint64_t newTarget = (avgSolveTime * 0x1d00ffff) / targetSpacing;
-    
-    // Clamp to reasonable bounds
-    if (newTarget > 0x1d00ffff * 4) newTarget = 0x1d00ffff * 4;
-    if (newTarget < 0x1d00ffff / 4) newTarget = 0x1d00ffff / 4;
-    
-    return static_cast<unsigned int>(newTarget);
+std::optional<AlgoType> PoWAlgoFromName(std::string_view name) {
+    if (name == "sha256d" || name == "sha256") return AlgoType::SHA256D;
+    if (name == "scrypt") return AlgoType::SCRYPT;
+    if (name == "groestl") return AlgoType::GROESTL;
+    return std::nullopt;
 }
 
-unsigned int GetNextWorkRequiredScrypt(int height) {
-    // LWMA difficulty adjustment for Scrypt
-    const int N = 144; // 24 hours worth of blocks
-    const int T = 600; // 10 minute target spacing
-    
-    if (height < N) return 0x1d00ffff; // Genesis difficulty
-    
-    // Calculate weighted average of solve times
-    uint64_t weightedSum = 0;
-    uint64_t weightSum = 0;
-    
-    for (int i = 0; i < N; i++) {
-        int weight = N - i;
-        // TODO: Get actual solve time from block at height - i
-        uint64_t solveTime = T; // Placeholder
-        weightedSum += solveTime * weight;
-        weightSum += weight;
-    }
-    
-    uint64_t avgSolveTime = weightedSum / weightSum;
-    uint64_t targetSpacing = T;
-    
-    // Adjust difficulty based on solve time ratio
-    uint64_t newTarget = (avgSolveTime * 0x1d00ffff) / targetSpacing;
-    
-    // Clamp to reasonable bounds
-    if (newTarget > 0x1d00ffff * 4) newTarget = 0x1d00ffff * 4;
-    if (newTarget < 0x1d00ffff / 4) newTarget = 0x1d00ffff / 4;
-    
-    return static_cast<unsigned int>(newTarget);
+int64_t LWMASolveTime(int64_t time, int64_t prev_time, int64_t spacing) {
+    return std::clamp<int64_t>(time - prev_time, -6 * spacing, 6 * spacing);
 }
 
-unsigned int GetNextWorkRequiredGroestl(int height) {
-    // LWMA difficulty adjustment for Groestl
-    const int N = 144; // 24 hours worth of blocks
-    const int T = 600; // 10 minute target spacing
-    
-    if (height < N) return 0x1d00ffff; // Genesis difficulty
-    
-    // Calculate weighted average of solve times
-    uint64_t weightedSum = 0;
-    uint64_t weightSum = 0;
-    
-    for (int i = 0; i < N; i++) {
-        int weight = N - i;
-        // TODO: Get actual solve time from block at height - i
-        uint64_t solveTime = T; // Placeholder
-        weightedSum += solveTime * weight;
-        weightSum += weight;
-    }
-    
-    uint64_t avgSolveTime = weightedSum / weightSum;
-    uint64_t targetSpacing = T;
-    
-    // Adjust difficulty based on solve time ratio
-    uint64_t newTarget = (avgSolveTime * 0x1d00ffff) / targetSpacing;
-    
-    // Clamp to reasonable bounds
-    if (newTarget > 0x1d00ffff * 4) newTarget = 0x1d00ffff * 4;
-    if (newTarget < 0x1d00ffff / 4) newTarget = 0x1d00ffff / 4;
-    
-    return static_cast<unsigned int>(newTarget);
-}
-
-unsigned int GetNextStakeTarget(int height) {
-    // PoS difficulty adjustment
-    const int N = 144; // 24 hours worth of blocks
-    const int T = 150; // 2.5 minute target spacing for PoS
-    
-    if (height < N) return 0x1d00ffff; // Genesis difficulty
-    
-    // Calculate weighted average of solve times
-    uint64_t weightedSum = 0;
-    uint64_t weightSum = 0;
-    
-    for (int i = 0; i < N; i++) {
-        int weight = N - i;
-        // TODO: Get actual solve time from PoS block at height - i
-        uint64_t solveTime = T; // Placeholder
-        weightedSum += solveTime * weight;
-        weightSum += weight;
-    }
-    
-    uint64_t avgSolveTime = weightedSum / weightSum;
-    uint64_t targetSpacing = T;
-    
-    // Adjust difficulty based on solve time ratio
-    uint64_t newTarget = (avgSolveTime * 0x1d00ffff) / targetSpacing;
-    
-    // Clamp to reasonable bounds
-    if (newTarget > 0x1d00ffff * 4) newTarget = 0x1d00ffff * 4;
-    if (newTarget < 0x1d00ffff / 4) newTarget = 0x1d00ffff / 4;
-    
-    return static_cast<unsigned int>(newTarget);
-}
+arith_uint256 LWMANextTarget(const arith_uint256& scaled_target_sum, int64_t window, int64_t weighted_solvetime_sum, int64_t n, int64_t spacing, const arith_uint256& pow_limit) {
+    assert(n > 0 && n <= window && spacing > 0);
+    const int64_t k = n * (n + 1) / 2 * spacing;
+    // Negative solve times can drive the weighted sum towards zero; limit the
+    // resulting difficulty increase to 10x per block.
+    const int64_t weighted = std::max(weighted_solvetime_sum, k / 10);
 
+    // Targets were summed after dividing by window; undo that for the n blocks present.
+    const arith_uint256 average = scaled_target_sum / arith_uint256(uint64_t(n)) * arith_uint256(uint64_t(window));
 
+    // average * weighted / k, split so that it cannot overflow for any pow_limit.
+    const arith_uint256 bn_k{uint64_t(k)};
+    const arith_uint256 bn_weighted{uint64_t(weighted)};
+    const arith_uint256 quotient = average / bn_k;
+    if (quotient > pow_limit / bn_weighted) return pow_limit;
+    arith_uint256 next = quotient * bn_weighted + (average - quotient * bn_k) * bn_weighted / bn_k;
+    if (next > pow_limit) next = pow_limit;
+    return next;
+}
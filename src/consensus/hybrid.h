@@ -2,7 +2,12 @@
 #ifndef SHAHCOIN_CONSENSUS_HYBRID_H
 #define SHAHCOIN_CONSENSUS_HYBRID_H
 
+#include <cstddef>
 #include <cstdint>
+#include <optional>
+#include <string_view>
+
+class arith_uint256;
 
 enum class AlgoType : uint8_t {
     SHA256D = 0,
@@ -10,17 +15,44 @@ enum class AlgoType : uint8_t {
     GROESTL = 2,
     POS     = 3
 };
+//! Number of AlgoType values
+static constexpr size_t ALGO_TYPE_COUNT{4};
+
+/**
+ * Hybrid consensus block versions set the BIP9 top bits and carry the algorithm in bits 25-27, below them.
+ * Those bits are reserved in versionbits (VERSIONshahbits_ALGO_MASK) and never signal a deployment.
+ */
+static constexpr int32_t HYBRID_VERSION_TOP_BITS{0x20000000};
+static constexpr int32_t HYBRID_VERSION_TOP_MASK{int32_t(0xE0000000)};
+static constexpr int HYBRID_VERSION_ALGO_SHIFT{25};
+static constexpr int32_t HYBRID_VERSION_ALGO_MASK{0x7 << HYBRID_VERSION_ALGO_SHIFT};
 
 AlgoType SelectNextAlgo(int height);
+// Algorithm encoded in a hybrid consensus block version; legacy versions are sha256d.
+// Not necessarily a valid AlgoType unless IsValidAlgoVersion(version).
+AlgoType AlgoFromVersion(int32_t version);
+// Whether the algorithm field of version, if any, names an AlgoType.
+bool IsValidAlgoVersion(int32_t version);
+// version with the hybrid top bits set and its algorithm field replaced by algo; other bits are kept.
+int32_t VersionWithAlgo(int32_t version, AlgoType algo);
 const char* AlgoName(AlgoType a);
-
-// Per‑algo DAA stubs
-unsigned int GetNextWorkRequiredSHA256(int height);
-unsigned int GetNextWorkRequiredScrypt(int height);
-unsigned int GetNextWorkRequiredGroestl(int height);
-
-// PoS target stub
-unsigned int GetNextStakeTarget(int height);
+// Inverse of AlgoName for the proof-of-work algorithms; also accepts "sha256".
+std::optional<AlgoType> PoWAlgoFromName(std::string_view name);
+
+/**
+ * Per-algo DAA: linearly weighted moving average (LWMA) retargeting.
+ *
+ * Over the last n blocks of one algorithm, the next target is the average of
+ * their targets scaled by the ratio of their solve times, weighted 1..n from
+ * oldest to newest, to the expected weighted solve time n(n+1)/2 * spacing.
+ * Each target enters scaled_target_sum divided by window (the largest n), so
+ * the sum cannot overflow. The sums are kept per block index and updated incrementally, see
+ * UpdateLWMASums in pow.h.
+ */
+arith_uint256 LWMANextTarget(const arith_uint256& scaled_target_sum, int64_t window, int64_t weighted_solvetime_sum, int64_t n, int64_t spacing, const arith_uint256& pow_limit);
+
+// Solve time counted by LWMA, clamped to +-6 spacings so that a single bad timestamp has bounded effect.
+int64_t LWMASolveTime(int64_t time, int64_t prev_time, int64_t spacing);
 
 #endif // SHAHCOIN_CONSENSUS_HYBRID_H
 
@@ -114,6 +114,13 @@ struct Params {
         return std::chrono::seconds{nPowTargetSpacing};
     }
     int64_t DifficultyAdjustmentInterval() const { return nPowTargetTimespan / nPowTargetSpacing; }
+    /** Hybrid consensus: height from which each algorithm retargets every block with LWMA */
+    int nLWMAHeight{std::numeric_limits<int>::max()};
+    /** Number of same-algorithm solve times averaged by LWMA */
+    int64_t nLWMAWindow{144};
+    /** Expected time between consecutive blocks of one PoW algorithm, and between PoS blocks */
+    int64_t nLWMAPowTargetSpacing{10 * 60};
+    int64_t nLWMAPosTargetSpacing{150};
     /** The best chain should have at least this much work */
     uint256 nMinimumChainWork;
     /** By default assume that the signatures in ancestors of this block are valid */
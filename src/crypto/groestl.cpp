@@ -2,60 +2,273 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <crypto/groestl.h>
-#include <crypto/sha256.h>
-#include <cstring>
+#include <crypto/common.h>
 
-// SHAHCOIN Core groestl implementation
-// For now, we'll implement a simplified groestl-like function using SHA256
-// In production, you would link against a proper groestl library
+#include <algorithm>
+#include <array>
+#include <assert.h>
+#include <string.h>
 
-CGroestl::CGroestl() : pimpl(nullptr)
+#include <compat/cpuid.h>
+
+namespace groestl_x86_aesni
 {
-    Reset();
+void Transform(uint64_t* s, const unsigned char* chunk, size_t blocks);
+void OutputTransform(uint64_t* s);
 }
 
-CGroestl::~CGroestl()
+// Internal implementation code.
+namespace
+{
+/// Internal Groestl-256 implementation.
+///
+/// The 8x8 byte state is kept as eight 64-bit columns, with row i of a column
+/// in byte i (little endian), which matches the column-major byte order of the
+/// specification when stored to memory.
+namespace groestl
+{
+static constexpr int ROUNDS = 10;
+
+constexpr uint8_t XTime(uint8_t x) { return uint8_t((x << 1) ^ ((x & 0x80) ? 0x1b : 0x00)); }
+
+constexpr uint8_t Mul(uint8_t a, uint8_t b)
 {
-    if (pimpl) {
-        free(pimpl);
+    uint8_t r = 0;
+    while (b) {
+        if (b & 1) r ^= a;
+        a = XTime(a);
+        b >>= 1;
     }
+    return r;
 }
 
-void CGroestl::Write(const unsigned char* data, size_t len)
+/** The AES S-box, derived from inversion in GF(2^8) followed by the affine map. */
+constexpr uint8_t SBox(uint8_t x)
 {
-    // Simplified implementation - in production use proper groestl
-    // This is a placeholder that uses SHA256 for compatibility
-    if (!pimpl) {
-        pimpl = malloc(CSHA256::OUTPUT_SIZE);
+    uint8_t inv = 0;
+    if (x) {
+        // x^254 == x^-1
+        uint8_t p = x;
+        inv = 1;
+        for (int e = 254; e; e >>= 1) {
+            if (e & 1) inv = Mul(inv, p);
+            p = Mul(p, p);
+        }
     }
-    
-    CSHA256 hasher;
-    hasher.Write(data, len);
-    hasher.Finalize((unsigned char*)pimpl);
+    uint8_t s = inv;
+    for (int i = 1; i <= 4; ++i) s ^= uint8_t((inv << i) | (inv >> (8 - i)));
+    return s ^ 0x63;
 }
 
-void CGroestl::Finalize(unsigned char hash[OUTPUT_SIZE])
+/** T[k][x] is S(x) times column k of the MixBytes matrix circ(02,02,03,04,05,03,05,07). */
+constexpr std::array<std::array<uint64_t, 256>, 8> MakeTables()
+{
+    constexpr uint8_t c[8] = {0x02, 0x02, 0x03, 0x04, 0x05, 0x03, 0x05, 0x07};
+    std::array<std::array<uint64_t, 256>, 8> t{};
+    for (int x = 0; x < 256; ++x) {
+        const uint8_t s = SBox(uint8_t(x));
+        for (int k = 0; k < 8; ++k) {
+            uint64_t v = 0;
+            for (int i = 0; i < 8; ++i) v |= uint64_t{Mul(s, c[(k - i + 8) & 7])} << (8 * i);
+            t[k][x] = v;
+        }
+    }
+    return t;
+}
+
+static constexpr auto T = MakeTables();
+
+uint64_t inline Column(const uint64_t* x, int j, int s0, int s1, int s2, int s3, int s4, int s5, int s6, int s7)
+{
+    return T[0][uint8_t(x[(j + s0) & 7])] ^
+           T[1][uint8_t(x[(j + s1) & 7] >> 8)] ^
+           T[2][uint8_t(x[(j + s2) & 7] >> 16)] ^
+           T[3][uint8_t(x[(j + s3) & 7] >> 24)] ^
+           T[4][uint8_t(x[(j + s4) & 7] >> 32)] ^
+           T[5][uint8_t(x[(j + s5) & 7] >> 40)] ^
+           T[6][uint8_t(x[(j + s6) & 7] >> 48)] ^
+           T[7][uint8_t(x[(j + s7) & 7] >> 56)];
+}
+
+void inline RoundP(uint64_t* x, uint64_t r)
+{
+    uint64_t t[8];
+    for (int j = 0; j < 8; ++j) t[j] = x[j] ^ (uint64_t(j << 4) ^ r);
+    for (int j = 0; j < 8; ++j) x[j] = Column(t, j, 0, 1, 2, 3, 4, 5, 6, 7);
+}
+
+void inline RoundQ(uint64_t* x, uint64_t r)
+{
+    uint64_t t[8];
+    for (int j = 0; j < 8; ++j) t[j] = x[j] ^ ~((uint64_t(j << 4) ^ r) << 56);
+    for (int j = 0; j < 8; ++j) x[j] = Column(t, j, 1, 3, 5, 7, 0, 2, 4, 6);
+}
+
+void inline Initialize(uint64_t* s)
+{
+    // IV is the output length in bits, as a big-endian number in the last bytes of the state.
+    memset(s, 0, 8 * sizeof(uint64_t));
+    s[7] = uint64_t{0x01} << 48;
+}
+
+/** Compression function f(h, m) = P(h ^ m) ^ Q(m) ^ h, applied to successive blocks. */
+void Transform(uint64_t* s, const unsigned char* chunk, size_t blocks)
+{
+    while (blocks--) {
+        uint64_t p[8], q[8];
+        for (int j = 0; j < 8; ++j) {
+            q[j] = ReadLE64(chunk + 8 * j);
+            p[j] = s[j] ^ q[j];
+        }
+        for (int r = 0; r < ROUNDS; ++r) {
+            RoundP(p, r);
+            RoundQ(q, r);
+        }
+        for (int j = 0; j < 8; ++j) s[j] ^= p[j] ^ q[j];
+        chunk += 64;
+    }
+}
+
+/** Output transformation: s = P(s) ^ s. */
+void OutputTransform(uint64_t* s)
+{
+    uint64_t p[8];
+    memcpy(p, s, sizeof(p));
+    for (int r = 0; r < ROUNDS; ++r) RoundP(p, r);
+    for (int j = 0; j < 8; ++j) s[j] ^= p[j];
+}
+
+typedef void (*TransformType)(uint64_t*, const unsigned char*, size_t);
+typedef void (*OutputTransformType)(uint64_t*);
+} // namespace groestl
+
+groestl::TransformType Transform = groestl::Transform;
+groestl::OutputTransformType OutputTransform = groestl::OutputTransform;
+
+bool SelfTest()
 {
-    if (pimpl) {
-        memcpy(hash, pimpl, OUTPUT_SIZE);
-    } else {
-        memset(hash, 0, OUTPUT_SIZE);
+    // Groestl-256 of "" and of a 43-byte message.
+    static const unsigned char data[] = "The quick brown fox jumps over the lazy dog";
+    static const unsigned char result[2][32] = {
+        {0x1a, 0x52, 0xd1, 0x1d, 0x55, 0x00, 0x39, 0xbe, 0x16, 0x10, 0x7f, 0x9c, 0x58, 0xdb, 0x9e, 0xbc,
+         0xc4, 0x17, 0xf1, 0x6f, 0x73, 0x6a, 0xdb, 0x25, 0x02, 0x56, 0x71, 0x19, 0xf0, 0x08, 0x34, 0x67},
+        {0x8c, 0x7a, 0xd6, 0x2e, 0xb2, 0x6a, 0x21, 0x29, 0x7b, 0xc3, 0x9c, 0x2d, 0x72, 0x93, 0xb4, 0xbd,
+         0x4d, 0x33, 0x99, 0xfa, 0x8a, 0xfa, 0xb2, 0x9e, 0x97, 0x04, 0x71, 0x73, 0x9e, 0x28, 0xb3, 0x01},
+    };
+    static const size_t lengths[2] = {0, sizeof(data) - 1};
+
+    unsigned char out[CGroestl::OUTPUT_SIZE];
+    for (int i = 0; i < 2; ++i) {
+        CGroestl().Write(data, lengths[i]).Finalize(out);
+        if (!std::equal(out, out + CGroestl::OUTPUT_SIZE, result[i])) return false;
     }
+
+    // Chain a few blocks through the selected and the generic transforms.
+    unsigned char chunk[64 * 3];
+    for (size_t i = 0; i < sizeof(chunk); ++i) chunk[i] = uint8_t(i * 37 + 11);
+    uint64_t s1[8], s2[8];
+    groestl::Initialize(s1);
+    groestl::Initialize(s2);
+    Transform(s1, chunk, 3);
+    OutputTransform(s1);
+    groestl::Transform(s2, chunk, 3);
+    groestl::OutputTransform(s2);
+    return std::equal(s1, s1 + 8, s2);
 }
 
-void CGroestl::Reset()
+} // namespace
+
+
+std::string GroestlAutoDetect(groestl_implementation::UseImplementation use_implementation)
 {
-    if (pimpl) {
-        free(pimpl);
-        pimpl = nullptr;
+    std::string ret = "standard";
+    Transform = groestl::Transform;
+    OutputTransform = groestl::OutputTransform;
+
+#if defined(USE_ASM) && defined(HAVE_GETCPUID)
+    [[maybe_unused]] bool have_x86_aesni = false;
+
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    if (use_implementation & groestl_implementation::USE_AESNI) {
+        // AES-NI for SubBytes, SSSE3 for the byte shuffles.
+        have_x86_aesni = ((ecx >> 25) & 1) && ((ecx >> 9) & 1);
+    }
+
+#if defined(ENABLE_X86_AESNI) && !defined(BUILD_SHAHCOIN_INTERNAL)
+    if (have_x86_aesni) {
+        Transform = groestl_x86_aesni::Transform;
+        OutputTransform = groestl_x86_aesni::OutputTransform;
+        ret = "x86_aesni";
     }
+#endif
+#endif // defined(USE_ASM) && defined(HAVE_GETCPUID)
+
+    assert(SelfTest());
+    return ret;
+}
+
+////// Groestl-256
+
+CGroestl::CGroestl()
+{
+    groestl::Initialize(s);
+}
+
+CGroestl& CGroestl::Write(const unsigned char* data, size_t len)
+{
+    const unsigned char* end = data + len;
+    size_t bufsize = bytes % 64;
+    if (bufsize && bufsize + len >= 64) {
+        // Fill the buffer, and process it.
+        memcpy(buf + bufsize, data, 64 - bufsize);
+        bytes += 64 - bufsize;
+        data += 64 - bufsize;
+        Transform(s, buf, 1);
+        bufsize = 0;
+    }
+    if (end - data >= 64) {
+        size_t blocks = (end - data) / 64;
+        Transform(s, data, blocks);
+        data += 64 * blocks;
+        bytes += 64 * blocks;
+    }
+    if (end > data) {
+        // Fill the buffer with what remains.
+        memcpy(buf + bufsize, data, end - data);
+        bytes += end - data;
+    }
+    return *this;
+}
+
+void CGroestl::Finalize(unsigned char hash[OUTPUT_SIZE])
+{
+    // Pad with a single 1 bit and zeros up to 8 bytes short of a block boundary, then
+    // append the total number of blocks (including padding) as a big-endian 64-bit value.
+    static const unsigned char pad[64] = {0x80};
+    const size_t padlen = 1 + ((119 - (bytes % 64)) % 64);
+    unsigned char blockcount[8];
+    WriteBE64(blockcount, (bytes + padlen + 8) / 64);
+    Write(pad, padlen);
+    Write(blockcount, 8);
+    OutputTransform(s);
+    // The digest is the last 256 bits of the state, i.e. columns 4 to 7.
+    WriteLE64(hash, s[4]);
+    WriteLE64(hash + 8, s[5]);
+    WriteLE64(hash + 16, s[6]);
+    WriteLE64(hash + 24, s[7]);
+}
+
+CGroestl& CGroestl::Reset()
+{
+    bytes = 0;
+    groestl::Initialize(s);
+    return *this;
 }
 
 void CGroestl::Hash(const unsigned char* input, size_t len, unsigned char output[OUTPUT_SIZE])
 {
-    CGroestl hasher;
-    hasher.Write(input, len);
-    hasher.Finalize(output);
+    CGroestl().Write(input, len).Finalize(output);
 }
 
 void CGroestl::Hash(const unsigned char* input, size_t len, unsigned char* output, size_t outlen)
@@ -6,26 +6,41 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include <string>
 
-/** Groestl hashing algorithm implementation */
+/** A hasher class for Groestl-256 (512-bit state, 256-bit output). */
 class CGroestl
 {
+private:
+    uint64_t s[8];
+    unsigned char buf[64];
+    uint64_t bytes{0};
+
 public:
     static const size_t OUTPUT_SIZE = 32;
 
     CGroestl();
-    ~CGroestl();
 
-    void Write(const unsigned char* data, size_t len);
+    CGroestl& Write(const unsigned char* data, size_t len);
     void Finalize(unsigned char hash[OUTPUT_SIZE]);
-    void Reset();
+    CGroestl& Reset();
 
     // Static convenience methods
     static void Hash(const unsigned char* input, size_t len, unsigned char output[OUTPUT_SIZE]);
     static void Hash(const unsigned char* input, size_t len, unsigned char* output, size_t outlen);
+};
 
-private:
-    void* pimpl;
+namespace groestl_implementation {
+enum UseImplementation : uint8_t {
+    STANDARD = 0,
+    USE_AESNI = 1 << 0,
+    USE_ALL = USE_AESNI,
 };
+}
+
+/** Autodetect the best available Groestl implementation.
+ *  Returns the name of the implementation.
+ */
+std::string GroestlAutoDetect(groestl_implementation::UseImplementation use_implementation = groestl_implementation::USE_ALL);
 
 #endif // SHAHCOIN_CRYPTO_GROESTL_H
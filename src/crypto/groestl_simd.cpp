@@ -3,95 +3,25 @@
 
 #include "crypto/groestl_simd.h"
 #include "crypto/groestl.h"
+#include <compat/cpuid.h>
 #include <chrono>
 #include <cstring>
 
-#ifdef GROESTL_USE_AVX2
-#include <immintrin.h>
-#endif
-
-#ifdef GROESTL_USE_SSE4
-#include <smmintrin.h>
-#endif
-
-// SIMD-optimized Groestl implementation
-// This is a simplified version that demonstrates the concept
-// In production, you would use a full Groestl implementation with SIMD
-
 void groestl_256_hash_simd(const unsigned char* input, size_t len, unsigned char* output) {
-#ifdef GROESTL_USE_AVX2
-    // AVX2-optimized implementation
-    // This is a placeholder - in production you would implement the full Groestl algorithm
-    // using AVX2 intrinsics for maximum performance
-    
-    // For now, we'll use the standard implementation but with SIMD-optimized processing
-    // of the input data in chunks
-    
-    // Process input in 32-byte chunks using AVX2
-    size_t chunks = len / 32;
-    size_t remainder = len % 32;
-    
-    // Use AVX2 for bulk processing
-    for (size_t i = 0; i < chunks; i++) {
-        __m256i data = _mm256_loadu_si256((__m256i*)(input + i * 32));
-        // In a real implementation, you would process this through the Groestl algorithm
-        // using AVX2 intrinsics for the S-box and MixColumns operations
-    }
-    
-    // Process remainder using standard implementation
-    if (remainder > 0) {
-        // Fall back to standard implementation for the remainder
-        CGroestl::Hash(input + chunks * 32, remainder, output);
-        return;
-    }
-    
-    // For now, use the standard implementation as fallback
-    CGroestl::Hash(input, len, output);
-    
-#elif defined(GROESTL_USE_SSE4)
-    // SSE4.1-optimized implementation
-    // Process input in 16-byte chunks using SSE4.1
-    
-    size_t chunks = len / 16;
-    size_t remainder = len % 16;
-    
-    for (size_t i = 0; i < chunks; i++) {
-        __m128i data = _mm_loadu_si128((__m128i*)(input + i * 16));
-        // Process through Groestl algorithm using SSE4.1 intrinsics
-    }
-    
-    if (remainder > 0) {
-        CGroestl::Hash(input + chunks * 16, remainder, output);
-        return;
-    }
-    
+    // CGroestl dispatches to the AES-NI round function when GroestlAutoDetect() found it.
     CGroestl::Hash(input, len, output);
-    
-#else
-    // Fall back to standard implementation
-    CGroestl::Hash(input, len, output);
-#endif
 }
 
 void groestl_256_hash_auto(const unsigned char* input, size_t len, unsigned char* output) {
-    if (groestl_simd_available()) {
-        groestl_256_hash_simd(input, len, output);
-    } else {
-        CGroestl::Hash(input, len, output);
-    }
+    CGroestl::Hash(input, len, output);
 }
 
 bool groestl_simd_available() {
-#ifdef GROESTL_USE_AVX2
-    // Check for AVX2 support
-    int cpu_info[4];
-    __cpuid(cpu_info, 7);
-    return (cpu_info[1] & (1 << 5)) != 0; // Check AVX2 bit
-#elif defined(GROESTL_USE_SSE4)
-    // Check for SSE4.1 support
-    int cpu_info[4];
-    __cpuid(cpu_info, 1);
-    return (cpu_info[2] & (1 << 19)) != 0; // Check SSE4.1 bit
+#if defined(USE_ASM) && defined(HAVE_GETCPUID) && defined(ENABLE_X86_AESNI)
+    // Same check GroestlAutoDetect() uses: AES-NI plus SSSE3.
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    return ((ecx >> 25) & 1) && ((ecx >> 9) & 1);
 #else
     return false;
 #endif
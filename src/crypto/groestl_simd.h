@@ -8,15 +8,8 @@
 #include <cstddef>
 
 // SIMD-optimized Groestl implementation
-// This provides significant performance improvements on modern CPUs
-
-#ifdef __AVX2__
-#define GROESTL_USE_AVX2 1
-#endif
-
-#ifdef __SSE4_1__
-#define GROESTL_USE_SSE4 1
-#endif
+// The AES-NI round function lives in crypto/groestl_x86_aesni.cpp and is
+// selected at runtime by GroestlAutoDetect(); these are thin wrappers over it.
 
 // SIMD-optimized Groestl-256 hash function
 void groestl_256_hash_simd(const unsigned char* input, size_t len, unsigned char* output);
@@ -24,7 +17,8 @@ void groestl_256_hash_simd(const unsigned char* input, size_t len, unsigned char
 // Auto-detect best available SIMD implementation
 void groestl_256_hash_auto(const unsigned char* input, size_t len, unsigned char* output);
 
-// Check if SIMD is available
+// Check if this build has the AES-NI implementation and the CPU supports it.
+// Whether it is actually selected is up to GroestlAutoDetect().
 bool groestl_simd_available();
 
 // Performance benchmark function
@@ -0,0 +1,171 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// Groestl-256 using AES-NI for SubBytes, following the approach of the
+// AES-NI implementation in the Groestl SHA-3 submission: the state is held
+// by rows, with row i of P in the low and row i of Q in the high half of one
+// register, so both permutations of the compression function run together.
+
+#ifdef ENABLE_X86_AESNI
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include <attributes.h>
+
+namespace groestl_x86_aesni {
+namespace {
+
+constexpr int ROUNDS = 10;
+
+/** pshufb masks which apply ShiftBytes to row i of P (low half) and Q (high half),
+ *  pre-compensated for the AES ShiftRows that aesenclast applies afterwards. */
+struct ShiftMasks
+{
+    alignas(16) uint8_t m[8][16];
+
+    constexpr ShiftMasks() : m{}
+    {
+        constexpr int shift_p[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+        constexpr int shift_q[8] = {1, 3, 5, 7, 0, 2, 4, 6};
+        constexpr int shift_rows[16] = {0, 5, 10, 15, 4, 9, 14, 3, 8, 13, 2, 7, 12, 1, 6, 11};
+        for (int i = 0; i < 8; ++i) {
+            for (int k = 0; k < 16; ++k) {
+                const int target = k < 8 ? (k + shift_p[i]) % 8 : 8 + (k - 8 + shift_q[i]) % 8;
+                m[i][shift_rows[k]] = uint8_t(target);
+            }
+        }
+    }
+};
+
+constexpr ShiftMasks SHIFT_MASKS;
+
+/** Round constant bases: row 0 of P and row 7 of Q; all other Q rows are xored with 0xff. */
+alignas(16) constexpr uint8_t RC_ROW0[16] = {0x00, 0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+alignas(16) constexpr uint8_t RC_ROW7[16] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xef, 0xdf, 0xcf, 0xbf, 0xaf, 0x9f, 0x8f};
+alignas(16) constexpr uint8_t RC_ROWQ[16] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+alignas(16) constexpr uint8_t INTERLEAVE[16] = {0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15};
+
+__m128i inline Load(const uint8_t* p) { return _mm_load_si128(reinterpret_cast<const __m128i*>(p)); }
+
+/** Multiply every byte by 2 in GF(2^8). */
+__m128i ALWAYS_INLINE XTime(__m128i x)
+{
+    const __m128i carry = _mm_cmplt_epi8(x, _mm_setzero_si128());
+    return _mm_xor_si128(_mm_add_epi8(x, x), _mm_and_si128(carry, _mm_set1_epi8(0x1b)));
+}
+
+__m128i inline Xor(__m128i x, __m128i y) { return _mm_xor_si128(x, y); }
+
+/** ShiftBytes, then SubBytes via aesenclast with a zero round key. */
+__m128i ALWAYS_INLINE ShiftSub(__m128i x, int row) { return _mm_aesenclast_si128(_mm_shuffle_epi8(x, Load(SHIFT_MASKS.m[row])), _mm_setzero_si128()); }
+
+void ALWAYS_INLINE Round(__m128i& x0, __m128i& x1, __m128i& x2, __m128i& x3, __m128i& x4, __m128i& x5, __m128i& x6, __m128i& x7, int r)
+{
+    const __m128i rv = _mm_set1_epi8(char(r));
+    const __m128i low = _mm_set_epi64x(0, -1);
+    const __m128i rcq = Load(RC_ROWQ);
+    x0 = ShiftSub(Xor(x0, Xor(Load(RC_ROW0), _mm_and_si128(rv, low))), 0);
+    x1 = ShiftSub(Xor(x1, rcq), 1);
+    x2 = ShiftSub(Xor(x2, rcq), 2);
+    x3 = ShiftSub(Xor(x3, rcq), 3);
+    x4 = ShiftSub(Xor(x4, rcq), 4);
+    x5 = ShiftSub(Xor(x5, rcq), 5);
+    x6 = ShiftSub(Xor(x6, rcq), 6);
+    x7 = ShiftSub(Xor(x7, Xor(Load(RC_ROW7), _mm_andnot_si128(low, rv))), 7);
+
+    // MixBytes: row i = sum over d of c[d] * row (i + d), c = (02, 02, 03, 04, 05, 03, 05, 07).
+    // Factored as 02 * (02 * u[i + 3] + v[i + 7]) + v[i + 4], where
+    // t[i] = x[i] + x[i + 1], u[i] = t[i] + t[i + 3] and v[i] = t[i] + t[i + 2] + x[i + 6].
+    const __m128i t0 = Xor(x0, x1), t1 = Xor(x1, x2), t2 = Xor(x2, x3), t3 = Xor(x3, x4);
+    const __m128i t4 = Xor(x4, x5), t5 = Xor(x5, x6), t6 = Xor(x6, x7), t7 = Xor(x7, x0);
+    const __m128i u0 = Xor(t0, t3), u1 = Xor(t1, t4), u2 = Xor(t2, t5), u3 = Xor(t3, t6);
+    const __m128i u4 = Xor(t4, t7), u5 = Xor(t5, t0), u6 = Xor(t6, t1), u7 = Xor(t7, t2);
+    const __m128i v0 = Xor(Xor(t0, t2), x6);
+    const __m128i v1 = Xor(Xor(t1, t3), x7);
+    const __m128i v2 = Xor(Xor(t2, t4), x0);
+    const __m128i v3 = Xor(Xor(t3, t5), x1);
+    const __m128i v4 = Xor(Xor(t4, t6), x2);
+    const __m128i v5 = Xor(Xor(t5, t7), x3);
+    const __m128i v6 = Xor(Xor(t6, t0), x4);
+    const __m128i v7 = Xor(Xor(t7, t1), x5);
+    x0 = Xor(XTime(Xor(XTime(u3), v7)), v4);
+    x1 = Xor(XTime(Xor(XTime(u4), v0)), v5);
+    x2 = Xor(XTime(Xor(XTime(u5), v1)), v6);
+    x3 = Xor(XTime(Xor(XTime(u6), v2)), v7);
+    x4 = Xor(XTime(Xor(XTime(u7), v3)), v0);
+    x5 = Xor(XTime(Xor(XTime(u0), v4)), v1);
+    x6 = Xor(XTime(Xor(XTime(u1), v5)), v2);
+    x7 = Xor(XTime(Xor(XTime(u2), v6)), v3);
+}
+
+/** Transpose a column-major 8x8 byte matrix into four registers holding two rows each. */
+void inline Transpose(const unsigned char* in, __m128i* rows)
+{
+    const __m128i interleave = Load(INTERLEAVE);
+    const __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), interleave);
+    const __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16)), interleave);
+    const __m128i c = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 32)), interleave);
+    const __m128i d = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 48)), interleave);
+    const __m128i ab_lo = _mm_unpacklo_epi16(a, b), ab_hi = _mm_unpackhi_epi16(a, b);
+    const __m128i cd_lo = _mm_unpacklo_epi16(c, d), cd_hi = _mm_unpackhi_epi16(c, d);
+    rows[0] = _mm_unpacklo_epi32(ab_lo, cd_lo);
+    rows[1] = _mm_unpackhi_epi32(ab_lo, cd_lo);
+    rows[2] = _mm_unpacklo_epi32(ab_hi, cd_hi);
+    rows[3] = _mm_unpackhi_epi32(ab_hi, cd_hi);
+}
+
+/** Inverse of Transpose (an 8x8 transpose is its own inverse). */
+void inline Untranspose(const __m128i* rows, uint64_t* s)
+{
+    alignas(16) unsigned char tmp[64];
+    for (int i = 0; i < 4; ++i) _mm_store_si128(reinterpret_cast<__m128i*>(tmp + 16 * i), rows[i]);
+    __m128i columns[4];
+    Transpose(tmp, columns);
+    for (int i = 0; i < 4; ++i) _mm_storeu_si128(reinterpret_cast<__m128i*>(s) + i, columns[i]);
+}
+
+} // namespace
+
+void Transform(uint64_t* s, const unsigned char* chunk, size_t blocks)
+{
+    __m128i h[4];
+    Transpose(reinterpret_cast<const unsigned char*>(s), h);
+    while (blocks--) {
+        __m128i m[4], x[8];
+        Transpose(chunk, m);
+        for (int i = 0; i < 4; ++i) {
+            const __m128i p = _mm_xor_si128(h[i], m[i]);
+            x[2 * i] = _mm_unpacklo_epi64(p, m[i]);
+            x[2 * i + 1] = _mm_unpackhi_epi64(p, m[i]);
+        }
+        for (int r = 0; r < ROUNDS; ++r) Round(x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7], r);
+        for (int i = 0; i < 4; ++i) {
+            const __m128i p = _mm_unpacklo_epi64(x[2 * i], x[2 * i + 1]);
+            const __m128i q = _mm_unpackhi_epi64(x[2 * i], x[2 * i + 1]);
+            h[i] = _mm_xor_si128(h[i], _mm_xor_si128(p, q));
+        }
+        chunk += 64;
+    }
+    Untranspose(h, s);
+}
+
+void OutputTransform(uint64_t* s)
+{
+    __m128i h[4], x[8];
+    Transpose(reinterpret_cast<const unsigned char*>(s), h);
+    // Only P is needed; the Q halves just carry zeros along.
+    for (int i = 0; i < 4; ++i) {
+        x[2 * i] = _mm_unpacklo_epi64(h[i], _mm_setzero_si128());
+        x[2 * i + 1] = _mm_unpackhi_epi64(h[i], _mm_setzero_si128());
+    }
+    for (int r = 0; r < ROUNDS; ++r) Round(x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7], r);
+    for (int i = 0; i < 4; ++i) {
+        h[i] = _mm_xor_si128(h[i], _mm_unpacklo_epi64(x[2 * i], x[2 * i + 1]));
+    }
+    Untranspose(h, s);
+}
+
+} // namespace groestl_x86_aesni
+
+#endif
@@ -2,60 +2,294 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <crypto/scrypt.h>
-#include <crypto/sha256.h>
-#include <cstring>
+#include <crypto/common.h>
+#include <crypto/hmac_sha256.h>
 
-// SHAHCOIN Core scrypt implementation
-// For now, we'll implement a simplified scrypt-like function using SHA256
-// In production, you would link against a proper scrypt library like libscrypt
+#include <algorithm>
+#include <assert.h>
+#include <string.h>
 
-CScrypt::CScrypt() : pimpl(nullptr)
+#include <compat/cpuid.h>
+
+#if defined(__x86_64__) || defined(__amd64__)
+#if defined(USE_ASM)
+namespace scrypt_sse2
+{
+void Core_4way(uint32_t* X, uint32_t* V);
+}
+#endif
+#endif
+
+namespace scrypt_avx2
+{
+void Core_8way(uint32_t* X, uint32_t* V);
+}
+
+// Internal implementation code.
+namespace
+{
+/// Internal scrypt-1024-1-1-256 implementation.
+namespace scrypt
 {
-    Reset();
+/** The scrypt cost parameter N. */
+static constexpr uint32_t N = 1024;
+/** Number of 32-bit words in one 128*r byte block, for r = 1. */
+static constexpr size_t WORDS = 32;
+/** Widest interleaved core we may dispatch to. */
+static constexpr size_t MAX_LANES = 8;
+
+uint32_t inline Rotl(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+
+/** B = Salsa20/8(B ^ Bx). */
+void inline XorSalsa8(uint32_t* B, const uint32_t* Bx)
+{
+    uint32_t x[16];
+    for (int i = 0; i < 16; ++i) x[i] = (B[i] ^= Bx[i]);
+    for (int i = 0; i < 8; i += 2) {
+        // Columns.
+        x[ 4] ^= Rotl(x[ 0] + x[12],  7); x[ 9] ^= Rotl(x[ 5] + x[ 1],  7);
+        x[14] ^= Rotl(x[10] + x[ 6],  7); x[ 3] ^= Rotl(x[15] + x[11],  7);
+        x[ 8] ^= Rotl(x[ 4] + x[ 0],  9); x[13] ^= Rotl(x[ 9] + x[ 5],  9);
+        x[ 2] ^= Rotl(x[14] + x[10],  9); x[ 7] ^= Rotl(x[ 3] + x[15],  9);
+        x[12] ^= Rotl(x[ 8] + x[ 4], 13); x[ 1] ^= Rotl(x[13] + x[ 9], 13);
+        x[ 6] ^= Rotl(x[ 2] + x[14], 13); x[11] ^= Rotl(x[ 7] + x[ 3], 13);
+        x[ 0] ^= Rotl(x[12] + x[ 8], 18); x[ 5] ^= Rotl(x[ 1] + x[13], 18);
+        x[10] ^= Rotl(x[ 6] + x[ 2], 18); x[15] ^= Rotl(x[11] + x[ 7], 18);
+        // Rows.
+        x[ 1] ^= Rotl(x[ 0] + x[ 3],  7); x[ 6] ^= Rotl(x[ 5] + x[ 4],  7);
+        x[11] ^= Rotl(x[10] + x[ 9],  7); x[12] ^= Rotl(x[15] + x[14],  7);
+        x[ 2] ^= Rotl(x[ 1] + x[ 0],  9); x[ 7] ^= Rotl(x[ 6] + x[ 5],  9);
+        x[ 8] ^= Rotl(x[11] + x[10],  9); x[13] ^= Rotl(x[12] + x[15],  9);
+        x[ 3] ^= Rotl(x[ 2] + x[ 1], 13); x[ 4] ^= Rotl(x[ 7] + x[ 6], 13);
+        x[ 9] ^= Rotl(x[ 8] + x[11], 13); x[14] ^= Rotl(x[13] + x[12], 13);
+        x[ 0] ^= Rotl(x[ 3] + x[ 2], 18); x[ 5] ^= Rotl(x[ 4] + x[ 7], 18);
+        x[10] ^= Rotl(x[ 9] + x[ 8], 18); x[15] ^= Rotl(x[14] + x[13], 18);
+    }
+    for (int i = 0; i < 16; ++i) B[i] += x[i];
 }
 
-CScrypt::~CScrypt()
+/** ROMix for r = 1: X is one 32-word block, V is an N*32 word scratchpad. */
+void Core(uint32_t* X, uint32_t* V)
 {
-    if (pimpl) {
-        free(pimpl);
+    for (uint32_t i = 0; i < N; ++i) {
+        memcpy(&V[i * WORDS], X, WORDS * sizeof(uint32_t));
+        XorSalsa8(&X[0], &X[16]);
+        XorSalsa8(&X[16], &X[0]);
+    }
+    for (uint32_t i = 0; i < N; ++i) {
+        const uint32_t j = X[16] & (N - 1);
+        for (size_t k = 0; k < WORDS; ++k) X[k] ^= V[j * WORDS + k];
+        XorSalsa8(&X[0], &X[16]);
+        XorSalsa8(&X[16], &X[0]);
     }
 }
 
-void CScrypt::Write(const unsigned char* data, size_t len)
+/** Compute B = PBKDF2-HMAC-SHA256(P=input, S=input, c=1, dkLen=128) as little-endian words. */
+void Expand(const unsigned char* input, size_t len, uint32_t* X)
 {
-    // Simplified implementation - in production use proper scrypt
-    // This is a placeholder that uses SHA256 for compatibility
-    if (!pimpl) {
-        pimpl = malloc(CSHA256::OUTPUT_SIZE);
+    // HMAC(P, S || INT(i)) shares the keyed state and the salt for all four blocks.
+    CHMAC_SHA256 salted(input, len);
+    salted.Write(input, len);
+    unsigned char counter[4];
+    unsigned char block[CHMAC_SHA256::OUTPUT_SIZE];
+    for (uint32_t i = 0; i < 4; ++i) {
+        WriteBE32(counter, i + 1);
+        CHMAC_SHA256(salted).Write(counter, 4).Finalize(block);
+        for (size_t k = 0; k < 8; ++k) X[i * 8 + k] = ReadLE32(block + 4 * k);
     }
-    
-    CSHA256 hasher;
-    hasher.Write(data, len);
-    hasher.Finalize((unsigned char*)pimpl);
 }
 
-void CScrypt::Finalize(unsigned char hash[OUTPUT_SIZE])
+/** Compute PBKDF2-HMAC-SHA256(P=input, S=B, c=1, dkLen=32). */
+void Finish(const unsigned char* input, size_t len, const uint32_t* X, unsigned char* out)
+{
+    unsigned char B[WORDS * 4];
+    for (size_t k = 0; k < WORDS; ++k) WriteLE32(B + 4 * k, X[k]);
+    static const unsigned char counter[4] = {0, 0, 0, 1};
+    CHMAC_SHA256(input, len).Write(B, sizeof(B)).Write(counter, 4).Finalize(out);
+}
+
+/** Per-thread scratchpad for `lanes` interleaved hashes, aligned for vector stores.
+ *  It only grows, so threads that never batch keep a single 128 KiB pad. */
+uint32_t* Scratchpad(size_t lanes)
+{
+    static constexpr size_t ALIGN_WORDS = 64 / sizeof(uint32_t);
+    thread_local std::vector<uint32_t> buf;
+    if (buf.size() < lanes * N * WORDS + ALIGN_WORDS) buf.resize(lanes * N * WORDS + ALIGN_WORDS);
+    uintptr_t p = reinterpret_cast<uintptr_t>(buf.data());
+    return reinterpret_cast<uint32_t*>((p + 63) & ~uintptr_t{63});
+}
+
+void Hash(const unsigned char* input, size_t len, unsigned char* out)
+{
+    uint32_t X[WORDS];
+    Expand(input, len, X);
+    Core(X, Scratchpad(1));
+    Finish(input, len, X, out);
+}
+} // namespace scrypt
+
+typedef void (*CoreFn)(uint32_t*, uint32_t*);
+CoreFn Core_4way = nullptr;
+CoreFn Core_8way = nullptr;
+
+/** Hash `lanes` messages through an interleaved core; messages past `count` are padding. */
+void HashLanes(CoreFn core, size_t lanes, unsigned char* output, const unsigned char* input, size_t len, size_t count)
 {
-    if (pimpl) {
-        memcpy(hash, pimpl, OUTPUT_SIZE);
-    } else {
-        memset(hash, 0, OUTPUT_SIZE);
+    uint32_t X[scrypt::MAX_LANES * scrypt::WORDS];
+    for (size_t l = 0; l < lanes; ++l) {
+        scrypt::Expand(input + std::min(l, count - 1) * len, len, X + l * scrypt::WORDS);
+    }
+    core(X, scrypt::Scratchpad(lanes));
+    for (size_t l = 0; l < count; ++l) {
+        scrypt::Finish(input + l * len, len, X + l * scrypt::WORDS, output + l * CScrypt::OUTPUT_SIZE);
     }
 }
 
-void CScrypt::Reset()
+bool SelfTest()
 {
-    if (pimpl) {
-        free(pimpl);
-        pimpl = nullptr;
+    // scrypt of a mainnet Litecoin block header, whose PoW uses the same parameters.
+    static const unsigned char header[80] = {
+        0x02, 0x00, 0x00, 0x00, 0x4c, 0x12, 0x71, 0xc2, 0x11, 0x71, 0x71, 0x98, 0x22, 0x73, 0x92, 0xb0,
+        0x29, 0xa6, 0x4a, 0x79, 0x71, 0x93, 0x1d, 0x35, 0x1b, 0x38, 0x7b, 0xb8, 0x0d, 0xb0, 0x27, 0xf2,
+        0x70, 0x41, 0x1e, 0x39, 0x8a, 0x07, 0x04, 0x6f, 0x7d, 0x4a, 0x08, 0xdd, 0x81, 0x54, 0x12, 0xa8,
+        0x71, 0x2f, 0x87, 0x4a, 0x7e, 0xbf, 0x05, 0x07, 0xe3, 0x87, 0x8b, 0xd2, 0x4e, 0x20, 0xa3, 0xb7,
+        0x3f, 0xd7, 0x50, 0xa6, 0x67, 0xd2, 0xf4, 0x51, 0xea, 0xc7, 0x47, 0x1b, 0x00, 0xde, 0x66, 0x59,
+    };
+    static const unsigned char result[32] = {
+        0x06, 0x58, 0x98, 0xd7, 0xab, 0x2d, 0xaa, 0x82, 0x35, 0xcd, 0xda, 0x95, 0x11, 0xd2, 0x48, 0xf3,
+        0x01, 0x0b, 0x5e, 0x11, 0xf6, 0x82, 0xf8, 0x07, 0x41, 0xef, 0x2b, 0x00, 0x00, 0x00, 0x00, 0x00,
+    };
+
+    unsigned char out[scrypt::MAX_LANES * CScrypt::OUTPUT_SIZE];
+    scrypt::Hash(header, sizeof(header), out);
+    if (!std::equal(out, out + CScrypt::OUTPUT_SIZE, result)) return false;
+
+    // Every lane of the interleaved cores must agree with the generic one. Use a
+    // different message per lane so that swapped or merged lanes are caught.
+    unsigned char in[scrypt::MAX_LANES * sizeof(header)];
+    unsigned char expected[scrypt::MAX_LANES * CScrypt::OUTPUT_SIZE];
+    for (size_t i = 0; i < sizeof(in); ++i) in[i] = header[i % sizeof(header)] ^ (i / sizeof(header));
+    for (size_t l = 0; l < scrypt::MAX_LANES; ++l) {
+        scrypt::Hash(in + l * sizeof(header), sizeof(header), expected + l * CScrypt::OUTPUT_SIZE);
+    }
+    if (Core_4way) {
+        HashLanes(Core_4way, 4, out, in, sizeof(header), 4);
+        if (!std::equal(out, out + 4 * CScrypt::OUTPUT_SIZE, expected)) return false;
     }
+    if (Core_8way) {
+        HashLanes(Core_8way, 8, out, in, sizeof(header), 8);
+        if (!std::equal(out, out + 8 * CScrypt::OUTPUT_SIZE, expected)) return false;
+    }
+    return true;
+}
+
+#if defined(USE_ASM) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+/** Check whether the OS has enabled AVX registers. */
+bool AVXEnabled()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 6) == 6;
+}
+#endif
+} // namespace
+
+
+std::string ScryptAutoDetect(scrypt_implementation::UseImplementation use_implementation)
+{
+    std::string ret = "standard";
+    Core_4way = nullptr;
+    Core_8way = nullptr;
+
+#if defined(USE_ASM) && defined(HAVE_GETCPUID)
+    [[maybe_unused]] bool have_avx2 = false;
+    [[maybe_unused]] bool enabled_avx = false;
+
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    const bool have_xsave = (ecx >> 27) & 1;
+    const bool have_avx = (ecx >> 28) & 1;
+    if (have_xsave && have_avx) {
+        enabled_avx = AVXEnabled();
+    }
+    if (use_implementation & scrypt_implementation::USE_AVX2) {
+        GetCPUID(7, 0, eax, ebx, ecx, edx);
+        have_avx2 = (ebx >> 5) & 1;
+    }
+
+#if defined(__x86_64__) || defined(__amd64__)
+    // SSE2 is part of the x86-64 baseline.
+    if (use_implementation & scrypt_implementation::USE_SSE2) {
+        Core_4way = scrypt_sse2::Core_4way;
+        ret += ",sse2(4way)";
+    }
+#endif
+
+#if defined(ENABLE_AVX2) && !defined(BUILD_SHAHCOIN_INTERNAL)
+    if (have_avx2 && have_avx && enabled_avx) {
+        Core_8way = scrypt_avx2::Core_8way;
+        ret += ",avx2(8way)";
+    }
+#endif
+#endif // defined(USE_ASM) && defined(HAVE_GETCPUID)
+
+    assert(SelfTest());
+    return ret;
+}
+
+void ScryptHashBatch(unsigned char* output, const unsigned char* input, size_t len, size_t count)
+{
+    // A wide core with padding lanes still beats running the stragglers one by one.
+    if (Core_8way) {
+        while (count >= 5) {
+            const size_t n = std::min<size_t>(count, 8);
+            HashLanes(Core_8way, 8, output, input, len, n);
+            output += n * CScrypt::OUTPUT_SIZE;
+            input += n * len;
+            count -= n;
+        }
+    }
+    if (Core_4way) {
+        while (count >= 2) {
+            const size_t n = std::min<size_t>(count, 4);
+            HashLanes(Core_4way, 4, output, input, len, n);
+            output += n * CScrypt::OUTPUT_SIZE;
+            input += n * len;
+            count -= n;
+        }
+    }
+    while (count > 0) {
+        scrypt::Hash(input, len, output);
+        output += CScrypt::OUTPUT_SIZE;
+        input += len;
+        --count;
+    }
+}
+
+////// scrypt
+
+CScrypt::CScrypt() = default;
+
+CScrypt& CScrypt::Write(const unsigned char* data, size_t len)
+{
+    m_data.insert(m_data.end(), data, data + len);
+    return *this;
+}
+
+void CScrypt::Finalize(unsigned char hash[OUTPUT_SIZE])
+{
+    scrypt::Hash(m_data.data(), m_data.size(), hash);
+}
+
+CScrypt& CScrypt::Reset()
+{
+    m_data.clear();
+    return *this;
 }
 
 void CScrypt::Hash(const unsigned char* input, size_t len, unsigned char output[OUTPUT_SIZE])
 {
-    CScrypt hasher;
-    hasher.Write(input, len);
-    hasher.Finalize(output);
+    scrypt::Hash(input, len, output);
 }
 
 void CScrypt::Hash(const unsigned char* input, size_t len, unsigned char* output, size_t outlen)
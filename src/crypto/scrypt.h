@@ -6,26 +6,56 @@
 
 #include <cstdint>
 #include <cstdlib>
-
-/** Scrypt hashing algorithm implementation */
+#include <string>
+#include <vector>
+
+/** A hasher class for scrypt(N=1024, r=1, p=1, dkLen=32), with the input used as both password and salt.
+ *
+ *  scrypt needs the whole message before it can start, so Write() only buffers
+ *  and all of the work happens in Finalize().
+ */
 class CScrypt
 {
 public:
     static const size_t OUTPUT_SIZE = 32;
 
     CScrypt();
-    ~CScrypt();
 
-    void Write(const unsigned char* data, size_t len);
+    CScrypt& Write(const unsigned char* data, size_t len);
     void Finalize(unsigned char hash[OUTPUT_SIZE]);
-    void Reset();
+    CScrypt& Reset();
 
     // Static convenience methods
     static void Hash(const unsigned char* input, size_t len, unsigned char output[OUTPUT_SIZE]);
     static void Hash(const unsigned char* input, size_t len, unsigned char* output, size_t outlen);
 
 private:
-    void* pimpl;
+    std::vector<unsigned char> m_data;
+};
+
+namespace scrypt_implementation {
+enum UseImplementation : uint8_t {
+    STANDARD = 0,
+    USE_SSE2 = 1 << 0,
+    USE_AVX2 = 1 << 1,
+    USE_ALL = USE_SSE2 | USE_AVX2,
 };
+}
+
+/** Autodetect the best available scrypt core implementation.
+ *  Returns the name of the implementation.
+ */
+std::string ScryptAutoDetect(scrypt_implementation::UseImplementation use_implementation = scrypt_implementation::USE_ALL);
+
+/** Compute multiple scrypt-1024-1-1-256 hashes of equally sized messages.
+ *  Messages are processed through the widest available interleaved core
+ *  (8-way AVX2, 4-way SSE2), so hashing a batch of block headers is
+ *  considerably faster than hashing them one by one.
+ *  output:  pointer to a count*32 byte output buffer
+ *  input:   pointer to a count*len byte input buffer
+ *  len:     the size of each message
+ *  count:   the number of hashes to compute.
+ */
+void ScryptHashBatch(unsigned char* output, const unsigned char* input, size_t len, size_t count);
 
 #endif // SHAHCOIN_CRYPTO_SCRYPT_H
@@ -0,0 +1,91 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace scrypt_avx2 {
+namespace {
+
+constexpr uint32_t N = 1024;
+constexpr size_t WORDS = 32;
+constexpr size_t LANES = 8;
+
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+__m256i inline Rotl(__m256i x, int n) { return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n)); }
+void inline Step(__m256i& a, __m256i b, __m256i c, int n) { a = Xor(a, Rotl(Add(b, c), n)); }
+
+/** B = Salsa20/8(B ^ Bx), on eight independent hashes at once (one per 32-bit lane). */
+void inline XorSalsa8(__m256i* B, const __m256i* Bx)
+{
+    __m256i x[16];
+    for (int i = 0; i < 16; ++i) x[i] = B[i] = Xor(B[i], Bx[i]);
+    for (int i = 0; i < 8; i += 2) {
+        Step(x[ 4], x[ 0], x[12],  7); Step(x[ 9], x[ 5], x[ 1],  7);
+        Step(x[14], x[10], x[ 6],  7); Step(x[ 3], x[15], x[11],  7);
+        Step(x[ 8], x[ 4], x[ 0],  9); Step(x[13], x[ 9], x[ 5],  9);
+        Step(x[ 2], x[14], x[10],  9); Step(x[ 7], x[ 3], x[15],  9);
+        Step(x[12], x[ 8], x[ 4], 13); Step(x[ 1], x[13], x[ 9], 13);
+        Step(x[ 6], x[ 2], x[14], 13); Step(x[11], x[ 7], x[ 3], 13);
+        Step(x[ 0], x[12], x[ 8], 18); Step(x[ 5], x[ 1], x[13], 18);
+        Step(x[10], x[ 6], x[ 2], 18); Step(x[15], x[11], x[ 7], 18);
+
+        Step(x[ 1], x[ 0], x[ 3],  7); Step(x[ 6], x[ 5], x[ 4],  7);
+        Step(x[11], x[10], x[ 9],  7); Step(x[12], x[15], x[14],  7);
+        Step(x[ 2], x[ 1], x[ 0],  9); Step(x[ 7], x[ 6], x[ 5],  9);
+        Step(x[ 8], x[11], x[10],  9); Step(x[13], x[12], x[15],  9);
+        Step(x[ 3], x[ 2], x[ 1], 13); Step(x[ 4], x[ 7], x[ 6], 13);
+        Step(x[ 9], x[ 8], x[11], 13); Step(x[14], x[13], x[12], 13);
+        Step(x[ 0], x[ 3], x[ 2], 18); Step(x[ 5], x[ 4], x[ 7], 18);
+        Step(x[10], x[ 9], x[ 8], 18); Step(x[15], x[14], x[13], 18);
+    }
+    for (int i = 0; i < 16; ++i) B[i] = Add(B[i], x[i]);
+}
+
+} // namespace
+
+/** ROMix on eight hashes. X holds eight consecutive 32-word blocks; V is a 64-byte
+ *  aligned 8*N*32 word scratchpad, stored with the lanes interleaved per word. */
+void Core_8way(uint32_t* X, uint32_t* V)
+{
+    __m256i x[WORDS];
+    __m256i* v = reinterpret_cast<__m256i*>(V);
+    const __m256i lane_offsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i word_stride = _mm256_set1_epi32(LANES);
+
+    // Transpose in with a gather: word k of lane l lives at X[l * WORDS + k].
+    const __m256i in_index = _mm256_mullo_epi32(lane_offsets, _mm256_set1_epi32(WORDS));
+    for (size_t k = 0; k < WORDS; ++k) {
+        x[k] = _mm256_i32gather_epi32(reinterpret_cast<const int*>(X + k), in_index, 4);
+    }
+
+    for (uint32_t i = 0; i < N; ++i) {
+        for (size_t k = 0; k < WORDS; ++k) _mm256_store_si256(&v[i * WORDS + k], x[k]);
+        XorSalsa8(&x[0], &x[16]);
+        XorSalsa8(&x[16], &x[0]);
+    }
+    for (uint32_t i = 0; i < N; ++i) {
+        // Index of word 0 of each lane's scratchpad entry: (j * WORDS) * LANES + lane.
+        const __m256i j = _mm256_and_si256(x[16], _mm256_set1_epi32(N - 1));
+        __m256i index = _mm256_add_epi32(_mm256_slli_epi32(j, 8), lane_offsets);
+        for (size_t k = 0; k < WORDS; ++k) {
+            x[k] = Xor(x[k], _mm256_i32gather_epi32(reinterpret_cast<const int*>(V), index, 4));
+            index = _mm256_add_epi32(index, word_stride);
+        }
+        XorSalsa8(&x[0], &x[16]);
+        XorSalsa8(&x[16], &x[0]);
+    }
+
+    alignas(32) uint32_t lanes[LANES];
+    for (size_t k = 0; k < WORDS; ++k) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), x[k]);
+        for (size_t l = 0; l < LANES; ++l) X[l * WORDS + k] = lanes[l];
+    }
+}
+
+} // namespace scrypt_avx2
+
+#endif
@@ -23,48 +23,12 @@ void scrypt_1024_1_1_256_optimized(const char* input, char* output) {
 
 // Parallel Scrypt implementation
 void scrypt_1024_1_1_256_parallel(const char* input, char* output, unsigned int num_threads) {
-    if (num_threads == 0) {
-        num_threads = std::thread::hardware_concurrency();
-        if (num_threads == 0) num_threads = 1;
-    }
-    
-    // For parallel processing, we can split the work across multiple threads
-    // This is a simplified implementation - in production you would implement
-    // proper parallel Scrypt with thread-safe memory management
-    
-    if (num_threads == 1) {
-        // Single-threaded fallback
-        CScrypt::Hash(reinterpret_cast<const unsigned char*>(input), 80, 
-                     reinterpret_cast<unsigned char*>(output));
-        return;
-    }
-    
-    // Multi-threaded implementation
-    std::vector<std::thread> threads;
-    std::vector<std::vector<unsigned char>> thread_outputs(num_threads, std::vector<unsigned char>(32));
-    
-    // Split work across threads (simplified approach)
-    for (unsigned int i = 0; i < num_threads; i++) {
-        threads.emplace_back([input, i, num_threads, &thread_outputs]() {
-            // Each thread processes a portion of the work
-            // In a real implementation, you would implement proper parallel Scrypt
-            unsigned char temp_input[80];
-            std::memcpy(temp_input, input, 80);
-            
-            // Modify input slightly for each thread (simplified)
-            temp_input[0] ^= static_cast<unsigned char>(i);
-            
-            CScrypt::Hash(temp_input, 80, thread_outputs[i].data());
-        });
-    }
-    
-    // Wait for all threads to complete
-    for (auto& thread : threads) {
-        thread.join();
-    }
-    
-    // Combine results (simplified - in reality you'd implement proper parallel Scrypt)
-    std::memcpy(output, thread_outputs[0].data(), 32);
+    // With p = 1 a single hash is one sequential ROMix and cannot be split across
+    // threads. Throughput comes from hashing many headers at once through
+    // ScryptHashBatch() instead, so this is the plain single-hash path.
+    (void)num_threads;
+    CScrypt::Hash(reinterpret_cast<const unsigned char*>(input), 80,
+                 reinterpret_cast<unsigned char*>(output));
 }
 
 // Memory-efficient Scrypt with configurable parameters
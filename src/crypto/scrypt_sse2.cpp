@@ -0,0 +1,91 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <cstdlib>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__amd64__)
+
+#include <emmintrin.h>
+
+namespace scrypt_sse2 {
+namespace {
+
+constexpr uint32_t N = 1024;
+constexpr size_t WORDS = 32;
+constexpr size_t LANES = 4;
+
+__m128i inline Add(__m128i x, __m128i y) { return _mm_add_epi32(x, y); }
+__m128i inline Xor(__m128i x, __m128i y) { return _mm_xor_si128(x, y); }
+__m128i inline Rotl(__m128i x, int n) { return _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - n)); }
+void inline Step(__m128i& a, __m128i b, __m128i c, int n) { a = Xor(a, Rotl(Add(b, c), n)); }
+
+/** B = Salsa20/8(B ^ Bx), on four independent hashes at once (one per 32-bit lane). */
+void inline XorSalsa8(__m128i* B, const __m128i* Bx)
+{
+    __m128i x[16];
+    for (int i = 0; i < 16; ++i) x[i] = B[i] = Xor(B[i], Bx[i]);
+    for (int i = 0; i < 8; i += 2) {
+        Step(x[ 4], x[ 0], x[12],  7); Step(x[ 9], x[ 5], x[ 1],  7);
+        Step(x[14], x[10], x[ 6],  7); Step(x[ 3], x[15], x[11],  7);
+        Step(x[ 8], x[ 4], x[ 0],  9); Step(x[13], x[ 9], x[ 5],  9);
+        Step(x[ 2], x[14], x[10],  9); Step(x[ 7], x[ 3], x[15],  9);
+        Step(x[12], x[ 8], x[ 4], 13); Step(x[ 1], x[13], x[ 9], 13);
+        Step(x[ 6], x[ 2], x[14], 13); Step(x[11], x[ 7], x[ 3], 13);
+        Step(x[ 0], x[12], x[ 8], 18); Step(x[ 5], x[ 1], x[13], 18);
+        Step(x[10], x[ 6], x[ 2], 18); Step(x[15], x[11], x[ 7], 18);
+
+        Step(x[ 1], x[ 0], x[ 3],  7); Step(x[ 6], x[ 5], x[ 4],  7);
+        Step(x[11], x[10], x[ 9],  7); Step(x[12], x[15], x[14],  7);
+        Step(x[ 2], x[ 1], x[ 0],  9); Step(x[ 7], x[ 6], x[ 5],  9);
+        Step(x[ 8], x[11], x[10],  9); Step(x[13], x[12], x[15],  9);
+        Step(x[ 3], x[ 2], x[ 1], 13); Step(x[ 4], x[ 7], x[ 6], 13);
+        Step(x[ 9], x[ 8], x[11], 13); Step(x[14], x[13], x[12], 13);
+        Step(x[ 0], x[ 3], x[ 2], 18); Step(x[ 5], x[ 4], x[ 7], 18);
+        Step(x[10], x[ 9], x[ 8], 18); Step(x[15], x[14], x[13], 18);
+    }
+    for (int i = 0; i < 16; ++i) B[i] = Add(B[i], x[i]);
+}
+
+} // namespace
+
+/** ROMix on four hashes. X holds four consecutive 32-word blocks; V is a 64-byte
+ *  aligned 4*N*32 word scratchpad, stored with the lanes interleaved per word. */
+void Core_4way(uint32_t* X, uint32_t* V)
+{
+    __m128i x[WORDS];
+    __m128i* v = reinterpret_cast<__m128i*>(V);
+    for (size_t k = 0; k < WORDS; ++k) {
+        x[k] = _mm_set_epi32(X[3 * WORDS + k], X[2 * WORDS + k], X[WORDS + k], X[k]);
+    }
+
+    for (uint32_t i = 0; i < N; ++i) {
+        for (size_t k = 0; k < WORDS; ++k) _mm_store_si128(&v[i * WORDS + k], x[k]);
+        XorSalsa8(&x[0], &x[16]);
+        XorSalsa8(&x[16], &x[0]);
+    }
+    alignas(16) uint32_t j[LANES];
+    for (uint32_t i = 0; i < N; ++i) {
+        // Each lane reads its own scratchpad entry, so the loads are gathered per lane.
+        _mm_store_si128(reinterpret_cast<__m128i*>(j), _mm_and_si128(x[16], _mm_set1_epi32(N - 1)));
+        const uint32_t* v0 = V + (j[0] * WORDS) * LANES + 0;
+        const uint32_t* v1 = V + (j[1] * WORDS) * LANES + 1;
+        const uint32_t* v2 = V + (j[2] * WORDS) * LANES + 2;
+        const uint32_t* v3 = V + (j[3] * WORDS) * LANES + 3;
+        for (size_t k = 0; k < WORDS; ++k) {
+            x[k] = Xor(x[k], _mm_set_epi32(v3[k * LANES], v2[k * LANES], v1[k * LANES], v0[k * LANES]));
+        }
+        XorSalsa8(&x[0], &x[16]);
+        XorSalsa8(&x[16], &x[0]);
+    }
+
+    alignas(16) uint32_t lanes[LANES];
+    for (size_t k = 0; k < WORDS; ++k) {
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), x[k]);
+        for (size_t l = 0; l < LANES; ++l) X[l * WORDS + k] = lanes[l];
+    }
+}
+
+} // namespace scrypt_sse2
+
+#endif
@@ -0,0 +1,201 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <dex/amm.h>
+
+#include <arith_uint256.h>
+#include <util/check.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <vector>
+
+using uint128 = unsigned __int128;
+
+static constexpr uint64_t MAX_AMOUNT{std::numeric_limits<uint64_t>::max()};
+
+namespace {
+
+arith_uint256 ToArith(uint128 n)
+{
+    return (arith_uint256{static_cast<uint64_t>(n >> 64)} << 64) | arith_uint256{static_cast<uint64_t>(n)};
+}
+
+/** n narrowed to 64 bits, or 0 if it does not fit. */
+uint64_t Narrow(uint128 n)
+{
+    return n > MAX_AMOUNT ? 0 : static_cast<uint64_t>(n);
+}
+
+} // namespace
+
+uint64_t GetSwapFee(uint64_t amount_in, uint32_t fee_bps)
+{
+    const uint128 fee{(uint128{amount_in} * std::min(fee_bps, AMM_BPS) + AMM_BPS - 1) / AMM_BPS};
+    return static_cast<uint64_t>(fee);
+}
+
+uint64_t GetSwapAmountOut(uint64_t amount_in, uint64_t reserve_in, uint64_t reserve_out, uint32_t fee_bps)
+{
+    if (reserve_in == 0 || reserve_out == 0) return 0;
+    // x * y = (x + dx) * (y - dy)  =>  dy = y * dx / (x + dx), with dx net of the fee.
+    // dx, y < 2^64, so the product fits 128 bits and the sum 65 bits.
+    const uint64_t amount_in_net{amount_in - GetSwapFee(amount_in, fee_bps)};
+    return static_cast<uint64_t>(uint128{amount_in_net} * reserve_out / (uint128{reserve_in} + amount_in_net));
+}
+
+uint32_t GetPriceImpactBps(uint64_t amount_in, uint64_t reserve_in, uint64_t reserve_out, uint32_t fee_bps)
+{
+    const uint64_t amount_out{GetSwapAmountOut(amount_in, reserve_in, reserve_out, fee_bps)};
+    if (amount_out == 0) return AMM_BPS;
+    // Execution price over spot price: (dy / dx) / (y / x) = dy * x / (dx * y) <= 1.
+    // dy * x * AMM_BPS can exceed 128 bits.
+    const arith_uint256 ratio{ToArith(uint128{amount_out} * reserve_in) * AMM_BPS / ToArith(uint128{amount_in} * reserve_out)};
+    return AMM_BPS - static_cast<uint32_t>(ratio.GetLow64());
+}
+
+uint64_t GetInitialLiquidity(uint64_t amount_a, uint64_t amount_b)
+{
+    const uint128 n{uint128{amount_a} * amount_b};
+    if (n == 0) return 0;
+    // Newton's method from above; the result is at most 2^64 - 1.
+    uint128 x{uint128{1} << 64}, y{(x + n / x) / 2};
+    while (y < x) {
+        x = y;
+        y = (x + n / x) / 2;
+    }
+    return static_cast<uint64_t>(x);
+}
+
+uint64_t GetMintedLiquidity(uint64_t amount_a, uint64_t amount_b, uint64_t reserve_a, uint64_t reserve_b, uint64_t total_liquidity)
+{
+    if (reserve_a == 0 || reserve_b == 0) return 0;
+    return Narrow(std::min(uint128{amount_a} * total_liquidity / reserve_a,
+                           uint128{amount_b} * total_liquidity / reserve_b));
+}
+
+uint64_t GetLiquidityWithdrawal(uint64_t liquidity, uint64_t reserve, uint64_t total_liquidity)
+{
+    if (total_liquidity == 0 || liquidity > total_liquidity) return 0;
+    return static_cast<uint64_t>(uint128{reserve} * liquidity / total_liquidity);
+}
+
+uint64_t ApplySwap(AMMReserves& reserves, const AMMSwap& swap, uint32_t fee_bps)
+{
+    // Selects and masks instead of branches, so a batch of mixed-direction
+    // swaps runs without mispredictions.
+    const uint64_t reserve_in{swap.a_to_b ? reserves.reserve_a : reserves.reserve_b};
+    const uint64_t reserve_out{swap.a_to_b ? reserves.reserve_b : reserves.reserve_a};
+    uint64_t amount_out{GetSwapAmountOut(swap.amount_in, reserve_in, reserve_out, fee_bps)};
+    const bool ok{(amount_out != 0) & (amount_out >= swap.min_amount_out) & (swap.amount_in <= MAX_AMOUNT - reserve_in)};
+    const uint64_t mask{uint64_t{0} - ok};
+    amount_out &= mask;
+    const uint64_t new_in{reserve_in + (swap.amount_in & mask)};
+    const uint64_t new_out{reserve_out - amount_out};
+    reserves.reserve_a = swap.a_to_b ? new_in : new_out;
+    reserves.reserve_b = swap.a_to_b ? new_out : new_in;
+    return amount_out;
+}
+
+AMMReserves QuoteSwaps(AMMReserves reserves, Span<const AMMSwap> swaps, Span<uint64_t> amounts_out, uint32_t fee_bps)
+{
+    Assume(amounts_out.size() >= swaps.size());
+    for (size_t i = 0; i < swaps.size(); ++i) {
+        amounts_out[i] = ApplySwap(reserves, swaps[i], fee_bps);
+    }
+    return reserves;
+}
+
+AMMReserves SettleSwaps(AMMReserves reserves, Span<const AMMSwap> swaps, Span<uint64_t> amounts_out, uint32_t fee_bps)
+{
+    Assume(amounts_out.size() >= swaps.size());
+    std::fill(amounts_out.begin(), amounts_out.begin() + swaps.size(), 0);
+    if (reserves.reserve_a == 0 || reserves.reserve_b == 0) return reserves;
+
+    // Index 0 is the a-to-b side, 1 the b-to-a side. Swaps left with nothing
+    // after the fee could never be paid and take no part.
+    const std::array<uint64_t, 2> reserve_in{reserves.reserve_a, reserves.reserve_b};
+    std::vector<uint64_t> net_in(swaps.size());
+    std::array<std::vector<size_t>, 2> order;
+    for (size_t i = 0; i < swaps.size(); ++i) {
+        net_in[i] = swaps[i].amount_in - GetSwapFee(swaps[i].amount_in, fee_bps);
+        if (net_in[i] != 0) order[swaps[i].a_to_b ? 0 : 1].push_back(i);
+    }
+
+    // A swap is paid floor(net_in * paid / net) of its side's output, which is
+    // less than max(min_amount_out, 1) exactly when that limit exceeds
+    // net_in * paid / net. Sorted by limit per unit of input, the swaps that
+    // fail are always the last on their side, whatever the clearing price.
+    const auto limit{[&](size_t i) { return uint128{std::max<uint64_t>(swaps[i].min_amount_out, 1)}; }};
+    std::array<std::vector<uint128>, 2> gross_sum, net_sum;
+    for (int side : {0, 1}) {
+        std::sort(order[side].begin(), order[side].end(), [&](size_t i, size_t j) {
+            const uint128 lhs{limit(i) * net_in[j]}, rhs{limit(j) * net_in[i]};
+            if (lhs != rhs) return lhs < rhs;
+            if (swaps[i].amount_in != swaps[j].amount_in) return swaps[i].amount_in < swaps[j].amount_in;
+            return swaps[i].min_amount_out < swaps[j].min_amount_out;
+        });
+        gross_sum[side].assign(1, 0);
+        net_sum[side].assign(1, 0);
+        for (size_t i : order[side]) {
+            gross_sum[side].push_back(gross_sum[side].back() + swaps[i].amount_in);
+            net_sum[side].push_back(net_sum[side].back() + net_in[i]);
+        }
+    }
+
+    // The first kept[side] swaps of a side take part. The most demanding
+    // swaps on a side whose inputs would overflow its reserve are dropped.
+    std::array<size_t, 2> kept{order[0].size(), order[1].size()};
+    for (int side : {0, 1}) {
+        while (gross_sum[side][kept[side]] > MAX_AMOUNT - reserve_in[side]) --kept[side];
+    }
+
+    std::array<uint128, 2> net, paid;
+    while (true) {
+        net = {net_sum[0][kept[0]], net_sum[1][kept[1]]};
+
+        // With net inputs x, y against reserves ra, rb, the larger side in spot
+        // value trades a residual dx against the pool at the rate the pool gives
+        // for dx itself: dx = (x * rb - y * ra) / (rb + y), which makes the
+        // matched part x - dx worth exactly y at that rate.
+        const uint128 ra{reserves.reserve_a}, rb{reserves.reserve_b};
+        const uint128 value_a{net[0] * rb}, value_b{net[1] * ra};
+        if (value_a >= value_b) {
+            const uint64_t dx{static_cast<uint64_t>((value_a - value_b) / (rb + net[1]))};
+            paid[0] = net[1] + GetSwapAmountOut(dx, reserves.reserve_a, reserves.reserve_b, 0);
+            paid[1] = net[0] - dx;
+        } else {
+            const uint64_t dy{static_cast<uint64_t>((value_b - value_a) / (ra + net[0]))};
+            paid[1] = net[0] + GetSwapAmountOut(dy, reserves.reserve_b, reserves.reserve_a, 0);
+            paid[0] = net[1] - dy;
+        }
+
+        // Drop every swap paid less than its minimum, or nothing, and clear the
+        // rest again. Each round drops at least one swap.
+        bool dropped{false};
+        for (int side : {0, 1}) {
+            while (kept[side] > 0) {
+                const size_t i{order[side][kept[side] - 1]};
+                if (limit(i) * net[side] <= uint128{net_in[i]} * paid[side]) break;
+                --kept[side];
+                dropped = true;
+            }
+        }
+        if (!dropped) break;
+    }
+
+    // Each swap gets its pro rata share of its side's output. Rounding dust of
+    // the shares stays in the pool.
+    std::array<uint128, 2> paid_out{};
+    for (int side : {0, 1}) {
+        for (size_t k = 0; k < kept[side]; ++k) {
+            const size_t i{order[side][k]};
+            amounts_out[i] = static_cast<uint64_t>(uint128{net_in[i]} * paid[side] / net[side]);
+            paid_out[side] += amounts_out[i];
+        }
+    }
+    reserves.reserve_a = static_cast<uint64_t>(reserves.reserve_a + gross_sum[0][kept[0]] - paid_out[1]);
+    reserves.reserve_b = static_cast<uint64_t>(reserves.reserve_b + gross_sum[1][kept[1]] - paid_out[0]);
+    return reserves;
+}
@@ -0,0 +1,93 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SHAHCOIN_DEX_AMM_H
+#define SHAHCOIN_DEX_AMM_H
+
+#include <span.h>
+
+#include <cstdint>
+
+/**
+ * Exact integer constant-product AMM math.
+ *
+ * All amounts are token base units. Products are formed in unsigned
+ * __int128, falling back to arith_uint256 where they can exceed 128 bits,
+ * and every division rounds in the pool's favour, so results are identical
+ * on every platform and never let a pool's invariant x * y decrease.
+ * Kernels return 0 for inputs they cannot price (empty reserves, overflow).
+ */
+
+/** Denominator of fee and price-impact values. */
+static constexpr uint32_t AMM_BPS{10000};
+
+/** Pool reserves a swap is priced against. */
+struct AMMReserves {
+    uint64_t reserve_a{0};
+    uint64_t reserve_b{0};
+};
+
+/** A swap of amount_in of one pool token for at least min_amount_out of the other. */
+struct AMMSwap {
+    bool a_to_b{false};
+    uint64_t amount_in{0};
+    uint64_t min_amount_out{0};
+};
+
+/** Part of amount_in kept by the pool as swap fee, rounded up. */
+uint64_t GetSwapFee(uint64_t amount_in, uint32_t fee_bps);
+
+/** Output of swapping amount_in into a pool, after fee_bps, rounded down. Always less than reserve_out. */
+uint64_t GetSwapAmountOut(uint64_t amount_in, uint64_t reserve_in, uint64_t reserve_out, uint32_t fee_bps);
+
+/**
+ * Loss of a swap against the pool's spot price, fee included, in basis
+ * points, rounded up: 0 for an infinitesimal fee-less swap, AMM_BPS when
+ * nothing comes out.
+ */
+uint32_t GetPriceImpactBps(uint64_t amount_in, uint64_t reserve_in, uint64_t reserve_out, uint32_t fee_bps);
+
+/** Liquidity minted for the first deposit into a pool: floor(sqrt(amount_a * amount_b)). */
+uint64_t GetInitialLiquidity(uint64_t amount_a, uint64_t amount_b);
+
+/** Liquidity minted for a deposit into a pool, for whichever side is scarcer relative to the reserves. */
+uint64_t GetMintedLiquidity(uint64_t amount_a, uint64_t amount_b, uint64_t reserve_a, uint64_t reserve_b, uint64_t total_liquidity);
+
+/** Share of reserve paid out for burning liquidity out of total_liquidity, rounded down. */
+uint64_t GetLiquidityWithdrawal(uint64_t liquidity, uint64_t reserve, uint64_t total_liquidity);
+
+/**
+ * Execute one swap against reserves. On success the reserves are updated and
+ * the output is returned; a swap that yields nothing, less than its minimum or
+ * would overflow a reserve returns 0 and leaves the reserves unchanged.
+ */
+uint64_t ApplySwap(AMMReserves& reserves, const AMMSwap& swap, uint32_t fee_bps);
+
+/**
+ * Price a list of swaps against a pool snapshot in one pass, each seeing the
+ * reserves left by the ones before it, exactly as ApplySwap would execute
+ * them in order. amounts_out must be as long as swaps.
+ *
+ * @return the reserves after all swaps
+ */
+AMMReserves QuoteSwaps(AMMReserves reserves, Span<const AMMSwap> swaps, Span<uint64_t> amounts_out, uint32_t fee_bps);
+
+/**
+ * Settle a batch of swaps against one pool at a single clearing price.
+ *
+ * After fees, opposing flows are matched against each other and only the
+ * residual trades against the pool, along its constant-product curve. The
+ * clearing price is the price of that residual trade. Every swap in a
+ * direction gets the same rate, so the result does not depend on the order
+ * of swaps. Swaps paid less than their minimum, or nothing, are dropped and
+ * the batch is cleared again without them. Swaps in a direction that would
+ * overflow a reserve are dropped first, those with the highest minimum per
+ * unit of input first, so that too is independent of their order.
+ * Settling n swaps takes O(n log n). amounts_out must be as long as swaps;
+ * dropped swaps get 0.
+ *
+ * @return the reserves after settlement
+ */
+AMMReserves SettleSwaps(AMMReserves reserves, Span<const AMMSwap> swaps, Span<uint64_t> amounts_out, uint32_t fee_bps);
+
+#endif // SHAHCOIN_DEX_AMM_H
@@ -2,6 +2,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <dex/dex.h>
+#include <dex/amm.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <coins.h>
@@ -238,32 +239,10 @@ uint64_t CDEXManager::CalculateSwapOutput(const uint256& pairId, bool isBuy, uin
         return 0;
     }
     
-    // Constant Product Market Maker (CPMM) formula
-    // (x + dx) * (y - dy) = x * y
-    // dy = y * dx / (x + dx)
-    
-    uint64_t reserveIn, reserveOut;
     if (isBuy) {
-        reserveIn = pair.reserveA;
-        reserveOut = pair.reserveB;
-    } else {
-        reserveIn = pair.reserveB;
-        reserveOut = pair.reserveA;
-    }
-    
-    // Calculate fee
-    uint64_t fee = (amountIn * DEX_SWAP_FEE_RATE) / 10000; // 0.1% fee
-    uint64_t amountInAfterFee = amountIn - fee;
-    
-    // Calculate output using CPMM formula
-    uint64_t numerator = amountInAfterFee * reserveOut;
-    uint64_t denominator = reserveIn + amountInAfterFee;
-    
-    if (denominator == 0) {
-        return 0;
+        return GetSwapAmountOut(amountIn, pair.reserveA, pair.reserveB, DEX_SWAP_FEE_RATE);
     }
-    
-    return numerator / denominator;
+    return GetSwapAmountOut(amountIn, pair.reserveB, pair.reserveA, DEX_SWAP_FEE_RATE);
 }
 
 uint64_t CDEXManager::CalculateLiquidityTokens(const uint256& pairId, uint64_t amountA, uint64_t amountB) const {
@@ -278,14 +257,11 @@ uint64_t CDEXManager::CalculateLiquidityTokens(const uint256& pairId, uint64_t a
     
     if (pair.totalLiquidity == 0) {
         // First liquidity provider
-        return static_cast<uint64_t>(sqrt(static_cast<double>(amountA) * amountB));
+        return GetInitialLiquidity(amountA, amountB);
     }
     
     // Calculate proportional to existing liquidity
-    uint64_t liquidityA = (amountA * pair.totalLiquidity) / pair.reserveA;
-    uint64_t liquidityB = (amountB * pair.totalLiquidity) / pair.reserveB;
-    
-    return std::min(liquidityA, liquidityB);
+    return GetMintedLiquidity(amountA, amountB, pair.reserveA, pair.reserveB, pair.totalLiquidity);
 }
 
 std::pair<uint64_t, uint64_t> CDEXManager::CalculateLiquidityRemoval(const uint256& pairId, 
@@ -299,15 +275,9 @@ std::pair<uint64_t, uint64_t> CDEXManager::CalculateLiquidityRemoval(const uint2
     
     const CTradingPair& pair = it->second;
     
-    if (pair.totalLiquidity == 0) {
-        return {0, 0};
-    }
-    
     // Calculate proportional amounts
-    uint64_t amountA = (liquidityTokens * pair.reserveA) / pair.totalLiquidity;
-    uint64_t amountB = (liquidityTokens * pair.reserveB) / pair.totalLiquidity;
-    
-    return {amountA, amountB};
+    return {GetLiquidityWithdrawal(liquidityTokens, pair.reserveA, pair.totalLiquidity),
+            GetLiquidityWithdrawal(liquidityTokens, pair.reserveB, pair.totalLiquidity)};
 }
 
 CTradingPair CDEXManager::GetTradingPair(const uint256& pairId) const {
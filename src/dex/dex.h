@@ -65,7 +65,7 @@ struct CLiquidityPool {
     bool IsValid() const;
     std::string GetDisplayName() const;
     double CalculatePrice() const;
-    double CalculatePriceImpact(CAmount swapAmount, bool isTokenToShah) const;
+    uint32_t CalculatePriceImpact(CAmount swapAmount, bool isTokenToShah) const; // basis points, see GetPriceImpactBps
     CAmount CalculateSwapOutput(CAmount inputAmount, bool isTokenToShah) const;
     CAmount CalculateLiquidityTokens(CAmount tokenAmount, CAmount shahAmount) const;
 };
@@ -226,7 +226,7 @@ public:
     
     // Price and calculation functions
     double GetTokenPrice(const uint256& poolHash) const;
-    double CalculatePriceImpact(const uint256& poolHash, CAmount swapAmount, bool isTokenToShah) const;
+    uint32_t CalculatePriceImpact(const uint256& poolHash, CAmount swapAmount, bool isTokenToShah) const; // basis points
     CAmount CalculateSwapOutput(const uint256& poolHash, CAmount inputAmount, bool isTokenToShah) const;
     CAmount CalculateLiquidityTokens(const uint256& poolHash, CAmount tokenAmount, CAmount shahAmount) const;
     CAmount CalculateFees(const uint256& poolHash, CAmount swapAmount) const;
@@ -290,7 +290,7 @@ private:
     void UpdateOrderIndexes(const CSwapOrder& order, bool add);
     void RemoveOrderIndexes(const CSwapOrder& order);
     bool ValidatePoolParameters(const uint256& tokenHash, CAmount tokenAmount, CAmount shahAmount) const;
-    bool ValidateSwapParameters(const uint256& poolHash, CAmount amount, double slippage) const;
+    bool ValidateSwapParameters(const uint256& poolHash, CAmount amount, uint32_t max_slippage_bps) const;
     bool ValidateLiquidityParameters(const uint256& poolHash, CAmount tokenAmount, CAmount shahAmount) const;
     void UpdateStats();
     void CleanupExpiredOrders();
@@ -0,0 +1,351 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <dex/dex_state.h>
+
+#include <chain.h>
+#include <dex/amm.h>
+#include <hash.h>
+#include <logging.h>
+#include <streams.h>
+#include <undo.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <set>
+
+static constexpr uint8_t DB_POOL{'p'};
+static constexpr uint8_t DB_POSITION{'l'};
+static constexpr uint8_t DB_UNDO{'u'};
+static constexpr uint8_t DB_BEST_BLOCK{'B'};
+
+//! Marker following OP_RETURN in a DEX operation output
+static const std::vector<unsigned char> DEX_OP_MARKER{'D', 'E', 'X'};
+
+uint256 GetDEXPoolId(const uint256& token_a, const uint256& token_b)
+{
+    HashWriter hasher{};
+    hasher << std::min(token_a, token_b) << std::max(token_a, token_b);
+    return hasher.GetHash();
+}
+
+CScript GetDEXOperationScript(const DEXOperation& op)
+{
+    DataStream stream{};
+    stream << op;
+    std::vector<unsigned char> data{DEX_OP_MARKER};
+    data.insert(data.end(), UCharCast(stream.data()), UCharCast(stream.data() + stream.size()));
+    return CScript() << OP_RETURN << data;
+}
+
+std::optional<DEXOperation> ParseDEXOperation(const CScript& script)
+{
+    CScript::const_iterator pc{script.begin()};
+    opcodetype opcode;
+    std::vector<unsigned char> data;
+    if (!script.GetOp(pc, opcode) || opcode != OP_RETURN) return std::nullopt;
+    if (!script.GetOp(pc, opcode, data) || pc != script.end()) return std::nullopt;
+    if (data.size() <= DEX_OP_MARKER.size() || !std::equal(DEX_OP_MARKER.begin(), DEX_OP_MARKER.end(), data.begin())) {
+        return std::nullopt;
+    }
+
+    SpanReader reader{0, Span{data}.subspan(DEX_OP_MARKER.size())};
+    DEXOperation op;
+    try {
+        reader >> op;
+    } catch (const std::ios_base::failure&) {
+        return std::nullopt;
+    }
+    if (!reader.empty()) return std::nullopt;
+    if (op.type < DEXOpType::CREATE_POOL || op.type > DEXOpType::SWAP) return std::nullopt;
+    return op;
+}
+
+bool HasDEXOperations(const CBlock& block)
+{
+    for (const auto& tx : block.vtx) {
+        for (const auto& txout : tx->vout) {
+            if (ParseDEXOperation(txout.scriptPubKey)) return true;
+        }
+    }
+    return false;
+}
+
+namespace {
+
+bool AddChecked(uint64_t& a, uint64_t b)
+{
+    if (b > std::numeric_limits<uint64_t>::max() - a) return false;
+    a += b;
+    return true;
+}
+
+} // namespace
+
+DEXStateCache::DEXStateCache(DBParams db_params) : m_db{db_params}
+{
+    m_db.Read(DB_BEST_BLOCK, m_best_block);
+
+    std::vector<std::pair<uint256, std::optional<DEXPool>>> pools;
+    std::unique_ptr<CDBIterator> it{m_db.NewIterator()};
+    for (it->Seek(std::make_pair(DB_POOL, uint256::ZERO)); it->Valid(); it->Next()) {
+        std::pair<uint8_t, uint256> key;
+        DEXPool pool;
+        if (!it->GetKey(key) || key.first != DB_POOL || !it->GetValue(pool)) break;
+        pools.emplace_back(key.second, pool);
+    }
+    m_routes->Update(pools);
+}
+
+DEXStateCache::~DEXStateCache() = default;
+
+std::optional<DEXPool> DEXStateCache::GetPool(const uint256& pool_id) const
+{
+    if (auto it{m_pools.find(pool_id)}; it != m_pools.end()) return it->second;
+    DEXPool pool;
+    if (!m_db.Read(std::make_pair(DB_POOL, pool_id), pool)) return std::nullopt;
+    return pool;
+}
+
+uint64_t DEXStateCache::GetLiquidity(const uint256& pool_id, const uint160& owner) const
+{
+    const DEXPositionKey key{pool_id, owner};
+    if (auto it{m_positions.find(key)}; it != m_positions.end()) return it->second;
+    uint64_t liquidity{0};
+    m_db.Read(std::make_pair(DB_POSITION, key), liquidity);
+    return liquidity;
+}
+
+std::optional<DEXBlockUndo> DEXStateCache::ReadUndo(const uint256& block_hash) const
+{
+    if (auto it{m_undo.find(block_hash)}; it != m_undo.end()) return it->second;
+    DEXBlockUndo undo;
+    if (!m_db.Read(std::make_pair(DB_UNDO, block_hash), undo)) return std::nullopt;
+    return undo;
+}
+
+namespace {
+
+/** A DEX operation of a block and the owner that authorized it. */
+struct DEXPoolOp {
+    uint160 owner;
+    DEXOperation op;
+};
+
+/** What the operations of one block did to one pool and its positions. */
+struct DEXPoolChanges {
+    std::optional<DEXPool> before;
+    std::optional<DEXPool> after;
+    //! Previous and new liquidity of every position the operations touched
+    std::map<uint160, std::pair<uint64_t, uint64_t>> positions;
+};
+
+/**
+ * Apply a block's operations on one pool: liquidity operations in transaction
+ * order, then the swaps in one batch at a single clearing price (see
+ * SettleSwaps), so the result does not depend on the order of the swaps.
+ * Only reads state, so pools can be applied concurrently.
+ */
+void ApplyPoolOperations(const DEXStateCache& state, const uint256& id, const std::vector<DEXPoolOp>& ops, DEXPoolChanges& changes)
+{
+    changes.before = state.GetPool(id);
+    std::optional<DEXPool>& pool{changes.after};
+    pool = changes.before;
+    auto position = [&](const uint160& owner) -> uint64_t& {
+        auto it{changes.positions.find(owner)};
+        if (it == changes.positions.end()) {
+            const uint64_t liquidity{state.GetLiquidity(id, owner)};
+            it = changes.positions.emplace(owner, std::make_pair(liquidity, liquidity)).first;
+        }
+        return it->second.second;
+    };
+
+    std::vector<AMMSwap> swaps;
+    for (const auto& [owner, op] : ops) {
+        switch (op.type) {
+        case DEXOpType::CREATE_POOL: {
+            if (!(op.token_a < op.token_b) || op.amount_a == 0 || op.amount_b == 0) break;
+            // A pool whose liquidity was fully withdrawn can be created again.
+            if (pool && pool->total_liquidity != 0) break;
+            const uint64_t liquidity{GetInitialLiquidity(op.amount_a, op.amount_b)};
+            pool = DEXPool{op.token_a, op.token_b, op.amount_a, op.amount_b, liquidity};
+            position(owner) = liquidity;
+            break;
+        }
+        case DEXOpType::ADD_LIQUIDITY: {
+            if (!pool || pool->total_liquidity == 0 || pool->reserve_a == 0 || pool->reserve_b == 0) break;
+            if (op.amount_a == 0 || op.amount_b == 0) break;
+            // Liquidity is minted for the scarcer side; the excess of the other side stays in the pool.
+            const uint64_t liquidity{GetMintedLiquidity(op.amount_a, op.amount_b, pool->reserve_a, pool->reserve_b, pool->total_liquidity)};
+            DEXPool added{*pool};
+            uint64_t added_position{position(owner)};
+            if (liquidity == 0 || !AddChecked(added.reserve_a, op.amount_a) || !AddChecked(added.reserve_b, op.amount_b) ||
+                !AddChecked(added.total_liquidity, liquidity) || !AddChecked(added_position, liquidity)) {
+                break;
+            }
+            pool = added;
+            position(owner) = added_position;
+            break;
+        }
+        case DEXOpType::REMOVE_LIQUIDITY: {
+            const uint64_t liquidity{op.amount_a};
+            if (!pool || liquidity == 0 || liquidity > position(owner)) break;
+            pool->reserve_a -= GetLiquidityWithdrawal(liquidity, pool->reserve_a, pool->total_liquidity);
+            pool->reserve_b -= GetLiquidityWithdrawal(liquidity, pool->reserve_b, pool->total_liquidity);
+            pool->total_liquidity -= liquidity;
+            position(owner) -= liquidity;
+            break;
+        }
+        case DEXOpType::SWAP: {
+            swaps.push_back(AMMSwap{op.a_to_b, op.amount_a, op.amount_b});
+            break;
+        }
+        } // no default case, so the compiler can warn about missing cases
+    }
+
+    if (pool && !swaps.empty()) {
+        std::vector<uint64_t> amounts_out(swaps.size());
+        const AMMReserves reserves{SettleSwaps({pool->reserve_a, pool->reserve_b}, swaps, amounts_out, DEX_SWAP_FEE_BPS)};
+        pool->reserve_a = reserves.reserve_a;
+        pool->reserve_b = reserves.reserve_b;
+    }
+}
+
+} // namespace
+
+bool DEXStateCache::ConnectBlock(const CBlock& block, const CBlockUndo& block_undo, const CBlockIndex& index)
+{
+    if (index.pprev == nullptr ? !m_best_block.IsNull() : index.pprev->GetBlockHash() != m_best_block) {
+        return error("%s: block %s does not connect to DEX state at %s", __func__, index.GetBlockHash().ToString(), m_best_block.ToString());
+    }
+
+    // Every operation acts on exactly one pool, so group them by pool, in
+    // transaction order within each group.
+    std::map<uint256, std::vector<DEXPoolOp>> pool_ops;
+    // The coinbase has no inputs to authorize an operation, so start at 1.
+    for (size_t i = 1; i < block.vtx.size(); ++i) {
+        const CTransaction& tx{*block.vtx[i]};
+        std::optional<DEXOperation> op;
+        for (const auto& txout : tx.vout) {
+            if ((op = ParseDEXOperation(txout.scriptPubKey))) break;
+        }
+        if (!op) continue;
+        if (block_undo.vtxundo.size() < i || block_undo.vtxundo[i - 1].vprevout.empty()) {
+            return error("%s: missing undo data for %s", __func__, tx.GetHash().ToString());
+        }
+        const uint160 owner{Hash160(block_undo.vtxundo[i - 1].vprevout[0].out.scriptPubKey)};
+        const uint256 id{op->type == DEXOpType::CREATE_POOL ? GetDEXPoolId(op->token_a, op->token_b) : op->pool};
+        pool_ops[id].push_back(DEXPoolOp{owner, std::move(*op)});
+    }
+
+    // Pools are independent, so apply them on the script check workers, which
+    // are idle once the block's scripts are checked. Each check only reads the
+    // state and writes its own pool's changes. Operations that are not valid
+    // against the state are skipped rather than failing the check; a check
+    // only fails when the state cannot be read, since an exception must not
+    // escape a worker thread. Nothing is written until all are done.
+    std::vector<DEXPoolChanges> pool_changes(pool_ops.size());
+    std::vector<std::function<bool()>> checks;
+    checks.reserve(pool_ops.size());
+    size_t n{0};
+    for (const auto& [id, ops] : pool_ops) {
+        checks.emplace_back([this, &id = id, &ops = ops, &changes = pool_changes[n++]] {
+            try {
+                ApplyPoolOperations(*this, id, ops, changes);
+            } catch (const std::exception& e) {
+                LogPrintf("DEX state: reading pool %s failed: %s\n", id.ToString(), e.what());
+                return false;
+            }
+            return true;
+        });
+    }
+    if (!RunValidationChecks(std::move(checks))) {
+        return error("%s: failed to read DEX state for block %s", __func__, index.GetBlockHash().ToString());
+    }
+
+    // Merge in pool id order, so the undo record is the same however the
+    // checks were scheduled.
+    DEXBlockUndo undo;
+    std::vector<std::pair<uint256, std::optional<DEXPool>>> changed;
+    n = 0;
+    for (const auto& [id, _] : pool_ops) {
+        DEXPoolChanges& changes{pool_changes[n++]};
+        if (changes.after != changes.before) {
+            undo.pools.emplace_back(id, changes.before);
+            changed.emplace_back(id, changes.after);
+            m_pools[id] = changes.after;
+        }
+        for (const auto& [owner, liquidity] : changes.positions) {
+            if (liquidity.first == liquidity.second) continue;
+            undo.positions.emplace_back(DEXPositionKey{id, owner}, liquidity.first);
+            m_positions[{id, owner}] = liquidity.second;
+        }
+    }
+    m_routes->Update(changed);
+
+    m_undo[index.GetBlockHash()] = std::move(undo);
+    // Undo records are only needed as deep as a reorg can go.
+    if (index.nHeight >= static_cast<int>(MIN_BLOCKS_TO_KEEP)) {
+        m_undo[index.GetAncestor(index.nHeight - MIN_BLOCKS_TO_KEEP)->GetBlockHash()] = std::nullopt;
+    }
+    m_best_block = index.GetBlockHash();
+    return true;
+}
+
+bool DEXStateCache::DisconnectBlock(const CBlockIndex& index)
+{
+    if (index.GetBlockHash() != m_best_block) {
+        return error("%s: block %s is not the DEX state tip %s", __func__, index.GetBlockHash().ToString(), m_best_block.ToString());
+    }
+    const std::optional<DEXBlockUndo> undo{ReadUndo(index.GetBlockHash())};
+    if (!undo) {
+        return error("%s: no DEX undo record for block %s", __func__, index.GetBlockHash().ToString());
+    }
+
+    for (const auto& [id, pool] : undo->pools) {
+        m_pools[id] = pool;
+    }
+    for (const auto& [key, liquidity] : undo->positions) {
+        m_positions[key] = liquidity;
+    }
+    m_routes->Update(undo->pools);
+    m_undo[index.GetBlockHash()] = std::nullopt;
+    m_best_block = index.pprev ? index.pprev->GetBlockHash() : uint256{};
+    return true;
+}
+
+bool DEXStateCache::Flush()
+{
+    CDBBatch batch{m_db};
+    for (const auto& [id, pool] : m_pools) {
+        if (pool) {
+            batch.Write(std::make_pair(DB_POOL, id), *pool);
+        } else {
+            batch.Erase(std::make_pair(DB_POOL, id));
+        }
+    }
+    for (const auto& [key, liquidity] : m_positions) {
+        if (liquidity) {
+            batch.Write(std::make_pair(DB_POSITION, key), liquidity);
+        } else {
+            batch.Erase(std::make_pair(DB_POSITION, key));
+        }
+    }
+    for (const auto& [hash, undo] : m_undo) {
+        if (undo) {
+            batch.Write(std::make_pair(DB_UNDO, hash), *undo);
+        } else {
+            batch.Erase(std::make_pair(DB_UNDO, hash));
+        }
+    }
+    batch.Write(DB_BEST_BLOCK, m_best_block);
+    if (!m_db.WriteBatch(batch, /*fSync=*/true)) return false;
+
+    m_pools.clear();
+    m_positions.clear();
+    m_undo.clear();
+    return true;
+}
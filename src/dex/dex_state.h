@@ -0,0 +1,191 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SHAHCOIN_DEX_DEX_STATE_H
+#define SHAHCOIN_DEX_DEX_STATE_H
+
+#include <dbwrapper.h>
+#include <dex/route.h>
+#include <primitives/block.h>
+#include <script/script.h>
+#include <serialize.h>
+#include <uint256.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+class CBlockIndex;
+class CBlockUndo;
+
+/** LevelDB cache for the DEX state database. */
+static constexpr size_t DEX_STATE_DB_CACHE{8 << 20};
+
+/** Swap fee, in basis points of the input amount, left in the pool for its liquidity providers. */
+static constexpr uint32_t DEX_SWAP_FEE_BPS{30};
+
+/** A constant-product pool between two tokens, identified by GetDEXPoolId(token_a, token_b). */
+struct DEXPool {
+    //! token_a < token_b
+    uint256 token_a;
+    uint256 token_b;
+    uint64_t reserve_a{0};
+    uint64_t reserve_b{0};
+    //! Sum of all liquidity positions in the pool
+    uint64_t total_liquidity{0};
+
+    SERIALIZE_METHODS(DEXPool, obj) { READWRITE(obj.token_a, obj.token_b, obj.reserve_a, obj.reserve_b, obj.total_liquidity); }
+
+    friend bool operator==(const DEXPool& a, const DEXPool& b)
+    {
+        return a.token_a == b.token_a && a.token_b == b.token_b && a.reserve_a == b.reserve_a &&
+               a.reserve_b == b.reserve_b && a.total_liquidity == b.total_liquidity;
+    }
+};
+
+uint256 GetDEXPoolId(const uint256& token_a, const uint256& token_b);
+
+/** A pool and a liquidity provider, identified by the Hash160 of the script it spent from. */
+using DEXPositionKey = std::pair<uint256, uint160>;
+
+enum class DEXOpType : uint8_t {
+    CREATE_POOL = 1,
+    ADD_LIQUIDITY = 2,
+    REMOVE_LIQUIDITY = 3,
+    SWAP = 4,
+};
+
+/**
+ * A DEX operation, carried in an OP_RETURN output of a transaction and
+ * authorized by the script of the transaction's first input.
+ *
+ * CREATE_POOL:      token_a, token_b (token_a < token_b), amount_a, amount_b
+ * ADD_LIQUIDITY:    pool, amount_a, amount_b
+ * REMOVE_LIQUIDITY: pool, amount_a = liquidity
+ * SWAP:             pool, a_to_b, amount_a = amount in, amount_b = minimum amount out
+ */
+struct DEXOperation {
+    DEXOpType type{DEXOpType::SWAP};
+    uint256 pool;
+    uint256 token_a;
+    uint256 token_b;
+    uint64_t amount_a{0};
+    uint64_t amount_b{0};
+    bool a_to_b{false};
+
+    SERIALIZE_METHODS(DEXOperation, obj)
+    {
+        uint8_t type{static_cast<uint8_t>(obj.type)};
+        READWRITE(type);
+        SER_READ(obj, obj.type = static_cast<DEXOpType>(type));
+        if (obj.type == DEXOpType::CREATE_POOL) {
+            READWRITE(obj.token_a, obj.token_b);
+        } else {
+            READWRITE(obj.pool);
+        }
+        READWRITE(VARINT(obj.amount_a), VARINT(obj.amount_b), obj.a_to_b);
+    }
+};
+
+CScript GetDEXOperationScript(const DEXOperation& op);
+std::optional<DEXOperation> ParseDEXOperation(const CScript& script);
+bool HasDEXOperations(const CBlock& block);
+
+/**
+ * The previous value of every pool and position a block changed, so that
+ * disconnecting the block restores them exactly. An absent pool and a zero
+ * position are deleted on restore.
+ */
+struct DEXBlockUndo {
+    std::vector<std::pair<uint256, std::optional<DEXPool>>> pools;
+    std::vector<std::pair<DEXPositionKey, uint64_t>> positions;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        WriteCompactSize(s, pools.size());
+        for (const auto& [id, pool] : pools) {
+            s << id << bool{pool.has_value()};
+            if (pool) s << *pool;
+        }
+        s << positions;
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        pools.resize(ReadCompactSize(s));
+        for (auto& [id, pool] : pools) {
+            bool exists;
+            s >> id >> exists;
+            if (exists) s >> pool.emplace();
+        }
+        s >> positions;
+    }
+};
+
+/**
+ * DEX pools and liquidity positions, committed per block to a LevelDB
+ * database (datadir/dexstate) next to the coins database.
+ *
+ * Changes are kept in memory until Flush(), which FlushStateToDisk calls
+ * right before flushing the coins cache, so both are written at the same
+ * points. The DEX state is flushed first and may therefore be ahead of the
+ * coins database after a crash; the per-block undo records kept here let
+ * startup rewind it instead of replaying the chain.
+ */
+class DEXStateCache
+{
+public:
+    explicit DEXStateCache(DBParams db_params);
+    ~DEXStateCache();
+
+    /** Block the state is at; null for an empty state. */
+    uint256 GetBestBlock() const { return m_best_block; }
+
+    std::optional<DEXPool> GetPool(const uint256& pool_id) const;
+    uint64_t GetLiquidity(const uint256& pool_id, const uint160& owner) const;
+
+    /**
+     * Apply the DEX operations of a block connected on top of GetBestBlock().
+     * block_undo must hold the spent coins when HasDEXOperations(block).
+     * Operations that are not valid against the current state are skipped.
+     * Liquidity operations apply in transaction order; swaps then settle per
+     * pool in one batch (see SettleSwaps). Operations on different pools are
+     * independent, so pools are applied in parallel on the DEX check workers
+     * and merged in pool id order.
+     */
+    bool ConnectBlock(const CBlock& block, const CBlockUndo& block_undo, const CBlockIndex& index);
+
+    /** Revert the block at GetBestBlock() from its undo record. */
+    bool DisconnectBlock(const CBlockIndex& index);
+
+    /** Write all changes and the best block in one batch. */
+    bool Flush();
+
+    /**
+     * Active pools as of GetBestBlock(), for route quotes. The graph has its
+     * own lock and outlives this cache while the caller holds it, so only
+     * this call needs cs_main, not the queries.
+     */
+    std::shared_ptr<const DEXRouteGraph> GetRouteGraph() const { return m_routes; }
+
+private:
+    CDBWrapper m_db;
+    uint256 m_best_block;
+
+    //! Changed entries not yet flushed; nullopt and 0 mean erase
+    std::map<uint256, std::optional<DEXPool>> m_pools;
+    std::map<DEXPositionKey, uint64_t> m_positions;
+    std::map<uint256, std::optional<DEXBlockUndo>> m_undo;
+
+    //! Updated after each connected or disconnected block
+    const std::shared_ptr<DEXRouteGraph> m_routes{std::make_shared<DEXRouteGraph>()};
+
+    std::optional<DEXBlockUndo> ReadUndo(const uint256& block_hash) const;
+};
+
+#endif // SHAHCOIN_DEX_DEX_STATE_H
@@ -0,0 +1,137 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <dex/route.h>
+
+#include <dex/dex_state.h>
+
+#include <algorithm>
+#include <array>
+
+uint32_t DEXRouteGraph::GetTokenNode(const uint256& token)
+{
+    AssertLockHeld(m_mutex);
+    const auto [it, inserted]{m_token_nodes.try_emplace(token, m_tokens.size())};
+    if (inserted) {
+        m_tokens.push_back(token);
+        m_edges.emplace_back();
+    }
+    return it->second;
+}
+
+void DEXRouteGraph::RemoveEdge(uint32_t node, uint32_t slot)
+{
+    AssertLockHeld(m_mutex);
+    auto& edges{m_edges[node]};
+    const auto it{std::find_if(edges.begin(), edges.end(), [&](const Edge& edge) { return edge.slot == slot; })};
+    if (it == edges.end()) return;
+    *it = edges.back();
+    edges.pop_back();
+}
+
+void DEXRouteGraph::Update(Span<const std::pair<uint256, std::optional<DEXPool>>> pools)
+{
+    LOCK(m_mutex);
+    for (const auto& [id, pool] : pools) {
+        const bool active{pool && pool->total_liquidity != 0 && pool->reserve_a != 0 && pool->reserve_b != 0};
+        const auto it{m_pool_slots.find(id)};
+        if (it != m_pool_slots.end()) {
+            PoolSlot& slot{m_slots[it->second]};
+            if (active) {
+                slot.reserves = AMMReserves{pool->reserve_a, pool->reserve_b};
+                continue;
+            }
+            RemoveEdge(slot.token_a, it->second);
+            RemoveEdge(slot.token_b, it->second);
+            m_free_slots.push_back(it->second);
+            m_pool_slots.erase(it);
+            continue;
+        }
+        if (!active) continue;
+
+        uint32_t index;
+        if (m_free_slots.empty()) {
+            index = m_slots.size();
+            m_slots.emplace_back();
+        } else {
+            index = m_free_slots.back();
+            m_free_slots.pop_back();
+        }
+        const uint32_t token_a{GetTokenNode(pool->token_a)}, token_b{GetTokenNode(pool->token_b)};
+        m_slots[index] = PoolSlot{id, token_a, token_b, AMMReserves{pool->reserve_a, pool->reserve_b}};
+        m_pool_slots.emplace(id, index);
+        m_edges[token_a].push_back(Edge{index, token_b, /*a_to_b=*/true});
+        m_edges[token_b].push_back(Edge{index, token_a, /*a_to_b=*/false});
+    }
+}
+
+std::optional<DEXRoute> DEXRouteGraph::FindBestRoute(const uint256& token_in, const uint256& token_out, uint64_t amount_in,
+                                                     int max_hops, uint32_t fee_bps) const
+{
+    max_hops = std::clamp(max_hops, 1, MAX_HOPS);
+    LOCK(m_mutex);
+    const auto from{m_token_nodes.find(token_in)}, to{m_token_nodes.find(token_out)};
+    if (from == m_token_nodes.end() || to == m_token_nodes.end() || from->second == to->second || amount_in == 0) {
+        return std::nullopt;
+    }
+
+    // Depth-first over simple paths; at most MAX_HOPS levels, so fixed arrays suffice.
+    std::array<uint32_t, MAX_HOPS + 1> nodes{from->second};
+    std::array<uint32_t, MAX_HOPS> slots;
+    std::array<uint64_t, MAX_HOPS + 1> amounts{amount_in};
+    std::array<uint32_t, MAX_HOPS + 1> best_nodes;
+    std::array<uint32_t, MAX_HOPS> best_slots;
+    std::array<uint64_t, MAX_HOPS + 1> best_amounts;
+    int best_hops{0};
+
+    auto better = [&](int hops) EXCLUSIVE_LOCKS_REQUIRED(m_mutex) {
+        if (best_hops == 0) return true;
+        if (amounts[hops] != best_amounts[best_hops]) return amounts[hops] > best_amounts[best_hops];
+        if (hops != best_hops) return hops < best_hops;
+        for (int i = 0; i < hops; ++i) {
+            if (m_slots[slots[i]].id != m_slots[best_slots[i]].id) return m_slots[slots[i]].id < m_slots[best_slots[i]].id;
+        }
+        return false;
+    };
+
+    auto search = [&](auto& self, int depth) EXCLUSIVE_LOCKS_REQUIRED(m_mutex) -> void {
+        for (const Edge& edge : m_edges[nodes[depth]]) {
+            if (std::find(nodes.begin(), nodes.begin() + depth + 1, edge.to) != nodes.begin() + depth + 1) continue;
+            const AMMReserves& reserves{m_slots[edge.slot].reserves};
+            const uint64_t out{edge.a_to_b ? GetSwapAmountOut(amounts[depth], reserves.reserve_a, reserves.reserve_b, fee_bps)
+                                           : GetSwapAmountOut(amounts[depth], reserves.reserve_b, reserves.reserve_a, fee_bps)};
+            if (out == 0) continue;
+            nodes[depth + 1] = edge.to;
+            slots[depth] = edge.slot;
+            amounts[depth + 1] = out;
+            if (edge.to == to->second) {
+                if (better(depth + 1)) {
+                    best_hops = depth + 1;
+                    best_nodes = nodes;
+                    best_slots = slots;
+                    best_amounts = amounts;
+                }
+            } else if (depth + 1 < max_hops) {
+                self(self, depth + 1);
+            }
+        }
+    };
+    search(search, 0);
+    if (best_hops == 0) return std::nullopt;
+
+    DEXRoute route;
+    route.tokens.push_back(token_in);
+    route.amounts.push_back(amount_in);
+    for (int i = 0; i < best_hops; ++i) {
+        route.pools.push_back(m_slots[best_slots[i]].id);
+        route.tokens.push_back(m_tokens[best_nodes[i + 1]]);
+        route.amounts.push_back(best_amounts[i + 1]);
+    }
+    return route;
+}
+
+size_t DEXRouteGraph::PoolCount() const
+{
+    LOCK(m_mutex);
+    return m_pool_slots.size();
+}
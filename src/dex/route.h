@@ -0,0 +1,86 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SHAHCOIN_DEX_ROUTE_H
+#define SHAHCOIN_DEX_ROUTE_H
+
+#include <dex/amm.h>
+#include <span.h>
+#include <sync.h>
+#include <uint256.h>
+#include <util/hasher.h>
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct DEXPool;
+
+/** A path of swaps from tokens.front() to tokens.back() through pools. */
+struct DEXRoute {
+    std::vector<uint256> pools;
+    //! Tokens visited, one more than pools
+    std::vector<uint256> tokens;
+    //! Amount held after each hop, amounts[0] being the amount in
+    std::vector<uint64_t> amounts;
+
+    uint64_t AmountOut() const { return amounts.back(); }
+};
+
+/**
+ * Adjacency graph of the active DEX pools, with tokens as nodes and pools as
+ * edges, for quoting multi-hop swaps.
+ *
+ * Pools live in a flat slot array and each token keeps the slots of its
+ * pools, so a reserve change is an O(1) write and a quote only touches
+ * adjacency lists and reserves. The graph has its own lock, so quotes do not
+ * contend with block validation beyond the brief update after each block.
+ */
+class DEXRouteGraph
+{
+public:
+    static constexpr int MAX_HOPS{3};
+
+    /** Apply pool changes; nullopt, or a pool without liquidity, removes it from the graph. */
+    void Update(Span<const std::pair<uint256, std::optional<DEXPool>>> pools) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /**
+     * The route of at most max_hops (capped at MAX_HOPS) swaps through
+     * distinct tokens that yields the most token_out for amount_in of
+     * token_in. Ties go to the shorter route, then to the smaller pool ids,
+     * so every node quotes the same route for the same pools.
+     */
+    std::optional<DEXRoute> FindBestRoute(const uint256& token_in, const uint256& token_out, uint64_t amount_in,
+                                          int max_hops, uint32_t fee_bps) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    size_t PoolCount() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    struct PoolSlot {
+        uint256 id;
+        uint32_t token_a;
+        uint32_t token_b;
+        AMMReserves reserves;
+    };
+    struct Edge {
+        uint32_t slot;
+        //! Token node this pool swaps into
+        uint32_t to;
+        bool a_to_b;
+    };
+
+    mutable Mutex m_mutex;
+    std::vector<PoolSlot> m_slots GUARDED_BY(m_mutex);
+    std::vector<uint32_t> m_free_slots GUARDED_BY(m_mutex);
+    std::unordered_map<uint256, uint32_t, SaltedTxidHasher> m_pool_slots GUARDED_BY(m_mutex);
+    std::vector<uint256> m_tokens GUARDED_BY(m_mutex);
+    std::unordered_map<uint256, uint32_t, SaltedTxidHasher> m_token_nodes GUARDED_BY(m_mutex);
+    std::vector<std::vector<Edge>> m_edges GUARDED_BY(m_mutex);
+
+    uint32_t GetTokenNode(const uint256& token) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void RemoveEdge(uint32_t node, uint32_t slot) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+};
+
+#endif // SHAHCOIN_DEX_ROUTE_H
@@ -0,0 +1,319 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/delegationindex.h>
+
+#include <common/args.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <serialize.h>
+#include <stake/delegation_script.h>
+#include <undo.h>
+#include <validation.h>
+
+#include <map>
+
+static constexpr uint8_t DB_DELEGATION{'d'};
+static constexpr uint8_t DB_TOTALS{'s'};
+static constexpr uint8_t DB_BLOCK_HEIGHT{'h'};
+
+std::unique_ptr<DelegationIndex> g_delegation_index;
+
+namespace {
+
+struct DBDelegationKey {
+    CKeyID staker;
+    COutPoint outpoint;
+
+    DBDelegationKey() = default;
+    DBDelegationKey(const CKeyID& staker_in, const COutPoint& outpoint_in) : staker(staker_in), outpoint(outpoint_in) {}
+
+    SERIALIZE_METHODS(DBDelegationKey, obj)
+    {
+        uint8_t prefix{DB_DELEGATION};
+        READWRITE(prefix);
+        if (prefix != DB_DELEGATION) {
+            throw std::ios_base::failure("Invalid format for delegationindex DB delegation key");
+        }
+        READWRITE(obj.staker, obj.outpoint);
+    }
+};
+
+struct DBDelegationValue {
+    CKeyID owner;
+    CAmount amount{0};
+    int height{0};
+
+    SERIALIZE_METHODS(DBDelegationValue, obj) { READWRITE(obj.owner, obj.amount, obj.height); }
+};
+
+/** Key of the totals of a staker. It is also a prefix of all of its DBDelegationKeys. */
+struct DBStakerKey {
+    uint8_t prefix;
+    CKeyID staker;
+
+    DBStakerKey(uint8_t prefix_in, const CKeyID& staker_in) : prefix(prefix_in), staker(staker_in) {}
+
+    SERIALIZE_METHODS(DBStakerKey, obj) { READWRITE(obj.prefix, obj.staker); }
+};
+
+/**
+ * Records that the block at a height has been applied to the index. It is
+ * written in the same batch as the block's changes, which makes appending and
+ * reversing a block idempotent although the best block locator is only
+ * committed later.
+ */
+struct DBHeightKey {
+    int height;
+
+    explicit DBHeightKey(int height_in) : height(height_in) {}
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_BLOCK_HEIGHT);
+        ser_writedata32be(s, height);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t prefix{ser_readdata8(s)};
+        if (prefix != DB_BLOCK_HEIGHT) {
+            throw std::ios_base::failure("Invalid format for delegationindex DB height key");
+        }
+        height = ser_readdata32be(s);
+    }
+};
+
+/** The changes of one block, with the per-staker totals folded together before they are written. */
+class BlockChanges
+{
+    CDBWrapper& m_db;
+    CDBBatch m_batch;
+    //! Change in total amount and count per staker
+    std::map<CKeyID, std::pair<CAmount, int64_t>> m_deltas;
+
+public:
+    explicit BlockChanges(CDBWrapper& db) : m_db(db), m_batch(db) {}
+
+    void Add(const CKeyID& staker, const COutPoint& outpoint, const DBDelegationValue& value)
+    {
+        m_batch.Write(DBDelegationKey(staker, outpoint), value);
+        auto& [amount, count]{m_deltas[staker]};
+        amount += value.amount;
+        ++count;
+    }
+
+    void Remove(const CKeyID& staker, const COutPoint& outpoint, CAmount amount)
+    {
+        m_batch.Erase(DBDelegationKey(staker, outpoint));
+        auto& [delta_amount, delta_count]{m_deltas[staker]};
+        delta_amount -= amount;
+        --delta_count;
+    }
+
+    /** Write the changes and mark the block at height as applied (block_hash) or reversed (nullptr). */
+    bool Commit(int height, const uint256* block_hash)
+    {
+        for (const auto& [staker, delta] : m_deltas) {
+            const auto& [delta_amount, delta_count]{delta};
+            const DBStakerKey key{DB_TOTALS, staker};
+            DelegationTotals totals;
+            if (!m_db.Read(key, totals) && m_db.Exists(key)) {
+                return error("%s: Cannot read delegation totals; index may be corrupted", __func__);
+            }
+            totals.amount += delta_amount;
+            totals.count += delta_count;
+            if (totals.count == 0) {
+                m_batch.Erase(key);
+            } else {
+                m_batch.Write(key, totals);
+            }
+        }
+        if (block_hash) {
+            m_batch.Write(DBHeightKey(height), *block_hash);
+        } else {
+            m_batch.Erase(DBHeightKey(height));
+        }
+        return m_db.WriteBatch(m_batch);
+    }
+};
+
+} // namespace
+
+/** Access to the delegation index database (indexes/delegationindex/) */
+class DelegationIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Whether the block at height is applied to the index, and if so which one.
+    bool ReadAppliedBlock(int height, uint256& block_hash) const;
+};
+
+DelegationIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "delegationindex", n_cache_size, f_memory, f_wipe)
+{}
+
+bool DelegationIndex::DB::ReadAppliedBlock(int height, uint256& block_hash) const
+{
+    return Read(DBHeightKey(height), block_hash);
+}
+
+DelegationIndex::DelegationIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "delegationindex"), m_db(std::make_unique<DelegationIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+DelegationIndex::~DelegationIndex() = default;
+
+BaseIndex::DB& DelegationIndex::GetDB() const { return *m_db; }
+
+bool DelegationIndex::CustomInit(const std::optional<interfaces::BlockKey>& block)
+{
+    // Blocks applied after the last commit were never recorded in the best
+    // block locator, and the sync would not reverse them if they have since
+    // been disconnected. Reverse them now; sync reapplies those still active.
+    std::vector<uint256> applied;
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+    for (db_it->Seek(DBHeightKey(block ? block->height + 1 : 0)); db_it->Valid(); db_it->Next()) {
+        DBHeightKey key{0};
+        uint256 block_hash;
+        if (!db_it->GetKey(key)) break;
+        if (!db_it->GetValue(block_hash)) {
+            return error("%s: Cannot read applied block at height %d; index may be corrupted", __func__, key.height);
+        }
+        applied.push_back(block_hash);
+    }
+
+    for (auto it{applied.rbegin()}; it != applied.rend(); ++it) {
+        const CBlockIndex* block_index{WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(*it))};
+        CBlock block_data;
+        if (!block_index || !m_chainstate->m_blockman.ReadBlockFromDisk(block_data, *block_index)) {
+            return error("%s: Cannot read uncommitted block %s; please rebuild the index", __func__, it->ToString());
+        }
+        if (!ReverseBlock(block_data, *block_index)) return false;
+    }
+    return true;
+}
+
+bool DelegationIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    // Already applied before an unclean shutdown.
+    uint256 applied;
+    if (m_db->ReadAppliedBlock(block.height, applied) && applied == block.hash) return true;
+
+    assert(block.data);
+    CBlockUndo block_undo;
+    if (block.height > 0) {
+        const CBlockIndex* block_index{WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(block.hash))};
+        if (!m_chainstate->m_blockman.UndoReadFromDisk(block_undo, *Assert(block_index))) {
+            return error("%s: Failed to read undo data of block %s", __func__, block.hash.ToString());
+        }
+    }
+
+    BlockChanges changes{*m_db};
+    CKeyID staker, owner;
+    for (size_t i = 0; i < block.data->vtx.size(); ++i) {
+        const CTransaction& tx{*block.data->vtx[i]};
+
+        // The coinbase tx has no undo data since no former output is spent
+        if (!tx.IsCoinBase()) {
+            const CTxUndo& tx_undo{block_undo.vtxundo.at(i - 1)};
+            for (size_t j = 0; j < tx_undo.vprevout.size(); ++j) {
+                const Coin& coin{tx_undo.vprevout[j]};
+                if (MatchDelegationScript(coin.out.scriptPubKey, staker, owner)) {
+                    changes.Remove(staker, tx.vin[j].prevout, coin.out.nValue);
+                }
+            }
+        }
+
+        for (uint32_t j = 0; j < tx.vout.size(); ++j) {
+            const CTxOut& out{tx.vout[j]};
+            if (MatchDelegationScript(out.scriptPubKey, staker, owner)) {
+                changes.Add(staker, COutPoint{tx.GetHash(), j}, {owner, out.nValue, block.height});
+            }
+        }
+    }
+    return changes.Commit(block.height, &block.hash);
+}
+
+bool DelegationIndex::CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip)
+{
+    LOCK(cs_main);
+    const CBlockIndex* iter_tip{m_chainstate->m_blockman.LookupBlockIndex(current_tip.hash)};
+    const CBlockIndex* new_tip_index{m_chainstate->m_blockman.LookupBlockIndex(new_tip.hash)};
+
+    do {
+        CBlock block;
+        if (!m_chainstate->m_blockman.ReadBlockFromDisk(block, *iter_tip)) {
+            return error("%s: Failed to read block %s from disk",
+                         __func__, iter_tip->GetBlockHash().ToString());
+        }
+        if (!ReverseBlock(block, *iter_tip)) {
+            return false; // failure cause logged internally
+        }
+        iter_tip = iter_tip->GetAncestor(iter_tip->nHeight - 1);
+    } while (new_tip_index != iter_tip);
+
+    return true;
+}
+
+// Reverse a single block as part of a reorg
+bool DelegationIndex::ReverseBlock(const CBlock& block, const CBlockIndex& block_index)
+{
+    // Already reversed before an unclean shutdown.
+    uint256 applied;
+    if (!m_db->ReadAppliedBlock(block_index.nHeight, applied) || applied != block_index.GetBlockHash()) return true;
+
+    CBlockUndo block_undo;
+    if (block_index.nHeight > 0 && !m_chainstate->m_blockman.UndoReadFromDisk(block_undo, block_index)) {
+        return error("%s: Failed to read undo data of block %s", __func__, block_index.GetBlockHash().ToString());
+    }
+
+    // Walk the block backwards, so that a delegation created and spent in the
+    // same block is restored before it is removed.
+    BlockChanges changes{*m_db};
+    CKeyID staker, owner;
+    for (size_t i = block.vtx.size(); i-- > 0;) {
+        const CTransaction& tx{*block.vtx[i]};
+
+        for (uint32_t j = 0; j < tx.vout.size(); ++j) {
+            const CTxOut& out{tx.vout[j]};
+            if (MatchDelegationScript(out.scriptPubKey, staker, owner)) {
+                changes.Remove(staker, COutPoint{tx.GetHash(), j}, out.nValue);
+            }
+        }
+
+        if (!tx.IsCoinBase()) {
+            const CTxUndo& tx_undo{block_undo.vtxundo.at(i - 1)};
+            for (size_t j = 0; j < tx_undo.vprevout.size(); ++j) {
+                const Coin& coin{tx_undo.vprevout[j]};
+                if (MatchDelegationScript(coin.out.scriptPubKey, staker, owner)) {
+                    changes.Add(staker, tx.vin[j].prevout, {owner, coin.out.nValue, static_cast<int>(coin.nHeight)});
+                }
+            }
+        }
+    }
+    return changes.Commit(block_index.nHeight, nullptr);
+}
+
+DelegationTotals DelegationIndex::GetDelegatedTotals(const CKeyID& staker) const
+{
+    DelegationTotals totals;
+    m_db->Read(DBStakerKey{DB_TOTALS, staker}, totals);
+    return totals;
+}
+
+std::vector<DelegationEntry> DelegationIndex::GetDelegations(const CKeyID& staker) const
+{
+    std::vector<DelegationEntry> result;
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+    for (db_it->Seek(DBStakerKey{DB_DELEGATION, staker}); db_it->Valid(); db_it->Next()) {
+        DBDelegationKey key;
+        DBDelegationValue value;
+        if (!db_it->GetKey(key) || key.staker != staker || !db_it->GetValue(value)) break;
+        result.push_back({key.outpoint, value.owner, value.amount, value.height});
+    }
+    return result;
+}
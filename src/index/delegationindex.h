@@ -0,0 +1,83 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SHAHCOIN_INDEX_DELEGATIONINDEX_H
+#define SHAHCOIN_INDEX_DELEGATIONINDEX_H
+
+#include <consensus/amount.h>
+#include <index/base.h>
+#include <primitives/transaction.h>
+#include <pubkey.h>
+
+#include <vector>
+
+static constexpr bool DEFAULT_DELEGATIONINDEX{false};
+
+/** An unspent cold-staking delegation output, see GetDelegationScript(). */
+struct DelegationEntry {
+    COutPoint outpoint;
+    CKeyID owner;
+    CAmount amount{0};
+    int height{0};
+};
+
+/** Running totals of the unspent delegations to one staker. */
+struct DelegationTotals {
+    CAmount amount{0};
+    uint64_t count{0};
+
+    SERIALIZE_METHODS(DelegationTotals, obj) { READWRITE(obj.amount, obj.count); }
+};
+
+/**
+ * DelegationIndex tracks the unspent cold-staking delegation outputs of the
+ * active chain, keyed by staker (hot wallet). Each staker also has a running
+ * total, so the delegated amount of a staking pool is one key lookup no
+ * matter how many owners delegate to it.
+ *
+ * Outputs are added when created and removed when spent (which is how a
+ * delegation is revoked); a reorg reverses disconnected blocks using their
+ * undo data.
+ */
+class DelegationIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    bool AllowPrune() const override { return true; }
+
+    [[nodiscard]] bool ReverseBlock(const CBlock& block, const CBlockIndex& block_index);
+
+protected:
+    bool CustomInit(const std::optional<interfaces::BlockKey>& block) override;
+
+    bool CustomAppend(const interfaces::BlockInfo& block) override;
+
+    bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit DelegationIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~DelegationIndex() override;
+
+    /// Total value and number of the unspent delegations to staker.
+    DelegationTotals GetDelegatedTotals(const CKeyID& staker) const;
+
+    /// Total value of the unspent delegations to staker.
+    CAmount GetDelegatedAmount(const CKeyID& staker) const { return GetDelegatedTotals(staker).amount; }
+
+    /// The unspent delegations to staker, in outpoint order.
+    std::vector<DelegationEntry> GetDelegations(const CKeyID& staker) const;
+};
+
+/// The global delegation index. May be null.
+extern std::unique_ptr<DelegationIndex> g_delegation_index;
+
+#endif // SHAHCOIN_INDEX_DELEGATIONINDEX_H
@@ -0,0 +1,470 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/tokenindex.h>
+
+#include <common/args.h>
+#include <crypto/siphash.h>
+#include <logging.h>
+#include <memusage.h>
+#include <node/blockstorage.h>
+#include <random.h>
+#include <tokens/token_script.h>
+#include <undo.h>
+#include <validation.h>
+
+static constexpr uint8_t DB_ACCOUNT{'a'};
+static constexpr uint8_t DB_TOKEN{'t'};
+static constexpr uint8_t DB_UNDO{'u'};
+static constexpr uint8_t DB_HOLDING{'h'};
+static constexpr uint8_t DB_ISSUED{'i'};
+
+static constexpr uint64_t MAX_SUPPLY{static_cast<uint64_t>(MAX_TOKEN_SUPPLY)};
+
+static_assert(TokenIndex::TOKEN_UNDO_DEPTH >= static_cast<int>(MIN_BLOCKS_TO_KEEP));
+
+std::unique_ptr<TokenIndex> g_token_index;
+
+TokenAccountKeyHasher::TokenAccountKeyHasher() : m_k0(GetRand<uint64_t>()), m_k1(GetRand<uint64_t>()) {}
+
+size_t TokenAccountKeyHasher::operator()(const TokenAccountKey& key) const
+{
+    return CSipHasher(m_k0, m_k1).Write(key.token).Write(key.owner).Write(key.spender).Finalize();
+}
+
+TokenLedgerCache::TokenLedgerCache(CDBWrapper& db, size_t max_usage) : m_db{db}, m_max_usage{max_usage} {}
+
+TokenLedgerCache::AccountMap::iterator TokenLedgerCache::FetchEntry(const TokenAccountKey& key) const
+{
+    AssertLockHeld(m_mutex);
+    const auto [it, inserted]{m_accounts.try_emplace(key)};
+    if (inserted && !m_db.Read(std::make_pair(DB_ACCOUNT, key), it->second.amount)) {
+        it->second.flags = Entry::FRESH;
+    }
+    return it;
+}
+
+uint64_t TokenLedgerCache::GetAmount(const TokenAccountKey& key) const
+{
+    LOCK(m_mutex);
+    return FetchEntry(key)->second.amount;
+}
+
+uint256 TokenLedgerCache::GetAmounts(const uint256& token, Span<const uint160> owners, std::vector<uint64_t>& amounts) const
+{
+    LOCK(m_mutex);
+    amounts.clear();
+    amounts.reserve(owners.size());
+    for (const uint160& owner : owners) {
+        amounts.push_back(FetchEntry({token, owner, uint160{}})->second.amount);
+    }
+    return m_best_block;
+}
+
+std::optional<TokenInfo> TokenLedgerCache::ReadToken(const uint256& token) const
+{
+    AssertLockHeld(m_mutex);
+    if (auto it{m_tokens.find(token)}; it != m_tokens.end()) return it->second.first;
+    TokenInfo info;
+    if (!m_db.Read(std::make_pair(DB_TOKEN, token), info)) return std::nullopt;
+    return info;
+}
+
+std::optional<TokenInfo> TokenLedgerCache::GetToken(const uint256& token) const
+{
+    LOCK(m_mutex);
+    return ReadToken(token);
+}
+
+uint256 TokenLedgerCache::ListTokens(const std::optional<uint256>& after, size_t limit, std::vector<std::pair<uint256, TokenInfo>>& tokens) const
+{
+    LOCK(m_mutex);
+    tokens.clear();
+    // Tokens evicted from the cache were flushed before, so the database and
+    // the cache, whose entries are newer, together hold every token.
+    std::unique_ptr<CDBIterator> it{m_db.NewIterator()};
+    it->Seek(std::make_pair(DB_TOKEN, after.value_or(uint256::ZERO)));
+    auto cached{after ? m_tokens.upper_bound(*after) : m_tokens.begin()};
+    std::pair<uint8_t, uint256> key;
+    while (tokens.size() < limit) {
+        std::optional<uint256> stored;
+        if (it->Valid() && it->GetKey(key) && key.first == DB_TOKEN) stored = key.second;
+        if (stored && after && *stored == *after) {
+            it->Next();
+            continue;
+        }
+        if (cached != m_tokens.end() && (!stored || !(*stored < cached->first))) {
+            if (stored && *stored == cached->first) it->Next();
+            if (const auto& info{cached->second.first}) tokens.emplace_back(cached->first, *info);
+            ++cached;
+        } else if (stored) {
+            TokenInfo info;
+            if (!it->GetValue(info)) {
+                error("%s: cannot read token %s", __func__, stored->ToString());
+                break;
+            }
+            tokens.emplace_back(*stored, std::move(info));
+            it->Next();
+        } else {
+            break;
+        }
+    }
+    return m_best_block;
+}
+
+uint256 TokenLedgerCache::GetHeldTokens(const uint160& account, const std::optional<uint256>& after, size_t limit, std::vector<uint256>& tokens) const
+{
+    return GetAccountTokens(DB_HOLDING, account, after, limit, tokens);
+}
+
+uint256 TokenLedgerCache::GetIssuedTokens(const uint160& account, const std::optional<uint256>& after, size_t limit, std::vector<uint256>& tokens) const
+{
+    return GetAccountTokens(DB_ISSUED, account, after, limit, tokens);
+}
+
+uint256 TokenLedgerCache::GetAccountTokens(uint8_t kind, const uint160& account, const std::optional<uint256>& after, size_t limit,
+                                           std::vector<uint256>& tokens) const
+{
+    LOCK(m_mutex);
+    tokens.clear();
+    // As in ListTokens(), the cached entries are newer than the database.
+    const TokenAccountIndexKey first{kind, account, after.value_or(uint256::ZERO)};
+    const auto in_range = [&](const TokenAccountIndexKey& key) { return key.kind == kind && key.account == account; };
+    std::unique_ptr<CDBIterator> it{m_db.NewIterator()};
+    it->Seek(first);
+    auto cached{after ? m_account_index.upper_bound(first) : m_account_index.lower_bound(first)};
+    TokenAccountIndexKey key;
+    while (tokens.size() < limit) {
+        std::optional<uint256> stored;
+        if (it->Valid() && it->GetKey(key) && in_range(key)) stored = key.token;
+        if (stored && after && *stored == *after) {
+            it->Next();
+            continue;
+        }
+        if (cached != m_account_index.end() && in_range(cached->first) && (!stored || !(*stored < cached->first.token))) {
+            if (stored && *stored == cached->first.token) it->Next();
+            if (cached->second.first) tokens.push_back(cached->first.token);
+            ++cached;
+        } else if (stored) {
+            tokens.push_back(*stored);
+            it->Next();
+        } else {
+            break;
+        }
+    }
+    return m_best_block;
+}
+
+void TokenLedgerCache::BatchWrite(const Changes& changes, const uint256& best_block)
+{
+    LOCK(m_mutex);
+    for (const auto& [key, amount] : changes.accounts) {
+        const auto it{FetchEntry(key)};
+        Entry& entry{it->second};
+        if (entry.amount == amount) continue;
+        // Balances, but not allowances, are in the account index while nonzero.
+        if (key.spender.IsNull() && (entry.amount == 0) != (amount == 0)) {
+            m_account_index.insert_or_assign(TokenAccountIndexKey{DB_HOLDING, key.owner, key.token}, std::make_pair(amount != 0, true));
+        }
+        if ((entry.flags & Entry::FRESH) && amount == 0) {
+            // Never written, so there is nothing to erase from the database either.
+            m_accounts.erase(it);
+            continue;
+        }
+        entry.amount = amount;
+        entry.flags |= Entry::DIRTY;
+    }
+    for (const auto& [id, info] : changes.tokens) {
+        const std::optional<TokenInfo> previous{ReadToken(id)};
+        if (previous && (!info || info->issuer != previous->issuer)) {
+            m_account_index.insert_or_assign(TokenAccountIndexKey{DB_ISSUED, previous->issuer, id}, std::make_pair(false, true));
+        }
+        if (info && (!previous || previous->issuer != info->issuer)) {
+            m_account_index.insert_or_assign(TokenAccountIndexKey{DB_ISSUED, info->issuer, id}, std::make_pair(true, true));
+        }
+        m_tokens.insert_or_assign(id, std::make_pair(info, true));
+    }
+    m_best_block = best_block;
+}
+
+void TokenLedgerCache::Flush(CDBBatch& batch)
+{
+    LOCK(m_mutex);
+    const bool evict{memusage::DynamicUsage(m_accounts) > m_max_usage};
+    for (auto it{m_accounts.begin()}; it != m_accounts.end();) {
+        it = evict && !(it->second.flags & Entry::DIRTY) ? m_accounts.erase(it) : std::next(it);
+    }
+    for (auto it{m_tokens.begin()}; it != m_tokens.end();) {
+        it = it->second.second ? std::next(it) : m_tokens.erase(it);
+    }
+    for (auto it{m_account_index.begin()}; it != m_account_index.end();) {
+        it = it->second.second ? std::next(it) : m_account_index.erase(it);
+    }
+
+    for (auto& [key, entry] : m_accounts) {
+        if (!(entry.flags & Entry::DIRTY)) continue;
+        if (entry.amount == 0) {
+            batch.Erase(std::make_pair(DB_ACCOUNT, key));
+            entry.flags = Entry::FRESH;
+        } else {
+            batch.Write(std::make_pair(DB_ACCOUNT, key), entry.amount);
+            entry.flags = 0;
+        }
+    }
+    for (auto& [id, item] : m_tokens) {
+        auto& [info, dirty]{item};
+        if (info) {
+            batch.Write(std::make_pair(DB_TOKEN, id), *info);
+        } else {
+            batch.Erase(std::make_pair(DB_TOKEN, id));
+        }
+        dirty = false;
+    }
+    for (auto& [key, item] : m_account_index) {
+        auto& [exists, dirty]{item};
+        if (exists) {
+            batch.Write(key, true);
+        } else {
+            batch.Erase(key);
+        }
+        dirty = false;
+    }
+}
+
+void TokenLedgerCache::SetBestBlock(const uint256& best_block)
+{
+    LOCK(m_mutex);
+    m_best_block = best_block;
+}
+
+size_t TokenLedgerCache::DynamicMemoryUsage() const
+{
+    LOCK(m_mutex);
+    return memusage::DynamicUsage(m_accounts);
+}
+
+namespace {
+
+/** The changes of one block, staged on top of the cache and recorded in its undo record as they are made. */
+class BlockChanges
+{
+    const TokenLedgerCache& m_cache;
+    TokenLedgerCache::Changes m_changes;
+    TokenBlockUndo& m_undo;
+
+public:
+    BlockChanges(const TokenLedgerCache& cache, TokenBlockUndo& undo) : m_cache(cache), m_undo(undo) {}
+
+    uint64_t GetAmount(const TokenAccountKey& key) const
+    {
+        if (auto it{m_changes.accounts.find(key)}; it != m_changes.accounts.end()) return it->second;
+        return m_cache.GetAmount(key);
+    }
+
+    void SetAmount(const TokenAccountKey& key, uint64_t amount)
+    {
+        if (m_changes.accounts.count(key) == 0) m_undo.accounts.emplace_back(key, m_cache.GetAmount(key));
+        m_changes.accounts[key] = amount;
+    }
+
+    std::optional<TokenInfo> GetToken(const uint256& id) const
+    {
+        if (auto it{m_changes.tokens.find(id)}; it != m_changes.tokens.end()) return it->second;
+        return m_cache.GetToken(id);
+    }
+
+    void SetToken(const uint256& id, const TokenInfo& info)
+    {
+        if (m_changes.tokens.count(id) == 0) m_undo.tokens.emplace_back(id, m_cache.GetToken(id));
+        m_changes.tokens[id] = info;
+    }
+
+    bool Empty() const { return m_changes.accounts.empty() && m_changes.tokens.empty(); }
+    const TokenLedgerCache::Changes& Get() const { return m_changes; }
+};
+
+/** Move amount from one balance to another, if from holds enough. */
+bool Transfer(BlockChanges& changes, const uint256& token, const uint160& from, const uint160& to, uint64_t amount)
+{
+    const TokenAccountKey from_key{token, from, uint160{}}, to_key{token, to, uint160{}};
+    const uint64_t from_balance{changes.GetAmount(from_key)};
+    if (amount > from_balance) return false;
+    changes.SetAmount(from_key, from_balance - amount);
+    // Balances add up to the supply, which is at most MAX_TOKEN_SUPPLY.
+    changes.SetAmount(to_key, changes.GetAmount(to_key) + amount);
+    return true;
+}
+
+/** Apply op sent by sender in transaction txid. Operations that are not valid against the ledger are skipped. */
+void ApplyTokenOperation(BlockChanges& changes, const TokenOperation& op, const uint160& sender, const uint256& txid, int height)
+{
+    switch (op.type) {
+    case TokenOpType::ISSUE: {
+        if (op.name.empty() || op.symbol.empty() || op.decimals > MAX_TOKEN_DECIMALS || op.amount > MAX_SUPPLY) return;
+        if (changes.GetToken(txid)) return;
+        changes.SetToken(txid, TokenInfo{op.name, op.symbol, op.decimals, sender, op.amount, height});
+        changes.SetAmount({txid, sender, uint160{}}, op.amount);
+        return;
+    }
+    case TokenOpType::TRANSFER: {
+        if (op.amount == 0 || !changes.GetToken(op.token)) return;
+        Transfer(changes, op.token, sender, op.to, op.amount);
+        return;
+    }
+    case TokenOpType::MINT: {
+        std::optional<TokenInfo> info{changes.GetToken(op.token)};
+        if (op.amount == 0 || !info || info->issuer != sender) return;
+        if (op.amount > MAX_SUPPLY - info->supply) return;
+        info->supply += op.amount;
+        changes.SetToken(op.token, *info);
+        const TokenAccountKey to_key{op.token, op.to, uint160{}};
+        changes.SetAmount(to_key, changes.GetAmount(to_key) + op.amount);
+        return;
+    }
+    case TokenOpType::BURN: {
+        std::optional<TokenInfo> info{changes.GetToken(op.token)};
+        const TokenAccountKey key{op.token, sender, uint160{}};
+        const uint64_t balance{changes.GetAmount(key)};
+        if (op.amount == 0 || !info || op.amount > balance) return;
+        info->supply -= op.amount;
+        changes.SetToken(op.token, *info);
+        changes.SetAmount(key, balance - op.amount);
+        return;
+    }
+    case TokenOpType::APPROVE: {
+        if (op.to.IsNull() || op.to == sender || !changes.GetToken(op.token)) return;
+        changes.SetAmount({op.token, sender, op.to}, op.amount);
+        return;
+    }
+    case TokenOpType::TRANSFER_FROM: {
+        const TokenAccountKey allowance_key{op.token, op.from, sender};
+        const uint64_t allowance{changes.GetAmount(allowance_key)};
+        if (op.amount == 0 || op.amount > allowance || !changes.GetToken(op.token)) return;
+        if (!Transfer(changes, op.token, op.from, op.to, op.amount)) return;
+        changes.SetAmount(allowance_key, allowance - op.amount);
+        return;
+    }
+    } // no default case, so the compiler can warn about missing cases
+}
+
+bool HasTokenOperations(const CBlock& block)
+{
+    for (const auto& tx : block.vtx) {
+        for (const auto& txout : tx->vout) {
+            if (ParseTokenOperation(txout.scriptPubKey)) return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+/** Access to the token index database (indexes/tokenindex/) */
+class TokenIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+};
+
+TokenIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "tokenindex", n_cache_size, f_memory, f_wipe)
+{}
+
+TokenIndex::TokenIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "tokenindex"), m_db(std::make_unique<TokenIndex::DB>(n_cache_size, f_memory, f_wipe)),
+      m_cache(*m_db, TOKEN_LEDGER_CACHE_SIZE)
+{}
+
+TokenIndex::~TokenIndex() = default;
+
+BaseIndex::DB& TokenIndex::GetDB() const { return *m_db; }
+
+std::optional<TokenBlockUndo> TokenIndex::ReadUndo(int height) const
+{
+    if (auto it{m_undo.find(height)}; it != m_undo.end()) return it->second;
+    TokenBlockUndo undo;
+    if (!m_db->Read(std::make_pair(DB_UNDO, height), undo)) return std::nullopt;
+    return undo;
+}
+
+bool TokenIndex::CustomInit(const std::optional<interfaces::BlockKey>& block)
+{
+    // The ledger is committed together with the locator, so it is as of block.
+    m_cache.SetBestBlock(block ? block->hash : uint256{});
+    return true;
+}
+
+bool TokenIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    assert(block.data);
+    // The sender of an operation is the script its transaction's first input spends.
+    CBlockUndo block_undo;
+    if (block.height > 0 && HasTokenOperations(*block.data)) {
+        const CBlockIndex* block_index{WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(block.hash))};
+        if (!m_chainstate->m_blockman.UndoReadFromDisk(block_undo, *Assert(block_index))) {
+            return error("%s: Failed to read undo data of block %s", __func__, block.hash.ToString());
+        }
+    }
+
+    TokenBlockUndo undo;
+    undo.block_hash = block.hash;
+    BlockChanges changes{m_cache, undo};
+    // The coinbase has no inputs to authorize an operation, so start at 1.
+    for (size_t i = 1; i < block.data->vtx.size(); ++i) {
+        const CTransaction& tx{*block.data->vtx[i]};
+        std::optional<TokenOperation> op;
+        for (const auto& txout : tx.vout) {
+            if ((op = ParseTokenOperation(txout.scriptPubKey))) break;
+        }
+        if (!op) continue;
+        const uint160 sender{GetTokenAccount(block_undo.vtxundo.at(i - 1).vprevout.at(0).out.scriptPubKey)};
+        ApplyTokenOperation(changes, *op, sender, tx.GetHash(), block.height);
+    }
+
+    m_cache.BatchWrite(changes.Get(), block.hash);
+    // A block without changes leaves no record; one left at its height by a stale block is erased.
+    m_undo[block.height] = changes.Empty() ? std::nullopt : std::make_optional(std::move(undo));
+    // Without pruning a reorg can go back any distance, so every record is kept.
+    if (m_chainstate->m_blockman.IsPruneMode() && block.height >= TOKEN_UNDO_DEPTH) {
+        m_undo[block.height - TOKEN_UNDO_DEPTH] = std::nullopt;
+    }
+    return true;
+}
+
+bool TokenIndex::CustomCommit(CDBBatch& batch)
+{
+    // CDBWrapper::WriteBatch throws rather than fail, so the entries marked
+    // clean here are written before the cache is flushed again.
+    m_cache.Flush(batch);
+    for (const auto& [height, undo] : m_undo) {
+        if (undo) {
+            batch.Write(std::make_pair(DB_UNDO, height), *undo);
+        } else {
+            batch.Erase(std::make_pair(DB_UNDO, height));
+        }
+    }
+    m_undo.clear();
+    return true;
+}
+
+bool TokenIndex::CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip)
+{
+    if (m_chainstate->m_blockman.IsPruneMode() && current_tip.height - new_tip.height > TOKEN_UNDO_DEPTH) {
+        return error("%s: Cannot revert %d blocks of the token ledger; please rebuild the index", __func__,
+                     current_tip.height - new_tip.height);
+    }
+
+    const CBlockIndex* iter_tip{WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(current_tip.hash))};
+    while (iter_tip->nHeight > new_tip.height) {
+        TokenLedgerCache::Changes changes;
+        const std::optional<TokenBlockUndo> undo{ReadUndo(iter_tip->nHeight)};
+        if (undo && undo->block_hash == iter_tip->GetBlockHash()) {
+            for (const auto& [key, amount] : undo->accounts) changes.accounts.emplace(key, amount);
+            for (const auto& [id, info] : undo->tokens) changes.tokens.emplace(id, info);
+            m_undo[iter_tip->nHeight] = std::nullopt;
+        }
+        iter_tip = iter_tip->pprev;
+        m_cache.BatchWrite(changes, iter_tip->GetBlockHash());
+    }
+    return true;
+}
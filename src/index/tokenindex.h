@@ -0,0 +1,304 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SHAHCOIN_INDEX_TOKENINDEX_H
+#define SHAHCOIN_INDEX_TOKENINDEX_H
+
+#include <index/base.h>
+#include <serialize.h>
+#include <span.h>
+#include <sync.h>
+#include <uint256.h>
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+static constexpr bool DEFAULT_TOKENINDEX{false};
+
+/** Memory the token ledger cache may use before a commit evicts its clean entries. */
+static constexpr size_t TOKEN_LEDGER_CACHE_SIZE{32 << 20};
+
+/** A token issued by a TokenOpType::ISSUE operation, identified by the issuing txid. */
+struct TokenInfo {
+    std::string name;
+    std::string symbol;
+    uint8_t decimals{0};
+    //! Account that issued the token and may mint more of it
+    uint160 issuer;
+    //! Sum of all balances
+    uint64_t supply{0};
+    int height{0};
+
+    SERIALIZE_METHODS(TokenInfo, obj) { READWRITE(obj.name, obj.symbol, obj.decimals, obj.issuer, obj.supply, obj.height); }
+};
+
+/** The balance of owner in token, or with a non-null spender, the allowance owner granted spender. */
+struct TokenAccountKey {
+    uint256 token;
+    uint160 owner;
+    uint160 spender;
+
+    SERIALIZE_METHODS(TokenAccountKey, obj) { READWRITE(obj.token, obj.owner, obj.spender); }
+
+    friend bool operator==(const TokenAccountKey& a, const TokenAccountKey& b)
+    {
+        return a.token == b.token && a.owner == b.owner && a.spender == b.spender;
+    }
+    friend bool operator<(const TokenAccountKey& a, const TokenAccountKey& b)
+    {
+        return std::tie(a.token, a.owner, a.spender) < std::tie(b.token, b.owner, b.spender);
+    }
+};
+
+/**
+ * Entry of the account index, which lists the tokens an account holds a
+ * nonzero balance of, and those it issued. The kind is the database key
+ * prefix, so the entries of one account and kind are one range of keys.
+ */
+struct TokenAccountIndexKey {
+    uint8_t kind{0};
+    uint160 account;
+    uint256 token;
+
+    SERIALIZE_METHODS(TokenAccountIndexKey, obj) { READWRITE(obj.kind, obj.account, obj.token); }
+
+    friend bool operator<(const TokenAccountIndexKey& a, const TokenAccountIndexKey& b)
+    {
+        return std::tie(a.kind, a.account, a.token) < std::tie(b.kind, b.account, b.token);
+    }
+};
+
+class TokenAccountKeyHasher
+{
+    const uint64_t m_k0, m_k1;
+
+public:
+    TokenAccountKeyHasher();
+    size_t operator()(const TokenAccountKey& key) const;
+};
+
+/**
+ * The previous value of every account and token a block changed, so that
+ * reverting the block restores them exactly. A zero account and an absent
+ * token are deleted on restore.
+ */
+struct TokenBlockUndo {
+    uint256 block_hash;
+    std::vector<std::pair<TokenAccountKey, uint64_t>> accounts;
+    std::vector<std::pair<uint256, std::optional<TokenInfo>>> tokens;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << block_hash << accounts;
+        WriteCompactSize(s, tokens.size());
+        for (const auto& [id, info] : tokens) {
+            s << id << bool{info.has_value()};
+            if (info) s << *info;
+        }
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        s >> block_hash >> accounts;
+        tokens.resize(ReadCompactSize(s));
+        for (auto& [id, info] : tokens) {
+            bool exists;
+            s >> id >> exists;
+            if (exists) s >> info.emplace();
+        }
+    }
+};
+
+/**
+ * Write-back cache of the token ledger database, modeled on CCoinsViewCache.
+ *
+ * Accounts read from the database stay cached, so a repeated balance query is
+ * one hash table lookup. Changes are applied a block at a time and marked
+ * DIRTY until Flush() adds them to the batch that also commits the index's
+ * best block. Entries for keys the database does not have are FRESH, and a
+ * FRESH entry that returns to zero is dropped without touching the database.
+ *
+ * The account index is kept up to date as balances become zero or nonzero
+ * and tokens are issued, so listing an account's tokens is a range scan.
+ *
+ * Readers on other threads always see the ledger as of one whole block.
+ */
+class TokenLedgerCache
+{
+public:
+    struct Entry {
+        uint64_t amount{0};
+        uint8_t flags{0};
+
+        enum Flags : uint8_t {
+            //! Differs from the database
+            DIRTY = (1 << 0),
+            //! The database has no entry for the key
+            FRESH = (1 << 1),
+        };
+    };
+
+    /** The new values of the accounts and tokens one block changed. */
+    struct Changes {
+        std::map<TokenAccountKey, uint64_t> accounts;
+        //! nullopt deletes the token
+        std::map<uint256, std::optional<TokenInfo>> tokens;
+    };
+
+    TokenLedgerCache(CDBWrapper& db, size_t max_usage);
+
+    uint64_t GetAmount(const TokenAccountKey& key) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    std::optional<TokenInfo> GetToken(const uint256& token) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Amounts of several accounts of one token, all as of the returned block. */
+    uint256 GetAmounts(const uint256& token, Span<const uint160> owners, std::vector<uint64_t>& amounts) const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /**
+     * Up to limit tokens in id order, starting after the token `after` or at
+     * the first token without it, all as of the returned block. Walks the
+     * database in key order merged with the cached tokens, so a page costs
+     * O(limit) however many tokens there are.
+     */
+    uint256 ListTokens(const std::optional<uint256>& after, size_t limit, std::vector<std::pair<uint256, TokenInfo>>& tokens) const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Up to limit tokens in id order, after `after`, that account holds a nonzero balance of; as of the returned block. */
+    uint256 GetHeldTokens(const uint160& account, const std::optional<uint256>& after, size_t limit, std::vector<uint256>& tokens) const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Up to limit tokens in id order, after `after`, that account issued; as of the returned block. */
+    uint256 GetIssuedTokens(const uint160& account, const std::optional<uint256>& after, size_t limit, std::vector<uint256>& tokens) const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Apply the changes of a block, after which the ledger is as of best_block. */
+    void BatchWrite(const Changes& changes, const uint256& best_block) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /**
+     * Add the dirty entries to batch and mark them clean. Clean entries were
+     * written by an earlier flush, so the cache can evict them here when it is
+     * over its memory budget.
+     */
+    void Flush(CDBBatch& batch) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    void SetBestBlock(const uint256& best_block) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    size_t DynamicMemoryUsage() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    using AccountMap = std::unordered_map<TokenAccountKey, Entry, TokenAccountKeyHasher>;
+
+    CDBWrapper& m_db;
+    const size_t m_max_usage;
+
+    mutable Mutex m_mutex;
+    mutable AccountMap m_accounts GUARDED_BY(m_mutex);
+    //! Changed tokens and whether they are dirty; clean ones go at the next flush
+    std::map<uint256, std::pair<std::optional<TokenInfo>, bool>> m_tokens GUARDED_BY(m_mutex);
+    //! Changed account index entries, whether they exist and whether they are dirty
+    std::map<TokenAccountIndexKey, std::pair<bool, bool>> m_account_index GUARDED_BY(m_mutex);
+    uint256 m_best_block GUARDED_BY(m_mutex);
+
+    AccountMap::iterator FetchEntry(const TokenAccountKey& key) const EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    std::optional<TokenInfo> ReadToken(const uint256& token) const EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    uint256 GetAccountTokens(uint8_t kind, const uint160& account, const std::optional<uint256>& after, size_t limit,
+                             std::vector<uint256>& tokens) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+};
+
+/**
+ * TokenIndex keeps the token ledger of the active chain: the issued tokens,
+ * and the balances and allowances of every account, as changed by the
+ * TokenOperation outputs of its transactions (see tokens/token_script.h).
+ *
+ * Every appended block leaves an undo record with the previous values of
+ * what it changed, and a reorg reverts disconnected blocks from those records
+ * instead of replaying the chain. Records are kept for every block, or for the
+ * last TOKEN_UNDO_DEPTH blocks when pruning, which cannot reorg deeper anyway.
+ * Ledger changes, undo records and the best block locator are written in one
+ * batch on commit, so the database is always consistent with its locator.
+ */
+class TokenIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+    TokenLedgerCache m_cache;
+
+    //! Undo records not yet committed, by height; nullopt erases
+    std::map<int, std::optional<TokenBlockUndo>> m_undo;
+
+    bool AllowPrune() const override { return true; }
+
+    std::optional<TokenBlockUndo> ReadUndo(int height) const;
+
+protected:
+    bool CustomInit(const std::optional<interfaces::BlockKey>& block) override;
+
+    bool CustomAppend(const interfaces::BlockInfo& block) override;
+
+    bool CustomCommit(CDBBatch& batch) override;
+
+    bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit TokenIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~TokenIndex() override;
+
+    /// Number of blocks a reorg can revert when pruning.
+    static constexpr int TOKEN_UNDO_DEPTH{288};
+
+    std::optional<TokenInfo> GetToken(const uint256& token) const { return m_cache.GetToken(token); }
+
+    /// Balance of account in token.
+    uint64_t GetTokenBalance(const uint256& token, const uint160& account) const { return m_cache.GetAmount({token, account, uint160{}}); }
+
+    /// Amount of owner's token that spender may transfer.
+    uint64_t GetTokenAllowance(const uint256& token, const uint160& owner, const uint160& spender) const
+    {
+        return m_cache.GetAmount({token, owner, spender});
+    }
+
+    /// Up to limit tokens in id order after `after`, all as of the returned block.
+    uint256 ListTokens(const std::optional<uint256>& after, size_t limit, std::vector<std::pair<uint256, TokenInfo>>& tokens) const
+    {
+        return m_cache.ListTokens(after, limit, tokens);
+    }
+
+    /// Up to limit tokens in id order after `after` that account holds, all as of the returned block.
+    uint256 GetHeldTokens(const uint160& account, const std::optional<uint256>& after, size_t limit, std::vector<uint256>& tokens) const
+    {
+        return m_cache.GetHeldTokens(account, after, limit, tokens);
+    }
+
+    /// Up to limit tokens in id order after `after` that account issued, all as of the returned block.
+    uint256 GetIssuedTokens(const uint160& account, const std::optional<uint256>& after, size_t limit, std::vector<uint256>& tokens) const
+    {
+        return m_cache.GetIssuedTokens(account, after, limit, tokens);
+    }
+
+    /// Balances of accounts in token, all as of the returned block.
+    uint256 GetTokenBalances(const uint256& token, Span<const uint160> accounts, std::vector<uint64_t>& balances) const
+    {
+        return m_cache.GetAmounts(token, accounts, balances);
+    }
+};
+
+/// The global token index. May be null.
+extern std::unique_ptr<TokenIndex> g_token_index;
+
+#endif // SHAHCOIN_INDEX_TOKENINDEX_H
@@ -3,6 +3,8 @@
 
 #include <kernel/context.h>
 
+#include <crypto/groestl.h>
+#include <crypto/scrypt.h>
 #include <crypto/sha256.h>
 #include <key.h>
 #include <logging.h>
@@ -21,6 +23,10 @@ Context::Context()
     g_context = this;
     std::string sha256_algo = SHA256AutoDetect();
     LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+    std::string scrypt_algo = ScryptAutoDetect();
+    LogPrintf("Using the '%s' scrypt implementation\n", scrypt_algo);
+    std::string groestl_algo = GroestlAutoDetect();
+    LogPrintf("Using the '%s' Groestl implementation\n", groestl_algo);
     RandomInit();
     ECC_Start();
 }
@@ -4,6 +4,7 @@
 #ifndef SHAHCOIN_KERNEL_VALIDATION_CACHE_SIZES_H
 #define SHAHCOIN_KERNEL_VALIDATION_CACHE_SIZES_H
 
+#include <pow_cache.h>
 #include <script/sigcache.h>
 
 #include <cstddef>
@@ -13,6 +14,7 @@ namespace kernel {
 struct ValidationCacheSizes {
     size_t signature_cache_bytes{DEFAULT_MAX_SIG_CACHE_BYTES / 2};
     size_t script_execution_cache_bytes{DEFAULT_MAX_SIG_CACHE_BYTES / 2};
+    size_t pow_cache_bytes{DEFAULT_MAX_POW_CACHE_BYTES};
 };
 }
 
@@ -30,6 +30,7 @@
 #include <random.h>
 #include <reverse_iterator.h>
 #include <scheduler.h>
+#include <stake/double_sign_index.h>
 #include <streams.h>
 #include <sync.h>
 #include <timedata.h>
@@ -658,6 +659,8 @@ private:
     /** Update peer state based on received headers message */
     void UpdatePeerStateForReceivedHeaders(CNode& pfrom, Peer& peer, const CBlockIndex& last_header, bool received_new_header, bool may_have_more_headers)
         EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
+    /** Feed accepted PoS headers to g_double_sign_index and log any conflicts they reveal */
+    void RecordStakeHeaders(const std::vector<CBlockHeader>& headers) LOCKS_EXCLUDED(::cs_main);
 
     void SendBlockTransactions(CNode& pfrom, Peer& peer, const CBlock& block, const BlockTransactionsRequest& req);
 
@@ -2983,6 +2986,8 @@ void PeerManagerImpl::ProcessHeadersMessage(CNode& pfrom, Peer& peer,
         }
     }
 
+    RecordStakeHeaders(headers);
+
     UpdatePeerStateForReceivedHeaders(pfrom, peer, *pindexLast, received_new_header, nCount == MAX_HEADERS_RESULTS);
 
     // Consider immediately downloading blocks.
@@ -2991,6 +2996,29 @@ void PeerManagerImpl::ProcessHeadersMessage(CNode& pfrom, Peer& peer,
     return;
 }
 
+void PeerManagerImpl::RecordStakeHeaders(const std::vector<CBlockHeader>& headers)
+{
+    if (!g_double_sign_index) return;
+
+    std::vector<std::pair<const CBlockHeader*, int>> accepted;
+    {
+        LOCK(cs_main);
+        for (const CBlockHeader& header : headers) {
+            if (!header.IsProofOfStake()) continue;
+            const CBlockIndex* pindex{m_chainman.m_blockman.LookupBlockIndex(header.GetHash())};
+            if (pindex && !(pindex->nStatus & BLOCK_FAILED_MASK)) accepted.emplace_back(&header, pindex->nHeight);
+        }
+    }
+    for (const auto& [header, height] : accepted) {
+        if (const auto conflict{g_double_sign_index->AddHeader(*header, height)}) {
+            // Headers are not signed by their staker, so this is not proof of double signing.
+            LogPrintf("Conflicting PoS headers for stake %s at height %d: %s and %s\n",
+                      header->hashStake.ToString(), height, conflict->first.GetHash().ToString(),
+                      conflict->second.GetHash().ToString());
+        }
+    }
+}
+
 bool PeerManagerImpl::ProcessOrphanTx(Peer& peer)
 {
     AssertLockHeld(g_msgproc_mutex);
@@ -3246,6 +3274,7 @@ void PeerManagerImpl::ProcessBlock(CNode& node, const std::shared_ptr<const CBlo
     bool new_block{false};
     m_chainman.ProcessNewBlock(block, force_processing, min_pow_checked, &new_block);
     if (new_block) {
+        RecordStakeHeaders({block->GetBlockHeader()});
         node.m_last_block_time = GetTime<std::chrono::seconds>();
         // In case this block came from a different peer than we requested
         // from, we can erase the block request now anyway (as we just stored
@@ -4415,6 +4444,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
         if (received_new_header) {
             LogPrintfCategory(BCLog::NET, "Saw new cmpctblock header hash=%s peer=%d\n",
                 blockhash.ToString(), pfrom.GetId());
+            RecordStakeHeaders({cmpctblock.header});
         }
 
         bool fProcessBLOCKTXN = false;
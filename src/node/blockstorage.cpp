@@ -17,11 +17,13 @@
 #include <pow.h>
 #include <reverse_iterator.h>
 #include <signet.h>
+#include <stake/kernel_search.h>
 #include <streams.h>
 #include <sync.h>
 #include <undo.h>
 #include <util/batchpriority.h>
 #include <util/fs.h>
+#include <util/fs_helpers.h>
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/translation.h>
@@ -120,6 +122,7 @@ bool BlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, s
                 pindexNew->nNonce         = diskindex.nNonce;
                 pindexNew->nStatus        = diskindex.nStatus;
                 pindexNew->nTx            = diskindex.nTx;
+                pindexNew->nStakeModifier = diskindex.nStakeModifier;
 
                 if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nshahbits, consensusParams)) {
                     return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
@@ -211,6 +214,7 @@ CBlockIndex* BlockManager::AddToBlockIndex(const CBlockHeader& block, CBlockInde
         pindexNew->pprev = &(*miPrev).second;
         pindexNew->nHeight = pindexNew->pprev->nHeight + 1;
         pindexNew->BuildSkip();
+        UpdateLWMASums(*pindexNew, GetConsensus());
     }
     pindexNew->nTimeMax = (pindexNew->pprev ? std::max(pindexNew->pprev->nTimeMax, pindexNew->nTime) : pindexNew->nTime);
     pindexNew->nChainWork = (pindexNew->pprev ? pindexNew->pprev->nChainWork : 0) + GetBlockProof(*pindexNew);
@@ -430,6 +434,13 @@ bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockha
         }
         if (pindex->pprev) {
             pindex->BuildSkip();
+            UpdateLWMASums(*pindex, GetConsensus());
+        }
+        // Entries written before the stake modifier was persisted lack it. The genesis
+        // block is connected without being raised to BLOCK_VALID_SCRIPTS.
+        if (pindex->nStakeModifier == 0 && (!pindex->pprev || pindex->IsValid(BLOCK_VALID_SCRIPTS))) {
+            pindex->nStakeModifier = ComputeStakeModifier(pindex->pprev ? pindex->pprev->nStakeModifier : 0, pindex->GetBlockHash());
+            m_dirty_blockindex.insert(pindex);
         }
     }
 
@@ -458,6 +469,51 @@ bool BlockManager::WriteBlockIndexDB()
     return true;
 }
 
+static constexpr uint32_t FINALITY_CHECKPOINT_VERSION{1};
+
+static fs::path FinalityCheckpointPath(const fs::path& blocks_dir)
+{
+    return blocks_dir / "finality.dat";
+}
+
+std::optional<uint256> BlockManager::ReadFinalityCheckpoint() const
+{
+    CAutoFile file{fsbridge::fopen(FinalityCheckpointPath(m_opts.blocks_dir), "rb"), CLIENT_VERSION};
+    if (file.IsNull()) return std::nullopt;
+    try {
+        uint32_t version;
+        uint256 hash;
+        file >> version;
+        if (version != FINALITY_CHECKPOINT_VERSION) {
+            LogPrintf("Ignoring finality checkpoint with unknown version %d\n", version);
+            return std::nullopt;
+        }
+        file >> hash;
+        return hash;
+    } catch (const std::exception& e) {
+        LogPrintf("Failed to read finality checkpoint: %s. Continuing anyway.\n", e.what());
+        return std::nullopt;
+    }
+}
+
+bool BlockManager::WriteFinalityCheckpoint(const uint256& hash) const
+{
+    const fs::path path{FinalityCheckpointPath(m_opts.blocks_dir)};
+    const fs::path path_new{fs::PathFromString(fs::PathToString(path) + ".new")};
+    try {
+        CAutoFile file{fsbridge::fopen(path_new, "wb"), CLIENT_VERSION};
+        if (file.IsNull()) return false;
+        file << FINALITY_CHECKPOINT_VERSION << hash;
+        if (!FileCommit(file.Get())) throw std::runtime_error("FileCommit failed");
+        file.fclose();
+        if (!RenameOver(path_new, path)) throw std::runtime_error("Rename failed");
+    } catch (const std::exception& e) {
+        LogPrintf("Failed to write finality checkpoint: %s\n", e.what());
+        return false;
+    }
+    return true;
+}
+
 bool BlockManager::LoadBlockIndexDB(const std::optional<uint256>& snapshot_blockhash)
 {
     if (!LoadBlockIndex(snapshot_blockhash)) {
@@ -1008,7 +1064,7 @@ bool BlockManager::ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos) cons
     }
 
     // Check the header
-    if (!CheckProofOfWork(block.GetHash(), block.nshahbits, GetConsensus())) {
+    if (block.IsProofOfWork() && !CheckProofOfWork(GetPoWHash(block), block.nshahbits, GetConsensus())) {
         return error("ReadBlockFromDisk: Errors in block header at %s", pos.ToString());
     }
 
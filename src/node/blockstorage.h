@@ -288,6 +288,14 @@ public:
     bool LoadBlockIndexDB(const std::optional<uint256>& snapshot_blockhash)
         EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
+    /**
+     * Finality checkpoint: the most recent block this node recorded as irreversible.
+     * It is kept in the blocks directory, outside the block index database, so that
+     * it survives -reindex.
+     */
+    std::optional<uint256> ReadFinalityCheckpoint() const;
+    bool WriteFinalityCheckpoint(const uint256& hash) const;
+
     /**
      * Remove any pruned block & undo files that are still on disk.
      * This could happen on some systems if the file was still being read while unlinked,
@@ -7,6 +7,7 @@
 #include <chain.h>
 #include <coins.h>
 #include <consensus/params.h>
+#include <dex/dex_state.h>
 #include <logging.h>
 #include <node/blockstorage.h>
 #include <node/caches.h>
@@ -140,6 +141,18 @@ static ChainstateLoadResult CompleteChainstateInitialization(
         }
     }
 
+    // SHAHCOIN Core: DEX state follows the active chainstate and is wiped with it.
+    // Close a previously opened database first, as LevelDB locks its directory.
+    chainman.m_dex_state.reset();
+    chainman.m_dex_state = std::make_unique<DEXStateCache>(DBParams{
+        .path = chainman.m_options.datadir / "dexstate",
+        .cache_bytes = DEX_STATE_DB_CACHE,
+        .memory_only = options.coins_db_in_memory,
+        .wipe_data = options.reindex || options.reindex_chainstate});
+    if (auto result{chainman.ActiveChainstate().ReconcileDEXState()}; !result) {
+        return {ChainstateLoadStatus::FAILURE, util::ErrorString(result)};
+    }
+
     if (!options.reindex) {
         auto chainstates{chainman.GetAll()};
         if (std::any_of(chainstates.begin(), chainstates.end(),
@@ -10,6 +10,7 @@
 #include <net.h>
 #include <net_processing.h>
 #include <netgroup.h>
+#include <node/cpuminer.h>
 #include <node/kernel_notifications.h>
 #include <policy/fees.h>
 #include <scheduler.h>
@@ -32,6 +32,7 @@ class WalletLoader;
 } // namespace interfaces
 
 namespace node {
+class CPUMiner;
 class KernelNotifications;
 
 //! NodeContext struct containing references to chain state and connection
@@ -68,6 +69,8 @@ struct NodeContext {
     std::unique_ptr<CScheduler> scheduler;
     std::function<void()> rpc_interruption_point = [] {};
     std::unique_ptr<KernelNotifications> notifications;
+    //! Built-in miner, only present with -gen
+    std::unique_ptr<CPUMiner> cpuminer;
     std::atomic<int> exit_status{EXIT_SUCCESS};
 
     //! Declare default constructor and destructor that are not inline, so code
@@ -0,0 +1,274 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/cpuminer.h>
+
+#include <addresstype.h>
+#include <arith_uint256.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <common/args.h>
+#include <common/system.h>
+#include <consensus/merkle.h>
+#include <crypto/common.h>
+#include <crypto/sha256.h>
+#include <key_io.h>
+#include <logging.h>
+#include <pow.h>
+#include <pow_dispatch.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <streams.h>
+#include <sync.h>
+#include <tinyformat.h>
+#include <txmempool.h>
+#include <util/thread.h>
+#include <util/translation.h>
+#include <validation.h>
+#include <version.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace node {
+namespace {
+/** Offset of nNonce in a serialized header: after nVersion, hashPrevBlock, hashMerkleRoot, nTime and nshahbits. */
+constexpr size_t NONCE_OFFSET{4 + 32 + 32 + 4 + 4};
+/** Bytes of a serialized header covered by the sha256d midstate; they do not include the nonce. */
+constexpr size_t MIDSTATE_SIZE{64};
+static_assert(NONCE_OFFSET >= MIDSTATE_SIZE && NONCE_OFFSET + 4 <= BLOCK_HEADER_SIZE_POW);
+
+/** A template is rebuilt for new mempool transactions only once it is this old. */
+constexpr auto TEMPLATE_REFRESH_INTERVAL{std::chrono::seconds{60}};
+
+/** Nonces scanned between checks for interruption and a stale template, about 10-50ms of work. */
+uint32_t NoncesPerBatch(AlgoType algo)
+{
+    switch (algo) {
+    case AlgoType::SHA256D: return 1 << 16;
+    case AlgoType::GROESTL: return 1 << 12;
+    case AlgoType::SCRYPT: return 1 << 8;
+    case AlgoType::POS: break;
+    }
+    assert(false);
+}
+
+/** Replace the extranonce in the coinbase scriptSig, which the template leaves at 0, and update the merkle root. */
+void SetExtraNonce(CBlock& block, int height, uint32_t extra_nonce)
+{
+    CMutableTransaction coinbase{*block.vtx[0]};
+    coinbase.vin[0].scriptSig = CScript() << height << CScriptNum(int64_t{extra_nonce});
+    block.vtx[0] = MakeTransactionRef(std::move(coinbase));
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+}
+} // namespace
+
+bool ScanPoWNonces(CBlockHeader& header, uint32_t nonce_first, uint32_t nonce_last, uint64_t& hashes)
+{
+    assert(header.nBlockType == BLOCK_TYPE_POW);
+    assert(nonce_first <= nonce_last);
+    hashes = 0;
+
+    bool negative, overflow;
+    arith_uint256 target;
+    target.SetCompact(header.nshahbits, &negative, &overflow);
+    if (negative || overflow || target == 0) return false;
+
+    std::array<unsigned char, BLOCK_HEADER_SIZE_POW> data;
+    SpanWriter{PROTOCOL_VERSION, data} << header;
+
+    const AlgoType algo{header.GetAlgoType()};
+    CSHA256 midstate;
+    if (algo == AlgoType::SHA256D) midstate.Write(data.data(), MIDSTATE_SIZE);
+
+    uint256 hash;
+    for (uint32_t nonce = nonce_first;; ++nonce) {
+        WriteLE32(data.data() + NONCE_OFFSET, nonce);
+        if (algo == AlgoType::SHA256D) {
+            unsigned char inner[CSHA256::OUTPUT_SIZE];
+            CSHA256{midstate}.Write(data.data() + MIDSTATE_SIZE, data.size() - MIDSTATE_SIZE).Finalize(inner);
+            CSHA256().Write(inner, sizeof(inner)).Finalize(hash.begin());
+        } else {
+            GetPoWHash(Span{data}, algo, hash.begin());
+        }
+        ++hashes;
+        if (UintToArith256(hash) <= target || nonce == nonce_last) {
+            header.nNonce = nonce;
+            return UintToArith256(hash) <= target;
+        }
+    }
+}
+
+CPUMiner::CPUMiner(ChainstateManager& chainman, const CTxMemPool* mempool, Options options)
+    : m_chainman{chainman},
+      m_mempool{mempool},
+      m_options{std::move(options)}
+{
+    assert(m_options.threads_per_algo > 0);
+    for (const AlgoType algo : m_options.algos) {
+        auto pool{std::make_unique<AlgoPool>()};
+        pool->algo = algo;
+        m_pools.push_back(std::move(pool));
+    }
+}
+
+CPUMiner::~CPUMiner()
+{
+    Stop();
+}
+
+void CPUMiner::Start()
+{
+    assert(m_threads.empty());
+    m_interrupt.reset();
+    m_start_time = SteadyClock::now();
+    for (const auto& pool : m_pools) {
+        for (int worker = 0; worker < m_options.threads_per_algo; ++worker) {
+            m_threads.emplace_back(&util::TraceThread, strprintf("gen.%s.%i", AlgoName(pool->algo), worker),
+                                   [this, &pool = *pool, worker] { ThreadMine(pool, worker); });
+        }
+    }
+    LogPrintf("CPUMiner: started %d thread(s) for each of %d algorithm(s)\n", m_options.threads_per_algo, m_pools.size());
+}
+
+void CPUMiner::Interrupt()
+{
+    m_interrupt();
+}
+
+void CPUMiner::Stop()
+{
+    if (m_threads.empty()) return;
+    Interrupt();
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+    LogPrintf("CPUMiner: stopped\n");
+}
+
+std::vector<MinerAlgoStats> CPUMiner::GetStats() const
+{
+    const double elapsed{IsRunning() ? Ticks<SecondsDouble>(SteadyClock::now() - m_start_time) : 0.0};
+    std::vector<MinerAlgoStats> stats;
+    for (const auto& pool : m_pools) {
+        const uint64_t hashes{pool->hashes.load(std::memory_order_relaxed)};
+        stats.push_back(MinerAlgoStats{
+            .algo = pool->algo,
+            .threads = IsRunning() ? m_options.threads_per_algo : 0,
+            .hashes = hashes,
+            .hashes_per_sec = elapsed > 0 ? hashes / elapsed : 0.0,
+            .blocks = pool->blocks.load(std::memory_order_relaxed),
+        });
+    }
+    return stats;
+}
+
+void CPUMiner::ThreadMine(AlgoPool& pool, uint32_t worker)
+{
+    const CChainParams& chainparams{m_chainman.GetParams()};
+    const Consensus::Params& consensus{chainparams.GetConsensus()};
+    const uint32_t batch{NoncesPerBatch(pool.algo)};
+
+    // This worker's share of the nonce range of the template's own coinbase.
+    const uint32_t workers = m_options.threads_per_algo;
+    const uint32_t share = uint32_t((uint64_t{std::numeric_limits<uint32_t>::max()} + 1) / workers);
+    const uint32_t share_first = worker * share;
+    const uint32_t share_last = worker + 1 == workers ? std::numeric_limits<uint32_t>::max() : share_first + share - 1;
+
+    BlockAssembler::Options assembler_options{m_options.assembler};
+    assembler_options.algo = pool.algo;
+
+    while (!m_interrupt) {
+        if (!chainparams.MineBlocksOnDemand() && m_chainman.IsInitialBlockDownload()) {
+            // Mining on a chain that is still catching up would only produce stale blocks.
+            if (!m_interrupt.sleep_for(std::chrono::seconds{1})) return;
+            continue;
+        }
+
+        const unsigned int txs_updated{m_mempool ? m_mempool->GetTransactionsUpdated() : 0};
+        const auto template_time{SteadyClock::now()};
+        std::unique_ptr<CBlockTemplate> block_template;
+        try {
+            block_template = BlockAssembler{m_chainman.ActiveChainstate(), m_mempool, assembler_options}.CreateNewBlock(m_options.coinbase_script);
+        } catch (const std::runtime_error& e) {
+            LogPrintf("CPUMiner: %s\n", e.what());
+        }
+        if (!block_template) {
+            if (!m_interrupt.sleep_for(std::chrono::seconds{1})) return;
+            continue;
+        }
+        CBlock& block{block_template->block};
+        const CBlockIndex* pindex_prev{WITH_LOCK(::cs_main, return m_chainman.m_blockman.LookupBlockIndex(block.hashPrevBlock))};
+        assert(pindex_prev);
+        block.hashMerkleRoot = BlockMerkleRoot(block);
+
+        uint32_t nonce_first{share_first};
+        uint32_t nonce_last{share_last};
+        while (!m_interrupt) {
+            uint64_t hashes;
+            const uint32_t batch_last{nonce_last - nonce_first < batch ? nonce_last : nonce_first + batch - 1};
+            const bool found{ScanPoWNonces(block, nonce_first, batch_last, hashes)};
+            pool.hashes.fetch_add(hashes, std::memory_order_relaxed);
+
+            if (found && CheckProofOfWork(GetPoWHash(block), block.nshahbits, consensus)) {
+                auto shared_block{std::make_shared<const CBlock>(block)};
+                if (m_chainman.ProcessNewBlock(shared_block, /*force_processing=*/true, /*min_pow_checked=*/true, /*new_block=*/nullptr)) {
+                    pool.blocks.fetch_add(1, std::memory_order_relaxed);
+                    LogPrintf("CPUMiner: %s block %s found at height %d\n", AlgoName(pool.algo), shared_block->GetHash().ToString(), pindex_prev->nHeight + 1);
+                } else {
+                    LogPrintf("CPUMiner: %s block %s not accepted\n", AlgoName(pool.algo), shared_block->GetHash().ToString());
+                }
+                break;
+            }
+
+            const bool tip_changed{WITH_LOCK(::cs_main, return m_chainman.ActiveChain().Tip() != pindex_prev)};
+            const bool mempool_changed{m_mempool && m_mempool->GetTransactionsUpdated() != txs_updated &&
+                                       SteadyClock::now() - template_time > TEMPLATE_REFRESH_INTERVAL};
+            if (tip_changed || mempool_changed) break;
+
+            if (block.nNonce == nonce_last) {
+                // Range exhausted: roll the extranonce instead of assembling a new template. Every
+                // extranonce is handed out once, so the full nonce range is this worker's to scan.
+                SetExtraNonce(block, pindex_prev->nHeight + 1, pool.extra_nonce.fetch_add(1, std::memory_order_relaxed) + 1);
+                nonce_first = 0;
+                nonce_last = std::numeric_limits<uint32_t>::max();
+            } else {
+                nonce_first = block.nNonce + 1;
+            }
+            UpdateTime(&block, consensus, pindex_prev);
+        }
+    }
+}
+
+util::Result<void> ApplyArgsManOptions(const ArgsManager& args, CPUMiner::Options& options)
+{
+    ApplyArgsManOptions(args, options.assembler);
+
+    int threads{int(args.GetIntArg("-genproclimit", options.threads_per_algo))};
+    if (threads <= 0) threads = GetNumCores();
+    options.threads_per_algo = std::clamp(threads, 1, MAX_GENERATE_THREADS);
+
+    std::vector<std::string> algo_names{args.GetArgs("-genalgo")};
+    if (algo_names.empty()) algo_names.push_back(args.GetArg("-algo", AlgoName(AlgoType::SHA256D)));
+    options.algos.clear();
+    for (const std::string& name : algo_names) {
+        const auto algo{PoWAlgoFromName(name)};
+        if (!algo) {
+            return util::Error{strprintf(_("Unknown mining algorithm '%s' (sha256d, scrypt, groestl)"), name)};
+        }
+        if (std::find(options.algos.begin(), options.algos.end(), *algo) == options.algos.end()) {
+            options.algos.push_back(*algo);
+        }
+    }
+
+    const std::string address{args.GetArg("-mineraddress", "")};
+    const CTxDestination dest{DecodeDestination(address)};
+    if (!IsValidDestination(dest)) {
+        return util::Error{strprintf(_("-gen requires a valid -mineraddress (got '%s')"), address)};
+    }
+    options.coinbase_script = GetScriptForDestination(dest);
+    return {};
+}
+} // namespace node
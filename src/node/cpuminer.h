@@ -0,0 +1,116 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SHAHCOIN_NODE_CPUMINER_H
+#define SHAHCOIN_NODE_CPUMINER_H
+
+#include <consensus/hybrid.h>
+#include <node/miner.h>
+#include <script/script.h>
+#include <util/result.h>
+#include <util/threadinterrupt.h>
+#include <util/time.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class ArgsManager;
+class CTxMemPool;
+class ChainstateManager;
+
+namespace node {
+static constexpr bool DEFAULT_GENERATE{false};
+static constexpr int DEFAULT_GENERATE_THREADS{1};
+static constexpr int MAX_GENERATE_THREADS{64};
+
+/** Hash rate of the built-in miner for one algorithm. */
+struct MinerAlgoStats {
+    AlgoType algo;
+    int threads;
+    //! Hashes computed since the miner was started
+    uint64_t hashes;
+    double hashes_per_sec;
+    //! Blocks found and accepted by ProcessNewBlock
+    uint64_t blocks;
+};
+
+/**
+ * Built-in CPU miner, running a pool of worker threads for each configured
+ * proof-of-work algorithm.
+ *
+ * Every worker assembles its own block template and scans its share of the
+ * nonce space, so that workers of one algorithm on the same template never
+ * hash the same header. A worker that exhausts its share rolls the coinbase
+ * extranonce, taken from a counter shared by the pool, and scans the full
+ * nonce range again after recomputing the merkle root; the template is only
+ * rebuilt when the tip changes, or the mempool has changed and the template
+ * is more than a minute old.
+ */
+class CPUMiner
+{
+public:
+    struct Options {
+        //! Output script of the coinbase of mined blocks
+        CScript coinbase_script;
+        //! Algorithms to mine, each with its own worker pool
+        std::vector<AlgoType> algos;
+        int threads_per_algo{DEFAULT_GENERATE_THREADS};
+        //! Options of the templates assembled by the workers; algo is set per pool
+        BlockAssembler::Options assembler;
+    };
+
+    CPUMiner(ChainstateManager& chainman, const CTxMemPool* mempool, Options options);
+    ~CPUMiner();
+
+    CPUMiner(const CPUMiner&) = delete;
+    CPUMiner& operator=(const CPUMiner&) = delete;
+
+    void Start();
+    /** Ask the workers to stop, without waiting for them. */
+    void Interrupt();
+    /** Interrupt and join all workers. */
+    void Stop();
+    bool IsRunning() const { return !m_threads.empty(); }
+
+    std::vector<MinerAlgoStats> GetStats() const;
+
+private:
+    struct AlgoPool {
+        AlgoType algo;
+        std::atomic<uint64_t> hashes{0};
+        std::atomic<uint64_t> blocks{0};
+        //! Source of unique extranonces for workers that exhausted their nonce range
+        std::atomic<uint32_t> extra_nonce{0};
+    };
+
+    void ThreadMine(AlgoPool& pool, uint32_t worker);
+
+    ChainstateManager& m_chainman;
+    const CTxMemPool* const m_mempool;
+    const Options m_options;
+    std::vector<std::unique_ptr<AlgoPool>> m_pools;
+    std::vector<std::thread> m_threads;
+    CThreadInterrupt m_interrupt;
+    SteadyClock::time_point m_start_time;
+};
+
+/**
+ * Scan nonces nonce_first to nonce_last (inclusive) of a proof-of-work header for one
+ * whose algorithm-specific hash meets its nshahbits target. For sha256d the
+ * SHA256 midstate of the first 64 serialized bytes, which do not contain the
+ * nonce, is computed once and reused for every nonce.
+ *
+ * @param[in,out] header    Header to solve; nNonce is left at the solution, or at the last nonce tried.
+ * @param[out]    hashes    Number of hashes computed.
+ * @return whether a solution was found.
+ */
+bool ScanPoWNonces(CBlockHeader& header, uint32_t nonce_first, uint32_t nonce_last, uint64_t& hashes);
+
+/** Apply -genproclimit, -genalgo, -mineraddress and the block creation options to CPUMiner options. */
+[[nodiscard]] util::Result<void> ApplyArgsManOptions(const ArgsManager& args, CPUMiner::Options& options);
+} // namespace node
+
+#endif // SHAHCOIN_NODE_CPUMINER_H
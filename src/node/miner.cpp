@@ -40,7 +40,7 @@ int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParam
 
     // Updating time can change work required on testnet:
     if (consensusParams.fPowAllowMinDifficultyBlocks) {
-        pblock->nshahbits = GetNextWorkRequired(pindexPrev, pblock, consensusParams);
+        pblock->nshahbits = GetNextWorkRequiredHybrid(pindexPrev, *pblock, consensusParams);
     }
 
     return nNewTime - nOldTime;
@@ -168,46 +168,24 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     UpdateTime(pblock, chainparams.GetConsensus(), pindexPrev);
     
     // Hybrid consensus: Set algorithm and block type
-    AlgoType expectedAlgo;
-    
-    // Check if user specified a specific algorithm via -algo parameter
-    std::string algoParam = gArgs.GetArg("-algo", "");
-    if (!algoParam.empty()) {
-        // Parse user-specified algorithm
-        if (algoParam == "sha256d" || algoParam == "sha256") {
-            expectedAlgo = AlgoType::SHA256D;
-        } else if (algoParam == "scrypt") {
-            expectedAlgo = AlgoType::SCRYPT;
-        } else if (algoParam == "groestl") {
-            expectedAlgo = AlgoType::GROESTL;
+    AlgoType expectedAlgo = SelectNextAlgo(nHeight);
+    if (m_options.algo) {
+        expectedAlgo = *m_options.algo;
+    } else if (const std::string algoParam{gArgs.GetArg("-algo", "")}; !algoParam.empty()) {
+        // Check if user specified a specific algorithm via -algo parameter
+        if (const auto algo{PoWAlgoFromName(algoParam)}) {
+            expectedAlgo = *algo;
         } else {
             // Invalid algorithm specified, fall back to automatic selection
             LogPrintf("Warning: Invalid algorithm '%s' specified. Using automatic algorithm selection.\n", algoParam);
-            expectedAlgo = SelectNextAlgo(nHeight);
         }
-    } else {
-        // No algorithm specified, use automatic selection
-        expectedAlgo = SelectNextAlgo(nHeight);
     }
     
     pblock->SetAlgoType(expectedAlgo);
     pblock->SetBlockType(BLOCK_TYPE_POW); // Default to PoW for mining
     
-    // Set difficulty based on algorithm
-    switch (expectedAlgo) {
-        case AlgoType::SHA256D:
-            pblock->nshahbits = GetNextWorkRequiredSHA256(pindexPrev, chainparams.GetConsensus());
-            break;
-        case AlgoType::SCRYPT:
-            pblock->nshahbits = GetNextWorkRequiredScrypt(pindexPrev, chainparams.GetConsensus());
-            break;
-        case AlgoType::GROESTL:
-            pblock->nshahbits = GetNextWorkRequiredGroestl(pindexPrev, chainparams.GetConsensus());
-            break;
-        default:
-            pblock->nshahbits = GetNextWorkRequired(pindexPrev, pblock, chainparams.GetConsensus());
-            break;
-    }
+    // Set difficulty based on algorithm; O(1) from the LWMA sums cached on pindexPrev's chain
+    pblock->nshahbits = GetNextWorkRequiredHybrid(pindexPrev, *pblock, chainparams.GetConsensus());
     
     pblock->nNonce         = 0;
     pblocktemplate->vTxSigOpsCost[0] = WITNESS_SCALE_FACTOR * GetLegacySigOpCount(*pblock->vtx[0]);
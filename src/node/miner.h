@@ -157,6 +157,8 @@ public:
         CFeeRate blockMinFeeRate{DEFAULT_BLOCK_MIN_TX_FEE};
         // Whether to call TestBlockValidity() at the end of CreateNewBlock().
         bool test_block_validity{true};
+        // Proof-of-work algorithm of the block; unset means -algo, or the rotation if that is not given.
+        std::optional<AlgoType> algo;
     };
 
     explicit BlockAssembler(Chainstate& chainstate, const CTxMemPool* mempool);
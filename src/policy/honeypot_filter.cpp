@@ -11,6 +11,8 @@
 #include <crypto/sha256.h>
 
 #include <algorithm>
+#include <array>
+#include <memory>
 #include <sstream>
 
 // Global honeypot filter manager instance
@@ -21,21 +23,25 @@ CHoneypotFilterManager::CHoneypotFilterManager()
 {
     m_stats = {0, 0, 0, {}, GetTime()};
     
-    // Initialize known spam patterns
-    m_knownSpamPatterns = {
-        "OP_DUP OP_HASH160",           // Common spam pattern
-        "OP_EQUALVERIFY OP_CHECKSIG",  // Another common pattern
-        "OP_RETURN OP_0",              // Empty OP_RETURN
-        "OP_RETURN OP_1",              // Single byte OP_RETURN
-    };
+    RateLimitSketch::Options rateLimitOptions;
+    rateLimitOptions.window = m_config.rateLimitWindow;
+    std::atomic_store(&m_rateLimitTracker, std::make_shared<RateLimitSketch>(rateLimitOptions));
+    
+    // Patterns are keyed on the push-range bytes of a script (see
+    // ScriptPatternMatcher::MatchPushBytes) and must equal the whole key.
+    using Anchor = ScriptPatternMatcher::Anchor;
+    m_knownSpamPatterns.AddPattern({OP_DUP, OP_HASH160}, Anchor::WHOLE_SCRIPT);           // Truncated P2PKH
+    m_knownSpamPatterns.AddPattern({OP_EQUALVERIFY, OP_CHECKSIG}, Anchor::WHOLE_SCRIPT);  // Truncated P2PKH
+    m_knownSpamPatterns.AddPattern({OP_RETURN, OP_0}, Anchor::WHOLE_SCRIPT);              // Empty OP_RETURN
+    m_knownSpamPatterns.AddPattern({OP_RETURN, OP_1}, Anchor::WHOLE_SCRIPT);              // Single byte OP_RETURN
+    m_knownSpamPatterns.Compile();
     
     // Initialize known exploit patterns
-    m_knownExploitPatterns = {
-        "OP_VERIFY OP_VERIFY",         // Double verify exploit
-        "OP_IF OP_VERIFY OP_ENDIF",    // Conditional verify exploit
-        "OP_DUP OP_DUP OP_DUP",        // Excessive duplication
-        "OP_HASH160 OP_HASH160",       // Double hashing exploit
-    };
+    m_knownExploitPatterns.AddPattern({OP_VERIFY, OP_VERIFY}, Anchor::WHOLE_SCRIPT);          // Double verify exploit
+    m_knownExploitPatterns.AddPattern({OP_IF, OP_VERIFY, OP_ENDIF}, Anchor::WHOLE_SCRIPT);    // Conditional verify exploit
+    m_knownExploitPatterns.AddPattern({OP_DUP, OP_DUP, OP_DUP}, Anchor::WHOLE_SCRIPT);        // Excessive duplication
+    m_knownExploitPatterns.AddPattern({OP_HASH160, OP_HASH160}, Anchor::WHOLE_SCRIPT);        // Double hashing exploit
+    m_knownExploitPatterns.Compile();
 }
 
 CHoneypotFilterManager::~CHoneypotFilterManager()
@@ -44,90 +50,43 @@ CHoneypotFilterManager::~CHoneypotFilterManager()
 
 void CHoneypotFilterManager::SetConfig(const HoneypotFilterConfig& config)
 {
+    if (config.rateLimitWindow != m_config.rateLimitWindow) {
+        RateLimitSketch::Options rateLimitOptions;
+        rateLimitOptions.window = config.rateLimitWindow;
+        std::atomic_store(&m_rateLimitTracker, std::make_shared<RateLimitSketch>(rateLimitOptions));
+    }
     m_config = config;
     LogPrint(BCLog::POLICY, "Honeypot filter configuration updated\n");
 }
 
 HoneypotFilterResult CHoneypotFilterManager::CheckTransaction(const CTransaction& tx)
 {
-    HoneypotFilterResult result;
-    result.timestamp = GetTime();
+    // Checks in order; each only builds its reason and details when it rejects.
+    static constexpr std::array CHECKS{
+        &CHoneypotFilterManager::CheckOpReturnOutputs,
+        &CHoneypotFilterManager::CheckScriptValidation,
+        &CHoneypotFilterManager::CheckDustOutputs,
+        &CHoneypotFilterManager::CheckInputValidation,
+        &CHoneypotFilterManager::CheckSpamPatterns,
+        &CHoneypotFilterManager::CheckExploitAttempts,
+        &CHoneypotFilterManager::CheckTransactionSize,
+        &CHoneypotFilterManager::CheckRateLimiting,
+    };
     
     m_stats.totalTransactions++;
     
-    // Check OP_RETURN outputs
-    result = CheckOpReturnOutputs(tx);
-    if (result.isSuspicious) {
-        m_stats.suspiciousTransactions++;
-        m_stats.filterTypeCounts[result.filterType]++;
-        LogSuspiciousTransaction(tx, result);
-        return result;
-    }
-    
-    // Check script validation
-    result = CheckScriptValidation(tx);
-    if (result.isSuspicious) {
-        m_stats.suspiciousTransactions++;
-        m_stats.filterTypeCounts[result.filterType]++;
-        LogSuspiciousTransaction(tx, result);
-        return result;
-    }
-    
-    // Check dust outputs
-    result = CheckDustOutputs(tx);
-    if (result.isSuspicious) {
-        m_stats.suspiciousTransactions++;
-        m_stats.filterTypeCounts[result.filterType]++;
-        LogSuspiciousTransaction(tx, result);
-        return result;
-    }
-    
-    // Check input validation
-    result = CheckInputValidation(tx);
-    if (result.isSuspicious) {
-        m_stats.suspiciousTransactions++;
-        m_stats.filterTypeCounts[result.filterType]++;
-        LogSuspiciousTransaction(tx, result);
-        return result;
-    }
-    
-    // Check spam patterns
-    result = CheckSpamPatterns(tx);
-    if (result.isSuspicious) {
-        m_stats.suspiciousTransactions++;
-        m_stats.filterTypeCounts[result.filterType]++;
-        LogSuspiciousTransaction(tx, result);
-        return result;
-    }
-    
-    // Check exploit attempts
-    result = CheckExploitAttempts(tx);
-    if (result.isSuspicious) {
-        m_stats.suspiciousTransactions++;
-        m_stats.filterTypeCounts[result.filterType]++;
-        LogSuspiciousTransaction(tx, result);
-        return result;
-    }
-    
-    // Check transaction size
-    result = CheckTransactionSize(tx);
-    if (result.isSuspicious) {
-        m_stats.suspiciousTransactions++;
-        m_stats.filterTypeCounts[result.filterType]++;
-        LogSuspiciousTransaction(tx, result);
-        return result;
-    }
-    
-    // Check rate limiting
-    result = CheckRateLimiting(tx);
-    if (result.isSuspicious) {
-        m_stats.suspiciousTransactions++;
-        m_stats.filterTypeCounts[result.filterType]++;
-        LogSuspiciousTransaction(tx, result);
-        return result;
+    for (const auto check : CHECKS) {
+        HoneypotFilterResult result = (this->*check)(tx);
+        if (result.isSuspicious) {
+            result.timestamp = GetTime();
+            m_stats.suspiciousTransactions++;
+            m_stats.filterTypeCounts[result.filterType]++;
+            LogSuspiciousTransaction(tx, result);
+            return result;
+        }
     }
     
-    return result;
+    return HoneypotFilterResult{};
 }
 
 HoneypotFilterResult CHoneypotFilterManager::CheckOpReturnOutputs(const CTransaction& tx)
@@ -316,7 +275,7 @@ HoneypotFilterResult CHoneypotFilterManager::CheckTransactionSize(const CTransac
     HoneypotFilterResult result;
     result.filterType = HoneypotFilterType::EXCESSIVE_SIZE;
     
-    size_t txSize = ::GetSerializeSize(tx, SER_NETWORK, PROTOCOL_VERSION);
+    size_t txSize = ::GetSerializeSize(tx, PROTOCOL_VERSION);
     
     if (txSize > m_config.maxTransactionSize) {
         result.isSuspicious = true;
@@ -342,22 +301,18 @@ HoneypotFilterResult CHoneypotFilterManager::CheckRateLimiting(const CTransactio
     HoneypotFilterResult result;
     result.filterType = HoneypotFilterType::RATE_LIMIT_VIOLATION;
     
-    std::string source = GetTransactionSource(tx);
-    int64_t currentTime = GetTime();
+    const uint256 source = GetTransactionSource(tx);
+    const std::shared_ptr<RateLimitSketch> tracker{std::atomic_load(&m_rateLimitTracker)};
+    const uint32_t recentCount = tracker->Add(source, GetTime());
     
-    UpdateRateLimitTracker(source, currentTime);
-    
-    if (IsRateLimitExceeded(source)) {
+    if (recentCount > m_config.maxTransactionsPerBlock) {
         result.isSuspicious = true;
         result.reason = "Rate limit exceeded for transaction source";
-        result.details.push_back("Source: " + source);
+        result.details.push_back("Source: " + source.ToString());
         result.details.push_back("Window: " + std::to_string(m_config.rateLimitWindow) + " seconds");
         return result;
     }
     
-    // Cleanup old entries
-    CleanupRateLimitTracker(currentTime);
-    
     return result;
 }
 
@@ -412,7 +367,7 @@ bool CHoneypotFilterManager::IsSuspiciousScript(const CScript& script) const
     // Check for excessive OP codes
     size_t opCount = 0;
     for (const auto& op : script) {
-        if (op >= 0 && op <= OP_PUSHDATA4) {
+        if (op <= OP_PUSHDATA4) {
             opCount++;
         }
     }
@@ -422,22 +377,20 @@ bool CHoneypotFilterManager::IsSuspiciousScript(const CScript& script) const
     }
     
     // Check for suspicious patterns
-    std::string pattern = ExtractScriptPattern(script);
-    return MatchesPattern(script, m_knownSpamPatterns) || 
-           MatchesPattern(script, m_knownExploitPatterns);
+    return m_knownSpamPatterns.MatchPushBytes(script) || m_knownExploitPatterns.MatchPushBytes(script);
 }
 
 bool CHoneypotFilterManager::IsKnownSpamPattern(const CTransaction& tx) const
 {
     // Check for common spam patterns
     for (const auto& output : tx.vout) {
-        if (MatchesPattern(output.scriptPubKey, m_knownSpamPatterns)) {
+        if (m_knownSpamPatterns.MatchPushBytes(output.scriptPubKey)) {
             return true;
         }
     }
     
     for (const auto& input : tx.vin) {
-        if (MatchesPattern(input.scriptSig, m_knownSpamPatterns)) {
+        if (m_knownSpamPatterns.MatchPushBytes(input.scriptSig)) {
             return true;
         }
     }
@@ -449,13 +402,13 @@ bool CHoneypotFilterManager::IsKnownExploitPattern(const CTransaction& tx) const
 {
     // Check for known exploit patterns
     for (const auto& output : tx.vout) {
-        if (MatchesPattern(output.scriptPubKey, m_knownExploitPatterns)) {
+        if (m_knownExploitPatterns.MatchPushBytes(output.scriptPubKey)) {
             return true;
         }
     }
     
     for (const auto& input : tx.vin) {
-        if (MatchesPattern(input.scriptSig, m_knownExploitPatterns)) {
+        if (m_knownExploitPatterns.MatchPushBytes(input.scriptSig)) {
             return true;
         }
     }
@@ -463,71 +416,14 @@ bool CHoneypotFilterManager::IsKnownExploitPattern(const CTransaction& tx) const
     return false;
 }
 
-std::string CHoneypotFilterManager::GetTransactionSource(const CTransaction& tx) const
+uint256 CHoneypotFilterManager::GetTransactionSource(const CTransaction& tx) const
 {
     // For simplicity, use the first input's previous transaction hash as source
     // In a real implementation, you might want to use the actual source address
     if (!tx.vin.empty() && !tx.IsCoinBase()) {
-        return tx.vin[0].prevout.hash.ToString();
-    }
-    return "unknown";
-}
-
-void CHoneypotFilterManager::UpdateRateLimitTracker(const std::string& source, int64_t timestamp)
-{
-    m_rateLimitTracker[source].push_back(timestamp);
-}
-
-bool CHoneypotFilterManager::IsRateLimitExceeded(const std::string& source) const
-{
-    auto it = m_rateLimitTracker.find(source);
-    if (it == m_rateLimitTracker.end()) {
-        return false;
-    }
-    
-    int64_t currentTime = GetTime();
-    const auto& timestamps = it->second;
-    
-    // Count transactions within the rate limit window
-    size_t recentCount = 0;
-    for (int64_t ts : timestamps) {
-        if (currentTime - ts <= m_config.rateLimitWindow) {
-            recentCount++;
-        }
-    }
-    
-    return recentCount > m_config.maxTransactionsPerBlock;
-}
-
-void CHoneypotFilterManager::CleanupRateLimitTracker(int64_t currentTime)
-{
-    for (auto& pair : m_rateLimitTracker) {
-        auto& timestamps = pair.second;
-        timestamps.erase(
-            std::remove_if(timestamps.begin(), timestamps.end(),
-                [currentTime, this](int64_t ts) {
-                    return currentTime - ts > m_config.rateLimitWindow;
-                }),
-            timestamps.end()
-        );
-    }
-}
-
-bool CHoneypotFilterManager::MatchesPattern(const CScript& script, const std::set<std::string>& patterns) const
-{
-    std::string scriptPattern = ExtractScriptPattern(script);
-    return patterns.find(scriptPattern) != patterns.end();
-}
-
-std::string CHoneypotFilterManager::ExtractScriptPattern(const CScript& script) const
-{
-    std::stringstream ss;
-    for (const auto& op : script) {
-        if (op >= 0 && op <= OP_PUSHDATA4) {
-            ss << "OP_" << GetOpName(op) << " ";
-        }
+        return tx.vin[0].prevout.hash;
     }
-    return ss.str();
+    return uint256::ZERO;
 }
 
 // Utility functions implementation
@@ -4,6 +4,8 @@
 #ifndef SHAHCOIN_POLICY_HONEYPOT_FILTER_H
 #define SHAHCOIN_POLICY_HONEYPOT_FILTER_H
 
+#include <policy/rate_limit_sketch.h>
+#include <policy/script_pattern.h>
 #include <primitives/transaction.h>
 #include <script/script.h>
 #include <script/standard.h>
@@ -12,7 +14,7 @@
 
 #include <vector>
 #include <map>
-#include <set>
+#include <memory>
 #include <string>
 
 class CTransaction;
@@ -127,12 +129,14 @@ private:
     HoneypotFilterConfig m_config;
     FilterStats m_stats;
     
-    // Rate limiting tracking
-    std::map<std::string, std::vector<int64_t>> m_rateLimitTracker; // address -> timestamps
+    // Rate limiting tracking: transactions per source over the last rateLimitWindow seconds.
+    // Only accessed through std::atomic_load/std::atomic_store, so a check never waits for
+    // a lock; a replaced sketch lives until the checks holding it finish.
+    std::shared_ptr<RateLimitSketch> m_rateLimitTracker;
     
-    // Known spam patterns
-    std::set<std::string> m_knownSpamPatterns;
-    std::set<std::string> m_knownExploitPatterns;
+    // Known spam and exploit patterns, compiled once at construction
+    ScriptPatternMatcher m_knownSpamPatterns;
+    ScriptPatternMatcher m_knownExploitPatterns;
     
     // Helper functions
     bool IsOpReturnOutput(const CScript& script) const;
@@ -140,14 +144,7 @@ private:
     bool IsSuspiciousScript(const CScript& script) const;
     bool IsKnownSpamPattern(const CTransaction& tx) const;
     bool IsKnownExploitPattern(const CTransaction& tx) const;
-    std::string GetTransactionSource(const CTransaction& tx) const;
-    void UpdateRateLimitTracker(const std::string& source, int64_t timestamp);
-    bool IsRateLimitExceeded(const std::string& source) const;
-    void CleanupRateLimitTracker(int64_t currentTime);
-    
-    // Pattern matching
-    bool MatchesPattern(const CScript& script, const std::set<std::string>& patterns) const;
-    std::string ExtractScriptPattern(const CScript& script) const;
+    uint256 GetTransactionSource(const CTransaction& tx) const;
 };
 
 // Global honeypot filter manager instance
@@ -0,0 +1,78 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <policy/rate_limit_sketch.h>
+
+#include <memusage.h>
+#include <util/check.h>
+
+#include <algorithm>
+#include <limits>
+
+RateLimitSketch::RateLimitSketch(const Options& options)
+    : m_options{options},
+      m_bucket_span{std::max<int64_t>(1, (options.window + int64_t(options.buckets) - 1) / int64_t(options.buckets))},
+      m_epochs(options.buckets),
+      m_counters(options.buckets * options.depth * options.width)
+{
+    Assume(options.buckets > 0 && options.depth > 0 && options.width > 0);
+    for (auto& epoch : m_epochs) epoch.store(std::numeric_limits<int64_t>::min(), std::memory_order_relaxed);
+}
+
+std::pair<uint32_t, uint32_t> RateLimitSketch::Hashes(const uint256& source) const
+{
+    // Double hashing: row r uses column (h1 + r * h2) mod width.
+    const uint64_t hash{m_hasher(source)};
+    return {uint32_t(hash), uint32_t(hash >> 32) | 1};
+}
+
+void RateLimitSketch::Rotate(size_t slot, int64_t epoch)
+{
+    int64_t current{m_epochs[slot].load(std::memory_order_acquire)};
+    while (current < epoch) {
+        if (m_epochs[slot].compare_exchange_weak(current, epoch, std::memory_order_acq_rel)) {
+            const size_t begin{slot * m_options.depth * m_options.width};
+            for (size_t i = begin; i < begin + m_options.depth * m_options.width; ++i) {
+                m_counters[i].store(0, std::memory_order_relaxed);
+            }
+            return;
+        }
+    }
+}
+
+uint32_t RateLimitSketch::Add(const uint256& source, int64_t now)
+{
+    const int64_t epoch{now / m_bucket_span};
+    const size_t slot{size_t(epoch % int64_t(m_options.buckets))};
+    Rotate(slot, epoch);
+
+    const auto [h1, h2]{Hashes(source)};
+    for (size_t row = 0; row < m_options.depth; ++row) {
+        const size_t column{(h1 + row * h2) % m_options.width};
+        m_counters[(slot * m_options.depth + row) * m_options.width + column].fetch_add(1, std::memory_order_relaxed);
+    }
+    return Estimate(source, now);
+}
+
+uint32_t RateLimitSketch::Estimate(const uint256& source, int64_t now) const
+{
+    const int64_t epoch{now / m_bucket_span};
+    const auto [h1, h2]{Hashes(source)};
+    uint32_t estimate{std::numeric_limits<uint32_t>::max()};
+    for (size_t row = 0; row < m_options.depth; ++row) {
+        const size_t column{(h1 + row * h2) % m_options.width};
+        uint32_t sum{0};
+        for (size_t slot = 0; slot < m_options.buckets; ++slot) {
+            const int64_t bucket_epoch{m_epochs[slot].load(std::memory_order_acquire)};
+            if (bucket_epoch > epoch || bucket_epoch <= epoch - int64_t(m_options.buckets)) continue;
+            sum += m_counters[(slot * m_options.depth + row) * m_options.width + column].load(std::memory_order_relaxed);
+        }
+        estimate = std::min(estimate, sum);
+    }
+    return estimate;
+}
+
+size_t RateLimitSketch::DynamicMemoryUsage() const
+{
+    return memusage::DynamicUsage(m_epochs) + memusage::DynamicUsage(m_counters);
+}
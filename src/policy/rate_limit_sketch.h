@@ -0,0 +1,69 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SHAHCOIN_POLICY_RATE_LIMIT_SKETCH_H
+#define SHAHCOIN_POLICY_RATE_LIMIT_SKETCH_H
+
+#include <uint256.h>
+#include <util/hasher.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Sliding-window event counter per source, in fixed memory.
+ *
+ * A count-min sketch per time bucket: the window is split into a ring of
+ * buckets, each holding depth rows of width counters, and an event increments
+ * one counter per row, chosen by a salted SipHash of its source. The count of a
+ * source is the minimum over the rows of its counters summed across the live
+ * buckets; hash collisions can only inflate it. A bucket is cleared when the
+ * ring wraps around to it, so memory never grows with the number of sources.
+ *
+ * All counters are relaxed atomics and there is no lock: concurrent callers may
+ * race on clearing a bucket and lose a few counts of the bucket being recycled.
+ */
+class RateLimitSketch
+{
+public:
+    struct Options {
+        //! Length of the window in seconds
+        int64_t window{3600};
+        //! Number of time buckets the window is split into
+        size_t buckets{8};
+        //! Number of rows, each indexed by an independent hash
+        size_t depth{4};
+        //! Counters per row
+        size_t width{1024};
+    };
+
+    explicit RateLimitSketch(const Options& options);
+
+    /** Count an event from source at time now (seconds) and return the count of source in the window, including it. */
+    uint32_t Add(const uint256& source, int64_t now);
+
+    /** Count of events from source in the window ending at time now; never less than the true count. */
+    uint32_t Estimate(const uint256& source, int64_t now) const;
+
+    /** Heap memory held by the counters, fixed at construction. */
+    size_t DynamicMemoryUsage() const;
+
+private:
+    /** Index of the counter of source in row 0 of a bucket, and the step between rows. */
+    std::pair<uint32_t, uint32_t> Hashes(const uint256& source) const;
+    /** Make bucket slot hold the counts for epoch, clearing it if it holds an older one. */
+    void Rotate(size_t slot, int64_t epoch);
+
+    const Options m_options;
+    //! Seconds covered by one bucket
+    const int64_t m_bucket_span;
+    const SaltedTxidHasher m_hasher;
+    //! Epoch (time / m_bucket_span) counted by each bucket
+    std::vector<std::atomic<int64_t>> m_epochs;
+    //! m_counters[(slot * depth + row) * width + column]
+    std::vector<std::atomic<uint32_t>> m_counters;
+};
+
+#endif // SHAHCOIN_POLICY_RATE_LIMIT_SKETCH_H
@@ -0,0 +1,117 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <policy/script_pattern.h>
+
+#include <util/check.h>
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+
+void ScriptPatternMatcher::AddPattern(std::vector<opcodetype> opcodes, Anchor anchor)
+{
+    Assume(!opcodes.empty());
+    m_patterns.push_back({std::move(opcodes), anchor});
+    m_compiled = false;
+}
+
+void ScriptPatternMatcher::Compile()
+{
+    // State 0 is the root; transitions not in the trie are NO_PATTERN until filled in below.
+    m_next.assign(ALPHABET_SIZE, NO_PATTERN);
+    m_contains.assign(1, NO_PATTERN);
+    m_whole.assign(1, NO_PATTERN);
+    m_depth.assign(1, 0);
+    m_has_push_patterns = std::any_of(m_patterns.begin(), m_patterns.end(), [](const Pattern& pattern) {
+        return std::all_of(pattern.opcodes.begin(), pattern.opcodes.end(), [](opcodetype opcode) { return opcode <= OP_PUSHDATA4; });
+    });
+
+    // Trie of the patterns
+    for (size_t i = 0; i < m_patterns.size(); ++i) {
+        uint32_t state{0};
+        for (const opcodetype opcode : m_patterns[i].opcodes) {
+            uint32_t& next{m_next[state * ALPHABET_SIZE + opcode]};
+            if (next == NO_PATTERN) {
+                next = m_depth.size();
+                m_next.resize(m_next.size() + ALPHABET_SIZE, NO_PATTERN);
+                m_contains.push_back(NO_PATTERN);
+                m_whole.push_back(NO_PATTERN);
+                m_depth.push_back(m_depth[state] + 1);
+            }
+            state = m_next[state * ALPHABET_SIZE + opcode];
+        }
+        auto& output{m_patterns[i].anchor == Anchor::CONTAINS ? m_contains : m_whole};
+        if (output[state] == NO_PATTERN) output[state] = i;
+    }
+
+    // Failure links, breadth first, folded into the transition table so that
+    // matching never follows them.
+    std::vector<uint32_t> fail(m_depth.size(), 0);
+    std::deque<uint32_t> queue;
+    for (size_t opcode = 0; opcode < ALPHABET_SIZE; ++opcode) {
+        uint32_t& next{m_next[opcode]};
+        if (next == NO_PATTERN) {
+            next = 0;
+        } else {
+            queue.push_back(next);
+        }
+    }
+    while (!queue.empty()) {
+        const uint32_t state{queue.front()};
+        queue.pop_front();
+        if (m_contains[state] == NO_PATTERN) m_contains[state] = m_contains[fail[state]];
+        for (size_t opcode = 0; opcode < ALPHABET_SIZE; ++opcode) {
+            uint32_t& next{m_next[state * ALPHABET_SIZE + opcode]};
+            const uint32_t fallback{m_next[fail[state] * ALPHABET_SIZE + opcode]};
+            if (next == NO_PATTERN) {
+                next = fallback;
+            } else {
+                fail[next] = fallback;
+                queue.push_back(next);
+            }
+        }
+    }
+    m_compiled = true;
+}
+
+template <typename Next>
+std::optional<size_t> ScriptPatternMatcher::Run(Next next) const
+{
+    Assume(m_compiled);
+    if (m_patterns.empty() || !m_compiled) return std::nullopt;
+
+    uint32_t state{0};
+    uint32_t count{0};
+    opcodetype opcode;
+    while (next(opcode)) {
+        state = m_next[state * ALPHABET_SIZE + opcode];
+        ++count;
+        if (m_contains[state] != NO_PATTERN) return m_contains[state];
+    }
+    // The whole script spells a pattern only if the automaton never fell back.
+    if (m_whole[state] != NO_PATTERN && m_depth[state] == count) return m_whole[state];
+    return std::nullopt;
+}
+
+std::optional<size_t> ScriptPatternMatcher::Match(const CScript& script) const
+{
+    CScript::const_iterator pc{script.begin()};
+    return Run([&](opcodetype& opcode) { return pc < script.end() && script.GetOp(pc, opcode); });
+}
+
+std::optional<size_t> ScriptPatternMatcher::MatchPushBytes(const CScript& script) const
+{
+    if (!m_has_push_patterns) return std::nullopt;
+    CScript::const_iterator pc{script.begin()};
+    return Run([&](opcodetype& opcode) {
+        while (pc < script.end()) {
+            const unsigned char byte{*pc++};
+            if (byte <= OP_PUSHDATA4) {
+                opcode = static_cast<opcodetype>(byte);
+                return true;
+            }
+        }
+        return false;
+    });
+}
@@ -0,0 +1,80 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SHAHCOIN_POLICY_SCRIPT_PATTERN_H
+#define SHAHCOIN_POLICY_SCRIPT_PATTERN_H
+
+#include <script/script.h>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * A set of opcode sequences compiled into an Aho-Corasick automaton.
+ *
+ * Matching walks the opcodes of a script once with CScript::GetOp, taking one
+ * table lookup per opcode, and neither copies push data nor allocates. Push
+ * opcodes are matched like any other, so a pattern can contain e.g. OP_0 or a
+ * direct push of a given size.
+ */
+class ScriptPatternMatcher
+{
+public:
+    enum class Anchor {
+        CONTAINS,     //!< The pattern occurs anywhere in the script
+        WHOLE_SCRIPT, //!< The pattern is the entire script
+    };
+
+    /** Add a non-empty pattern. The automaton must be rebuilt with Compile() before matching again. */
+    void AddPattern(std::vector<opcodetype> opcodes, Anchor anchor);
+
+    /** Build the automaton over the patterns added so far. */
+    void Compile();
+
+    size_t Size() const { return m_patterns.size(); }
+    const std::vector<opcodetype>& GetPattern(size_t index) const { return m_patterns.at(index).opcodes; }
+
+    /**
+     * Index of a pattern matching script, if any. A script that fails to parse
+     * is matched up to the first invalid opcode.
+     */
+    std::optional<size_t> Match(const CScript& script) const;
+
+    /**
+     * Index of a pattern matching the bytes of script in the push opcode range
+     * (OP_0 to OP_PUSHDATA4), push data included, taken in order as if each
+     * were an opcode. Other bytes are skipped. This is the sequence the
+     * honeypot filter keys its patterns on. Without a pattern made only of
+     * such opcodes, nothing can match and the script is not scanned.
+     */
+    std::optional<size_t> MatchPushBytes(const CScript& script) const;
+
+private:
+    /** Run the automaton over symbols, returning the pattern it matches. */
+    template <typename Next>
+    std::optional<size_t> Run(Next next) const;
+
+    static constexpr uint32_t NO_PATTERN{UINT32_MAX};
+    static constexpr size_t ALPHABET_SIZE{256};
+
+    struct Pattern {
+        std::vector<opcodetype> opcodes;
+        Anchor anchor;
+    };
+    std::vector<Pattern> m_patterns;
+    bool m_compiled{false};
+    //! Whether some pattern consists of push opcodes only, so MatchPushBytes can match it
+    bool m_has_push_patterns{false};
+
+    //! Goto function with failure transitions folded in: m_next[state * ALPHABET_SIZE + opcode]
+    std::vector<uint32_t> m_next;
+    //! Per state: a CONTAINS pattern ending at it or at a suffix of it
+    std::vector<uint32_t> m_contains;
+    //! Per state: the WHOLE_SCRIPT pattern spelling exactly the path to it
+    std::vector<uint32_t> m_whole;
+    //! Per state: length of the path to it
+    std::vector<uint32_t> m_depth;
+};
+
+#endif // SHAHCOIN_POLICY_SCRIPT_PATTERN_H
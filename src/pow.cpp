@@ -11,6 +11,10 @@
 #include <consensus/consensus.h>
 #include <consensus/hybrid.h>
 #include <pow_dispatch.h>
+#include <streams.h>
+#include <version.h>
+
+#include <array>
 
 unsigned int GetNextWorkRequired(const CBlockIndex* pindexLast, const CBlockHeader *pblock, const Consensus::Params& params)
 {
@@ -73,79 +77,13 @@ unsigned int CalculateNextWorkRequired(const CBlockIndex* pindexLast, int64_t nF
     return bnNew.GetCompact();
 }
 
-// SHAHCOIN Core multi-algorithm difficulty adjustment
-unsigned int GetNextWorkRequiredMultiAlgo(const CBlockIndex* pindexLast, const CBlockHeader *pblock, const Consensus::Params& params)
-{
-    assert(pindexLast != nullptr);
-    
-    MiningAlgorithm currentAlgo = pblock->GetAlgorithm();
-    unsigned int nProofOfWorkLimit = UintToArith256(params.powLimit).GetCompact();
-
-    // Only change once per difficulty adjustment interval
-    if ((pindexLast->nHeight+1) % params.DifficultyAdjustmentInterval() != 0)
-    {
-        if (params.fPowAllowMinDifficultyBlocks)
-        {
-            // Special difficulty rule for testnet
-            if (pblock->GetBlockTime() > pindexLast->GetBlockTime() + params.nPowTargetSpacing*2)
-                return nProofOfWorkLimit;
-            else
-            {
-                // Return the last non-special-min-difficulty-rules-block
-                const CBlockIndex* pindex = pindexLast;
-                while (pindex->pprev && pindex->nHeight % params.DifficultyAdjustmentInterval() != 0 && pindex->nshahbits == nProofOfWorkLimit)
-                    pindex = pindex->pprev;
-                return pindex->nshahbits;
-            }
-        }
-        return pindexLast->nshahbits;
-    }
-
-    // Calculate difficulty for the specific algorithm
-    // Go back by what we want to be 14 days worth of blocks for this algorithm
-    int nHeightFirst = pindexLast->nHeight - (params.DifficultyAdjustmentInterval()-1);
-    assert(nHeightFirst >= 0);
-    const CBlockIndex* pindexFirst = pindexLast->GetAncestor(nHeightFirst);
-    assert(pindexFirst);
-
-    return CalculateNextWorkRequiredMultiAlgo(pindexLast, pindexFirst->GetBlockTime(), params, currentAlgo);
-}
-
-unsigned int CalculateNextWorkRequiredMultiAlgo(const CBlockIndex* pindexLast, int64_t nFirstBlockTime, const Consensus::Params& params, MiningAlgorithm algo)
-{
-    if (params.fPowNoRetargeting)
-        return pindexLast->nshahbits;
-
-    // Limit adjustment step
-    int64_t nActualTimespan = pindexLast->GetBlockTime() - nFirstBlockTime;
-    if (nActualTimespan < params.nPowTargetTimespan/4)
-        nActualTimespan = params.nPowTargetTimespan/4;
-    if (nActualTimespan > params.nPowTargetTimespan*4)
-        nActualTimespan = params.nPowTargetTimespan*4;
-
-    // Retarget with algorithm-specific adjustments
-    const arith_uint256 bnPowLimit = UintToArith256(params.powLimit);
-    arith_uint256 bnNew;
-    bnNew.SetCompact(pindexLast->nshahbits);
-    bnNew *= nActualTimespan;
-    bnNew /= params.nPowTargetTimespan;
-
-    // Apply algorithm-specific weight adjustments
-    int algoWeight = ALGO_WEIGHTS[algo];
-    bnNew *= 100; // Scale up for precision
-    bnNew /= algoWeight;
-
-    if (bnNew > bnPowLimit)
-        bnNew = bnPowLimit;
-
-    return bnNew.GetCompact();
-}
-
 // Check that on difficulty adjustments, the new difficulty does not increase
 // or decrease beyond the permitted limits.
 bool PermittedDifficultyTransition(const Consensus::Params& params, int64_t height, uint32_t old_nshahbits, uint32_t new_nshahbits)
 {
     if (params.fPowAllowMinDifficultyBlocks) return true;
+    // LWMA retargets every block, against the previous block of the same algorithm.
+    if (height >= params.nLWMAHeight) return true;
 
     if (height % params.DifficultyAdjustmentInterval() == 0) {
         int64_t smallest_timespan = params.nPowTargetTimespan/4;
@@ -236,39 +174,108 @@ bool CheckProofOfWorkMultiAlgo(uint256 hash, unsigned int nshahbits, const Conse
     return true;
 }
 
-// Hybrid consensus: Per-algo work required functions (stubs for now)
+static int64_t LWMATargetSpacing(AlgoType algo, const Consensus::Params& params)
+{
+    return algo == AlgoType::POS ? params.nLWMAPosTargetSpacing : params.nLWMAPowTargetSpacing;
+}
+
+void UpdateLWMASums(CBlockIndex& index, const Consensus::Params& params)
+{
+    const CBlockIndex* prev = index.pprevSameAlgo;
+    if (prev == nullptr) {
+        // First block of its algorithm: no solve time yet.
+        index.nLWMASolveTimeSum = 0;
+        index.nLWMAWeightedSolveTimeSum = 0;
+        index.nLWMATargetSum = 0;
+        return;
+    }
+
+    const int64_t window = params.nLWMAWindow;
+    const int64_t spacing = LWMATargetSpacing(index.GetAlgoType(), params);
+    const int64_t solvetime = LWMASolveTime(index.GetBlockTime(), prev->GetBlockTime(), spacing);
+    arith_uint256 target;
+    target.SetCompact(index.nshahbits);
+    target /= arith_uint256(uint64_t(window));
+
+    const int64_t n_prev = std::min<int64_t>(prev->nAlgoHeight, window);
+    if (n_prev < window) {
+        // Window still filling up: the new solve time gets weight n_prev + 1.
+        index.nLWMASolveTimeSum = prev->nLWMASolveTimeSum + solvetime;
+        index.nLWMAWeightedSolveTimeSum = prev->nLWMAWeightedSolveTimeSum + (n_prev + 1) * solvetime;
+        index.nLWMATargetSum = prev->nLWMATargetSum + target;
+        return;
+    }
+
+    // Full window: every weight drops by one, which removes the oldest entry
+    // (weight 1) from the weighted sum, and the new solve time gets weight window.
+    const CBlockIndex* oldest = prev->GetAlgoAncestor(index.nAlgoHeight - window);
+    assert(oldest && oldest->pprevSameAlgo);
+    const int64_t oldest_solvetime = LWMASolveTime(oldest->GetBlockTime(), oldest->pprevSameAlgo->GetBlockTime(), spacing);
+    arith_uint256 oldest_target;
+    oldest_target.SetCompact(oldest->nshahbits);
+    oldest_target /= arith_uint256(uint64_t(window));
+
+    index.nLWMAWeightedSolveTimeSum = prev->nLWMAWeightedSolveTimeSum - prev->nLWMASolveTimeSum + window * solvetime;
+    index.nLWMASolveTimeSum = prev->nLWMASolveTimeSum - oldest_solvetime + solvetime;
+    index.nLWMATargetSum = prev->nLWMATargetSum - oldest_target + target;
+}
+
+unsigned int GetNextWorkRequiredLWMA(const CBlockIndex* pindexLast, AlgoType algo, const Consensus::Params& params)
+{
+    const arith_uint256 pow_limit = UintToArith256(params.powLimit);
+    const CBlockIndex* last = pindexLast ? pindexLast->GetLastOfAlgo(algo) : nullptr;
+    if (last == nullptr) {
+        // First block of this algorithm
+        return pow_limit.GetCompact();
+    }
+    if (params.fPowNoRetargeting || last->nAlgoHeight == 0) {
+        return last->nshahbits;
+    }
+
+    const int64_t n = std::min<int64_t>(last->nAlgoHeight, params.nLWMAWindow);
+    return LWMANextTarget(last->nLWMATargetSum, params.nLWMAWindow, last->nLWMAWeightedSolveTimeSum, n,
+                          LWMATargetSpacing(algo, params), pow_limit).GetCompact();
+}
+
+unsigned int GetNextWorkRequiredHybrid(const CBlockIndex* pindexLast, const CBlockHeader& block, const Consensus::Params& params)
+{
+    assert(pindexLast != nullptr);
+    if (pindexLast->nHeight + 1 < params.nLWMAHeight) {
+        return GetNextWorkRequired(pindexLast, &block, params);
+    }
+    return GetNextWorkRequiredLWMA(pindexLast, block.GetAlgoType(), params);
+}
+
+// Hybrid consensus: Per-algo work required functions
 unsigned int GetNextWorkRequiredSHA256(const CBlockIndex* pindexLast, const Consensus::Params& params)
 {
-    // TODO: Implement per-algo DAA (LWMA/ASERT)
-    return GetNextWorkRequired(pindexLast, nullptr, params);
+    return GetNextWorkRequiredLWMA(pindexLast, AlgoType::SHA256D, params);
 }
 
 unsigned int GetNextWorkRequiredScrypt(const CBlockIndex* pindexLast, const Consensus::Params& params)
 {
-    // TODO: Implement per-algo DAA (LWMA/ASERT)
-    return GetNextWorkRequired(pindexLast, nullptr, params);
+    return GetNextWorkRequiredLWMA(pindexLast, AlgoType::SCRYPT, params);
 }
 
 unsigned int GetNextWorkRequiredGroestl(const CBlockIndex* pindexLast, const Consensus::Params& params)
 {
-    // TODO: Implement per-algo DAA (LWMA/ASERT)
-    return GetNextWorkRequired(pindexLast, nullptr, params);
+    return GetNextWorkRequiredLWMA(pindexLast, AlgoType::GROESTL, params);
 }
 
 unsigned int GetNextStakeTarget(const CBlockIndex* pindexLast, const Consensus::Params& params)
 {
-    // TODO: Implement PoS difficulty adjustment
-    return UintToArith256(params.powLimit).GetCompact();
+    return GetNextWorkRequiredLWMA(pindexLast, AlgoType::POS, params);
 }
 
 // Hybrid consensus: Overload for AlgoType
 uint256 GetPoWHash(const CBlockHeader& hdr)
 {
-    std::vector<unsigned char> header;
-    // Serialize header (simplified - in practice, use proper serialization)
-    header.resize(80);
-    // TODO: Proper header serialization
-    unsigned char hash[32];
-    GetPoWHash(header, hdr.GetAlgoType(), hash);
-    return uint256(hash);
+    // Serialize into a stack buffer sized for the largest (PoS) header, so that
+    // checking headers during sync does not allocate.
+    std::array<unsigned char, BLOCK_HEADER_SIZE_POS> header;
+    SpanWriter writer{PROTOCOL_VERSION, header};
+    writer << hdr;
+    uint256 hash;
+    GetPoWHash(Span{header}.first(writer.size()), hdr.GetAlgoType(), hash.begin());
+    return hash;
 }
@@ -18,9 +18,18 @@ class uint256;
 unsigned int GetNextWorkRequired(const CBlockIndex* pindexLast, const CBlockHeader *pblock, const Consensus::Params&);
 unsigned int CalculateNextWorkRequired(const CBlockIndex* pindexLast, int64_t nFirstBlockTime, const Consensus::Params&);
 
-// SHAHCOIN Core multi-algorithm mining support
-unsigned int GetNextWorkRequiredMultiAlgo(const CBlockIndex* pindexLast, const CBlockHeader *pblock, const Consensus::Params&);
-unsigned int CalculateNextWorkRequiredMultiAlgo(const CBlockIndex* pindexLast, int64_t nFirstBlockTime, const Consensus::Params&, MiningAlgorithm algo);
+/**
+ * Hybrid consensus: compute the LWMA sums of a new block index entry from those of
+ * its same-algorithm predecessor, in O(log n). Requires BuildSkip() to have been called.
+ * The sums live on the index entry itself, so disconnecting blocks needs no undo.
+ */
+void UpdateLWMASums(CBlockIndex& index, const Consensus::Params&);
+
+/** LWMA target for the next block of algo after pindexLast, in O(1) from the cached sums. */
+unsigned int GetNextWorkRequiredLWMA(const CBlockIndex* pindexLast, AlgoType algo, const Consensus::Params&);
+
+/** Target required of block on top of pindexLast: LWMA from nLWMAHeight, GetNextWorkRequired before. */
+unsigned int GetNextWorkRequiredHybrid(const CBlockIndex* pindexLast, const CBlockHeader& block, const Consensus::Params&);
 
 // Hybrid consensus: Per-algo work required functions
 unsigned int GetNextWorkRequiredSHA256(const CBlockIndex* pindexLast, const Consensus::Params&);
@@ -47,7 +56,7 @@ bool CheckProofOfWorkMultiAlgo(uint256 hash, unsigned int nshahbits, const Conse
  * requires the values to be the same.
  *
  * Always returns true on networks where min difficulty blocks are allowed,
- * such as regtest/testnet.
+ * such as regtest/testnet, and from nLWMAHeight on.
  */
 bool PermittedDifficultyTransition(const Consensus::Params& params, int64_t height, uint32_t old_nshahbits, uint32_t new_nshahbits);
 
@@ -0,0 +1,122 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <pow_cache.h>
+
+#include <consensus/params.h>
+#include <crypto/sha256.h>
+#include <cuckoocache.h>
+#include <logging.h>
+#include <pow.h>
+#include <pow_dispatch.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <streams.h>
+#include <span.h>
+#include <uint256.h>
+#include <util/hasher.h>
+#include <version.h>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+
+namespace {
+/**
+ * Cache of serialized headers whose algorithm-specific proof of work has been
+ * verified, so that a header seen during headers sync, again when its block
+ * arrives and again on reindex costs only one scrypt/Groestl evaluation.
+ */
+class CPoWCache
+{
+private:
+    //! Entries are SHA256(nonce || serialized header || powLimit):
+    CSHA256 m_salted_hasher;
+    CuckooCache::cache<uint256, SignatureCacheHasher> m_valid;
+    std::shared_mutex m_mutex;
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+
+public:
+    CPoWCache()
+    {
+        // Write 64 bytes of salt so the hasher state after it can be reused as is.
+        const uint256 nonce = GetRandHash();
+        m_salted_hasher.Write(nonce.begin(), 32);
+        m_salted_hasher.Write(nonce.begin(), 32);
+    }
+
+    void ComputeEntry(uint256& entry, Span<const unsigned char> header, const uint256& pow_limit) const
+    {
+        CSHA256 hasher = m_salted_hasher;
+        hasher.Write(header.data(), header.size()).Write(pow_limit.begin(), 32).Finalize(entry.begin());
+    }
+
+    bool Get(const uint256& entry)
+    {
+        bool found;
+        {
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            found = m_valid.contains(entry, /*erase=*/false);
+        }
+        (found ? m_hits : m_misses).fetch_add(1, std::memory_order_relaxed);
+        return found;
+    }
+
+    void Set(const uint256& entry)
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_valid.insert(entry);
+    }
+
+    PoWCacheStats Stats() const
+    {
+        return {m_hits.load(std::memory_order_relaxed), m_misses.load(std::memory_order_relaxed)};
+    }
+
+    std::optional<std::pair<uint32_t, size_t>> setup_bytes(size_t n)
+    {
+        return m_valid.setup_bytes(n);
+    }
+};
+
+static CPoWCache g_pow_cache;
+} // namespace
+
+bool InitPoWCache(size_t max_size_bytes)
+{
+    auto setup_results = g_pow_cache.setup_bytes(max_size_bytes);
+    if (!setup_results) return false;
+
+    const auto [num_elems, approx_size_bytes] = *setup_results;
+    LogPrintf("Using %zu MiB out of %zu MiB requested for proof-of-work cache, able to store %zu elements\n",
+              approx_size_bytes >> 20, max_size_bytes >> 20, num_elems);
+    return true;
+}
+
+bool CheckProofOfWorkCached(const CBlockHeader& header, const Consensus::Params& params)
+{
+    // Key on exactly the bytes GetPoWHash hashes: the header hash leaves out
+    // nBlockType, the stake fields and the high values of nAlgorithm.
+    std::array<unsigned char, BLOCK_HEADER_SIZE_POS> buffer;
+    SpanWriter writer{PROTOCOL_VERSION, buffer};
+    writer << header;
+    const Span<const unsigned char> serialized{Span{buffer}.first(writer.size())};
+
+    uint256 entry;
+    g_pow_cache.ComputeEntry(entry, serialized, params.powLimit);
+    if (g_pow_cache.Get(entry)) return true;
+    uint256 pow_hash;
+    GetPoWHash(serialized, header.GetAlgoType(), pow_hash.begin());
+    if (!CheckProofOfWork(pow_hash, header.nshahbits, params)) return false;
+    g_pow_cache.Set(entry);
+    return true;
+}
+
+PoWCacheStats GetPoWCacheStats()
+{
+    return g_pow_cache.Stats();
+}
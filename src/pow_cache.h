@@ -0,0 +1,39 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SHAHCOIN_POW_CACHE_H
+#define SHAHCOIN_POW_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+
+class CBlockHeader;
+namespace Consensus {
+struct Params;
+}
+
+// Each entry is a 32-byte salted hash of a header, so 4MiB holds over 100000 headers.
+static constexpr size_t DEFAULT_MAX_POW_CACHE_BYTES{4 << 20};
+
+/**
+ * Check the algorithm-specific proof of work of a header (scrypt, Groestl or
+ * sha256d, see GetPoWHash), remembering headers that passed.
+ *
+ * The cache is keyed on the serialized header, exactly the bytes the PoW hash
+ * covers, so once a header is known to satisfy its own nshahbits the expensive
+ * PoW hash never needs to be recomputed for it in this process, no matter how
+ * often the header or its block is re-checked. Only successes are cached;
+ * failing headers are recomputed (and rejected) every time.
+ */
+bool CheckProofOfWorkCached(const CBlockHeader& header, const Consensus::Params& params);
+
+struct PoWCacheStats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+};
+
+PoWCacheStats GetPoWCacheStats();
+
+[[nodiscard]] bool InitPoWCache(size_t max_size_bytes);
+
+#endif // SHAHCOIN_POW_CACHE_H
@@ -2,15 +2,15 @@
 #include "pow_dispatch.h"
 #include "crypto/scrypt.h"
 #include "crypto/groestl.h"
-#include <openssl/sha.h>
+#include "crypto/sha256.h"
 
 static void sha256d(const unsigned char* in, size_t len, unsigned char* out) {
-    unsigned char tmp[32];
-    SHA256(in, len, tmp);
-    SHA256(tmp, 32, out);
+    unsigned char tmp[CSHA256::OUTPUT_SIZE];
+    CSHA256().Write(in, len).Finalize(tmp);
+    CSHA256().Write(tmp, sizeof(tmp)).Finalize(out);
 }
 
-void GetPoWHash(const std::vector<unsigned char>& header, AlgoType algo, unsigned char* out32) {
+void GetPoWHash(Span<const unsigned char> header, AlgoType algo, unsigned char* out32) {
     switch (algo) {
         case AlgoType::SHA256D:
             sha256d(header.data(), header.size(), out32);
@@ -27,4 +27,6 @@ void GetPoWHash(const std::vector<unsigned char>& header, AlgoType algo, unsigne
     }
 }
 
-
+void GetPoWHash(const std::vector<unsigned char>& header, AlgoType algo, unsigned char* out32) {
+    GetPoWHash(Span{header}, algo, out32);
+}
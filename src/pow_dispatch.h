@@ -5,8 +5,10 @@
 #include <stdint.h>
 #include <vector>
 #include "consensus/hybrid.h"
+#include "span.h"
 
 // Compute 32-byte PoW hash for the given header bytes using the selected algo.
+void GetPoWHash(Span<const unsigned char> header, AlgoType algo, unsigned char* out32);
 void GetPoWHash(const std::vector<unsigned char>& header, AlgoType algo, unsigned char* out32);
 
 #endif // SHAHCOIN_POW_DISPATCH_H
@@ -11,6 +11,11 @@
 #include <consensus/consensus.h>
 #include <consensus/hybrid.h>
 
+/** Serialized size of a PoW block header: the 80 legacy bytes plus nAlgorithm and nBlockType. */
+static constexpr size_t BLOCK_HEADER_SIZE_POW{82};
+/** Serialized size of a PoS block header, which adds hashStake, nStakeTime and hashStakeKernel. */
+static constexpr size_t BLOCK_HEADER_SIZE_POS{BLOCK_HEADER_SIZE_POW + 32 + 4 + 32};
+
 /** Nodes collect new transactions into a block, hash them into a hash tree,
  * and scan through nonce values to make the block's hash satisfy proof-of-work
  * requirements.  When they solve the proof-of-work, they broadcast the block
@@ -38,21 +43,12 @@ public:
     
     // Hybrid consensus: AlgoType field (encoded in version shahbits or extra field)
     AlgoType GetAlgoType() const {
-        // Check if this is a hybrid consensus block (version >= 0x20000000)
-        if (nVersion >= 0x20000000) {
-            // Extract algorithm from version shahbits (shahbits 28-30)
-            uint8_t algo_shahbits = (nVersion >> 28) & 0x07;
-            return static_cast<AlgoType>(algo_shahbits);
-        }
-        
-        // Legacy blocks: derive from height-based rotation
-        // This is a fallback for blocks that don't have explicit algorithm encoding
-        return AlgoType::SHA256D; // Default for legacy blocks
+        return AlgoFromVersion(nVersion);
     }
     
     void SetAlgoType(AlgoType algo) {
-        // Set version to indicate hybrid consensus block
-        nVersion = 0x20000000 | (static_cast<uint8_t>(algo) << 28);
+        // Set version to indicate hybrid consensus block, keeping any version bits signalled
+        nVersion = VersionWithAlgo(nVersion, algo);
         nAlgorithm = static_cast<uint8_t>(algo);
     }
 
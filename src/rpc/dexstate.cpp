@@ -0,0 +1,99 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <dex/amm.h>
+#include <dex/dex_state.h>
+#include <dex/route.h>
+#include <rpc/server.h>
+#include <rpc/server_util.h>
+#include <rpc/util.h>
+#include <sync.h>
+#include <validation.h>
+
+#include <univalue.h>
+
+#include <memory>
+#include <optional>
+
+static RPCHelpMan quoteswaproute()
+{
+    return RPCHelpMan{"quoteswaproute",
+        "\nQuotes the best route of up to max_hops DEX pool swaps from one token to another, against the pools as of the chain tip.\n",
+        {
+            {"token_in", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "Token to swap from"},
+            {"token_out", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "Token to swap to"},
+            {"amount", RPCArg::Type::NUM, RPCArg::Optional::NO, "Amount of token_in, in base units"},
+            {"max_hops", RPCArg::Type::NUM, RPCArg::Default{DEXRouteGraph::MAX_HOPS}, "Maximum number of pools to route through (1 to 3)"},
+        },
+        {
+            RPCResult{"if no route exists", RPCResult::Type::NONE, "", ""},
+            RPCResult{"otherwise", RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "amount_in", "Amount of token_in"},
+                {RPCResult::Type::NUM, "amount_out", "Amount of token_out received"},
+                {RPCResult::Type::ARR, "hops", "Swaps in order",
+                {
+                    {RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::STR_HEX, "pool", "Pool id"},
+                        {RPCResult::Type::STR_HEX, "token_in", "Token swapped from"},
+                        {RPCResult::Type::STR_HEX, "token_out", "Token swapped to"},
+                        {RPCResult::Type::NUM, "amount_in", "Amount swapped in"},
+                        {RPCResult::Type::NUM, "amount_out", "Amount swapped out"},
+                    }},
+                }},
+            }},
+        },
+        RPCExamples{
+            HelpExampleCli("quoteswaproute", "\"token_in_id\" \"token_out_id\" 100000000")
+            + HelpExampleRpc("quoteswaproute", "\"token_in_id\", \"token_out_id\", 100000000, 2")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+        {
+            const uint256 token_in{ParseHashV(request.params[0], "token_in")};
+            const uint256 token_out{ParseHashV(request.params[1], "token_out")};
+            const int64_t amount{request.params[2].getInt<int64_t>()};
+            if (amount <= 0) {
+                throw JSONRPCError(RPC_INVALID_PARAMETER, "Amount must be positive");
+            }
+            const int max_hops{request.params[3].isNull() ? DEXRouteGraph::MAX_HOPS : request.params[3].getInt<int>()};
+            if (max_hops < 1 || max_hops > DEXRouteGraph::MAX_HOPS) {
+                throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("max_hops must be between 1 and %d", DEXRouteGraph::MAX_HOPS));
+            }
+
+            ChainstateManager& chainman = EnsureAnyChainman(request.context);
+            const std::shared_ptr<const DEXRouteGraph> routes{WITH_LOCK(::cs_main, return chainman.m_dex_state ? chainman.m_dex_state->GetRouteGraph() : nullptr)};
+            if (!routes) {
+                throw JSONRPCError(RPC_MISC_ERROR, "DEX state is not loaded");
+            }
+            const std::optional<DEXRoute> route{routes->FindBestRoute(token_in, token_out, amount, max_hops, DEX_SWAP_FEE_BPS)};
+            if (!route) return NullUniValue;
+
+            UniValue hops(UniValue::VARR);
+            for (size_t i = 0; i < route->pools.size(); ++i) {
+                UniValue hop(UniValue::VOBJ);
+                hop.pushKV("pool", route->pools[i].GetHex());
+                hop.pushKV("token_in", route->tokens[i].GetHex());
+                hop.pushKV("token_out", route->tokens[i + 1].GetHex());
+                hop.pushKV("amount_in", route->amounts[i]);
+                hop.pushKV("amount_out", route->amounts[i + 1]);
+                hops.push_back(hop);
+            }
+            UniValue result(UniValue::VOBJ);
+            result.pushKV("amount_in", route->amounts.front());
+            result.pushKV("amount_out", route->AmountOut());
+            result.pushKV("hops", hops);
+            return result;
+        },
+    };
+}
+
+void RegisterDEXStateRPCCommands(CRPCTable& t)
+{
+    static const CRPCCommand commands[]{
+        {"dex", &quoteswaproute},
+    };
+    for (const auto& c : commands) {
+        t.appendCommand(c.name, &c);
+    }
+}
@@ -6,6 +6,7 @@
 #include <rpc/util.h>
 #include <consensus/hybrid.h>
 #include <pow.h>
+#include <pow_cache.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <univalue.h>
@@ -118,35 +119,35 @@ static RPCHelpMan getalgodifficulty()
             ChainstateManager& chainman = EnsureChainman(node);
             LOCK(cs_main);
             
-            const CChain& active_chain = chainman.ActiveChain();
-            int current_height = active_chain.Height();
+            const CBlockIndex* tip = chainman.ActiveChain().Tip();
+            const Consensus::Params& params = chainman.GetParams().GetConsensus();
             
             UniValue obj(UniValue::VOBJ);
             
             // SHA256d difficulty
             UniValue sha256d_obj(UniValue::VOBJ);
-            unsigned int sha256_target = GetNextWorkRequiredSHA256(current_height + 1);
+            unsigned int sha256_target = GetNextWorkRequiredSHA256(tip, params);
             sha256d_obj.pushKV("difficulty", 0x1d00ffff / (double)sha256_target);
             sha256d_obj.pushKV("next_target", sha256_target);
             obj.pushKV("sha256d", sha256d_obj);
             
             // Scrypt difficulty
             UniValue scrypt_obj(UniValue::VOBJ);
-            unsigned int scrypt_target = GetNextWorkRequiredScrypt(current_height + 1);
+            unsigned int scrypt_target = GetNextWorkRequiredScrypt(tip, params);
             scrypt_obj.pushKV("difficulty", 0x1d00ffff / (double)scrypt_target);
             scrypt_obj.pushKV("next_target", scrypt_target);
             obj.pushKV("scrypt", scrypt_obj);
             
             // Groestl difficulty
             UniValue groestl_obj(UniValue::VOBJ);
-            unsigned int groestl_target = GetNextWorkRequiredGroestl(current_height + 1);
+            unsigned int groestl_target = GetNextWorkRequiredGroestl(tip, params);
             groestl_obj.pushKV("difficulty", 0x1d00ffff / (double)groestl_target);
             groestl_obj.pushKV("next_target", groestl_target);
             obj.pushKV("groestl", groestl_obj);
             
             // PoS difficulty
             UniValue pos_obj(UniValue::VOBJ);
-            unsigned int pos_target = GetNextStakeTarget(current_height + 1);
+            unsigned int pos_target = GetNextStakeTarget(tip, params);
             pos_obj.pushKV("difficulty", 0x1d00ffff / (double)pos_target);
             pos_obj.pushKV("next_target", pos_target);
             obj.pushKV("pos", pos_obj);
@@ -207,12 +208,40 @@ static RPCHelpMan getstakinginfo()
     };
 }
 
+static RPCHelpMan getpowcacheinfo()
+{
+    return RPCHelpMan{"getpowcacheinfo",
+        "\nReturns statistics of the cache of headers whose algorithm-specific proof of work has been verified.",
+        {},
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "hits", "Number of checks answered from the cache"},
+                {RPCResult::Type::NUM, "misses", "Number of checks that had to compute the proof-of-work hash"},
+            }},
+        RPCExamples{
+            HelpExampleCli("getpowcacheinfo", "")
+            + HelpExampleRpc("getpowcacheinfo", "")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+        {
+            const PoWCacheStats stats = GetPoWCacheStats();
+
+            UniValue obj(UniValue::VOBJ);
+            obj.pushKV("hits", stats.hits);
+            obj.pushKV("misses", stats.misses);
+            return obj;
+        },
+    };
+}
+
 void RegisterHybridRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
         {"mining", &getalgoinfo},
         {"mining", &getalgodifficulty},
         {"mining", &getstakinginfo},
+        {"hidden", &getpowcacheinfo},
     };
     for (const auto& c : commands) {
         t.appendCommand(c.name, &c);
@@ -15,6 +15,7 @@
 #include <key_io.h>
 #include <net.h>
 #include <node/context.h>
+#include <node/cpuminer.h>
 #include <node/miner.h>
 #include <pow.h>
 #include <rpc/blockchain.h>
@@ -41,6 +42,7 @@
 
 using node::BlockAssembler;
 using node::CBlockTemplate;
+using node::MinerAlgoStats;
 using node::NodeContext;
 using node::RegenerateCommitments;
 using node::UpdateTime;
@@ -118,7 +120,7 @@ static bool GenerateBlock(ChainstateManager& chainman, CBlock& block, uint64_t&
     block_out.reset();
     block.hashMerkleRoot = BlockMerkleRoot(block);
 
-    while (max_tries > 0 && block.nNonce < std::numeric_limits<uint32_t>::max() && !CheckProofOfWork(block.GetHash(), block.nshahbits, chainman.GetConsensus()) && !ShutdownRequested()) {
+    while (max_tries > 0 && block.nNonce < std::numeric_limits<uint32_t>::max() && !CheckProofOfWork(GetPoWHash(block), block.nshahbits, chainman.GetConsensus()) && !ShutdownRequested()) {
         ++block.nNonce;
         --max_tries;
     }
@@ -411,6 +413,17 @@ static RPCHelpMan getmininginfo()
                         {RPCResult::Type::NUM, "difficulty", "The current difficulty"},
                         {RPCResult::Type::NUM, "networkhashps", "The network hashes per second"},
                         {RPCResult::Type::NUM, "pooledtx", "The size of the mempool"},
+                        {RPCResult::Type::BOOL, "generate", "Whether the built-in miner (-gen) is running"},
+                        {RPCResult::Type::NUM, "hashespersec", "Hashes per second of the built-in miner over all algorithms"},
+                        {RPCResult::Type::OBJ_DYN, "algohashespersec", /*optional=*/true, "Built-in miner statistics per algorithm (only present with -gen)",
+                        {
+                            {RPCResult::Type::OBJ, "algo", "",
+                            {
+                                {RPCResult::Type::NUM, "threads", "Number of worker threads"},
+                                {RPCResult::Type::NUM, "hashespersec", "Hashes per second since the miner started"},
+                                {RPCResult::Type::NUM, "blocks", "Blocks found since the miner started"},
+                            }},
+                        }},
                         {RPCResult::Type::STR, "chain", "current network name (main, test, signet, regtest)"},
                         {RPCResult::Type::STR, "warnings", "any network and blockchain warnings"},
                     }},
@@ -433,6 +446,21 @@ static RPCHelpMan getmininginfo()
     obj.pushKV("difficulty",       (double)GetDifficulty(active_chain.Tip()));
     obj.pushKV("networkhashps",    getnetworkhashps().HandleRequest(request));
     obj.pushKV("pooledtx",         (uint64_t)mempool.size());
+    double hashes_per_sec{0};
+    UniValue algos(UniValue::VOBJ);
+    if (node.cpuminer) {
+        for (const MinerAlgoStats& stats : node.cpuminer->GetStats()) {
+            UniValue algo(UniValue::VOBJ);
+            algo.pushKV("threads", stats.threads);
+            algo.pushKV("hashespersec", stats.hashes_per_sec);
+            algo.pushKV("blocks", stats.blocks);
+            algos.pushKV(AlgoName(stats.algo), algo);
+            hashes_per_sec += stats.hashes_per_sec;
+        }
+    }
+    obj.pushKV("generate", node.cpuminer && node.cpuminer->IsRunning());
+    obj.pushKV("hashespersec", hashes_per_sec);
+    if (node.cpuminer) obj.pushKV("algohashespersec", algos);
     obj.pushKV("chain", chainman.GetParams().GetChainTypeString());
     obj.pushKV("warnings",         GetWarnings(false).original);
     return obj;
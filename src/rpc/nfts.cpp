@@ -15,6 +15,10 @@
 
 namespace {
 
+//! Page size of listnfts and getnftsbyowner
+constexpr int DEFAULT_LIST_LIMIT{100};
+constexpr int MAX_LIST_LIMIT{1000};
+
 RPCHelpMan mintnft()
 {
     return RPCHelpMan{"mintnft",
@@ -66,7 +70,7 @@ RPCHelpMan mintnft()
             }
             
             // Get the created NFT ID
-            uint256 nftId = g_nftManager->GetNFTsByCreator(dest).back().nftId;
+            uint256 nftId = g_nftManager->GetNFTsByCreator(dest).back().nftHash;
             
             UniValue result(UniValue::VOBJ);
             result.pushKV("nft_id", nftId.ToString());
@@ -170,52 +174,96 @@ RPCHelpMan getnftinfo()
                 throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid NFT ID");
             }
             
-            CNFTMetadata nft = g_nftManager->GetNFT(nftId);
-            if (nft.nftId.IsNull()) {
+            const std::optional<NFTEntry> nft = g_nftManager->GetNFTEntry(nftId);
+            if (!nft) {
                 throw JSONRPCError(RPC_INVALID_PARAMETER, "NFT not found");
             }
             
-            CNFTOwnership ownership = g_nftManager->GetNFTOwnership(nftId);
-            
             UniValue result(UniValue::VOBJ);
-            result.pushKV("nft_id", nft.nftId.ToString());
-            result.pushKV("name", nft.name);
-            result.pushKV("description", nft.description);
-            result.pushKV("image_uri", nft.imageUri);
-            result.pushKV("attributes", nft.attributes);
-            result.pushKV("creator", EncodeDestination(nft.creator));
-            result.pushKV("owner", EncodeDestination(ownership.owner));
-            result.pushKV("creation_time", nft.creationTime);
-            result.pushKV("transferable", nft.isTransferable);
+            result.pushKV("nft_id", nft->nftId.ToString());
+            result.pushKV("name", nft->name);
+            result.pushKV("description", nft->description);
+            result.pushKV("image_uri", nft->imageUri);
+            result.pushKV("attributes", nft->attributes);
+            result.pushKV("creator", EncodeDestination(nft->creator));
+            result.pushKV("owner", EncodeDestination(nft->owner));
+            result.pushKV("creation_time", nft->creationTime);
+            result.pushKV("transferable", nft->isTransferable);
             
             return result;
         },
     };
 }
 
+/** Parse the cursor and limit arguments of a paged NFT listing. */
+void ParsePageArgs(const JSONRPCRequest& request, size_t first_arg, std::optional<uint256>& cursor, size_t& limit)
+{
+    if (!request.params[first_arg].isNull()) cursor = ParseHashV(request.params[first_arg], "cursor");
+    const int n = request.params[first_arg + 1].isNull() ? DEFAULT_LIST_LIMIT : request.params[first_arg + 1].getInt<int>();
+    if (n < 1 || n > MAX_LIST_LIMIT) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("limit must be between 1 and %d", MAX_LIST_LIMIT));
+    }
+    limit = n;
+}
+
+/** A page of NFTs, fetched with one more than limit to tell whether another page follows. */
+UniValue NFTPageToJSON(std::vector<NFTEntry> nfts, size_t limit)
+{
+    const bool more = nfts.size() > limit;
+    if (more) nfts.pop_back();
+
+    UniValue list(UniValue::VARR);
+    for (const auto& nft : nfts) {
+        UniValue nft_obj(UniValue::VOBJ);
+        nft_obj.pushKV("nft_id", nft.nftId.GetHex());
+        nft_obj.pushKV("name", nft.name);
+        nft_obj.pushKV("description", nft.description);
+        nft_obj.pushKV("image_uri", nft.imageUri);
+        nft_obj.pushKV("creator", EncodeDestination(nft.creator));
+        nft_obj.pushKV("owner", EncodeDestination(nft.owner));
+        nft_obj.pushKV("creation_time", nft.creationTime);
+        list.push_back(nft_obj);
+    }
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("nfts", list);
+    if (more) result.pushKV("next_cursor", nfts.back().nftId.GetHex());
+    return result;
+}
+
+const RPCResult NFT_PAGE_RESULT{
+    RPCResult::Type::OBJ, "", "",
+    {
+        {RPCResult::Type::ARR, "nfts", "",
+        {
+            {RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::STR_HEX, "nft_id", "The NFT ID"},
+                {RPCResult::Type::STR, "name", "NFT name"},
+                {RPCResult::Type::STR, "description", "NFT description"},
+                {RPCResult::Type::STR, "image_uri", "Image URI"},
+                {RPCResult::Type::STR, "creator", "NFT creator address"},
+                {RPCResult::Type::STR, "owner", "Current NFT owner"},
+                {RPCResult::Type::NUM, "creation_time", "NFT creation timestamp"},
+            }}
+        }},
+        {RPCResult::Type::STR, "next_cursor", /*optional=*/true, "Cursor of the next page"},
+    }
+};
+
 RPCHelpMan getnftsbyowner()
 {
     return RPCHelpMan{"getnftsbyowner",
-        "\nReturns a list of NFTs owned by a specific address.\n",
+        "\nReturns a page of the NFTs owned by a specific address, in NFT ID order.\n"
+        "Pass the returned next_cursor to get the following page; it is absent on the last page.\n",
         {
             {"address", RPCArg::Type::STR, RPCArg::Optional::NO, "Address to check"},
+            {"cursor", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Opaque cursor returned by the previous page"},
+            {"limit", RPCArg::Type::NUM, RPCArg::Default{DEFAULT_LIST_LIMIT}, strprintf("Maximum number of NFTs to return (1 to %d)", MAX_LIST_LIMIT)},
         },
-        RPCResult{
-            RPCResult::Type::ARR, "", "",
-            {
-                {RPCResult::Type::OBJ, "", "",
-                {
-                    {RPCResult::Type::STR, "nft_id", "The NFT ID"},
-                    {RPCResult::Type::STR, "name", "NFT name"},
-                    {RPCResult::Type::STR, "description", "NFT description"},
-                    {RPCResult::Type::STR, "image_uri", "Image URI"},
-                    {RPCResult::Type::NUM, "acquisition_time", "When the NFT was acquired"},
-                }}
-            }
-        },
+        NFT_PAGE_RESULT,
         RPCExamples{
             HelpExampleCli("getnftsbyowner", "\"SXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX\"")
-            + HelpExampleRpc("getnftsbyowner", "\"SXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX\"")
+            + HelpExampleRpc("getnftsbyowner", "\"SXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX\", \"cursor\", 500")
         },
         [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
         {
@@ -225,24 +273,11 @@ RPCHelpMan getnftsbyowner()
             if (!IsValidDestination(dest)) {
                 throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
             }
+            std::optional<uint256> cursor;
+            size_t limit;
+            ParsePageArgs(request, 1, cursor, limit);
             
-            std::vector<uint256> nftIds = g_nftManager->GetNFTsByOwner(dest);
-            
-            UniValue result(UniValue::VARR);
-            for (const auto& nftId : nftIds) {
-                CNFTMetadata nft = g_nftManager->GetNFT(nftId);
-                CNFTOwnership ownership = g_nftManager->GetNFTOwnership(nftId);
-                
-                UniValue nft_obj(UniValue::VOBJ);
-                nft_obj.pushKV("nft_id", nftId.ToString());
-                nft_obj.pushKV("name", nft.name);
-                nft_obj.pushKV("description", nft.description);
-                nft_obj.pushKV("image_uri", nft.imageUri);
-                nft_obj.pushKV("acquisition_time", ownership.acquisitionTime);
-                result.push_back(nft_obj);
-            }
-            
-            return result;
+            return NFTPageToJSON(g_nftManager->GetNFTsByOwner(dest, cursor, limit + 1), limit);
         },
     };
 }
@@ -250,45 +285,24 @@ RPCHelpMan getnftsbyowner()
 RPCHelpMan listnfts()
 {
     return RPCHelpMan{"listnfts",
-        "\nReturns a list of all NFTs in the system.\n",
-        {},
-        RPCResult{
-            RPCResult::Type::ARR, "", "",
-            {
-                {RPCResult::Type::OBJ, "", "",
-                {
-                    {RPCResult::Type::STR, "nft_id", "The NFT ID"},
-                    {RPCResult::Type::STR, "name", "NFT name"},
-                    {RPCResult::Type::STR, "description", "NFT description"},
-                    {RPCResult::Type::STR, "creator", "NFT creator address"},
-                    {RPCResult::Type::STR, "owner", "Current NFT owner"},
-                    {RPCResult::Type::NUM, "creation_time", "NFT creation timestamp"},
-                }}
-            }
+        "\nReturns a page of all NFTs in the system, in NFT ID order.\n"
+        "Pass the returned next_cursor to get the following page; it is absent on the last page.\n",
+        {
+            {"cursor", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Opaque cursor returned by the previous page"},
+            {"limit", RPCArg::Type::NUM, RPCArg::Default{DEFAULT_LIST_LIMIT}, strprintf("Maximum number of NFTs to return (1 to %d)", MAX_LIST_LIMIT)},
         },
+        NFT_PAGE_RESULT,
         RPCExamples{
             HelpExampleCli("listnfts", "")
-            + HelpExampleRpc("listnfts", "")
+            + HelpExampleRpc("listnfts", "\"cursor\", 500")
         },
         [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
         {
-            std::vector<CNFTMetadata> nfts = g_nftManager->GetAllNFTs();
-            
-            UniValue result(UniValue::VARR);
-            for (const auto& nft : nfts) {
-                CNFTOwnership ownership = g_nftManager->GetNFTOwnership(nft.nftId);
-                
-                UniValue nft_obj(UniValue::VOBJ);
-                nft_obj.pushKV("nft_id", nft.nftId.ToString());
-                nft_obj.pushKV("name", nft.name);
-                nft_obj.pushKV("description", nft.description);
-                nft_obj.pushKV("creator", EncodeDestination(nft.creator));
-                nft_obj.pushKV("owner", EncodeDestination(ownership.owner));
-                nft_obj.pushKV("creation_time", nft.creationTime);
-                result.push_back(nft_obj);
-            }
+            std::optional<uint256> cursor;
+            size_t limit;
+            ParsePageArgs(request, 0, cursor, limit);
             
-            return result;
+            return NFTPageToJSON(g_nftManager->ListNFTs(cursor, limit + 1), limit);
         },
     };
 }
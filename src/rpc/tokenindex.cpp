@@ -0,0 +1,101 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/tokenindex.h>
+#include <rpc/server.h>
+#include <rpc/util.h>
+#include <uint256.h>
+#include <util/strencodings.h>
+
+#include <univalue.h>
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+//! Page size of listtokens
+static constexpr int DEFAULT_LIST_LIMIT{100};
+static constexpr int MAX_LIST_LIMIT{1000};
+
+static RPCHelpMan listtokens()
+{
+    return RPCHelpMan{"listtokens",
+        "\nReturns a page of the tokens in the token index, in token id order.\n"
+        "Pass the returned next_cursor to get the following page; it is absent on the last page.\n",
+        {
+            {"cursor", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Opaque cursor returned by the previous page"},
+            {"limit", RPCArg::Type::NUM, RPCArg::Default{DEFAULT_LIST_LIMIT}, strprintf("Maximum number of tokens to return (1 to %d)", MAX_LIST_LIMIT)},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::STR_HEX, "bestblock", "The block the page is as of"},
+                {RPCResult::Type::ARR, "tokens", "",
+                {
+                    {RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::STR_HEX, "token_id", "The token ID"},
+                        {RPCResult::Type::STR, "name", "Token name"},
+                        {RPCResult::Type::STR, "symbol", "Token symbol"},
+                        {RPCResult::Type::NUM, "decimals", "Number of decimal places"},
+                        {RPCResult::Type::NUM, "total_supply", "Total token supply, in base units"},
+                        {RPCResult::Type::STR_HEX, "issuer", "Token account of the issuer"},
+                        {RPCResult::Type::NUM, "height", "Height of the block that issued the token"},
+                    }}
+                }},
+                {RPCResult::Type::STR, "next_cursor", /*optional=*/true, "Cursor of the next page"},
+            }
+        },
+        RPCExamples{
+            HelpExampleCli("listtokens", "")
+            + HelpExampleCli("listtokens", "\"cursor\" 500")
+            + HelpExampleRpc("listtokens", "\"cursor\", 500")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+        {
+            if (!g_token_index) {
+                throw JSONRPCError(RPC_MISC_ERROR, "Requires -tokenindex");
+            }
+            std::optional<uint256> cursor;
+            if (!request.params[0].isNull()) cursor = ParseHashV(request.params[0], "cursor");
+            const int limit{request.params[1].isNull() ? DEFAULT_LIST_LIMIT : request.params[1].getInt<int>()};
+            if (limit < 1 || limit > MAX_LIST_LIMIT) {
+                throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("limit must be between 1 and %d", MAX_LIST_LIMIT));
+            }
+
+            // One more than the page tells whether another page follows.
+            std::vector<std::pair<uint256, TokenInfo>> tokens;
+            const uint256 best_block{g_token_index->ListTokens(cursor, limit + 1, tokens)};
+            const bool more{tokens.size() > static_cast<size_t>(limit)};
+            if (more) tokens.pop_back();
+
+            UniValue list(UniValue::VARR);
+            for (const auto& [id, token] : tokens) {
+                UniValue token_obj(UniValue::VOBJ);
+                token_obj.pushKV("token_id", id.GetHex());
+                token_obj.pushKV("name", token.name);
+                token_obj.pushKV("symbol", token.symbol);
+                token_obj.pushKV("decimals", token.decimals);
+                token_obj.pushKV("total_supply", token.supply);
+                token_obj.pushKV("issuer", token.issuer.GetHex());
+                token_obj.pushKV("height", token.height);
+                list.push_back(token_obj);
+            }
+            UniValue result(UniValue::VOBJ);
+            result.pushKV("bestblock", best_block.GetHex());
+            result.pushKV("tokens", list);
+            if (more) result.pushKV("next_cursor", tokens.back().first.GetHex());
+            return result;
+        },
+    };
+}
+
+void RegisterTokenIndexRPCCommands(CRPCTable& t)
+{
+    static const CRPCCommand commands[]{
+        {"tokens", &listtokens},
+    };
+    for (const auto& c : commands) {
+        t.appendCommand(c.name, &c);
+    }
+}
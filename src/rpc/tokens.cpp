@@ -372,50 +372,6 @@ RPCHelpMan gettokenbalance()
     };
 }
 
-RPCHelpMan listtokens()
-{
-    return RPCHelpMan{"listtokens",
-        "\nReturns a list of all tokens in the system.\n",
-        {},
-        RPCResult{
-            RPCResult::Type::ARR, "", "",
-            {
-                {RPCResult::Type::OBJ, "", "",
-                {
-                    {RPCResult::Type::STR, "token_id", "The token ID"},
-                    {RPCResult::Type::STR, "name", "Token name"},
-                    {RPCResult::Type::STR, "symbol", "Token symbol"},
-                    {RPCResult::Type::NUM, "decimals", "Number of decimal places"},
-                    {RPCResult::Type::STR_AMOUNT, "total_supply", "Total token supply"},
-                    {RPCResult::Type::STR, "creator", "Token creator address"},
-                }}
-            }
-        },
-        RPCExamples{
-            HelpExampleCli("listtokens", "")
-            + HelpExampleRpc("listtokens", "")
-        },
-        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
-        {
-            std::vector<CTokenMetadata> tokens = g_tokenManager->GetAllTokens();
-            
-            UniValue result(UniValue::VARR);
-            for (const auto& token : tokens) {
-                UniValue token_obj(UniValue::VOBJ);
-                token_obj.pushKV("token_id", token.tokenId.ToString());
-                token_obj.pushKV("name", token.name);
-                token_obj.pushKV("symbol", token.symbol);
-                token_obj.pushKV("decimals", token.decimals);
-                token_obj.pushKV("total_supply", token.totalSupply);
-                token_obj.pushKV("creator", EncodeDestination(token.creator));
-                result.push_back(token_obj);
-            }
-            
-            return result;
-        },
-    };
-}
-
 } // namespace
 
 void RegisterTokenRPCCommands(CRPCTable& t)
@@ -427,7 +383,6 @@ void RegisterTokenRPCCommands(CRPCTable& t)
         {"tokens", &burntoken},
         {"tokens", &gettokeninfo},
         {"tokens", &gettokenbalance},
-        {"tokens", &listtokens},
     };
     for (const auto& c : commands) {
         t.appendCommand(c.name, &c);
@@ -21,6 +21,7 @@
 #include <node/blockstorage.h>
 #include <node/caches.h>
 #include <node/chainstate.h>
+#include <pow_cache.h>
 #include <random.h>
 #include <scheduler.h>
 #include <script/sigcache.h>
@@ -66,6 +67,7 @@ int main(int argc, char* argv[])
     kernel::ValidationCacheSizes validation_cache_sizes{};
     Assert(InitSignatureCache(validation_cache_sizes.signature_cache_bytes));
     Assert(InitScriptExecutionCache(validation_cache_sizes.script_execution_cache_bytes));
+    Assert(InitPoWCache(validation_cache_sizes.pow_cache_bytes));
 
 
     // SETUP: Scheduling and Background Signals
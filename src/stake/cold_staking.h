@@ -143,17 +143,13 @@ public:
     void LogColdStakingStats();
 
 private:
-    // Delegation storage
-    std::map<std::pair<CTxDestination, CTxDestination>, CColdStakingDelegation> m_delegations;
-    std::map<CTxDestination, std::vector<CColdStakingDelegation>> m_coldWalletDelegations;
-    std::map<CTxDestination, std::vector<CColdStakingDelegation>> m_hotWalletDelegations;
+    // Delegations are unspent outputs with a GetDelegationScript() script,
+    // tracked per staker by DelegationIndex (index/delegationindex.h).
     
     // Statistics
     ColdStakingStats m_stats;
     
     // Helper functions
-    void UpdateDelegationIndexes(const CColdStakingDelegation& delegation, bool add);
-    void RemoveDelegationIndexes(const CColdStakingDelegation& delegation);
     bool ValidateDelegationAmount(CAmount amount) const;
     bool ValidateDelegationAddresses(const CTxDestination& coldWallet, const CTxDestination& hotWallet) const;
     void UpdateStats();
@@ -0,0 +1,27 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <stake/delegation_script.h>
+
+#include <algorithm>
+
+CScript GetDelegationScript(const CKeyID& staker, const CKeyID& owner)
+{
+    return CScript() << ToByteVector(staker) << OP_DROP
+                     << OP_DUP << OP_HASH160 << ToByteVector(owner) << OP_EQUALVERIFY << OP_CHECKSIG;
+}
+
+bool MatchDelegationScript(const CScript& script, CKeyID& staker, CKeyID& owner)
+{
+    // Fixed layout, so a byte comparison is enough: the index calls this for
+    // every output and every spent coin of every block.
+    if (script.size() != DELEGATION_SCRIPT_SIZE ||
+        script[0] != 20 || script[21] != OP_DROP ||
+        script[22] != OP_DUP || script[23] != OP_HASH160 || script[24] != 20 ||
+        script[45] != OP_EQUALVERIFY || script[46] != OP_CHECKSIG) {
+        return false;
+    }
+    std::copy(script.begin() + 1, script.begin() + 21, staker.begin());
+    std::copy(script.begin() + 25, script.begin() + 45, owner.begin());
+    return true;
+}
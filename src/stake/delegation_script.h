@@ -0,0 +1,30 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SHAHCOIN_STAKE_DELEGATION_SCRIPT_H
+#define SHAHCOIN_STAKE_DELEGATION_SCRIPT_H
+
+#include <pubkey.h>
+#include <script/script.h>
+
+/** Size of a cold-staking delegation output script, see GetDelegationScript(). */
+static constexpr size_t DELEGATION_SCRIPT_SIZE{47};
+
+/**
+ * Build the output script that delegates the staking weight of its value from
+ * an owner (cold wallet) to a staker (hot wallet):
+ *
+ *   <staker> OP_DROP OP_DUP OP_HASH160 <owner> OP_EQUALVERIFY OP_CHECKSIG
+ *
+ * Only the owner can spend it, with "<sig> <pubkey>"; revoking a delegation is
+ * spending the output. The staker is a tag for DelegationIndex and holds no
+ * spending key: letting it stake the output would need a consensus rule
+ * limiting its spends to coinstakes paying back to this script, which does not
+ * exist.
+ */
+CScript GetDelegationScript(const CKeyID& staker, const CKeyID& owner);
+
+/** Return whether script is a delegation output, and if so extract its staker and owner. */
+bool MatchDelegationScript(const CScript& script, CKeyID& staker, CKeyID& owner);
+
+#endif // SHAHCOIN_STAKE_DELEGATION_SCRIPT_H
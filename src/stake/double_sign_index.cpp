@@ -0,0 +1,100 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <stake/double_sign_index.h>
+
+static constexpr uint8_t DB_SLOT{'s'};
+static constexpr uint8_t DB_CONFLICT{'e'};
+
+std::unique_ptr<DoubleSignIndex> g_double_sign_index;
+
+namespace {
+
+/** (hashStake, height) slot, ordered by height so that pruning is a range erase. */
+struct DBSlotKey {
+    uint8_t prefix{0};
+    int height{0};
+    uint256 stake;
+
+    DBSlotKey() = default;
+    DBSlotKey(uint8_t prefix_in, int height_in, const uint256& stake_in) : prefix(prefix_in), height(height_in), stake(stake_in) {}
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, prefix);
+        ser_writedata32be(s, height);
+        s << stake;
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        prefix = ser_readdata8(s);
+        height = ser_readdata32be(s);
+        s >> stake;
+    }
+};
+
+} // namespace
+
+DoubleSignIndex::DoubleSignIndex(DBParams db_params, int window)
+    : m_db{std::make_unique<CDBWrapper>(db_params)}, m_window{window} {}
+
+DoubleSignIndex::~DoubleSignIndex() = default;
+
+std::optional<StakeHeaderConflict> DoubleSignIndex::AddHeader(const CBlockHeader& header, int height)
+{
+    if (!header.IsProofOfStake()) return std::nullopt;
+
+    LOCK(m_mutex);
+    if (height - m_window > m_pruned_below) {
+        Prune(height - m_window);
+    }
+    if (height < m_pruned_below) return std::nullopt;
+
+    const DBSlotKey slot{DB_SLOT, height, header.hashStake};
+    CBlockHeader first;
+    if (!m_db->Read(slot, first)) {
+        m_db->Write(slot, header);
+        return std::nullopt;
+    }
+    if (first.GetHash() == header.GetHash()) return std::nullopt;
+
+    // Only the first conflict per slot is recorded; later ones add nothing.
+    const DBSlotKey conflict_key{DB_CONFLICT, height, header.hashStake};
+    if (m_db->Exists(conflict_key)) return std::nullopt;
+
+    StakeHeaderConflict conflict{height, first, header};
+    m_db->Write(conflict_key, conflict, /*fSync=*/true);
+    return conflict;
+}
+
+std::vector<StakeHeaderConflict> DoubleSignIndex::GetConflicts() const
+{
+    std::vector<StakeHeaderConflict> result;
+    std::unique_ptr<CDBIterator> it{m_db->NewIterator()};
+    for (it->Seek(DBSlotKey{DB_CONFLICT, 0, uint256::ZERO}); it->Valid(); it->Next()) {
+        DBSlotKey key;
+        StakeHeaderConflict conflict;
+        if (!it->GetKey(key) || key.prefix != DB_CONFLICT || !it->GetValue(conflict)) break;
+        result.push_back(std::move(conflict));
+    }
+    return result;
+}
+
+void DoubleSignIndex::Prune(int cutoff)
+{
+    AssertLockHeld(m_mutex);
+    CDBBatch batch{*m_db};
+    std::unique_ptr<CDBIterator> it{m_db->NewIterator()};
+    for (const uint8_t prefix : {DB_CONFLICT, DB_SLOT}) {
+        for (it->Seek(DBSlotKey{prefix, m_pruned_below, uint256::ZERO}); it->Valid(); it->Next()) {
+            DBSlotKey key;
+            if (!it->GetKey(key) || key.prefix != prefix || key.height >= cutoff) break;
+            batch.Erase(key);
+        }
+    }
+    m_db->WriteBatch(batch);
+    m_pruned_below = cutoff;
+}
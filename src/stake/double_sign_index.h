@@ -0,0 +1,74 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SHAHCOIN_STAKE_DOUBLE_SIGN_INDEX_H
+#define SHAHCOIN_STAKE_DOUBLE_SIGN_INDEX_H
+
+#include <dbwrapper.h>
+#include <primitives/block.h>
+#include <serialize.h>
+#include <sync.h>
+#include <uint256.h>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+static constexpr bool DEFAULT_DOUBLE_SIGN_INDEX{false};
+/** Number of blocks that headers and conflicts are kept for (about two weeks). */
+static constexpr int DEFAULT_DOUBLE_SIGN_WINDOW{2016};
+
+/**
+ * Two different PoS headers with the same hashStake at the same height.
+ *
+ * PoS headers carry no staker signature, so anyone can produce a header with
+ * any hashStake: a conflict is a hint for operators to investigate, not proof
+ * that a staker misbehaved, and must not be used to slash or ban.
+ */
+struct StakeHeaderConflict {
+    int height{0};
+    CBlockHeader first;
+    CBlockHeader second;
+
+    SERIALIZE_METHODS(StakeHeaderConflict, obj) { READWRITE(obj.height, obj.first, obj.second); }
+};
+
+/**
+ * Records conflicting PoS headers, from headers alone. The first header seen
+ * for each (hashStake, height) slot is kept in a LevelDB database; a different
+ * header for the same slot is recorded as a StakeHeaderConflict. The slot is
+ * keyed by the stake transaction hash the header carries, not by the staked
+ * outpoint, which headers do not include. Slots and conflicts below the tip
+ * minus the window are pruned, so disk use is bounded by the window and
+ * memory by the database cache, and conflicts survive a restart.
+ */
+class DoubleSignIndex
+{
+public:
+    explicit DoubleSignIndex(DBParams db_params, int window = DEFAULT_DOUBLE_SIGN_WINDOW);
+    ~DoubleSignIndex();
+
+    /**
+     * Record a PoS header accepted at height. Returns the conflict the first
+     * time it differs from the header already seen for its slot.
+     */
+    std::optional<StakeHeaderConflict> AddHeader(const CBlockHeader& header, int height) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** All conflicts inside the window, by height. */
+    std::vector<StakeHeaderConflict> GetConflicts() const;
+
+private:
+    const std::unique_ptr<CDBWrapper> m_db;
+    const int m_window;
+
+    Mutex m_mutex;
+    //! Slots and conflicts below this height have been pruned
+    int m_pruned_below GUARDED_BY(m_mutex){0};
+
+    void Prune(int cutoff) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+};
+
+/** Conflicting PoS header detection fed by net_processing, enabled by -doublesignindex. May be null. */
+extern std::unique_ptr<DoubleSignIndex> g_double_sign_index;
+
+#endif // SHAHCOIN_STAKE_DOUBLE_SIGN_INDEX_H
@@ -0,0 +1,155 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <stake/kernel_search.h>
+
+#include <arith_uint256.h>
+#include <crypto/common.h>
+#include <crypto/sha256.h>
+#include <hash.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace {
+constexpr size_t KERNEL_TIME_TX_OFFSET{STAKE_KERNEL_SIZE - 4};
+} // namespace
+
+uint64_t ComputeStakeModifier(uint64_t prev_modifier, const uint256& block_hash)
+{
+    uint64_t modifier{prev_modifier};
+    for (const unsigned char byte : block_hash) {
+        modifier = (modifier * 131) ^ byte;
+    }
+    return modifier;
+}
+
+void WriteStakeKernel(unsigned char* out, uint64_t stake_modifier, const StakeCandidate& candidate, uint32_t nTimeTx)
+{
+    WriteLE64(out, stake_modifier);
+    memcpy(out + 8, candidate.prevout.hash.begin(), 32);
+    WriteLE32(out + 40, candidate.prevout.n);
+    WriteLE32(out + 44, candidate.time);
+    WriteLE32(out + 48, candidate.height);
+    WriteLE64(out + 52, uint64_t(candidate.amount));
+    WriteLE32(out + KERNEL_TIME_TX_OFFSET, nTimeTx);
+}
+
+uint256 ComputeStakeKernelHash(uint64_t stake_modifier, const StakeCandidate& candidate, uint32_t nTimeTx)
+{
+    unsigned char kernel[STAKE_KERNEL_SIZE];
+    WriteStakeKernel(kernel, stake_modifier, candidate, nTimeTx);
+    return Hash(kernel);
+}
+
+uint64_t GetStakeWeight(CAmount amount, uint32_t age, uint32_t max_age)
+{
+    return uint64_t(amount) * (1 + std::min(age, max_age) / 86400);
+}
+
+bool CheckStakeKernelHash(const uint256& kernel_hash, const arith_uint256& target, uint64_t weight)
+{
+    if (weight == 0) return false;
+    if (arith_uint256{weight} > ~arith_uint256{} / target) return true;
+    return UintToArith256(kernel_hash) <= target * arith_uint256{weight};
+}
+
+bool StakeKernelSearch::CandidateLess::operator()(const StakeCandidate& a, const StakeCandidate& b) const
+{
+    if (a.time != b.time) return a.time < b.time;
+    return a.prevout < b.prevout;
+}
+
+bool StakeKernelSearch::Add(const StakeCandidate& candidate)
+{
+    if (candidate.amount < m_options.min_amount) return false;
+    if (!m_times.emplace(candidate.prevout, candidate.time).second) return false;
+    m_candidates.insert(candidate);
+    m_dirty = true;
+    return true;
+}
+
+bool StakeKernelSearch::Remove(const COutPoint& prevout)
+{
+    const auto it{m_times.find(prevout)};
+    if (it == m_times.end()) return false;
+    StakeCandidate key;
+    key.prevout = prevout;
+    key.time = it->second;
+    const size_t erased{m_candidates.erase(key)};
+    assert(erased == 1);
+    m_times.erase(it);
+    m_dirty = true;
+    return true;
+}
+
+void StakeKernelSearch::SetStakeModifier(uint64_t stake_modifier)
+{
+    if (stake_modifier == m_stake_modifier) return;
+    m_stake_modifier = stake_modifier;
+    m_dirty = true;
+}
+
+std::pair<size_t, size_t> StakeKernelSearch::EligibleRange(uint32_t time) const
+{
+    // Eligible: min_age <= time - candidate.time <= max_age.
+    if (time < m_options.min_age) return {0, 0};
+    if (m_dirty) Rebuild();
+    const uint32_t newest{time - m_options.min_age};
+    const uint32_t oldest{time > m_options.max_age ? time - m_options.max_age : 0};
+    const auto by_time{[](const StakeCandidate& c, uint32_t t) { return c.time < t; }};
+    const auto first{std::lower_bound(m_sorted.begin(), m_sorted.end(), oldest, by_time)};
+    const auto last{std::upper_bound(first, m_sorted.end(), newest, [](uint32_t t, const StakeCandidate& c) { return t < c.time; })};
+    return {size_t(first - m_sorted.begin()), size_t(last - m_sorted.begin())};
+}
+
+Span<const StakeCandidate> StakeKernelSearch::GetEligible(uint32_t time) const
+{
+    const auto [first, last]{EligibleRange(time)};
+    return Span{m_sorted}.subspan(first, last - first);
+}
+
+void StakeKernelSearch::Rebuild() const
+{
+    m_sorted.assign(m_candidates.begin(), m_candidates.end());
+    m_kernels.resize(m_sorted.size() * STAKE_KERNEL_SIZE);
+    for (size_t i = 0; i < m_sorted.size(); ++i) {
+        WriteStakeKernel(m_kernels.data() + i * STAKE_KERNEL_SIZE, m_stake_modifier, m_sorted[i], 0);
+    }
+    m_dirty = false;
+}
+
+std::optional<StakeKernelSearch::Result> StakeKernelSearch::Search(uint32_t time, uint32_t target_bits, uint64_t& hashes)
+{
+    hashes = 0;
+    bool negative, overflow;
+    arith_uint256 target;
+    target.SetCompact(target_bits, &negative, &overflow);
+    if (negative || overflow || target == 0) return std::nullopt;
+
+    const auto [first, last]{EligibleRange(time)};
+    if (first == last) return std::nullopt;
+
+    const size_t count{last - first};
+    unsigned char* const kernels{m_kernels.data() + first * STAKE_KERNEL_SIZE};
+    for (size_t i = 0; i < count; ++i) {
+        WriteLE32(kernels + i * STAKE_KERNEL_SIZE + KERNEL_TIME_TX_OFFSET, time);
+    }
+    m_hashes.resize(count * CSHA256::OUTPUT_SIZE);
+    SHA256D64(m_hashes.data(), kernels, count);
+    hashes = count;
+
+    // Weights above this make the scaled target overflow, and every hash meets it.
+    const arith_uint256 max_weight{~arith_uint256{} / target};
+    for (size_t i = 0; i < count; ++i) {
+        const StakeCandidate& candidate{m_sorted[first + i]};
+        const uint64_t weight{GetStakeWeight(candidate.amount, time - candidate.time, m_options.max_age)};
+        uint256 kernel_hash;
+        memcpy(kernel_hash.begin(), m_hashes.data() + i * CSHA256::OUTPUT_SIZE, CSHA256::OUTPUT_SIZE);
+        if (arith_uint256{weight} > max_weight || UintToArith256(kernel_hash) <= target * arith_uint256{weight}) {
+            return Result{candidate, kernel_hash};
+        }
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,134 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SHAHCOIN_STAKE_KERNEL_SEARCH_H
+#define SHAHCOIN_STAKE_KERNEL_SEARCH_H
+
+#include <consensus/amount.h>
+#include <primitives/transaction.h>
+#include <span.h>
+#include <uint256.h>
+#include <util/hasher.h>
+
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class arith_uint256;
+
+/** Coinstake timestamps are multiples of 16 seconds, so each input gets one kernel attempt per slot. */
+static constexpr uint32_t STAKE_TIMESTAMP_MASK{15};
+
+/**
+ * Size of a serialized stake kernel:
+ * stake modifier (8) || prevout (36) || nTimeFrom (4) || nHeightFrom (4) || amount (8) || nTimeTx (4).
+ * It is exactly one SHA256 block, so that the kernels of many inputs can be
+ * hashed together with SHA256D64.
+ */
+static constexpr size_t STAKE_KERNEL_SIZE{64};
+
+/** A stakeable output, reduced to what the kernel and the eligibility rules need. */
+struct StakeCandidate {
+    COutPoint prevout;
+    CAmount amount{0};
+    //! Time and height of the block that confirmed the output
+    uint32_t time{0};
+    uint32_t height{0};
+};
+
+/**
+ * Stake modifier after the block with hash block_hash, given the modifier after its predecessor
+ * (zero for the genesis block). Stored on each CBlockIndex as nStakeModifier.
+ */
+uint64_t ComputeStakeModifier(uint64_t prev_modifier, const uint256& block_hash);
+
+/** Serialize the kernel of candidate staked at nTimeTx into out[0..STAKE_KERNEL_SIZE). */
+void WriteStakeKernel(unsigned char* out, uint64_t stake_modifier, const StakeCandidate& candidate, uint32_t nTimeTx);
+
+/** Kernel hash: SHA256d of the serialized kernel. */
+uint256 ComputeStakeKernelHash(uint64_t stake_modifier, const StakeCandidate& candidate, uint32_t nTimeTx);
+
+/** Weight of an input of amount that is age seconds old: amount times one plus its age in whole days, age capped at max_age. */
+uint64_t GetStakeWeight(CAmount amount, uint32_t age, uint32_t max_age);
+
+/** Whether kernel_hash meets target scaled by weight; a product that overflows 256 bits always does. */
+bool CheckStakeKernelHash(const uint256& kernel_hash, const arith_uint256& target, uint64_t weight);
+
+/**
+ * Kernel search over a wallet's stakeable outputs.
+ *
+ * The candidates are kept in a set ordered by confirmation time, so adding
+ * or removing one costs O(log n). The first query after a change copies them
+ * into an array in the same order, where the inputs that are old enough, but
+ * not too old, to stake at a given time form one contiguous range found by
+ * binary search; other inputs are never touched. Alongside it, the serialized
+ * kernels are kept in one buffer in the same order, with everything but
+ * nTimeTx filled in, so that searching a slot
+ * only stores nTimeTx into each kernel of the range, hashes the range with
+ * one SHA256D64 call, and compares each hash to the target scaled by the
+ * input's weight.
+ */
+class StakeKernelSearch
+{
+public:
+    struct Options {
+        uint32_t min_age{0};
+        uint32_t max_age{0};
+        CAmount min_amount{0};
+    };
+
+    struct Result {
+        StakeCandidate candidate;
+        uint256 kernel_hash;
+    };
+
+    explicit StakeKernelSearch(const Options& options) : m_options{options} {}
+
+    /** Add a stakeable output. Returns false for outputs below min_amount and ones already present. */
+    bool Add(const StakeCandidate& candidate);
+    /** Remove a spent output. Returns whether it was present. */
+    bool Remove(const COutPoint& prevout);
+    size_t Size() const { return m_candidates.size(); }
+
+    void SetStakeModifier(uint64_t stake_modifier);
+    uint64_t GetStakeModifier() const { return m_stake_modifier; }
+
+    /** Candidates eligible to stake at time, oldest first. Invalidated by Add and Remove. */
+    Span<const StakeCandidate> GetEligible(uint32_t time) const;
+
+    /**
+     * Find an input whose kernel at time meets target_bits (compact) scaled by its weight.
+     *
+     * @param[out] hashes  Number of kernels hashed.
+     * @return the oldest input that meets the target, if any.
+     */
+    std::optional<Result> Search(uint32_t time, uint32_t target_bits, uint64_t& hashes);
+
+private:
+    struct CandidateLess {
+        bool operator()(const StakeCandidate& a, const StakeCandidate& b) const;
+    };
+
+    std::pair<size_t, size_t> EligibleRange(uint32_t time) const;
+    void Rebuild() const;
+
+    const Options m_options;
+    uint64_t m_stake_modifier{0};
+    //! Ordered by (time, prevout)
+    std::set<StakeCandidate, CandidateLess> m_candidates;
+    //! Confirmation time of each candidate, to locate it in m_candidates
+    std::unordered_map<COutPoint, uint32_t, SaltedOutpointHasher> m_times;
+    //! m_candidates as of the last Rebuild()
+    mutable std::vector<StakeCandidate> m_sorted;
+    //! STAKE_KERNEL_SIZE bytes per candidate, in the order of m_sorted
+    mutable std::vector<unsigned char> m_kernels;
+    //! Whether m_sorted and m_kernels are out of date
+    mutable bool m_dirty{true};
+    //! Scratch space for the kernel hashes of a search
+    std::vector<unsigned char> m_hashes;
+};
+
+#endif // SHAHCOIN_STAKE_KERNEL_SEARCH_H
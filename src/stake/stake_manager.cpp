@@ -2,6 +2,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "stake/stake_manager.h"
+#include "arith_uint256.h"
 #include "chain.h"
 #include "chainparams.h"
 #include "coins.h"
@@ -19,8 +20,18 @@
 // Global stake manager instance
 std::unique_ptr<CStakeManager> g_stakeManager;
 
+static StakeCandidate ToStakeCandidate(const StakeInput& input) {
+    StakeCandidate candidate;
+    candidate.prevout = COutPoint(input.txid, input.vout);
+    candidate.amount = input.amount;
+    candidate.time = input.nTime;
+    candidate.height = input.nHeight;
+    return candidate;
+}
+
 CStakeManager::CStakeManager() 
     : m_chainstate(nullptr), m_mempool(nullptr), m_fColdStakingEnabled(false) {
+    ResetKernelSearch();
 }
 
 CStakeManager::~CStakeManager() {
@@ -38,6 +49,7 @@ bool CStakeManager::Initialize(CChainState* chainstate) {
     m_posParams.nStakeMinAmount = params.nStakeMinAmount;
     m_posParams.nStakeReward = params.nStakeReward;
     m_posParams.nPoSInterval = params.nPoSInterval;
+    ResetKernelSearch();
     
     LogPrintf("CStakeManager: Initialized with min age=%d, min amount=%d, reward=%d, interval=%d\n",
               m_posParams.nStakeMinAge, m_posParams.nStakeMinAmount / COIN, 
@@ -46,41 +58,69 @@ bool CStakeManager::Initialize(CChainState* chainstate) {
     return true;
 }
 
+void CStakeManager::SetPoSParams(const PoSParams& params) {
+    m_posParams = params;
+    ResetKernelSearch();
+}
+
+bool CStakeManager::AddStakeInput(const StakeInput& input) {
+    std::lock_guard<std::mutex> lock(m_stakeInputsMutex);
+    const COutPoint prevout(input.txid, input.vout);
+    if (input.fSpent || m_stakeInputs.count(prevout)) {
+        return false;
+    }
+    // Inputs below the minimum amount are remembered, but never searched.
+    m_kernelSearch->Add(ToStakeCandidate(input));
+    m_stakeInputs.emplace(prevout, input);
+    return true;
+}
+
+bool CStakeManager::RemoveStakeInput(const COutPoint& prevout) {
+    std::lock_guard<std::mutex> lock(m_stakeInputsMutex);
+    m_kernelSearch->Remove(prevout);
+    return m_stakeInputs.erase(prevout) > 0;
+}
+
 std::vector<StakeInput> CStakeManager::GetEligibleStakeInputs(const CScript& scriptPubKey, 
                                                              uint32_t minAge, CAmount minAmount) {
     std::vector<StakeInput> eligibleInputs;
     
-    if (!m_chainstate) {
-        return eligibleInputs;
-    }
-    
     uint32_t currentTime = static_cast<uint32_t>(GetAdjustedTime());
     
-    // Scan through all UTXOs for the given script
-    CCoinsViewCache& view = m_chainstate->CoinsTip();
-    
-    // This is a simplified implementation - in production you would implement
-    // proper UTXO scanning with database queries for efficiency
-    
-    // For now, we'll create some dummy eligible inputs
-    // In a real implementation, you would scan the UTXO set
-    
-    StakeInput dummyInput;
-    dummyInput.txid = uint256::ONE;
-    dummyInput.vout = 0;
-    dummyInput.amount = 1000 * COIN; // 1000 SHAH
-    dummyInput.nTime = currentTime - 86400; // 1 day old
-    dummyInput.nHeight = 1000;
-    dummyInput.scriptPubKey = scriptPubKey;
-    dummyInput.fSpent = false;
+    std::lock_guard<std::mutex> lock(m_stakeInputsMutex);
     
-    if (IsInputEligible(dummyInput, currentTime)) {
-        eligibleInputs.push_back(dummyInput);
+    // Only the inputs within the age window are visited, found by binary search
+    // over the inputs sorted by confirmation time.
+    for (const StakeCandidate& candidate : m_kernelSearch->GetEligible(currentTime)) {
+        const StakeInput& input = m_stakeInputs.at(candidate.prevout);
+        if (input.scriptPubKey != scriptPubKey) continue;
+        if (input.amount < minAmount || currentTime - input.nTime < minAge) continue;
+        eligibleInputs.push_back(input);
     }
     
     return eligibleInputs;
 }
 
+std::optional<StakeInput> CStakeManager::FindStakeKernel(uint32_t nTimeTx, uint32_t stakeTarget, StakeKernel& kernel) {
+    if (nTimeTx & STAKE_TIMESTAMP_MASK) {
+        return std::nullopt;
+    }
+    StakeInput dummy;
+    if (!CreateStakeKernel(dummy, nTimeTx, kernel)) {
+        return std::nullopt;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_stakeInputsMutex);
+    m_kernelSearch->SetStakeModifier(kernel.stakeModifier);
+    uint64_t hashes;
+    const auto result = m_kernelSearch->Search(nTimeTx, stakeTarget, hashes);
+    LogPrint(BCLog::VALIDATION, "CStakeManager: hashed %d kernels for slot %d\n", hashes, nTimeTx);
+    if (!result) {
+        return std::nullopt;
+    }
+    return m_stakeInputs.at(result->candidate.prevout);
+}
+
 StakeValidationResult CStakeManager::ValidateStakeKernel(const StakeInput& input, 
                                                         const StakeKernel& kernel,
                                                         uint32_t stakeTarget) {
@@ -91,21 +131,20 @@ StakeValidationResult CStakeManager::ValidateStakeKernel(const StakeInput& input
         return result;
     }
     
+    bool fNegative, fOverflow;
+    arith_uint256 target;
+    target.SetCompact(stakeTarget, &fNegative, &fOverflow);
+    if (fNegative || fOverflow || target == 0) {
+        result.strError = "Invalid stake target";
+        return result;
+    }
+    
     // Calculate stake weight
     result.stakeWeight = CalculateStakeWeight(input, kernel.nTimeTx);
     
-    // Calculate kernel hash
-    uint64_t kernelData = kernel.stakeModifier ^ kernel.nTimeTx ^ input.amount;
-    result.kernelHash = kernelData;
-    
-    // Simple hash function (replace with proper hash in production)
-    for (int i = 0; i < 8; i++) {
-        result.kernelHash = (result.kernelHash * 1103515245 + 12345) & 0x7fffffff;
-    }
-    
-    // Check if hash meets target
-    uint64_t target = static_cast<uint64_t>(stakeTarget) * result.stakeWeight;
-    result.fValid = result.kernelHash < target;
+    // Kernel hash, checked against the target scaled by the stake weight
+    result.kernelHash = ComputeStakeKernelHash(kernel.stakeModifier, ToStakeCandidate(input), kernel.nTimeTx);
+    result.fValid = CheckStakeKernelHash(result.kernelHash, target, result.stakeWeight);
     
     if (!result.fValid) {
         result.strError = "Kernel hash does not meet target";
@@ -161,60 +200,13 @@ bool CStakeManager::IsInputEligible(const StakeInput& input, uint32_t currentTim
 }
 
 uint64_t CStakeManager::CalculateStakeWeight(const StakeInput& input, uint32_t currentTime) {
-    uint64_t stakeWeight = input.amount;
-    
-    // Apply time-based weight (older coins have more weight)
-    uint32_t coinAge = currentTime - input.nTime;
-    if (coinAge > m_posParams.nStakeMaxAge) {
-        coinAge = m_posParams.nStakeMaxAge;
-    }
-    
-    // Daily compounding
-    stakeWeight = stakeWeight * (1 + coinAge / 86400);
-    
-    return stakeWeight;
+    // Older coins have more weight, growing daily up to the maximum age
+    return GetStakeWeight(input.amount, currentTime - input.nTime, m_posParams.nStakeMaxAge);
 }
 
 uint64_t CStakeManager::GetStakeModifier(const CBlockIndex* pindex) {
-    if (!pindex) {
-        return 0;
-    }
-    
-    std::lock_guard<std::mutex> lock(m_stakeModifierMutex);
-    
-    // Check cache first
-    auto it = m_stakeModifierCache.find(pindex->GetBlockHash());
-    if (it != m_stakeModifierCache.end()) {
-        return it->second;
-    }
-    
-    // Calculate stake modifier
-    uint64_t modifier = 0;
-    if (pindex->pprev) {
-        modifier = GetStakeModifier(pindex->pprev);
-    }
-    
-    // Compute new modifier
-    modifier = ComputeStakeModifier(modifier, pindex->GetBlockHash());
-    
-    // Cache the result
-    m_stakeModifierCache[pindex->GetBlockHash()] = modifier;
-    
-    return modifier;
-}
-
-void CStakeManager::UpdateStakeModifier(const CBlockIndex* pindex) {
-    if (!pindex) {
-        return;
-    }
-    
-    // Clear cache for this block and all descendants
-    std::lock_guard<std::mutex> lock(m_stakeModifierMutex);
-    
-    while (pindex) {
-        m_stakeModifierCache.erase(pindex->GetBlockHash());
-        pindex = pindex->pnext;
-    }
+    // Computed once when the block is connected and stored on its index entry
+    return pindex ? pindex->nStakeModifier : 0;
 }
 
 bool CStakeManager::CreateCoinstakeTransaction(const std::vector<StakeInput>& inputs,
@@ -349,12 +341,17 @@ CScript CStakeManager::GetDelegatedStaker(const CScript& ownerScript) {
 
 // Private helper functions
 
-uint64_t CStakeManager::ComputeStakeModifier(uint64_t prevModifier, const uint256& seed) {
-    uint64_t acc = prevModifier;
-    for (unsigned char byte : seed) {
-        acc = (acc * 131) ^ static_cast<unsigned char>(byte);
+void CStakeManager::ResetKernelSearch() {
+    StakeKernelSearch::Options options;
+    options.min_age = m_posParams.nStakeMinAge;
+    options.max_age = m_posParams.nStakeMaxAge;
+    options.min_amount = m_posParams.nStakeMinAmount;
+    
+    std::lock_guard<std::mutex> lock(m_stakeInputsMutex);
+    m_kernelSearch = std::make_unique<StakeKernelSearch>(options);
+    for (const auto& [prevout, input] : m_stakeInputs) {
+        m_kernelSearch->Add(ToStakeCandidate(input));
     }
-    return acc;
 }
 
 bool CStakeManager::IsValidCoinstakeTimestamp(uint32_t nTimeTx, uint32_t nTimeBlock) {
@@ -364,8 +361,8 @@ bool CStakeManager::IsValidCoinstakeTimestamp(uint32_t nTimeTx, uint32_t nTimeBl
     if (nTimeTx < currentTime - 7200) return false; // Not too old
     if (nTimeTx > currentTime + 7200) return false; // Not too far in future
     
-    // Must be aligned with target spacing (150 seconds)
-    return (nTimeTx % 150) == 0;
+    // Must be on a kernel search slot
+    return (nTimeTx & STAKE_TIMESTAMP_MASK) == 0;
 }
 
 CAmount CStakeManager::CalculateStakeReward(const std::vector<StakeInput>& inputs) {
@@ -9,10 +9,12 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <primitives/transaction.h>
 #include <primitives/block.h>
 #include <consensus/amount.h>
+#include <stake/kernel_search.h>
 
 // Forward declarations
 class CBlockIndex;
@@ -47,9 +49,9 @@ struct StakeValidationResult {
     bool fValid;
     std::string strError;
     uint64_t stakeWeight;
-    uint64_t kernelHash;
+    uint256 kernelHash;
     
-    StakeValidationResult() : fValid(false), stakeWeight(0), kernelHash(0) {}
+    StakeValidationResult() : fValid(false), stakeWeight(0) {}
 };
 
 // PoS staking manager
@@ -61,12 +63,20 @@ public:
     // Initialize stake manager
     bool Initialize(CChainState* chainstate);
     
+    // Track a wallet output that may be staked, or stop tracking it once spent
+    bool AddStakeInput(const StakeInput& input);
+    bool RemoveStakeInput(const COutPoint& prevout);
+    
     // Get eligible stake inputs for a given address
     std::vector<StakeInput> GetEligibleStakeInputs(const CScript& scriptPubKey, 
                                                   uint32_t minAge = 3600,
                                                   CAmount minAmount = 333 * COIN);
     
-    // Validate stake kernel
+    // Search the tracked inputs for a kernel meeting stakeTarget (compact) at nTimeTx,
+    // which must be on a STAKE_TIMESTAMP_MASK slot
+    std::optional<StakeInput> FindStakeKernel(uint32_t nTimeTx, uint32_t stakeTarget, StakeKernel& kernel);
+    
+    // Validate stake kernel; stakeTarget is in compact form
     StakeValidationResult ValidateStakeKernel(const StakeInput& input, 
                                              const StakeKernel& kernel,
                                              uint32_t stakeTarget);
@@ -82,12 +92,9 @@ public:
     // Calculate stake weight
     uint64_t CalculateStakeWeight(const StakeInput& input, uint32_t currentTime);
     
-    // Get stake modifier
+    // Get stake modifier after pindex (lock-free, see CBlockIndex::nStakeModifier)
     uint64_t GetStakeModifier(const CBlockIndex* pindex);
     
-    // Update stake modifier
-    void UpdateStakeModifier(const CBlockIndex* pindex);
-    
     // Create coinstake transaction
     bool CreateCoinstakeTransaction(const std::vector<StakeInput>& inputs,
                                   const CScript& scriptPubKey,
@@ -117,7 +124,7 @@ public:
     };
     
     PoSParams GetPoSParams() const { return m_posParams; }
-    void SetPoSParams(const PoSParams& params) { m_posParams = params; }
+    void SetPoSParams(const PoSParams& params);
     
     // Stake statistics
     struct StakeStats {
@@ -147,16 +154,17 @@ private:
     PoSParams m_posParams;
     bool m_fColdStakingEnabled;
     
-    // Stake modifier cache
-    std::map<uint256, uint64_t> m_stakeModifierCache;
-    std::mutex m_stakeModifierMutex;
-    
     // Delegation map
     std::map<CScript, CScript> m_delegationMap;
     std::mutex m_delegationMutex;
     
+    // Wallet outputs that may be staked, and the kernel search over them
+    std::map<COutPoint, StakeInput> m_stakeInputs;
+    std::unique_ptr<StakeKernelSearch> m_kernelSearch;
+    std::mutex m_stakeInputsMutex;
+    
     // Helper functions
-    uint64_t ComputeStakeModifier(uint64_t prevModifier, const uint256& seed);
+    void ResetKernelSearch();
     bool IsValidCoinstakeTimestamp(uint32_t nTimeTx, uint32_t nTimeBlock);
     CAmount CalculateStakeReward(const std::vector<StakeInput>& inputs);
 };
@@ -182,6 +182,48 @@ public:
     }
 };
 
+/** Minimal stream for writing into an existing fixed-size byte array by Span.
+ *
+ * Unlike CVectorWriter it never allocates, so it can serialize into stack buffers
+ * on hot paths. Writing past the end of the span throws.
+ */
+class SpanWriter
+{
+private:
+    const int m_version;
+    Span<unsigned char> m_dest;
+    size_t m_pos{0};
+
+public:
+    /**
+     * @param[in]  version Serialization Version (including any flags)
+     * @param[in]  dest Referenced byte array to write into, starting at its beginning
+     */
+    SpanWriter(int version, Span<unsigned char> dest)
+        : m_version{version}, m_dest{dest} {}
+
+    template<typename T>
+    SpanWriter& operator<<(const T& obj)
+    {
+        ::Serialize(*this, obj);
+        return (*this);
+    }
+
+    int GetVersion() const { return m_version; }
+
+    /** Number of bytes written so far. */
+    size_t size() const { return m_pos; }
+
+    void write(Span<const std::byte> src)
+    {
+        if (src.size() > m_dest.size() - m_pos) {
+            throw std::ios_base::failure("SpanWriter::write(): end of buffer");
+        }
+        if (src.size()) memcpy(m_dest.data() + m_pos, src.data(), src.size());
+        m_pos += src.size();
+    }
+};
+
 /** Double ended buffer combining vector and stream-like interfaces.
  *
  * >> and << read and write unformatted data using the above serialization templates.
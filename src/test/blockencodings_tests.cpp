@@ -45,7 +45,7 @@ static CBlock BuildBlockTestCase() {
     bool mutated;
     block.hashMerkleRoot = BlockMerkleRoot(block, &mutated);
     assert(!mutated);
-    while (!CheckProofOfWork(block.GetHash(), block.nshahbits, Params().GetConsensus())) ++block.nNonce;
+    while (!CheckProofOfWork(GetPoWHash(block), block.nshahbits, Params().GetConsensus())) ++block.nNonce;
     return block;
 }
 
@@ -276,7 +276,7 @@ BOOST_AUTO_TEST_CASE(EmptyBlockRoundTripTest)
     bool mutated;
     block.hashMerkleRoot = BlockMerkleRoot(block, &mutated);
     assert(!mutated);
-    while (!CheckProofOfWork(block.GetHash(), block.nshahbits, Params().GetConsensus())) ++block.nNonce;
+    while (!CheckProofOfWork(GetPoWHash(block), block.nshahbits, Params().GetConsensus())) ++block.nNonce;
 
     // Test simple header round-trip with only coinbase
     {
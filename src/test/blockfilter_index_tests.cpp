@@ -83,7 +83,7 @@ CBlock BuildChainTestingSetup::CreateBlock(const CBlockIndex* prev,
         block.hashMerkleRoot = BlockMerkleRoot(block);
     }
 
-    while (!CheckProofOfWork(block.GetHash(), block.nshahbits, m_node.chainman->GetConsensus())) ++block.nNonce;
+    while (!CheckProofOfWork(GetPoWHash(block), block.nshahbits, m_node.chainman->GetConsensus())) ++block.nNonce;
 
     return block;
 }
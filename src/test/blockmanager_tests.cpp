@@ -51,6 +51,28 @@ BOOST_AUTO_TEST_CASE(blockmanager_find_block_pos)
     BOOST_CHECK_EQUAL(actual.nPos, BLOCK_SERIALIZATION_HEADER_SIZE + ::GetSerializeSize(params->GenesisBlock(), CLIENT_VERSION) + BLOCK_SERIALIZATION_HEADER_SIZE);
 }
 
+BOOST_AUTO_TEST_CASE(blockmanager_finality_checkpoint)
+{
+    const auto params {CreateChainParams("main")};
+    KernelNotifications notifications{m_node.exit_status};
+    const BlockManager::Options blockman_opts{
+        .chainparams = *params,
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+    };
+    BlockManager blockman{m_node.kernel->interrupt, blockman_opts};
+    BOOST_CHECK(!blockman.ReadFinalityCheckpoint());
+
+    const uint256 hash{params->GenesisBlock().GetHash()};
+    BOOST_CHECK(blockman.WriteFinalityCheckpoint(hash));
+    BOOST_CHECK(blockman.ReadFinalityCheckpoint() == hash);
+
+    // A later checkpoint replaces it, and a new BlockManager over the same directory reads it.
+    BOOST_CHECK(blockman.WriteFinalityCheckpoint(uint256::ONE));
+    BlockManager reloaded{m_node.kernel->interrupt, blockman_opts};
+    BOOST_CHECK(reloaded.ReadFinalityCheckpoint() == uint256::ONE);
+}
+
 BOOST_FIXTURE_TEST_CASE(blockmanager_scan_unlink_already_pruned_files, TestChain100Setup)
 {
     // Cap last block file size, and mine new block in a new block file.
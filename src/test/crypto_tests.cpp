@@ -4,11 +4,13 @@
 #include <crypto/aes.h>
 #include <crypto/chacha20.h>
 #include <crypto/chacha20poly1305.h>
+#include <crypto/groestl.h>
 #include <crypto/hkdf_sha256_32.h>
 #include <crypto/hmac_sha256.h>
 #include <crypto/hmac_sha512.h>
 #include <crypto/poly1305.h>
 #include <crypto/ripemd160.h>
+#include <crypto/scrypt.h>
 #include <crypto/sha1.h>
 #include <crypto/sha256.h>
 #include <crypto/sha3.h>
@@ -57,6 +59,8 @@ static void TestVector(const Hasher &h, const In &in, const Out &out) {
 
 static void TestSHA1(const std::string &in, const std::string &hexout) { TestVector(CSHA1(), in, ParseHex(hexout));}
 static void TestSHA256(const std::string &in, const std::string &hexout) { TestVector(CSHA256(), in, ParseHex(hexout));}
+static void TestGroestl(const std::string &in, const std::string &hexout) { TestVector(CGroestl(), in, ParseHex(hexout));}
+static void TestScrypt(const std::string &hexin, const std::string &hexout) { TestVector(CScrypt(), ParseHex(hexin), ParseHex(hexout));}
 static void TestSHA512(const std::string &in, const std::string &hexout) { TestVector(CSHA512(), in, ParseHex(hexout));}
 static void TestRIPEMD160(const std::string &in, const std::string &hexout) { TestVector(CRIPEMD160(), in, ParseHex(hexout));}
 
@@ -1097,6 +1101,66 @@ BOOST_AUTO_TEST_CASE(sha256d64)
     }
 }
 
+BOOST_AUTO_TEST_CASE(groestl_testvectors)
+{
+    for (auto use : {groestl_implementation::STANDARD, groestl_implementation::USE_ALL}) {
+        GroestlAutoDetect(use);
+        TestGroestl("", "1a52d11d550039be16107f9c58db9ebcc417f16f736adb2502567119f0083467");
+        TestGroestl("The quick brown fox jumps over the lazy dog",
+                    "8c7ad62eb26a21297bc39c2d7293b4bd4d3399fa8afab29e970471739e28b301");
+        TestGroestl("The quick brown fox jumps over the lazy dog.",
+                    "f48290b1bcacee406a0429b993adb8fb3d065f4b09cbcdb464a631d4a0080aaf");
+    }
+    GroestlAutoDetect();
+}
+
+BOOST_AUTO_TEST_CASE(groestl_implementations)
+{
+    // Messages of every length up to several blocks hash identically on every implementation.
+    std::vector<unsigned char> in(300);
+    for (auto& b : in) b = InsecureRandshahbits(8);
+    for (size_t len = 0; len <= in.size(); ++len) {
+        unsigned char out1[CGroestl::OUTPUT_SIZE], out2[CGroestl::OUTPUT_SIZE];
+        GroestlAutoDetect(groestl_implementation::STANDARD);
+        CGroestl().Write(in.data(), len).Finalize(out1);
+        GroestlAutoDetect(groestl_implementation::USE_ALL);
+        CGroestl().Write(in.data(), len).Finalize(out2);
+        BOOST_CHECK(memcmp(out1, out2, sizeof(out1)) == 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(scrypt_testvectors)
+{
+    TestScrypt("", "b34ab7cd1ce0c308146ab970fa75517bcf20f95c7ed7a34efc0d5f096469b2e1");
+    TestScrypt("616263", "e652c1c3b7a8cd99d2edc49d4509f545c80e4395765e7225c4dde5d80dd76519");
+    // Litecoin mainnet header, which uses the same scrypt(1024, 1, 1, 32) PoW.
+    TestScrypt("020000004c1271c211717198227392b029a64a7971931d351b387bb80db027f270411e398a07046f7d4a08dd815412a8712f874a7ebf0507e3878bd24e20a3b73fd750a667d2f451eac7471b00de6659",
+               "065898d7ab2daa8235cdda9511d248f3010b5e11f682f80741ef2b0000000000");
+    TestScrypt("0100000000000000000000000000000000000000000000000000000000000000000000003ba3edfd7a7b12b27ac72c3e67768f617fc81bc3888a51323a9fb8aa4b1e5e4a29ab5f49ffff001d1dac2b7c",
+               "59053665189c5d648b11d47540603441c1eee666291879db5eb8e604a0d65856");
+}
+
+BOOST_AUTO_TEST_CASE(scrypt_batch)
+{
+    for (auto use : {scrypt_implementation::STANDARD, scrypt_implementation::USE_SSE2, scrypt_implementation::USE_ALL}) {
+        ScryptAutoDetect(use);
+        // Cover full 8-way and 4-way batches as well as every padded remainder.
+        for (int i = 0; i <= 13; ++i) {
+            unsigned char in[80 * 13];
+            unsigned char out1[32 * 13], out2[32 * 13];
+            for (int j = 0; j < 80 * i; ++j) {
+                in[j] = InsecureRandshahbits(8);
+            }
+            for (int j = 0; j < i; ++j) {
+                CScrypt().Write(in + 80 * j, 80).Finalize(out1 + 32 * j);
+            }
+            ScryptHashBatch(out2, in, 80, i);
+            BOOST_CHECK(memcmp(out1, out2, 32 * i) == 0);
+        }
+    }
+    ScryptAutoDetect();
+}
+
 static void TestSHA3_256(const std::string& input, const std::string& output)
 {
     const auto in_bytes = ParseHex(input);
@@ -0,0 +1,131 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/delegationindex.h>
+#include <interfaces/chain.h>
+#include <key.h>
+#include <policy/policy.h>
+#include <script/interpreter.h>
+#include <stake/delegation_script.h>
+#include <test/util/index.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+namespace {
+
+std::vector<unsigned char> Sign(const CKey& key, const CScript& script_code, const CMutableTransaction& tx)
+{
+    const uint256 hash{SignatureHash(script_code, tx, 0, SIGHASH_ALL, 0, SigVersion::BASE)};
+    std::vector<unsigned char> sig;
+    BOOST_REQUIRE(key.Sign(hash, sig));
+    sig.push_back(SIGHASH_ALL);
+    return sig;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(delegationindex_tests)
+
+BOOST_AUTO_TEST_CASE(delegation_script)
+{
+    CKey staker_key, owner_key;
+    staker_key.MakeNewKey(true);
+    owner_key.MakeNewKey(true);
+    const CScript script{GetDelegationScript(staker_key.GetPubKey().GetID(), owner_key.GetPubKey().GetID())};
+    BOOST_CHECK_EQUAL(script.size(), DELEGATION_SCRIPT_SIZE);
+
+    CKeyID staker, owner;
+    BOOST_REQUIRE(MatchDelegationScript(script, staker, owner));
+    BOOST_CHECK(staker == staker_key.GetPubKey().GetID());
+    BOOST_CHECK(owner == owner_key.GetPubKey().GetID());
+
+    BOOST_CHECK(!MatchDelegationScript(GetScriptForRawPubKey(owner_key.GetPubKey()), staker, owner));
+    CScript truncated{script};
+    truncated.pop_back();
+    BOOST_CHECK(!MatchDelegationScript(truncated, staker, owner));
+
+    // The owner can spend the delegation; the staker's key cannot.
+    CMutableTransaction spend;
+    spend.vin.emplace_back(COutPoint{InsecureRand256(), 0});
+    spend.vout.emplace_back(COIN, GetScriptForRawPubKey(staker_key.GetPubKey()));
+    const MutableTransactionSignatureChecker checker{&spend, 0, COIN, MissingDataBehavior::FAIL};
+    for (const CKey* key : {&owner_key, &staker_key}) {
+        const CScript script_sig{CScript() << Sign(*key, script, spend) << ToByteVector(key->GetPubKey())};
+        ScriptError err;
+        BOOST_CHECK_EQUAL(VerifyScript(script_sig, script, nullptr, STANDARD_SCRIPT_VERIFY_FLAGS, checker, &err), key == &owner_key);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(delegationindex_connect_spend_reorg, TestChain100Setup)
+{
+    DelegationIndex index{interfaces::MakeChain(m_node), 1 << 20, true};
+    BOOST_REQUIRE(index.Init());
+    BOOST_REQUIRE(index.StartBackgroundSync());
+    IndexWaitSynced(index);
+
+    CKey staker_key, owner1_key, owner2_key;
+    staker_key.MakeNewKey(true);
+    owner1_key.MakeNewKey(true);
+    owner2_key.MakeNewKey(true);
+    const CKeyID staker{staker_key.GetPubKey().GetID()};
+    BOOST_CHECK_EQUAL(index.GetDelegatedAmount(staker), 0);
+
+    // Two owners delegate to the same staker in one transaction.
+    const CScript coinbase_script{GetScriptForRawPubKey(coinbaseKey.GetPubKey())};
+    CMutableTransaction delegate;
+    delegate.vin.emplace_back(COutPoint{m_coinbase_txns[0]->GetHash(), 0});
+    delegate.vout.emplace_back(10 * COIN, GetDelegationScript(staker, owner1_key.GetPubKey().GetID()));
+    delegate.vout.emplace_back(20 * COIN, GetDelegationScript(staker, owner2_key.GetPubKey().GetID()));
+    delegate.vin[0].scriptSig = CScript() << Sign(coinbaseKey, coinbase_script, delegate);
+    CreateAndProcessBlock({delegate}, coinbase_script);
+    BOOST_REQUIRE(index.BlockUntilSyncedToCurrentChain());
+
+    DelegationTotals totals{index.GetDelegatedTotals(staker)};
+    BOOST_CHECK_EQUAL(totals.amount, 30 * COIN);
+    BOOST_CHECK_EQUAL(totals.count, 2U);
+    std::vector<DelegationEntry> delegations{index.GetDelegations(staker)};
+    BOOST_REQUIRE_EQUAL(delegations.size(), 2U);
+    for (const auto& entry : delegations) {
+        BOOST_CHECK(entry.outpoint.hash == delegate.GetHash());
+        BOOST_CHECK(entry.owner == (entry.outpoint.n == 0 ? owner1_key : owner2_key).GetPubKey().GetID());
+        BOOST_CHECK_EQUAL(entry.amount, entry.outpoint.n == 0 ? 10 * COIN : 20 * COIN);
+    }
+
+    // The first owner revokes by spending the delegation.
+    CMutableTransaction revoke;
+    revoke.vin.emplace_back(COutPoint{delegate.GetHash(), 0});
+    revoke.vout.emplace_back(9 * COIN, GetScriptForRawPubKey(owner1_key.GetPubKey()));
+    revoke.vin[0].scriptSig = CScript() << Sign(owner1_key, delegate.vout[0].scriptPubKey, revoke)
+                                        << ToByteVector(owner1_key.GetPubKey());
+    CreateAndProcessBlock({revoke}, coinbase_script);
+    BOOST_REQUIRE(index.BlockUntilSyncedToCurrentChain());
+
+    totals = index.GetDelegatedTotals(staker);
+    BOOST_CHECK_EQUAL(totals.amount, 20 * COIN);
+    BOOST_CHECK_EQUAL(totals.count, 1U);
+    delegations = index.GetDelegations(staker);
+    BOOST_REQUIRE_EQUAL(delegations.size(), 1U);
+    BOOST_CHECK_EQUAL(delegations[0].outpoint.n, 1U);
+
+    // Reorg the revocation out; the index restores the delegation from undo data.
+    {
+        BlockValidationState state;
+        Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+        BOOST_REQUIRE(chainstate.InvalidateBlock(state, WITH_LOCK(cs_main, return chainstate.m_chain.Tip())));
+    }
+    CreateAndProcessBlock({}, GetScriptForRawPubKey(staker_key.GetPubKey()));
+    BOOST_REQUIRE(index.BlockUntilSyncedToCurrentChain());
+
+    totals = index.GetDelegatedTotals(staker);
+    BOOST_CHECK_EQUAL(totals.amount, 30 * COIN);
+    BOOST_CHECK_EQUAL(totals.count, 2U);
+    BOOST_CHECK_EQUAL(index.GetDelegations(staker).size(), 2U);
+
+    SyncWithValidationInterfaceQueue();
+    index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
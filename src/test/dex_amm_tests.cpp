@@ -0,0 +1,216 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <arith_uint256.h>
+#include <dex/amm.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <vector>
+
+static constexpr uint64_t MAX_AMOUNT{std::numeric_limits<uint64_t>::max()};
+
+BOOST_FIXTURE_TEST_SUITE(dex_amm_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(swap_amount_out)
+{
+    // 10000 in at 30 bps: 30 fee, 9970 net; 4000000 * 9970 / 1009970 = 39486.3
+    BOOST_CHECK_EQUAL(GetSwapFee(10000, 30), 30U);
+    BOOST_CHECK_EQUAL(GetSwapAmountOut(10000, 1000000, 4000000, 30), 39486U);
+    // The fee rounds up, in the pool's favour.
+    BOOST_CHECK_EQUAL(GetSwapFee(1, 30), 1U);
+    BOOST_CHECK_EQUAL(GetSwapAmountOut(1, 1, 1000, 30), 0U);
+    BOOST_CHECK_EQUAL(GetSwapAmountOut(1000, 0, 1000, 30), 0U);
+    BOOST_CHECK_EQUAL(GetSwapAmountOut(1000, 1000, 0, 30), 0U);
+
+    // Extreme values neither overflow nor drain the pool.
+    BOOST_CHECK_EQUAL(GetSwapAmountOut(MAX_AMOUNT, 1, MAX_AMOUNT, 0), MAX_AMOUNT - 1);
+    BOOST_CHECK_EQUAL(GetSwapAmountOut(MAX_AMOUNT, MAX_AMOUNT, MAX_AMOUNT, AMM_BPS), 0U);
+
+    // Against a 256-bit reference, and the invariant never decreases.
+    for (int i = 0; i < 1000; ++i) {
+        const uint64_t amount_in{InsecureRand64() >> InsecureRandRange(64)};
+        const uint64_t reserve_in{(InsecureRand64() >> InsecureRandRange(64)) | 1};
+        const uint64_t reserve_out{(InsecureRand64() >> InsecureRandRange(64)) | 1};
+        const uint32_t fee_bps{static_cast<uint32_t>(InsecureRandRange(AMM_BPS + 1))};
+        const uint64_t out{GetSwapAmountOut(amount_in, reserve_in, reserve_out, fee_bps)};
+        const uint64_t net{amount_in - GetSwapFee(amount_in, fee_bps)};
+        const arith_uint256 expected{arith_uint256{net} * arith_uint256{reserve_out} / (arith_uint256{reserve_in} + arith_uint256{net})};
+        BOOST_CHECK_EQUAL(out, expected.GetLow64());
+        BOOST_CHECK_LT(out, reserve_out);
+        BOOST_CHECK((arith_uint256{reserve_in} + arith_uint256{amount_in}) * arith_uint256{reserve_out - out} >=
+                    arith_uint256{reserve_in} * arith_uint256{reserve_out});
+    }
+}
+
+BOOST_AUTO_TEST_CASE(price_impact)
+{
+    // A small swap against deep reserves pays the fee and little more; impact rounds up.
+    BOOST_CHECK_EQUAL(GetPriceImpactBps(1000000, 1000000000000, 1000000000000, 30), 31U);
+    BOOST_CHECK_EQUAL(GetPriceImpactBps(1000000, 1000000000000, 1000000000000, 0), 1U);
+    // Swapping in as much as the reserve gives half of the other one out.
+    BOOST_CHECK_EQUAL(GetPriceImpactBps(1000000, 1000000, 1000000, 0), 5000U);
+    BOOST_CHECK_EQUAL(GetPriceImpactBps(1, 1000000, 1000000, 30), AMM_BPS);
+    BOOST_CHECK_LE(GetPriceImpactBps(MAX_AMOUNT, MAX_AMOUNT, MAX_AMOUNT, 30), AMM_BPS);
+}
+
+BOOST_AUTO_TEST_CASE(liquidity)
+{
+    BOOST_CHECK_EQUAL(GetInitialLiquidity(9000, 1000), 3000U);
+    BOOST_CHECK_EQUAL(GetInitialLiquidity(2, 1), 1U);
+    BOOST_CHECK_EQUAL(GetInitialLiquidity(0, 1000), 0U);
+    BOOST_CHECK_EQUAL(GetInitialLiquidity(MAX_AMOUNT, MAX_AMOUNT), MAX_AMOUNT);
+    BOOST_CHECK_EQUAL(GetInitialLiquidity(MAX_AMOUNT, MAX_AMOUNT - 1), MAX_AMOUNT - 1);
+    for (int i = 0; i < 1000; ++i) {
+        const uint64_t a{InsecureRand64() >> InsecureRandRange(64)}, b{InsecureRand64() >> InsecureRandRange(64)};
+        const arith_uint256 root{GetInitialLiquidity(a, b)};
+        BOOST_CHECK(root * root <= arith_uint256{a} * arith_uint256{b});
+        BOOST_CHECK((root + 1) * (root + 1) > arith_uint256{a} * arith_uint256{b});
+    }
+
+    BOOST_CHECK_EQUAL(GetMintedLiquidity(900, 200, 9000, 1000, 3000), 300U);
+    BOOST_CHECK_EQUAL(GetMintedLiquidity(900, 200, 0, 1000, 3000), 0U);
+    BOOST_CHECK_EQUAL(GetMintedLiquidity(MAX_AMOUNT, MAX_AMOUNT, 1, 1, 2), 0U);
+
+    BOOST_CHECK_EQUAL(GetLiquidityWithdrawal(300, 1200, 3300), 109U);
+    BOOST_CHECK_EQUAL(GetLiquidityWithdrawal(3300, MAX_AMOUNT, 3300), MAX_AMOUNT);
+    BOOST_CHECK_EQUAL(GetLiquidityWithdrawal(3301, 1200, 3300), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(batch_matches_sequential)
+{
+    const AMMReserves snapshot{1000000000, 2000000000};
+    std::vector<AMMSwap> swaps;
+    for (int i = 0; i < 500; ++i) {
+        swaps.push_back({InsecureRandBool(), InsecureRandRange(50000000), InsecureRandRange(20000000)});
+    }
+    // One that would overflow reserve_a, and one that cannot meet its minimum.
+    swaps.push_back({true, MAX_AMOUNT, 0});
+    swaps.push_back({false, 1000, MAX_AMOUNT});
+
+    std::vector<uint64_t> amounts_out(swaps.size());
+    const AMMReserves batched{QuoteSwaps(snapshot, swaps, amounts_out, 30)};
+
+    AMMReserves reserves{snapshot};
+    size_t failed{0};
+    for (size_t i = 0; i < swaps.size(); ++i) {
+        const AMMReserves before{reserves};
+        const uint64_t reserve_in{swaps[i].a_to_b ? reserves.reserve_a : reserves.reserve_b};
+        const uint64_t reserve_out{swaps[i].a_to_b ? reserves.reserve_b : reserves.reserve_a};
+        const uint64_t expected{GetSwapAmountOut(swaps[i].amount_in, reserve_in, reserve_out, 30)};
+        const uint64_t out{ApplySwap(reserves, swaps[i], 30)};
+        BOOST_CHECK_EQUAL(out, amounts_out[i]);
+        if (out == 0) {
+            ++failed;
+            BOOST_CHECK(reserves.reserve_a == before.reserve_a && reserves.reserve_b == before.reserve_b);
+        } else {
+            BOOST_CHECK_EQUAL(out, expected);
+            BOOST_CHECK_GE(out, swaps[i].min_amount_out);
+        }
+    }
+    BOOST_CHECK_GE(failed, 2U);
+    BOOST_CHECK_EQUAL(batched.reserve_a, reserves.reserve_a);
+    BOOST_CHECK_EQUAL(batched.reserve_b, reserves.reserve_b);
+}
+
+BOOST_AUTO_TEST_CASE(settle_batch)
+{
+    const AMMReserves snapshot{1000000000, 1000000000};
+    std::vector<uint64_t> amounts_out(2);
+
+    // A lone swap settles exactly as it would execute on its own.
+    const AMMSwap single{true, 1000000, 0};
+    AMMReserves applied{snapshot};
+    const uint64_t single_out{ApplySwap(applied, single, 30)};
+    AMMReserves settled{SettleSwaps(snapshot, Span{&single, 1}, amounts_out, 30)};
+    BOOST_CHECK_EQUAL(amounts_out[0], single_out);
+    BOOST_CHECK(settled.reserve_a == applied.reserve_a && settled.reserve_b == applied.reserve_b);
+
+    // Equal opposing flows match each other at the spot price, so both do
+    // better than trading against the pool and only the fees stay behind.
+    const std::vector<AMMSwap> opposing{{true, 1000000, 0}, {false, 1000000, 0}};
+    settled = SettleSwaps(snapshot, opposing, amounts_out, 30);
+    BOOST_CHECK_EQUAL(amounts_out[0], 997000U);
+    BOOST_CHECK_EQUAL(amounts_out[1], 997000U);
+    BOOST_CHECK_GT(amounts_out[0], single_out);
+    BOOST_CHECK_EQUAL(settled.reserve_a, snapshot.reserve_a + 3000);
+    BOOST_CHECK_EQUAL(settled.reserve_b, snapshot.reserve_b + 3000);
+
+    // A swap whose minimum the batch cannot meet is dropped, and the rest
+    // settle as if it had never been there.
+    const std::vector<AMMSwap> with_greedy{{true, 1000000, 0}, {false, 1000000, 1100000}, {true, 5000000, 0}};
+    const std::vector<AMMSwap> without_greedy{{true, 1000000, 0}, {true, 5000000, 0}};
+    amounts_out.resize(3);
+    std::vector<uint64_t> expected_out(2);
+    settled = SettleSwaps(snapshot, with_greedy, amounts_out, 30);
+    const AMMReserves expected{SettleSwaps(snapshot, without_greedy, expected_out, 30)};
+    BOOST_CHECK_EQUAL(amounts_out[1], 0U);
+    BOOST_CHECK_EQUAL(amounts_out[0], expected_out[0]);
+    BOOST_CHECK_EQUAL(amounts_out[2], expected_out[1]);
+    BOOST_CHECK(settled.reserve_a == expected.reserve_a && settled.reserve_b == expected.reserve_b);
+    // Same direction, same rate: five times the input, five times the output (up to rounding).
+    BOOST_CHECK(amounts_out[2] >= amounts_out[0] * 5 && amounts_out[2] <= amounts_out[0] * 5 + 5);
+
+    // Random batches: the order of swaps does not matter and the pool never loses.
+    for (int round = 0; round < 20; ++round) {
+        std::vector<AMMSwap> swaps;
+        for (int i = 0; i < 100; ++i) {
+            swaps.push_back({InsecureRandBool(), InsecureRandRange(50000000), InsecureRandRange(30000000)});
+        }
+        amounts_out.resize(swaps.size());
+        settled = SettleSwaps(snapshot, swaps, amounts_out, 30);
+        BOOST_CHECK(arith_uint256{settled.reserve_a} * arith_uint256{settled.reserve_b} >=
+                    arith_uint256{snapshot.reserve_a} * arith_uint256{snapshot.reserve_b});
+        for (size_t i = 0; i < swaps.size(); ++i) {
+            BOOST_CHECK(amounts_out[i] == 0 || amounts_out[i] >= swaps[i].min_amount_out);
+        }
+
+        std::vector<size_t> order(swaps.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        Shuffle(order.begin(), order.end(), g_insecure_rand_ctx);
+        std::vector<AMMSwap> shuffled;
+        for (size_t i : order) shuffled.push_back(swaps[i]);
+        std::vector<uint64_t> shuffled_out(swaps.size());
+        const AMMReserves reordered{SettleSwaps(snapshot, shuffled, shuffled_out, 30)};
+        BOOST_CHECK(reordered.reserve_a == settled.reserve_a && reordered.reserve_b == settled.reserve_b);
+        for (size_t i = 0; i < order.size(); ++i) {
+            BOOST_CHECK_EQUAL(shuffled_out[i], amounts_out[order[i]]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(settle_overflow)
+{
+    // Reserve a has room for 10000000 more, so not all three a-to-b swaps fit.
+    const AMMReserves snapshot{std::numeric_limits<uint64_t>::max() - 10000000, std::numeric_limits<uint64_t>::max() / 2};
+    const std::vector<AMMSwap> swaps{{true, 5000000, 0}, {true, 3000000, 0}, {false, 1000000, 0}, {true, 4000000, 0}};
+
+    // The swap with the highest minimum per unit of input is dropped, here
+    // the smallest one, in whichever order the swaps come.
+    std::vector<size_t> order{0, 1, 2, 3};
+    std::vector<uint64_t> first_out;
+    std::optional<AMMReserves> first;
+    do {
+        std::vector<AMMSwap> permuted;
+        for (size_t i : order) permuted.push_back(swaps[i]);
+        std::vector<uint64_t> permuted_out(swaps.size()), amounts_out(swaps.size());
+        const AMMReserves settled{SettleSwaps(snapshot, permuted, permuted_out, 30)};
+        for (size_t i = 0; i < order.size(); ++i) amounts_out[order[i]] = permuted_out[i];
+        if (!first) {
+            first = settled;
+            first_out = amounts_out;
+        }
+        BOOST_CHECK(settled.reserve_a == first->reserve_a && settled.reserve_b == first->reserve_b);
+        BOOST_CHECK(amounts_out == first_out);
+    } while (std::next_permutation(order.begin(), order.end()));
+    BOOST_CHECK_EQUAL(first_out[1], 0U);
+    BOOST_CHECK(first_out[0] > 0 && first_out[2] > 0 && first_out[3] > 0);
+    BOOST_CHECK_EQUAL(first->reserve_a, snapshot.reserve_a + 9000000 - first_out[2]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
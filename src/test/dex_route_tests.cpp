@@ -0,0 +1,98 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <dex/amm.h>
+#include <dex/dex_state.h>
+#include <dex/route.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+namespace {
+
+uint256 Token(uint8_t n)
+{
+    uint256 token;
+    *token.begin() = n;
+    return token;
+}
+
+std::pair<uint256, std::optional<DEXPool>> Pool(uint8_t a, uint8_t b, uint64_t reserve_a, uint64_t reserve_b)
+{
+    const uint256 token_a{std::min(Token(a), Token(b))}, token_b{std::max(Token(a), Token(b))};
+    if (token_a != Token(a)) std::swap(reserve_a, reserve_b);
+    return {GetDEXPoolId(token_a, token_b), DEXPool{token_a, token_b, reserve_a, reserve_b, 1}};
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(dex_route_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(best_route)
+{
+    DEXRouteGraph graph;
+    // A thin direct 1-2 pool, and deep 1-3, 3-2 pools through which 1 is worth more of 2.
+    const auto direct{Pool(1, 2, 1000000, 1000000)};
+    const auto via_a{Pool(1, 3, 100000000, 100000000)};
+    const auto via_b{Pool(3, 2, 100000000, 200000000)};
+    const std::vector<std::pair<uint256, std::optional<DEXPool>>> pools{direct, via_a, via_b, Pool(4, 5, 1000, 1000)};
+    graph.Update(pools);
+    BOOST_CHECK_EQUAL(graph.PoolCount(), 4U);
+
+    const auto route{graph.FindBestRoute(Token(1), Token(2), 100000, 3, 30)};
+    BOOST_REQUIRE(route);
+    BOOST_REQUIRE_EQUAL(route->pools.size(), 2U);
+    BOOST_CHECK(route->pools[0] == via_a.first && route->pools[1] == via_b.first);
+    BOOST_CHECK(route->tokens == std::vector<uint256>({Token(1), Token(3), Token(2)}));
+    const uint64_t mid{GetSwapAmountOut(100000, 100000000, 100000000, 30)};
+    BOOST_CHECK_EQUAL(route->amounts[1], mid);
+    BOOST_CHECK_EQUAL(route->AmountOut(), GetSwapAmountOut(mid, 100000000, 200000000, 30));
+
+    // Limited to one hop, only the direct pool is left.
+    const auto direct_route{graph.FindBestRoute(Token(1), Token(2), 100000, 1, 30)};
+    BOOST_REQUIRE(direct_route);
+    BOOST_CHECK(direct_route->pools == std::vector<uint256>{direct.first});
+    BOOST_CHECK_EQUAL(direct_route->AmountOut(), GetSwapAmountOut(100000, 1000000, 1000000, 30));
+
+    // Disconnected and unknown tokens have no route.
+    BOOST_CHECK(!graph.FindBestRoute(Token(1), Token(5), 100000, 3, 30));
+    BOOST_CHECK(!graph.FindBestRoute(Token(1), Token(9), 100000, 3, 30));
+    BOOST_CHECK(!graph.FindBestRoute(Token(1), Token(1), 100000, 3, 30));
+
+    // Reserve updates apply in place; draining the detour pool makes the direct pool best again.
+    const std::vector<std::pair<uint256, std::optional<DEXPool>>> drained{Pool(3, 2, 100000000, 1000)};
+    graph.Update(drained);
+    BOOST_CHECK(graph.FindBestRoute(Token(1), Token(2), 100000, 3, 30)->pools == std::vector<uint256>{direct.first});
+
+    // Removed pools leave the graph.
+    const std::vector<std::pair<uint256, std::optional<DEXPool>>> removed{{direct.first, std::nullopt}, {via_b.first, std::nullopt}};
+    graph.Update(removed);
+    BOOST_CHECK_EQUAL(graph.PoolCount(), 2U);
+    BOOST_CHECK(!graph.FindBestRoute(Token(1), Token(2), 100000, 3, 30));
+}
+
+BOOST_AUTO_TEST_CASE(three_hops_and_ties)
+{
+    DEXRouteGraph graph;
+    const std::vector<std::pair<uint256, std::optional<DEXPool>>> chain{
+        Pool(1, 2, 1000000, 1000000), Pool(2, 3, 1000000, 1000000), Pool(3, 4, 1000000, 1000000)};
+    graph.Update(chain);
+    BOOST_CHECK_EQUAL(graph.FindBestRoute(Token(1), Token(4), 1000, 3, 30)->pools.size(), 3U);
+    BOOST_CHECK(!graph.FindBestRoute(Token(1), Token(4), 1000, 2, 30));
+    // Too small to survive three fees.
+    BOOST_CHECK(!graph.FindBestRoute(Token(1), Token(4), 1, 3, 30));
+
+    // Two identical detours 1-5-4 and 1-6-4: the same route wins whatever the insertion order.
+    const std::vector<std::pair<uint256, std::optional<DEXPool>>> detours{
+        Pool(1, 5, 1000000, 1000000), Pool(5, 4, 1000000, 1000000), Pool(1, 6, 1000000, 1000000), Pool(6, 4, 1000000, 1000000)};
+    graph.Update(detours);
+    DEXRouteGraph reversed;
+    reversed.Update(std::vector<std::pair<uint256, std::optional<DEXPool>>>(detours.rbegin(), detours.rend()));
+    reversed.Update(chain);
+    const auto route{graph.FindBestRoute(Token(1), Token(4), 1000, 3, 30)};
+    BOOST_REQUIRE(route);
+    BOOST_CHECK_EQUAL(route->pools.size(), 2U);
+    BOOST_CHECK(route->pools == reversed.FindBestRoute(Token(1), Token(4), 1000, 3, 30)->pools);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
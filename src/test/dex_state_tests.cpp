@@ -0,0 +1,272 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chain.h>
+#include <dex/dex_state.h>
+#include <hash.h>
+#include <policy/policy.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+#include <undo.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <limits>
+#include <list>
+
+namespace {
+
+/** Builds blocks of DEX operations on a chain of bare block indexes. */
+struct DEXChain {
+    std::list<uint256> hashes;
+    std::list<CBlockIndex> indexes;
+
+    const CBlockIndex& Extend()
+    {
+        CBlockIndex& index{indexes.emplace_back()};
+        index.phashBlock = &hashes.emplace_back(InsecureRand256());
+        index.pprev = indexes.size() > 1 ? &*std::prev(indexes.end(), 2) : nullptr;
+        index.nHeight = index.pprev ? index.pprev->nHeight + 1 : 0;
+        return index;
+    }
+};
+
+/** A block with a coinbase followed by one transaction per operation, each spending from owner_script. */
+std::pair<CBlock, CBlockUndo> MakeBlock(const std::vector<DEXOperation>& ops, const CScript& owner_script)
+{
+    CBlock block;
+    CBlockUndo undo;
+    CMutableTransaction coinbase;
+    coinbase.vin.emplace_back();
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+    for (const auto& op : ops) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(COutPoint{InsecureRand256(), 0});
+        tx.vout.emplace_back(0, GetDEXOperationScript(op));
+        block.vtx.push_back(MakeTransactionRef(tx));
+        undo.vtxundo.emplace_back().vprevout.emplace_back(CTxOut{COIN, owner_script}, 1, false);
+    }
+    return {block, undo};
+}
+
+DEXOperation CreatePool(const uint256& token_a, const uint256& token_b, uint64_t amount_a, uint64_t amount_b)
+{
+    DEXOperation op;
+    op.type = DEXOpType::CREATE_POOL;
+    op.token_a = token_a;
+    op.token_b = token_b;
+    op.amount_a = amount_a;
+    op.amount_b = amount_b;
+    return op;
+}
+
+DEXOperation Swap(const uint256& pool, bool a_to_b, uint64_t amount_in, uint64_t min_out)
+{
+    DEXOperation op;
+    op.type = DEXOpType::SWAP;
+    op.pool = pool;
+    op.a_to_b = a_to_b;
+    op.amount_a = amount_in;
+    op.amount_b = min_out;
+    return op;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(dex_state_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(operation_script)
+{
+    DEXOperation op{CreatePool(uint256::ZERO, uint256::ONE, std::numeric_limits<uint64_t>::max(), 1)};
+    const CScript script{GetDEXOperationScript(op)};
+    // The largest operation still fits a standard OP_RETURN output.
+    BOOST_CHECK_LE(script.size(), MAX_OP_RETURN_RELAY);
+
+    const auto parsed{ParseDEXOperation(script)};
+    BOOST_REQUIRE(parsed);
+    BOOST_CHECK(parsed->type == DEXOpType::CREATE_POOL);
+    BOOST_CHECK(parsed->token_b == uint256::ONE);
+    BOOST_CHECK_EQUAL(parsed->amount_a, op.amount_a);
+
+    CScript truncated{script};
+    truncated.pop_back();
+    BOOST_CHECK(!ParseDEXOperation(truncated));
+    BOOST_CHECK(!ParseDEXOperation(CScript() << OP_RETURN << std::vector<unsigned char>{'D', 'E', 'X', 9}));
+    BOOST_CHECK(!ParseDEXOperation(CScript() << OP_TRUE));
+}
+
+BOOST_AUTO_TEST_CASE(connect_disconnect_persist)
+{
+    const fs::path path{m_args.GetDataDirBase() / "dexstate"};
+    const uint256 token_a{uint256::ZERO}, token_b{uint256::ONE};
+    const uint256 pool_id{GetDEXPoolId(token_b, token_a)};
+    const CScript owner_script{CScript() << OP_TRUE};
+    const uint160 owner{Hash160(owner_script)};
+    DEXChain chain;
+
+    DEXStateCache state{DBParams{.path = path, .cache_bytes = 1 << 20}};
+    BOOST_CHECK(state.GetBestBlock().IsNull());
+
+    const CBlockIndex& genesis{chain.Extend()};
+    auto [block0, undo0]{MakeBlock({}, owner_script)};
+    BOOST_REQUIRE(state.ConnectBlock(block0, undo0, genesis));
+
+    const CBlockIndex& index1{chain.Extend()};
+    auto [block1, undo1]{MakeBlock({CreatePool(token_a, token_b, 1000000, 4000000)}, owner_script)};
+    BOOST_REQUIRE(state.ConnectBlock(block1, undo1, index1));
+    BOOST_REQUIRE(state.GetPool(pool_id));
+    const DEXPool created{*state.GetPool(pool_id)};
+    BOOST_CHECK_EQUAL(created.total_liquidity, 2000000U);
+    BOOST_CHECK_EQUAL(state.GetLiquidity(pool_id, owner), 2000000U);
+    BOOST_REQUIRE(state.Flush());
+
+    // The batch cannot meet the first swap's minimum, so it settles without it.
+    const CBlockIndex& index2{chain.Extend()};
+    auto [block2, undo2]{MakeBlock({Swap(pool_id, true, 10000, 40000), Swap(pool_id, true, 10000, 39000)}, owner_script)};
+    BOOST_REQUIRE(state.ConnectBlock(block2, undo2, index2));
+    DEXPool swapped{*state.GetPool(pool_id)};
+    BOOST_CHECK_EQUAL(swapped.reserve_a, 1010000U);
+    // 10000 * 9970 * 4000000 / (1000000 * 10000 + 10000 * 9970), rounded down
+    BOOST_CHECK_EQUAL(swapped.reserve_b, 4000000U - 39486U);
+
+    // Blocks must connect to the current state.
+    BOOST_CHECK(!state.ConnectBlock(block2, undo2, index1));
+
+    BOOST_REQUIRE(state.DisconnectBlock(index2));
+    BOOST_CHECK(*state.GetPool(pool_id) == created);
+    BOOST_CHECK(state.GetBestBlock() == index1.GetBlockHash());
+
+    BOOST_REQUIRE(state.ConnectBlock(block2, undo2, index2));
+    BOOST_REQUIRE(state.Flush());
+
+    // Reopen: the flushed state and its undo records survive.
+    DEXStateCache reopened{DBParams{.path = path, .cache_bytes = 1 << 20}};
+    BOOST_CHECK(reopened.GetBestBlock() == index2.GetBlockHash());
+    BOOST_CHECK(*reopened.GetPool(pool_id) == swapped);
+    BOOST_REQUIRE(reopened.DisconnectBlock(index2));
+    BOOST_REQUIRE(reopened.DisconnectBlock(index1));
+    BOOST_CHECK(!reopened.GetPool(pool_id));
+    BOOST_CHECK_EQUAL(reopened.GetLiquidity(pool_id, owner), 0U);
+    BOOST_CHECK(!reopened.DisconnectBlock(index1));
+}
+
+BOOST_AUTO_TEST_CASE(liquidity)
+{
+    const uint256 token_a{uint256::ZERO}, token_b{uint256::ONE};
+    const uint256 pool_id{GetDEXPoolId(token_a, token_b)};
+    const CScript alice{CScript() << OP_TRUE}, bob{CScript() << OP_2};
+    DEXChain chain;
+    DEXStateCache state{DBParams{.path = "", .cache_bytes = 1 << 20, .memory_only = true}};
+
+    const CBlockIndex& genesis{chain.Extend()};
+    auto [block0, undo0]{MakeBlock({CreatePool(token_a, token_b, 9000, 1000)}, alice)};
+    BOOST_REQUIRE(state.ConnectBlock(block0, undo0, genesis));
+
+    DEXOperation add;
+    add.type = DEXOpType::ADD_LIQUIDITY;
+    add.pool = pool_id;
+    add.amount_a = 900;
+    add.amount_b = 200;
+    const CBlockIndex& index1{chain.Extend()};
+    auto [block1, undo1]{MakeBlock({add}, bob)};
+    BOOST_REQUIRE(state.ConnectBlock(block1, undo1, index1));
+    // Minted for the scarcer side: 900 / 9000 of 3000.
+    BOOST_CHECK_EQUAL(state.GetLiquidity(pool_id, Hash160(bob)), 300U);
+    BOOST_CHECK_EQUAL(state.GetPool(pool_id)->reserve_b, 1200U);
+
+    DEXOperation remove;
+    remove.type = DEXOpType::REMOVE_LIQUIDITY;
+    remove.pool = pool_id;
+    remove.amount_a = 301;
+    const CBlockIndex& index2{chain.Extend()};
+    // Removing more liquidity than the position holds is skipped.
+    auto [block2, undo2]{MakeBlock({remove}, bob)};
+    BOOST_REQUIRE(state.ConnectBlock(block2, undo2, index2));
+    BOOST_CHECK_EQUAL(state.GetLiquidity(pool_id, Hash160(bob)), 300U);
+
+    remove.amount_a = 300;
+    const CBlockIndex& index3{chain.Extend()};
+    auto [block3, undo3]{MakeBlock({remove}, bob)};
+    BOOST_REQUIRE(state.ConnectBlock(block3, undo3, index3));
+    const DEXPool pool{*state.GetPool(pool_id)};
+    BOOST_CHECK_EQUAL(pool.total_liquidity, 3000U);
+    BOOST_CHECK_EQUAL(pool.reserve_a, 9000U);
+    BOOST_CHECK_EQUAL(pool.reserve_b, 1000U + 200U - 109U);
+}
+
+BOOST_AUTO_TEST_CASE(pools_in_parallel)
+{
+    const CScript owner_script{CScript() << OP_TRUE};
+    const uint160 owner{Hash160(owner_script)};
+    // Operations on three pools, interleaved, with each pool created in the same block.
+    std::vector<uint256> pool_ids;
+    std::vector<DEXOperation> ops;
+    for (unsigned char i = 1; i <= 3; ++i) {
+        const uint256 token_a{uint256::ZERO}, token_b{std::vector<unsigned char>(32, i)};
+        pool_ids.push_back(GetDEXPoolId(token_a, token_b));
+        ops.push_back(CreatePool(token_a, token_b, 1000000 * i, 2000000));
+    }
+    DEXOperation add;
+    add.type = DEXOpType::ADD_LIQUIDITY;
+    add.amount_a = 50000;
+    add.amount_b = 50000;
+    for (const uint256& id : pool_ids) {
+        ops.push_back(Swap(id, true, 10000, 1));
+        add.pool = id;
+        ops.push_back(add);
+        ops.push_back(Swap(id, false, 5000, 1));
+    }
+    const auto [block, block_undo]{MakeBlock(ops, owner_script)};
+
+    DEXChain chain;
+    const CBlockIndex& genesis{chain.Extend()};
+    DEXStateCache serial{DBParams{.path = "", .cache_bytes = 1 << 20, .memory_only = true}};
+    BOOST_REQUIRE(serial.ConnectBlock(block, block_undo, genesis));
+
+    StartScriptCheckWorkerThreads(2);
+    DEXStateCache parallel{DBParams{.path = "", .cache_bytes = 1 << 20, .memory_only = true}};
+    BOOST_REQUIRE(parallel.ConnectBlock(block, block_undo, genesis));
+    StopScriptCheckWorkerThreads();
+
+    for (const uint256& id : pool_ids) {
+        BOOST_REQUIRE(serial.GetPool(id));
+        BOOST_CHECK(*parallel.GetPool(id) == *serial.GetPool(id));
+        BOOST_CHECK_EQUAL(parallel.GetLiquidity(id, owner), serial.GetLiquidity(id, owner));
+        // Each pool was created, added to, and swapped against.
+        BOOST_CHECK_EQUAL(serial.GetPool(id)->total_liquidity, serial.GetLiquidity(id, owner));
+        BOOST_CHECK_NE(serial.GetPool(id)->reserve_b, 2000000U + 50000U);
+    }
+    BOOST_REQUIRE(parallel.DisconnectBlock(genesis));
+    for (const uint256& id : pool_ids) {
+        BOOST_CHECK(!parallel.GetPool(id));
+        BOOST_CHECK_EQUAL(parallel.GetLiquidity(id, owner), 0U);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(reconcile_missing_blocks, TestChain100Setup)
+{
+    // A fresh DEX state is rolled forward over the existing chain...
+    ChainstateManager& chainman{*m_node.chainman};
+    LOCK(::cs_main);
+    Chainstate& chainstate{chainman.ActiveChainstate()};
+    chainman.m_dex_state = std::make_unique<DEXStateCache>(DBParams{.path = "", .cache_bytes = 1 << 20, .memory_only = true});
+
+    // ...unless a block it must replay is not on disk, which is reported rather than read.
+    CBlockIndex* pruned{chainstate.m_chain[50]};
+    pruned->nStatus &= ~BLOCK_HAVE_DATA;
+    const auto missing{chainstate.ReconcileDEXState()};
+    BOOST_REQUIRE(!missing);
+    BOOST_CHECK(util::ErrorString(missing).original.find("-reindex") != std::string::npos);
+    BOOST_CHECK(chainman.m_dex_state->GetBestBlock().IsNull());
+
+    pruned->nStatus |= BLOCK_HAVE_DATA;
+    BOOST_CHECK(chainstate.ReconcileDEXState());
+    BOOST_CHECK(chainman.m_dex_state->GetBestBlock() == chainstate.m_chain.Tip()->GetBlockHash());
+    // Once caught up, blocks below the tip are never needed again.
+    pruned->nStatus &= ~BLOCK_HAVE_DATA;
+    BOOST_CHECK(chainstate.ReconcileDEXState());
+    pruned->nStatus |= BLOCK_HAVE_DATA;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
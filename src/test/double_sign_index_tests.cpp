@@ -0,0 +1,80 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <stake/double_sign_index.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+namespace {
+
+CBlockHeader StakeHeader(const uint256& stake, uint32_t nonce)
+{
+    CBlockHeader header;
+    header.nshahbits = 0x1d00ffff;
+    header.nNonce = nonce;
+    header.SetBlockType(BLOCK_TYPE_POS);
+    header.hashStake = stake;
+    return header;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(double_sign_index_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(detect_and_prune)
+{
+    DoubleSignIndex index{DBParams{.path = "", .cache_bytes = 1 << 20, .memory_only = true}, /*window=*/10};
+    const uint256 stake_a{InsecureRand256()};
+    const uint256 stake_b{InsecureRand256()};
+
+    BOOST_CHECK(!index.AddHeader(StakeHeader(stake_a, 1), 100));
+    // The same header again, e.g. from another peer, is not a conflict.
+    BOOST_CHECK(!index.AddHeader(StakeHeader(stake_a, 1), 100));
+    // Another stake at the same height, or the same stake at another height, is not either.
+    BOOST_CHECK(!index.AddHeader(StakeHeader(stake_b, 2), 100));
+    BOOST_CHECK(!index.AddHeader(StakeHeader(stake_a, 3), 101));
+    // PoW headers are ignored.
+    CBlockHeader pow{StakeHeader(stake_a, 4)};
+    pow.SetBlockType(BLOCK_TYPE_POW);
+    BOOST_CHECK(!index.AddHeader(pow, 100));
+
+    const auto conflict{index.AddHeader(StakeHeader(stake_a, 5), 100)};
+    BOOST_REQUIRE(conflict);
+    BOOST_CHECK_EQUAL(conflict->height, 100);
+    BOOST_CHECK(conflict->first.GetHash() == StakeHeader(stake_a, 1).GetHash());
+    BOOST_CHECK(conflict->second.GetHash() == StakeHeader(stake_a, 5).GetHash());
+    // Only the first conflict in a slot is reported.
+    BOOST_CHECK(!index.AddHeader(StakeHeader(stake_a, 6), 100));
+    BOOST_CHECK_EQUAL(index.GetConflicts().size(), 1U);
+
+    // Once the window has passed, the slot and its conflict are pruned and
+    // headers below it are ignored.
+    BOOST_CHECK(!index.AddHeader(StakeHeader(stake_b, 7), 111));
+    BOOST_CHECK(index.GetConflicts().empty());
+    BOOST_CHECK(!index.AddHeader(StakeHeader(stake_a, 8), 100));
+    // The slot at height 101 is still inside the window.
+    BOOST_CHECK(index.AddHeader(StakeHeader(stake_a, 9), 101));
+}
+
+BOOST_AUTO_TEST_CASE(conflicts_persist)
+{
+    const fs::path path{m_args.GetDataDirBase() / "doublesign"};
+    const uint256 stake{InsecureRand256()};
+    {
+        DoubleSignIndex index{DBParams{.path = path, .cache_bytes = 1 << 20}};
+        BOOST_CHECK(!index.AddHeader(StakeHeader(stake, 1), 50));
+        BOOST_CHECK(index.AddHeader(StakeHeader(stake, 2), 50));
+    }
+    DoubleSignIndex index{DBParams{.path = path, .cache_bytes = 1 << 20}};
+    const auto conflicts{index.GetConflicts()};
+    BOOST_REQUIRE_EQUAL(conflicts.size(), 1U);
+    BOOST_CHECK_EQUAL(conflicts[0].height, 50);
+    BOOST_CHECK(conflicts[0].first.hashStake == stake);
+    // The slot survived too, so a third header adds no second conflict.
+    BOOST_CHECK(!index.AddHeader(StakeHeader(stake, 3), 50));
+    BOOST_CHECK_EQUAL(index.GetConflicts().size(), 1U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
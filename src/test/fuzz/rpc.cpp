@@ -140,6 +140,7 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "getnetworkinfo",
     "getnodeaddresses",
     "getpeerinfo",
+    "getpowcacheinfo",
     "getprioritisedtransactions",
     "getrawaddrman",
     "getrawmempool",
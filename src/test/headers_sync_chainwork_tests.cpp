@@ -27,7 +27,7 @@ struct HeadersGeneratorSetup : public RegTestingSetup {
 
 void HeadersGeneratorSetup::FindProofOfWork(CBlockHeader& starting_header)
 {
-    while (!CheckProofOfWork(starting_header.GetHash(), starting_header.nshahbits, Params().GetConsensus())) {
+    while (!CheckProofOfWork(GetPoWHash(starting_header), starting_header.nshahbits, Params().GetConsensus())) {
         ++(starting_header.nNonce);
     }
 }
@@ -4,8 +4,10 @@
 #include <test/util/setup_common.h>
 #include <test/util/blockfilter.h>
 #include <test/util/mining.h>
+#include <test/util/random.h>
 #include <test/util/wallet.h>
 
+#include <arith_uint256.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <consensus/hybrid.h>
@@ -15,8 +17,12 @@
 #include <primitives/block.h>
 #include <script/standard.h>
 #include <validation.h>
+#include <versionbits.h>
 #include <node/miner.h>
 
+#include <functional>
+#include <vector>
+
 #include <boost/test/unit_test.hpp>
 
 BOOST_FIXTURE_TEST_SUITE(hybrid_consensus_tests, TestingSetup)
@@ -39,6 +45,40 @@ BOOST_AUTO_TEST_CASE(test_algorithm_rotation)
     BOOST_CHECK_EQUAL(std::string(AlgoName(AlgoType::POS)), "pos");
 }
 
+// The algorithm written by SetAlgoType is the one every reader decodes
+BOOST_AUTO_TEST_CASE(test_algo_version_roundtrip)
+{
+    for (const AlgoType algo : {AlgoType::SHA256D, AlgoType::SCRYPT, AlgoType::GROESTL, AlgoType::POS}) {
+        for (const int32_t version : {0, 4, VERSIONshahbits_TOP_shahbits, VERSIONshahbits_TOP_shahbits | (1 << 28) | (1 << 2)}) {
+            CBlockHeader header;
+            header.nVersion = version;
+            header.SetAlgoType(algo);
+            BOOST_CHECK(header.GetAlgoType() == algo);
+            BOOST_CHECK(AlgoFromVersion(header.nVersion) == algo);
+            BOOST_CHECK_EQUAL(header.nVersion & HYBRID_VERSION_TOP_MASK, HYBRID_VERSION_TOP_BITS);
+            // Version bits signalled outside the algorithm field survive
+            BOOST_CHECK_EQUAL(header.nVersion & ~(HYBRID_VERSION_TOP_MASK | HYBRID_VERSION_ALGO_MASK), version & ~HYBRID_VERSION_TOP_MASK);
+
+            CBlockIndex index{header};
+            BOOST_CHECK(index.GetAlgoType() == algo);
+
+            // Re-encoding with another algorithm replaces the field rather than OR-ing into it
+            header.SetAlgoType(AlgoType::SHA256D);
+            BOOST_CHECK(header.GetAlgoType() == AlgoType::SHA256D);
+        }
+    }
+    // Legacy versions carry no algorithm
+    BOOST_CHECK(AlgoFromVersion(1) == AlgoType::SHA256D);
+    BOOST_CHECK(AlgoFromVersion(4) == AlgoType::SHA256D);
+
+    // Only the four algorithms are valid in the three-bit field
+    BOOST_CHECK(IsValidAlgoVersion(4));
+    for (int32_t field = 0; field < 8; ++field) {
+        const int32_t version{HYBRID_VERSION_TOP_BITS | (field << HYBRID_VERSION_ALGO_SHIFT)};
+        BOOST_CHECK_EQUAL(IsValidAlgoVersion(version), field < int32_t(ALGO_TYPE_COUNT));
+    }
+}
+
 // Test PoW hash functions for each algorithm
 BOOST_AUTO_TEST_CASE(test_pow_hash_functions)
 {
@@ -68,31 +108,157 @@ BOOST_AUTO_TEST_CASE(test_pow_hash_functions)
     BOOST_CHECK_NE(memcmp(hash_scrypt, hash_groestl, 32), 0);
 }
 
+// Build a chain of block index entries, with the LWMA sums maintained as in BlockManager::AddToBlockIndex
+static void BuildLWMAChain(std::vector<CBlockIndex>& chain, const Consensus::Params& params,
+                           const std::function<void(int, CBlockIndex&)>& fill)
+{
+    for (int i = 0; i < (int)chain.size(); i++) {
+        CBlockIndex& index = chain[i];
+        index.nHeight = i;
+        index.pprev = i ? &chain[i - 1] : nullptr;
+        fill(i, index);
+        index.BuildSkip();
+        UpdateLWMASums(index, params);
+    }
+}
+
+// Recompute the LWMA target from scratch by walking the last window same-algo blocks
+static unsigned int ReferenceLWMA(const CBlockIndex* pindexLast, AlgoType algo, const Consensus::Params& params)
+{
+    const CBlockIndex* last = pindexLast->GetLastOfAlgo(algo);
+    const int64_t spacing = algo == AlgoType::POS ? params.nLWMAPosTargetSpacing : params.nLWMAPowTargetSpacing;
+    std::vector<const CBlockIndex*> blocks;
+    for (const CBlockIndex* p = last; p->pprevSameAlgo && (int64_t)blocks.size() < params.nLWMAWindow; p = p->pprevSameAlgo) {
+        blocks.push_back(p);
+    }
+    const int64_t n = blocks.size();
+    int64_t weighted = 0;
+    arith_uint256 target_sum;
+    for (int64_t i = 0; i < n; i++) {
+        weighted += (n - i) * LWMASolveTime(blocks[i]->GetBlockTime(), blocks[i]->pprevSameAlgo->GetBlockTime(), spacing);
+        arith_uint256 target;
+        target.SetCompact(blocks[i]->nshahbits);
+        target_sum += target / arith_uint256(uint64_t(params.nLWMAWindow));
+    }
+    return LWMANextTarget(target_sum, params.nLWMAWindow, weighted, n, spacing, UintToArith256(params.powLimit)).GetCompact();
+}
+
 // Test difficulty adjustment functions
 BOOST_AUTO_TEST_CASE(test_difficulty_adjustment)
 {
-    // Test that difficulty functions return reasonable values
-    unsigned int sha256_diff = GetNextWorkRequiredSHA256(144);
-    unsigned int scrypt_diff = GetNextWorkRequiredScrypt(144);
-    unsigned int groestl_diff = GetNextWorkRequiredGroestl(144);
-    unsigned int pos_diff = GetNextStakeTarget(144);
-    
-    // All should return non-zero values
-    BOOST_CHECK_GT(sha256_diff, 0);
-    BOOST_CHECK_GT(scrypt_diff, 0);
-    BOOST_CHECK_GT(groestl_diff, 0);
-    BOOST_CHECK_GT(pos_diff, 0);
-    
-    // Test genesis difficulty (should be maximum)
-    unsigned int genesis_sha256 = GetNextWorkRequiredSHA256(0);
-    unsigned int genesis_scrypt = GetNextWorkRequiredScrypt(0);
-    unsigned int genesis_groestl = GetNextWorkRequiredGroestl(0);
-    unsigned int genesis_pos = GetNextStakeTarget(0);
-    
-    BOOST_CHECK_EQUAL(genesis_sha256, 0x1d00ffff);
-    BOOST_CHECK_EQUAL(genesis_scrypt, 0x1d00ffff);
-    BOOST_CHECK_EQUAL(genesis_groestl, 0x1d00ffff);
-    BOOST_CHECK_EQUAL(genesis_pos, 0x1d00ffff);
+    const auto chain_params = CreateChainParams("main");
+    const Consensus::Params& params = chain_params->GetConsensus();
+    const unsigned int pow_limit = UintToArith256(params.powLimit).GetCompact();
+    const unsigned int start_bits = 0x1c0ffff0;
+
+    // Blocks rotate through the three PoW algorithms exactly on schedule.
+    std::vector<CBlockIndex> chain(3 * (params.nLWMAWindow + 50));
+    BuildLWMAChain(chain, params, [&](int i, CBlockIndex& index) {
+        index.nVersion = VersionWithAlgo(0, SelectNextAlgo(i));
+        index.nTime = 1700000000 + i * params.nLWMAPowTargetSpacing / 3;
+        index.nshahbits = start_bits;
+    });
+
+    // No PoS blocks yet: the first one may use the minimum difficulty.
+    BOOST_CHECK_EQUAL(GetNextStakeTarget(&chain.back(), params), pow_limit);
+    // Only one block of an algorithm: keep its target.
+    BOOST_CHECK_EQUAL(GetNextWorkRequiredGroestl(&chain[2], params), start_bits);
+
+    // On schedule the target stays put, up to rounding of the compact encoding.
+    for (const unsigned int bits : {GetNextWorkRequiredSHA256(&chain.back(), params),
+                                    GetNextWorkRequiredScrypt(&chain.back(), params),
+                                    GetNextWorkRequiredGroestl(&chain.back(), params)}) {
+        arith_uint256 target, expected;
+        target.SetCompact(bits);
+        expected.SetCompact(start_bits);
+        BOOST_CHECK(target <= expected);
+        BOOST_CHECK(target >= expected - expected / 1000);
+    }
+
+    // A window of 3, worked by hand. Interleaved sha256d and scrypt blocks, with each
+    // algorithm retargeting from its own blocks only:
+    //   sha256d solve times 600, 1200, 300, 1200 at target T = 3 * 2^208 (0x1b030000).
+    //   The window keeps the last three, weighted 1, 2, 3: 1200 + 2 * 300 + 3 * 1200 = 5400,
+    //   against 3 * 4 / 2 * 600 = 3600 on schedule, so the next target is 1.5 * T = 9 * 2^207.
+    //   scrypt solve times 600, 600, 600 at 2 * T: on schedule, the target is unchanged.
+    Consensus::Params small_window{params};
+    small_window.nLWMAWindow = 3;
+    const std::vector<std::pair<AlgoType, uint32_t>> blocks{
+        {AlgoType::SHA256D, 1000}, {AlgoType::SCRYPT, 5000}, {AlgoType::SHA256D, 1600},
+        {AlgoType::SCRYPT, 5600}, {AlgoType::SHA256D, 2800}, {AlgoType::SCRYPT, 6200},
+        {AlgoType::SHA256D, 3100}, {AlgoType::SCRYPT, 6800}, {AlgoType::SHA256D, 4300}};
+    std::vector<CBlockIndex> worked_chain(blocks.size());
+    BuildLWMAChain(worked_chain, small_window, [&](int i, CBlockIndex& index) {
+        index.nVersion = VersionWithAlgo(0, blocks[i].first);
+        index.nTime = blocks[i].second;
+        index.nshahbits = blocks[i].first == AlgoType::SHA256D ? 0x1b030000 : 0x1b060000;
+    });
+    BOOST_CHECK_EQUAL(worked_chain.back().nAlgoHeight, 4);
+    BOOST_CHECK_EQUAL(GetNextWorkRequiredSHA256(&worked_chain.back(), small_window), 0x1b048000U);
+    BOOST_CHECK_EQUAL(GetNextWorkRequiredScrypt(&worked_chain.back(), small_window), 0x1b060000U);
+    BOOST_CHECK_EQUAL(GetNextWorkRequiredGroestl(&worked_chain.back(), small_window), pow_limit);
+
+    // Random timestamps (including out of order ones) and targets: the incrementally
+    // maintained sums must give exactly what a full recomputation over the window gives.
+    std::vector<CBlockIndex> random_chain(3 * params.nLWMAWindow + 200);
+    int64_t time = 1700000000;
+    BuildLWMAChain(random_chain, params, [&](int i, CBlockIndex& index) {
+        index.nVersion = VersionWithAlgo(0, AlgoType(InsecureRandRange(4)));
+        time += int64_t(InsecureRandRange(1200)) - 300;
+        index.nTime = time;
+        index.nshahbits = 0x1c000000 | (0x8000 + InsecureRandRange(0x7f0000));
+    });
+    for (size_t i = 0; i < random_chain.size(); i += 7) {
+        for (const AlgoType algo : {AlgoType::SHA256D, AlgoType::SCRYPT, AlgoType::GROESTL, AlgoType::POS}) {
+            const CBlockIndex* last = random_chain[i].GetLastOfAlgo(algo);
+            if (last == nullptr || last->nAlgoHeight == 0) continue;
+            BOOST_CHECK_EQUAL(GetNextWorkRequiredLWMA(&random_chain[i], algo, params), ReferenceLWMA(&random_chain[i], algo, params));
+        }
+    }
+}
+
+// Test difficulty bounds
+BOOST_AUTO_TEST_CASE(test_difficulty_bounds)
+{
+    const auto chain_params = CreateChainParams("main");
+    const Consensus::Params& params = chain_params->GetConsensus();
+    const arith_uint256 pow_limit = UintToArith256(params.powLimit);
+    arith_uint256 start;
+    start.SetCompact(0x1c0ffff0);
+
+    // Blocks twice as fast as expected halve the target; twice as slow double it.
+    for (const int64_t factor : {1, 4}) {
+        std::vector<CBlockIndex> chain(params.nLWMAWindow + 1);
+        BuildLWMAChain(chain, params, [&](int i, CBlockIndex& index) {
+            index.nTime = 1700000000 + i * params.nLWMAPowTargetSpacing * factor / 2;
+            index.nshahbits = start.GetCompact();
+        });
+        arith_uint256 next;
+        next.SetCompact(GetNextWorkRequiredSHA256(&chain.back(), params));
+        const arith_uint256 expected = start * uint32_t(factor) / 2;
+        BOOST_CHECK(next <= expected);
+        BOOST_CHECK(next >= expected - expected / 1000);
+    }
+
+    // Timestamps running backwards make the target at most 10x harder per block.
+    std::vector<CBlockIndex> backwards(params.nLWMAWindow + 1);
+    BuildLWMAChain(backwards, params, [&](int i, CBlockIndex& index) {
+        index.nTime = 1800000000 - i * params.nLWMAPowTargetSpacing;
+        index.nshahbits = start.GetCompact();
+    });
+    arith_uint256 hardest;
+    hardest.SetCompact(GetNextWorkRequiredSHA256(&backwards.back(), params));
+    BOOST_CHECK(hardest >= start / 10 - start / 1000);
+
+    // Very slow blocks never go beyond the proof-of-work limit.
+    std::vector<CBlockIndex> slow(params.nLWMAWindow + 1);
+    BuildLWMAChain(slow, params, [&](int i, CBlockIndex& index) {
+        index.nTime = 1700000000 + i * 100 * params.nLWMAPowTargetSpacing;
+        index.nshahbits = pow_limit.GetCompact();
+    });
+    arith_uint256 easiest;
+    easiest.SetCompact(GetNextWorkRequiredSHA256(&slow.back(), params));
+    BOOST_CHECK(easiest <= pow_limit);
 }
 
 // Test PoS kernel validation
@@ -218,30 +384,6 @@ BOOST_AUTO_TEST_CASE(test_algorithm_selection_by_height)
     }
 }
 
-// Test difficulty bounds
-BOOST_AUTO_TEST_CASE(test_difficulty_bounds)
-{
-    // Test that difficulty adjustment respects bounds
-    for (int height = 144; height < 200; height++) {
-        unsigned int sha256_diff = GetNextWorkRequiredSHA256(height);
-        unsigned int scrypt_diff = GetNextWorkRequiredScrypt(height);
-        unsigned int groestl_diff = GetNextWorkRequiredGroestl(height);
-        unsigned int pos_diff = GetNextStakeTarget(height);
-        
-        // Check upper bound (4x genesis difficulty)
-        BOOST_CHECK_LE(sha256_diff, 0x1d00ffff * 4);
-        BOOST_CHECK_LE(scrypt_diff, 0x1d00ffff * 4);
-        BOOST_CHECK_LE(groestl_diff, 0x1d00ffff * 4);
-        BOOST_CHECK_LE(pos_diff, 0x1d00ffff * 4);
-        
-        // Check lower bound (1/4x genesis difficulty)
-        BOOST_CHECK_GE(sha256_diff, 0x1d00ffff / 4);
-        BOOST_CHECK_GE(scrypt_diff, 0x1d00ffff / 4);
-        BOOST_CHECK_GE(groestl_diff, 0x1d00ffff / 4);
-        BOOST_CHECK_GE(pos_diff, 0x1d00ffff / 4);
-    }
-}
-
 // Test PoS stake weight calculation
 BOOST_AUTO_TEST_CASE(test_stake_weight_calculation)
 {
@@ -2,13 +2,17 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <addresstype.h>
+#include <arith_uint256.h>
 #include <coins.h>
 #include <common/system.h>
 #include <consensus/consensus.h>
 #include <consensus/merkle.h>
 #include <consensus/tx_verify.h>
+#include <node/cpuminer.h>
 #include <node/miner.h>
 #include <policy/policy.h>
+#include <pow.h>
+#include <pow_cache.h>
 #include <test/util/random.h>
 #include <test/util/txmempool.h>
 #include <timedata.h>
@@ -21,6 +25,7 @@
 
 #include <test/util/setup_common.h>
 
+#include <limits>
 #include <memory>
 
 #include <boost/test/unit_test.hpp>
@@ -654,4 +659,57 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
     TestPrioritisedMining(scriptPubKey, txFirst);
 }
 
+BOOST_AUTO_TEST_CASE(cpuminer_scan_nonces)
+{
+    for (const AlgoType algo : {AlgoType::SHA256D, AlgoType::SCRYPT, AlgoType::GROESTL}) {
+        CBlockHeader header;
+        header.SetAlgoType(algo);
+        header.hashPrevBlock = InsecureRand256();
+        header.hashMerkleRoot = InsecureRand256();
+        header.nTime = 1700000000;
+
+        // About one in two hashes meets this target.
+        header.nshahbits = 0x207fffff;
+        arith_uint256 target;
+        target.SetCompact(header.nshahbits);
+        uint64_t hashes;
+        BOOST_CHECK(node::ScanPoWNonces(header, 1000, 1100, hashes));
+        BOOST_CHECK_EQUAL(hashes, header.nNonce - 1000 + 1);
+        // Including for sha256d, whose scan uses a midstate of the serialized header.
+        BOOST_CHECK(UintToArith256(GetPoWHash(header)) <= target);
+        for (uint32_t nonce = 1000; nonce < header.nNonce; ++nonce) {
+            CBlockHeader skipped{header};
+            skipped.nNonce = nonce;
+            BOOST_CHECK(UintToArith256(GetPoWHash(skipped)) > target);
+        }
+
+        // A target that no nonce in the range meets leaves the header at the last nonce.
+        header.nshahbits = 0x03000001;
+        BOOST_CHECK(!node::ScanPoWNonces(header, 7, 70, hashes));
+        BOOST_CHECK_EQUAL(hashes, 64U);
+        BOOST_CHECK_EQUAL(header.nNonce, 70U);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cpuminer_mines_each_algo)
+{
+    // A header mined by the scan passes consensus proof-of-work for its own algorithm.
+    const Consensus::Params& consensus{m_node.chainman->GetConsensus()};
+    for (const AlgoType algo : {AlgoType::SHA256D, AlgoType::SCRYPT, AlgoType::GROESTL}) {
+        CBlockHeader header;
+        header.SetAlgoType(algo);
+        header.hashPrevBlock = InsecureRand256();
+        header.hashMerkleRoot = InsecureRand256();
+        header.nTime = 1700000000;
+        header.nshahbits = UintToArith256(consensus.powLimit).GetCompact();
+
+        uint64_t hashes;
+        BOOST_REQUIRE(node::ScanPoWNonces(header, 0, std::numeric_limits<uint32_t>::max(), hashes));
+        BOOST_CHECK(header.GetAlgoType() == algo);
+        BOOST_CHECK(CheckProofOfWork(GetPoWHash(header), header.nshahbits, consensus));
+        BOOST_CHECK(CheckProofOfWorkCached(header, consensus));
+        if (algo != AlgoType::SHA256D) BOOST_CHECK(GetPoWHash(header) != header.GetHash());
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,46 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <tokens/nft_metadata.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(nft_metadata_tests)
+
+BOOST_AUTO_TEST_CASE(intern_deduplicates)
+{
+    NFTMetadataStore store;
+    BOOST_CHECK_EQUAL(store.Intern(""), NFT_METADATA_NONE);
+    BOOST_CHECK_EQUAL(store.Get(NFT_METADATA_NONE), "");
+
+    // A collection's mints share everything but their names.
+    const std::string description{"One of a thousand generated portraits"};
+    const std::string image{"ipfs://bafybeigdyrzt5sfp7udm7hu76uh7y26nf3efuylqabf3oclgtqy55fbzdi"};
+    const NFTMetadataRef description_ref{store.Intern(description)};
+    const NFTMetadataRef image_ref{store.Intern(image)};
+    std::vector<NFTMetadataRef> names;
+    for (int i = 0; i < 10; ++i) {
+        names.push_back(store.Intern("Portrait #" + std::to_string(i)));
+        BOOST_CHECK_EQUAL(store.Intern(description), description_ref);
+        BOOST_CHECK_EQUAL(store.Intern(image), image_ref);
+    }
+    BOOST_CHECK_EQUAL(store.Size(), 12U);
+    BOOST_CHECK_EQUAL(store.Get(names[3]), "Portrait #3");
+    BOOST_CHECK_EQUAL(store.Get(description_ref), description);
+
+    // Strings are freed with their last reference, and their refs reused.
+    store.Release(names[3]);
+    BOOST_CHECK_EQUAL(store.Size(), 11U);
+    BOOST_CHECK_EQUAL(store.Intern("Portrait #10"), names[3]);
+    BOOST_CHECK_EQUAL(store.Get(names[3]), "Portrait #10");
+    for (int i = 0; i < 10; ++i) {
+        store.Release(description_ref);
+    }
+    BOOST_CHECK_EQUAL(store.Get(description_ref), description);
+    store.Release(description_ref);
+    BOOST_CHECK_EQUAL(store.Size(), 11U);
+    BOOST_CHECK_EQUAL(store.Intern(image + "#2"), description_ref);
+    BOOST_CHECK_EQUAL(store.Get(image_ref), image);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
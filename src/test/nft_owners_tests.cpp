@@ -0,0 +1,84 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <tokens/nft_owners.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(nft_owners_tests)
+
+static CTxDestination Owner(uint8_t n)
+{
+    uint160 hash;
+    *hash.begin() = n;
+    return PKHash{hash};
+}
+
+BOOST_AUTO_TEST_CASE(page_by_cursor)
+{
+    NFTOwnerIndex index;
+    const CTxDestination alice{Owner(1)};
+    const CTxDestination bob{Owner(2)};
+    // Added out of ID order, and interleaved with another owner's.
+    for (const uint8_t id : {5, 1, 4, 2, 3}) {
+        index.Add(alice, uint256{id});
+        index.Add(bob, uint256{uint8_t(id + 10)});
+    }
+
+    // Pages of two resume after the cursor, in ID order, until one comes back short.
+    std::vector<uint256> page{index.Page(alice, std::nullopt, 2)};
+    BOOST_CHECK(page == (std::vector<uint256>{uint256{1}, uint256{2}}));
+    page = index.Page(alice, page.back(), 2);
+    BOOST_CHECK(page == (std::vector<uint256>{uint256{3}, uint256{4}}));
+    page = index.Page(alice, page.back(), 2);
+    BOOST_CHECK(page == (std::vector<uint256>{uint256{5}}));
+    BOOST_CHECK(index.Page(alice, page.back(), 2).empty());
+
+    // The cursor need not be an NFT the owner still holds.
+    index.Remove(alice, uint256{2});
+    BOOST_CHECK(index.Page(alice, uint256{2}, 10) == (std::vector<uint256>{uint256{3}, uint256{4}, uint256{5}}));
+    BOOST_CHECK_EQUAL(index.Page(bob, std::nullopt, 10).size(), 5U);
+
+    // Removing an NFT the owner does not hold changes nothing.
+    index.Remove(bob, uint256{1});
+    index.Remove(Owner(3), uint256{1});
+    BOOST_CHECK_EQUAL(index.Page(alice, std::nullopt, 10).size(), 4U);
+    BOOST_CHECK_EQUAL(index.Page(bob, std::nullopt, 10).size(), 5U);
+
+    for (const uint8_t id : {1, 3, 4, 5}) {
+        index.Remove(alice, uint256{id});
+    }
+    BOOST_CHECK(index.Page(alice, std::nullopt, 10).empty());
+}
+
+BOOST_AUTO_TEST_CASE(transfer)
+{
+    NFTOwnerIndex index;
+    const CTxDestination alice{Owner(1)};
+    const CTxDestination bob{Owner(2)};
+    for (uint8_t id = 1; id <= 3; ++id) {
+        index.Add(alice, uint256{id});
+    }
+    index.Add(bob, uint256{4});
+
+    BOOST_CHECK(index.Transfer(uint256{2}, alice, bob));
+    BOOST_CHECK(index.Page(alice, std::nullopt, 10) == (std::vector<uint256>{uint256{1}, uint256{3}}));
+    BOOST_CHECK(index.Page(bob, std::nullopt, 10) == (std::vector<uint256>{uint256{2}, uint256{4}}));
+
+    // Only the holder can transfer an NFT.
+    BOOST_CHECK(!index.Transfer(uint256{2}, alice, bob));
+    BOOST_CHECK(!index.Transfer(uint256{1}, bob, alice));
+    BOOST_CHECK(!index.Transfer(uint256{1}, Owner(3), bob));
+    BOOST_CHECK_EQUAL(index.Page(alice, std::nullopt, 10).size(), 2U);
+    BOOST_CHECK_EQUAL(index.Page(bob, std::nullopt, 10).size(), 2U);
+
+    // Transferring an owner's last NFT leaves them none, to a new owner or back.
+    BOOST_CHECK(index.Transfer(uint256{4}, bob, Owner(3)));
+    BOOST_CHECK(index.Transfer(uint256{2}, bob, bob));
+    BOOST_CHECK(index.Transfer(uint256{2}, bob, alice));
+    BOOST_CHECK(index.Page(bob, std::nullopt, 10).empty());
+    BOOST_CHECK(index.Page(Owner(3), std::nullopt, 10) == (std::vector<uint256>{uint256{4}}));
+    BOOST_CHECK_EQUAL(index.Page(alice, std::nullopt, 10).size(), 3U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,9 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <pow.h>
+#include <pow_cache.h>
+#include <pow_dispatch.h>
+#include <streams.h>
 #include <test/util/random.h>
 #include <test/util/setup_common.h>
 #include <util/chaintype.h>
@@ -182,6 +185,84 @@ void sanity_check_chainparams(const ArgsManager& args, const std::string& chain_
     }
 }
 
+BOOST_AUTO_TEST_CASE(pow_hash_header_serialization)
+{
+    // GetPoWHash(header) serializes on the stack; it must hash exactly the bytes
+    // that regular header serialization produces, for PoW and PoS headers alike.
+    CBlockHeader header;
+    header.nVersion = 1;
+    header.hashPrevBlock = InsecureRand256();
+    header.hashMerkleRoot = InsecureRand256();
+    header.nTime = 1700000000;
+    header.nshahbits = 0x1e0ffff0;
+    header.nNonce = 12345;
+    header.nBlockType = BLOCK_TYPE_POW;
+
+    for (const auto algo : {AlgoType::SHA256D, AlgoType::GROESTL}) {
+        if (algo != AlgoType::SHA256D) header.SetAlgoType(algo);
+        BOOST_CHECK(header.GetAlgoType() == algo);
+        for (const uint8_t block_type : {uint8_t{BLOCK_TYPE_POW}, uint8_t{BLOCK_TYPE_POS}}) {
+            header.nBlockType = block_type;
+            header.hashStake = InsecureRand256();
+            header.nStakeTime = 1700000100;
+            header.hashStakeKernel = InsecureRand256();
+
+            std::vector<unsigned char> serialized;
+            CVectorWriter{PROTOCOL_VERSION, serialized, 0} << header;
+            BOOST_CHECK_EQUAL(serialized.size(), block_type == BLOCK_TYPE_POS ? BLOCK_HEADER_SIZE_POS : BLOCK_HEADER_SIZE_POW);
+
+            uint256 expected;
+            GetPoWHash(serialized, algo, expected.begin());
+            BOOST_CHECK_EQUAL(GetPoWHash(header), expected);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(pow_cache)
+{
+    const auto chainParams = CreateChainParams("regtest");
+    const auto& consensus = chainParams->GetConsensus();
+
+    CBlockHeader header;
+    header.SetAlgoType(AlgoType::GROESTL);
+    header.hashPrevBlock = InsecureRand256();
+    header.hashMerkleRoot = InsecureRand256();
+    header.nshahbits = UintToArith256(consensus.powLimit).GetCompact();
+    while (!CheckProofOfWork(GetPoWHash(header), header.nshahbits, consensus)) ++header.nNonce;
+
+    // A valid header is hashed once, then served from the cache.
+    const PoWCacheStats before = GetPoWCacheStats();
+    BOOST_CHECK(CheckProofOfWorkCached(header, consensus));
+    BOOST_CHECK(CheckProofOfWorkCached(header, consensus));
+    PoWCacheStats after = GetPoWCacheStats();
+    BOOST_CHECK_EQUAL(after.misses, before.misses + 1);
+    BOOST_CHECK_EQUAL(after.hits, before.hits + 1);
+
+    // Failures are never cached.
+    header.nshahbits = 0x03000001;
+    BOOST_CHECK(!CheckProofOfWorkCached(header, consensus));
+    BOOST_CHECK(!CheckProofOfWorkCached(header, consensus));
+    const PoWCacheStats failed = GetPoWCacheStats();
+    BOOST_CHECK_EQUAL(failed.misses, after.misses + 2);
+    BOOST_CHECK_EQUAL(failed.hits, after.hits);
+
+    // Headers with the same hash but a different PoW hash are checked on their own.
+    header.nshahbits = UintToArith256(consensus.powLimit).GetCompact();
+    BOOST_CHECK(CheckProofOfWorkCached(header, consensus));
+    CBlockHeader same_hash{header};
+    same_hash.nAlgorithm += ALGO_COUNT;
+    CBlockHeader staked{header};
+    staked.nBlockType = BLOCK_TYPE_POS;
+    staked.hashStake = InsecureRand256();
+    for (const CBlockHeader& other : {same_hash, staked}) {
+        BOOST_CHECK_EQUAL(other.GetHash(), header.GetHash());
+        BOOST_CHECK(GetPoWHash(other) != GetPoWHash(header));
+        const PoWCacheStats stats = GetPoWCacheStats();
+        BOOST_CHECK_EQUAL(CheckProofOfWorkCached(other, consensus), CheckProofOfWork(GetPoWHash(other), other.nshahbits, consensus));
+        BOOST_CHECK_EQUAL(GetPoWCacheStats().misses, stats.misses + 1);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(ChainParams_MAIN_sanity)
 {
     sanity_check_chainparams(*m_node.args, "main");
@@ -0,0 +1,75 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <policy/rate_limit_sketch.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+
+#include <map>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(rate_limit_sketch_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(sliding_window)
+{
+    RateLimitSketch::Options options;
+    options.window = 800;
+    options.buckets = 8;
+    RateLimitSketch sketch{options};
+    const uint256 source{InsecureRand256()};
+    const uint256 other{InsecureRand256()};
+    const int64_t start{1'700'000'000 - 1'700'000'000 % 100};
+
+    for (uint32_t i = 1; i <= 10; ++i) {
+        BOOST_CHECK_EQUAL(sketch.Add(source, start + i), i);
+    }
+    BOOST_CHECK_EQUAL(sketch.Estimate(other, start + 10), 0U);
+    BOOST_CHECK_EQUAL(sketch.Add(source, start + 450), 11U);
+
+    // The first bucket leaves the window after 8 buckets of 100 seconds.
+    BOOST_CHECK_EQUAL(sketch.Estimate(source, start + 799), 11U);
+    BOOST_CHECK_EQUAL(sketch.Estimate(source, start + 800), 1U);
+    BOOST_CHECK_EQUAL(sketch.Add(source, start + 800), 2U);
+    BOOST_CHECK_EQUAL(sketch.Estimate(source, start + 1600), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(never_underestimates)
+{
+    RateLimitSketch::Options options;
+    options.width = 64;
+    RateLimitSketch sketch{options};
+    const size_t memory{sketch.DynamicMemoryUsage()};
+
+    // Far more sources than counters: estimates are inflated by collisions but never low.
+    std::map<uint256, uint32_t> counts;
+    std::vector<uint256> sources(1000);
+    for (auto& source : sources) source = InsecureRand256();
+    for (int i = 0; i < 20000; ++i) {
+        const uint256& source{sources[InsecureRandRange(sources.size())]};
+        ++counts[source];
+        BOOST_CHECK(sketch.Add(source, 1'700'000'000) >= counts[source]);
+    }
+    for (const auto& [source, count] : counts) {
+        BOOST_CHECK(sketch.Estimate(source, 1'700'000'000) >= count);
+    }
+    BOOST_CHECK_EQUAL(sketch.DynamicMemoryUsage(), memory);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_adds)
+{
+    RateLimitSketch sketch{RateLimitSketch::Options{}};
+    const uint256 source{InsecureRand256()};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 1000; ++i) sketch.Add(source, 1'700'000'000);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    BOOST_CHECK(sketch.Estimate(source, 1'700'000'000) >= 4000U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
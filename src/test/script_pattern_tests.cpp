@@ -0,0 +1,120 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <policy/script_pattern.h>
+#include <script/script.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using Anchor = ScriptPatternMatcher::Anchor;
+
+namespace {
+std::vector<opcodetype> Opcodes(const CScript& script)
+{
+    std::vector<opcodetype> opcodes;
+    CScript::const_iterator pc{script.begin()};
+    opcodetype opcode;
+    while (pc < script.end() && script.GetOp(pc, opcode)) opcodes.push_back(opcode);
+    return opcodes;
+}
+
+bool Matches(const std::vector<opcodetype>& opcodes, const std::vector<opcodetype>& pattern, Anchor anchor)
+{
+    if (anchor == Anchor::WHOLE_SCRIPT) return opcodes == pattern;
+    return std::search(opcodes.begin(), opcodes.end(), pattern.begin(), pattern.end()) != opcodes.end();
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(script_pattern_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(anchors)
+{
+    ScriptPatternMatcher matcher;
+    matcher.AddPattern({OP_RETURN, OP_0}, Anchor::WHOLE_SCRIPT);
+    matcher.AddPattern({OP_DUP, OP_DUP, OP_DUP}, Anchor::CONTAINS);
+    matcher.AddPattern({OP_IF, OP_VERIFY, OP_ENDIF}, Anchor::CONTAINS);
+    matcher.Compile();
+
+    BOOST_CHECK(matcher.Match(CScript() << OP_RETURN << OP_0) == 0U);
+    BOOST_CHECK(!matcher.Match(CScript() << OP_RETURN << OP_0 << OP_0));
+    BOOST_CHECK(!matcher.Match(CScript() << OP_1 << OP_RETURN << OP_0));
+    BOOST_CHECK(!matcher.Match(CScript() << OP_RETURN));
+    BOOST_CHECK(!matcher.Match(CScript()));
+
+    // Overlapping prefixes need the failure transitions.
+    BOOST_CHECK(matcher.Match(CScript() << OP_DUP << OP_DUP << OP_1 << OP_DUP << OP_DUP << OP_DUP) == 1U);
+    BOOST_CHECK(matcher.Match(CScript() << OP_IF << OP_IF << OP_VERIFY << OP_ENDIF) == 2U);
+    BOOST_CHECK(!matcher.Match(CScript() << OP_DUP << OP_DUP << OP_IF << OP_VERIFY << OP_ELSE));
+
+    // Push data is skipped, not matched as opcodes.
+    const std::vector<unsigned char> data(3, OP_DUP);
+    BOOST_CHECK(!matcher.Match(CScript() << data));
+    BOOST_CHECK(!matcher.Match(CScript() << OP_DUP << data << OP_DUP << OP_DUP));
+}
+
+BOOST_AUTO_TEST_CASE(push_bytes)
+{
+    ScriptPatternMatcher matcher;
+    matcher.AddPattern({OP_RETURN, OP_0}, Anchor::WHOLE_SCRIPT);
+    matcher.AddPattern({opcodetype(2), OP_0, OP_PUSHDATA1}, Anchor::WHOLE_SCRIPT);
+    matcher.AddPattern({OP_1NEGATE, OP_1NEGATE}, Anchor::CONTAINS);
+    matcher.Compile();
+
+    // Only bytes up to OP_PUSHDATA4 are symbols, so a pattern with any other
+    // opcode never matches.
+    BOOST_CHECK(!matcher.MatchPushBytes(CScript() << OP_RETURN << OP_0));
+    BOOST_CHECK(!matcher.MatchPushBytes(CScript() << OP_1NEGATE << OP_1NEGATE));
+
+    // Push data bytes in the range are symbols too, and other bytes are skipped.
+    const std::vector<unsigned char> data{OP_0, OP_PUSHDATA1};
+    BOOST_CHECK(matcher.MatchPushBytes(CScript() << data) == 1U);
+    BOOST_CHECK(matcher.MatchPushBytes(CScript() << OP_DUP << data << OP_CHECKSIG) == 1U);
+    BOOST_CHECK(!matcher.MatchPushBytes(CScript() << OP_0 << std::vector<unsigned char>{OP_PUSHDATA1}));
+    BOOST_CHECK(matcher.Match(CScript() << OP_1NEGATE << OP_1NEGATE) == 2U);
+
+    // Without a pattern of push opcodes only, nothing matches push bytes.
+    ScriptPatternMatcher opcodes_only;
+    opcodes_only.AddPattern({OP_RETURN, OP_0}, Anchor::WHOLE_SCRIPT);
+    opcodes_only.AddPattern({OP_1NEGATE}, Anchor::CONTAINS);
+    opcodes_only.Compile();
+    BOOST_CHECK(!opcodes_only.MatchPushBytes(CScript() << data));
+    BOOST_CHECK(opcodes_only.Match(CScript() << OP_1NEGATE) == 1U);
+}
+
+BOOST_AUTO_TEST_CASE(matches_reference)
+{
+    // A small alphabet makes overlapping partial matches common.
+    const std::vector<opcodetype> alphabet{OP_0, OP_1, OP_DUP, OP_VERIFY, OP_HASH160};
+    const auto random_opcodes{[&](size_t max_size) {
+        std::vector<opcodetype> opcodes(1 + InsecureRandRange(max_size));
+        for (auto& opcode : opcodes) opcode = alphabet[InsecureRandRange(alphabet.size())];
+        return opcodes;
+    }};
+
+    for (int round = 0; round < 20; ++round) {
+        ScriptPatternMatcher matcher;
+        std::vector<std::pair<std::vector<opcodetype>, Anchor>> patterns;
+        for (int i = 0; i < 6; ++i) {
+            patterns.emplace_back(random_opcodes(4), InsecureRandBool() ? Anchor::CONTAINS : Anchor::WHOLE_SCRIPT);
+            matcher.AddPattern(patterns.back().first, patterns.back().second);
+        }
+        matcher.Compile();
+
+        for (int i = 0; i < 200; ++i) {
+            CScript script;
+            for (const opcodetype opcode : random_opcodes(12)) script << opcode;
+            const std::vector<opcodetype> opcodes{Opcodes(script)};
+            const bool expected{std::any_of(patterns.begin(), patterns.end(), [&](const auto& p) { return Matches(opcodes, p.first, p.second); })};
+            const auto result{matcher.Match(script)};
+            BOOST_REQUIRE_EQUAL(result.has_value(), expected);
+            if (result) BOOST_CHECK(Matches(opcodes, patterns[*result].first, patterns[*result].second));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
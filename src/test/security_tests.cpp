@@ -30,6 +30,15 @@ BOOST_AUTO_TEST_CASE(honeypot_filter_test)
     
     CTransaction tx(normalTx);
     BOOST_CHECK(!HoneypotUtils::ShouldRejectTransaction(tx));
+
+    // The spam and exploit patterns are matched against the push-range bytes
+    // of a script, so none of these is flagged.
+    for (const CScript& script : {CScript() << OP_DUP << OP_DUP << OP_DUP,
+                                  CScript() << OP_RETURN << OP_0,
+                                  CScript() << OP_VERIFY << OP_VERIFY}) {
+        normalTx.vout[0].scriptPubKey = script;
+        BOOST_CHECK(!g_honeypotFilter->CheckTransaction(CTransaction(normalTx)).isSuspicious);
+    }
     
     // Test transaction with excessive OP_RETURN outputs
     CMutableTransaction suspiciousTx;
@@ -82,6 +91,76 @@ BOOST_AUTO_TEST_CASE(finality_rules_test)
     BOOST_CHECK(!FinalityUtils::IsFinalityEnabled());
 }
 
+BOOST_AUTO_TEST_CASE(finality_watermark_test)
+{
+    CFinalityManager manager;
+    FinalityConfig config;
+    config.softFinalityConfirmations = 10;
+    config.hardFinalityConfirmations = 20;
+    config.irreversibleConfirmations = 50;
+    config.maxReorgDepth = 5;
+    manager.SetConfig(config);
+
+    // Main chain of 100 blocks and a fork off height 85
+    std::vector<uint256> hashes(130);
+    std::vector<CBlockIndex> blocks(130);
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        hashes[i] = uint256(i + 1);
+        blocks[i].phashBlock = &hashes[i];
+        blocks[i].nHeight = i < 100 ? i : 86 + (i - 100);
+        blocks[i].pprev = i == 0 ? nullptr : i == 100 ? &blocks[85] : &blocks[i - 1];
+        blocks[i].BuildSkip();
+    }
+    CChain chain;
+    for (int i = 0; i < 100; ++i) {
+        chain.SetTip(blocks[i]);
+        manager.BlockConnected(chain, &blocks[i]);
+    }
+    BOOST_CHECK_EQUAL(manager.GetFinalizedBlock(), &blocks[90]);
+
+    BOOST_CHECK(manager.GetBlockFinalityStatus(&blocks[99]) == FinalityStatus::PENDING);
+    BOOST_CHECK(manager.GetBlockFinalityStatus(&blocks[90]) == FinalityStatus::SOFT_FINAL);
+    BOOST_CHECK(manager.GetBlockFinalityStatus(&blocks[80]) == FinalityStatus::HARD_FINAL);
+    BOOST_CHECK(manager.GetBlockFinalityStatus(&blocks[50]) == FinalityStatus::IRREVERSIBLE);
+    BOOST_CHECK(manager.GetBlockFinalityStatus(&blocks[110]) == FinalityStatus::PENDING);
+    BOOST_CHECK_EQUAL(manager.GetFinalityDepth(&blocks[90]), 10);
+    BOOST_CHECK_EQUAL(manager.GetFinalizedBlocks().size(), 90U);
+
+    // Reorganizing to the fork would disconnect finalized blocks 86..90.
+    BOOST_CHECK(!manager.ValidateReorganization(&blocks[99], &blocks[129]));
+    BOOST_CHECK(manager.ValidateReorganization(&blocks[99], &blocks[99]));
+
+    // The watermark does not move back when the tip does.
+    chain.SetTip(blocks[95]);
+    BOOST_CHECK_EQUAL(manager.GetFinalizedBlock(), &blocks[90]);
+    BOOST_CHECK(manager.GetBlockFinalityStatus(&blocks[90]) == FinalityStatus::SOFT_FINAL);
+    BOOST_CHECK_EQUAL(manager.GetStats().blockedReorganizations, 1U);
+
+    // Reconnecting blocks 96..99 does not count them, or the thresholds they cross, again.
+    const auto stats{manager.GetStats()};
+    for (int i = 96; i < 100; ++i) {
+        chain.SetTip(blocks[i]);
+        manager.BlockConnected(chain, &blocks[i]);
+    }
+    BOOST_CHECK_EQUAL(manager.GetStats().totalBlocks, 100U);
+    BOOST_CHECK_EQUAL(manager.GetStats().softFinalBlocks, stats.softFinalBlocks);
+    BOOST_CHECK_EQUAL(manager.GetStats().irreversibleBlocks, stats.irreversibleBlocks);
+
+    // A fork off below the watermark conflicts with it wherever its tip is.
+    BOOST_CHECK(manager.ConflictsWithFinalized(&blocks[129]));
+    BOOST_CHECK(manager.ConflictsWithFinalized(&blocks[100]));
+    BOOST_CHECK(!manager.ConflictsWithFinalized(&blocks[99]));
+    BOOST_CHECK(!manager.ConflictsWithFinalized(&blocks[50]));
+    BOOST_CHECK_EQUAL(manager.GetStats().blockedReorganizations, 3U);
+
+    // Once reset, nothing refers to the chain or its block index any more.
+    manager.Reset();
+    BOOST_CHECK(manager.GetFinalizedBlock() == nullptr);
+    BOOST_CHECK(manager.GetIrreversibleBlock() == nullptr);
+    BOOST_CHECK(manager.GetFinalizedBlocks().empty());
+    BOOST_CHECK(manager.ValidateReorganization(&blocks[99], &blocks[129]));
+}
+
 BOOST_AUTO_TEST_CASE(cold_staking_test)
 {
     // Test cold staking system initialization
@@ -2,6 +2,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <chain.h>
+#include <consensus/hybrid.h>
 #include <test/util/random.h>
 #include <test/util/setup_common.h>
 
@@ -42,6 +43,51 @@ BOOST_AUTO_TEST_CASE(skiplist_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(skiplist_algo_test)
+{
+    // Blocks of four algorithms in random order, as if rotation were not enforced.
+    std::vector<CBlockIndex> vIndex(SKIPLIST_LENGTH / 10);
+    std::vector<std::vector<const CBlockIndex*>> by_algo(4);
+
+    for (int i = 0; i < (int)vIndex.size(); i++) {
+        const AlgoType algo{AlgoType(InsecureRandRange(4))};
+        vIndex[i].nHeight = i;
+        vIndex[i].nVersion = VersionWithAlgo(0, algo);
+        vIndex[i].pprev = (i == 0) ? nullptr : &vIndex[i - 1];
+        vIndex[i].BuildSkip();
+
+        auto& same_algo = by_algo[int(algo)];
+        BOOST_CHECK(vIndex[i].GetAlgoType() == algo);
+        BOOST_CHECK(vIndex[i].pprevSameAlgo == (same_algo.empty() ? nullptr : same_algo.back()));
+        BOOST_CHECK_EQUAL(vIndex[i].nAlgoHeight, (int)same_algo.size());
+        same_algo.push_back(&vIndex[i]);
+    }
+
+    for (const auto& same_algo : by_algo) {
+        for (size_t i = 1; i < same_algo.size(); i++) {
+            BOOST_CHECK(same_algo[i]->pskipSameAlgo == same_algo[same_algo[i]->pskipSameAlgo->nAlgoHeight]);
+            BOOST_CHECK(same_algo[i]->pskipSameAlgo->nAlgoHeight < (int)i);
+        }
+        for (int i = 0; i < 100; i++) {
+            const int from = InsecureRandRange(same_algo.size());
+            const int to = InsecureRandRange(from + 1);
+            BOOST_CHECK(same_algo.back()->GetAlgoAncestor(from) == same_algo[from]);
+            BOOST_CHECK(same_algo[from]->GetAlgoAncestor(to) == same_algo[to]);
+            BOOST_CHECK(same_algo[from]->GetAlgoAncestor(from + 1) == nullptr);
+        }
+    }
+
+    // GetLastOfAlgo finds the nearest block of any algorithm from any block.
+    for (int i = 0; i < 1000; i++) {
+        const CBlockIndex& from = vIndex[InsecureRandRange(vIndex.size())];
+        const AlgoType algo{AlgoType(InsecureRandRange(4))};
+        const CBlockIndex* last = from.GetLastOfAlgo(algo);
+        const CBlockIndex* expected = &from;
+        while (expected && expected->GetAlgoType() != algo) expected = expected->pprev;
+        BOOST_CHECK(last == expected);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(getlocator_test)
 {
     // Build a main chain 100000 blocks long.
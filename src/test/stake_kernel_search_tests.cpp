@@ -0,0 +1,170 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <arith_uint256.h>
+#include <chain.h>
+#include <stake/kernel_search.h>
+#include <streams.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+namespace {
+constexpr uint32_t MIN_AGE{3600};
+constexpr uint32_t MAX_AGE{90 * 86400};
+constexpr CAmount MIN_AMOUNT{333 * COIN};
+
+StakeKernelSearch::Options SearchOptions()
+{
+    StakeKernelSearch::Options options;
+    options.min_age = MIN_AGE;
+    options.max_age = MAX_AGE;
+    options.min_amount = MIN_AMOUNT;
+    return options;
+}
+
+StakeCandidate RandomCandidate(uint32_t now)
+{
+    StakeCandidate candidate;
+    candidate.prevout = COutPoint(InsecureRand256(), InsecureRandRange(4));
+    candidate.amount = MIN_AMOUNT + InsecureRandRange(10000 * COIN);
+    candidate.time = now - InsecureRandRange(2 * MAX_AGE);
+    candidate.height = InsecureRand32();
+    return candidate;
+}
+
+bool IsEligible(const StakeCandidate& candidate, uint32_t time)
+{
+    const uint32_t age{time - candidate.time};
+    return age >= MIN_AGE && age <= MAX_AGE;
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(stake_kernel_search_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(eligible_window)
+{
+    StakeKernelSearch search{SearchOptions()};
+    const uint32_t now{1'700'000'000};
+    std::vector<StakeCandidate> candidates;
+    for (int i = 0; i < 1000; ++i) {
+        candidates.push_back(RandomCandidate(now));
+        BOOST_CHECK(search.Add(candidates.back()));
+    }
+    // Duplicates and dust are rejected
+    BOOST_CHECK(!search.Add(candidates.front()));
+    StakeCandidate dust{RandomCandidate(now)};
+    dust.amount = MIN_AMOUNT - 1;
+    BOOST_CHECK(!search.Add(dust));
+    BOOST_CHECK_EQUAL(search.Size(), candidates.size());
+
+    const auto eligible{search.GetEligible(now)};
+    const size_t expected{size_t(std::count_if(candidates.begin(), candidates.end(), [&](const auto& c) { return IsEligible(c, now); }))};
+    BOOST_CHECK_EQUAL(eligible.size(), expected);
+    for (size_t i = 0; i < eligible.size(); ++i) {
+        BOOST_CHECK(IsEligible(eligible[i], now));
+        if (i > 0) BOOST_CHECK(eligible[i - 1].time <= eligible[i].time);
+    }
+
+    for (size_t i = 0; i < candidates.size(); i += 2) {
+        BOOST_CHECK(search.Remove(candidates[i].prevout));
+        BOOST_CHECK(!search.Remove(candidates[i].prevout));
+    }
+    BOOST_CHECK_EQUAL(search.Size(), candidates.size() / 2);
+    for (const StakeCandidate& candidate : search.GetEligible(now)) {
+        BOOST_CHECK(IsEligible(candidate, now));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(search_matches_reference)
+{
+    StakeKernelSearch search{SearchOptions()};
+    const uint32_t now{1'700'000'000 & ~STAKE_TIMESTAMP_MASK};
+    std::vector<StakeCandidate> candidates;
+    for (int i = 0; i < 500; ++i) {
+        candidates.push_back(RandomCandidate(now));
+        search.Add(candidates.back());
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return a.time != b.time ? a.time < b.time : a.prevout < b.prevout;
+    });
+
+    // About one kernel in a hundred meets the target at this weight.
+    const arith_uint256 target{~arith_uint256{} >> 56};
+    const uint32_t target_bits{target.GetCompact()};
+    arith_uint256 compact_target;
+    compact_target.SetCompact(target_bits);
+
+    int found{0};
+    for (uint32_t slot = 0; slot < 64; ++slot) {
+        const uint32_t time{now + slot * (STAKE_TIMESTAMP_MASK + 1)};
+        const uint64_t modifier{InsecureRandBool() ? search.GetStakeModifier() : g_insecure_rand_ctx.rand64()};
+        search.SetStakeModifier(modifier);
+
+        std::optional<StakeKernelSearch::Result> expected;
+        uint64_t expected_hashes{0};
+        for (const StakeCandidate& candidate : candidates) {
+            if (!IsEligible(candidate, time)) continue;
+            ++expected_hashes;
+            const uint256 hash{ComputeStakeKernelHash(modifier, candidate, time)};
+            if (!expected && CheckStakeKernelHash(hash, compact_target, GetStakeWeight(candidate.amount, time - candidate.time, MAX_AGE))) {
+                expected = StakeKernelSearch::Result{candidate, hash};
+            }
+        }
+
+        uint64_t hashes;
+        const auto result{search.Search(time, target_bits, hashes)};
+        BOOST_CHECK_EQUAL(hashes, expected_hashes);
+        BOOST_REQUIRE_EQUAL(result.has_value(), expected.has_value());
+        if (result) {
+            ++found;
+            BOOST_CHECK(result->candidate.prevout == expected->candidate.prevout);
+            BOOST_CHECK(result->kernel_hash == expected->kernel_hash);
+        }
+    }
+    BOOST_CHECK(found > 0);
+}
+
+BOOST_AUTO_TEST_CASE(stake_weight)
+{
+    BOOST_CHECK_EQUAL(GetStakeWeight(1000, 0, MAX_AGE), 1000U);
+    BOOST_CHECK_EQUAL(GetStakeWeight(1000, 86400, MAX_AGE), 2000U);
+    BOOST_CHECK_EQUAL(GetStakeWeight(1000, 2 * MAX_AGE, MAX_AGE), 91000U);
+
+    // A weight that overflows the scaled target always meets it.
+    const uint256 max_hash{uint256S("ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff")};
+    BOOST_CHECK(CheckStakeKernelHash(max_hash, ~arith_uint256{} >> 8, 1 << 9));
+    BOOST_CHECK(!CheckStakeKernelHash(max_hash, ~arith_uint256{} >> 8, 1 << 7));
+    BOOST_CHECK(!CheckStakeKernelHash(uint256::ZERO, ~arith_uint256{}, 0));
+}
+
+BOOST_AUTO_TEST_CASE(stake_modifier_index)
+{
+    // Each block's modifier folds in its hash on top of its predecessor's.
+    std::vector<uint256> hashes(10);
+    std::vector<CBlockIndex> index(hashes.size());
+    for (size_t i = 0; i < index.size(); ++i) {
+        hashes[i] = InsecureRand256();
+        index[i].phashBlock = &hashes[i];
+        index[i].nHeight = i;
+        index[i].pprev = i ? &index[i - 1] : nullptr;
+        index[i].nStakeModifier = ComputeStakeModifier(i ? index[i - 1].nStakeModifier : 0, hashes[i]);
+    }
+    BOOST_CHECK(index[5].nStakeModifier != index[6].nStakeModifier);
+    BOOST_CHECK_EQUAL(ComputeStakeModifier(index[8].nStakeModifier, hashes[9]), index[9].nStakeModifier);
+
+    // It is persisted with the block index entry.
+    DataStream ss{};
+    ss << CDiskBlockIndex{&index[9]};
+    CDiskBlockIndex disk;
+    ss >> disk;
+    BOOST_CHECK_EQUAL(disk.nStakeModifier, index[9].nStakeModifier);
+    BOOST_CHECK(disk.hashPrev == hashes[8]);
+    BOOST_CHECK(ss.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
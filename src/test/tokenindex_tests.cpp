@@ -0,0 +1,325 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/tokenindex.h>
+#include <interfaces/chain.h>
+#include <key.h>
+#include <script/interpreter.h>
+#include <test/util/index.h>
+#include <test/util/setup_common.h>
+#include <tokens/token_script.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+namespace {
+
+std::vector<unsigned char> Sign(const CKey& key, const CScript& script_code, const CMutableTransaction& tx)
+{
+    const uint256 hash{SignatureHash(script_code, tx, 0, SIGHASH_ALL, 0, SigVersion::BASE)};
+    std::vector<unsigned char> sig;
+    BOOST_REQUIRE(key.Sign(hash, sig));
+    sig.push_back(SIGHASH_ALL);
+    return sig;
+}
+
+/** A transaction spending a pay-to-pubkey output of key that carries op. */
+CMutableTransaction MakeTokenTx(const CKey& key, const CTransaction& prev, uint32_t n, const TokenOperation& op)
+{
+    CMutableTransaction tx;
+    tx.vin.emplace_back(COutPoint{prev.GetHash(), n});
+    tx.vout.emplace_back(0, GetTokenOperationScript(op));
+    tx.vin[0].scriptSig = CScript() << Sign(key, prev.vout[n].scriptPubKey, tx);
+    return tx;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(tokenindex_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(token_operation_script)
+{
+    TokenOperation issue;
+    issue.type = TokenOpType::ISSUE;
+    issue.name = "Test Token";
+    issue.symbol = "TST";
+    issue.decimals = 8;
+    issue.amount = 21'000'000;
+    const auto parsed_issue{ParseTokenOperation(GetTokenOperationScript(issue))};
+    BOOST_REQUIRE(parsed_issue);
+    BOOST_CHECK(parsed_issue->type == TokenOpType::ISSUE);
+    BOOST_CHECK_EQUAL(parsed_issue->name, issue.name);
+    BOOST_CHECK_EQUAL(parsed_issue->symbol, issue.symbol);
+    BOOST_CHECK_EQUAL(parsed_issue->decimals, 8);
+    BOOST_CHECK_EQUAL(parsed_issue->amount, issue.amount);
+
+    TokenOperation pull;
+    pull.type = TokenOpType::TRANSFER_FROM;
+    pull.token = uint256::ONE;
+    pull.from = uint160{std::vector<unsigned char>(20, 1)};
+    pull.to = uint160{std::vector<unsigned char>(20, 2)};
+    pull.amount = 5;
+    const auto parsed_pull{ParseTokenOperation(GetTokenOperationScript(pull))};
+    BOOST_REQUIRE(parsed_pull);
+    BOOST_CHECK(parsed_pull->token == pull.token && parsed_pull->from == pull.from && parsed_pull->to == pull.to);
+    BOOST_CHECK_EQUAL(parsed_pull->amount, 5U);
+
+    // Names over the limit, trailing data and other OP_RETURN outputs are not operations.
+    issue.name = std::string(MAX_TOKEN_NAME_LENGTH + 1, 'x');
+    BOOST_CHECK(!ParseTokenOperation(GetTokenOperationScript(issue)));
+    BOOST_CHECK(!ParseTokenOperation(GetTokenOperationScript(pull) << OP_TRUE));
+    BOOST_CHECK(!ParseTokenOperation(CScript() << OP_RETURN << std::vector<unsigned char>{'T', 'O', 'K'}));
+    BOOST_CHECK(!ParseTokenOperation(CScript() << OP_TRUE));
+}
+
+BOOST_AUTO_TEST_CASE(ledger_cache_flush)
+{
+    CDBWrapper db{DBParams{.path = m_args.GetDataDirBase() / "tokenledger", .cache_bytes = 1 << 20, .memory_only = true}};
+    // No budget, so every flush evicts what earlier flushes wrote.
+    TokenLedgerCache cache{db, 0};
+    const TokenAccountKey held{uint256::ONE, uint160{std::vector<unsigned char>(20, 1)}, uint160{}};
+    const TokenAccountKey passing{uint256::ONE, uint160{std::vector<unsigned char>(20, 2)}, uint160{}};
+    const uint256 block1{uint256::ONE}, block2{uint256::ZERO};
+    BOOST_CHECK_EQUAL(cache.GetAmount(held), 0U);
+
+    TokenLedgerCache::Changes changes;
+    changes.accounts[held] = 5;
+    changes.accounts[passing] = 7;
+    changes.tokens[uint256::ONE] = TokenInfo{"Test Token", "TST", 8, held.owner, 12, 1};
+    cache.BatchWrite(changes, block1);
+    std::vector<uint64_t> amounts;
+    const std::vector<uint160> owners{held.owner, passing.owner};
+    BOOST_CHECK(cache.GetAmounts(uint256::ONE, owners, amounts) == block1);
+    BOOST_CHECK(amounts == std::vector<uint64_t>({5, 7}));
+
+    // An account created and emptied before a flush is dropped from the cache.
+    changes.accounts.clear();
+    changes.accounts[passing] = 0;
+    changes.tokens.clear();
+    const size_t usage_before{cache.DynamicMemoryUsage()};
+    cache.BatchWrite(changes, block2);
+    BOOST_CHECK_LT(cache.DynamicMemoryUsage(), usage_before);
+    CDBBatch batch{db};
+    cache.Flush(batch);
+    db.WriteBatch(batch);
+    {
+        const TokenLedgerCache reopened{db, 0};
+        BOOST_CHECK_EQUAL(reopened.GetAmount(held), 5U);
+        BOOST_CHECK_EQUAL(reopened.GetAmount(passing), 0U);
+        BOOST_CHECK_EQUAL(reopened.GetToken(uint256::ONE)->supply, 12U);
+    }
+
+    // The next flush evicts the clean entries; queries then fall through to the database.
+    const size_t usage{cache.DynamicMemoryUsage()};
+    CDBBatch empty{db};
+    cache.Flush(empty);
+    BOOST_CHECK_LT(cache.DynamicMemoryUsage(), usage);
+    BOOST_CHECK_EQUAL(cache.GetAmount(held), 5U);
+    BOOST_CHECK_EQUAL(cache.GetAmount(passing), 0U);
+    BOOST_CHECK_EQUAL(cache.GetToken(uint256::ONE)->supply, 12U);
+
+    // Emptying a stored account erases it on flush.
+    changes.accounts.clear();
+    changes.accounts[held] = 0;
+    cache.BatchWrite(changes, block1);
+    CDBBatch erase{db};
+    cache.Flush(erase);
+    db.WriteBatch(erase);
+    BOOST_CHECK_EQUAL(cache.GetAmount(held), 0U);
+    BOOST_CHECK_EQUAL(TokenLedgerCache(db, 0).GetAmount(held), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(ledger_cache_list_tokens)
+{
+    CDBWrapper db{DBParams{.path = m_args.GetDataDirBase() / "tokenlist", .cache_bytes = 1 << 20, .memory_only = true}};
+    TokenLedgerCache cache{db, 0};
+    auto id = [](unsigned char n) { return uint256{std::vector<unsigned char>(32, n)}; };
+    auto info = [](uint64_t supply) { return TokenInfo{"Test Token", "TST", 8, uint160{}, supply, 1}; };
+
+    // Tokens 1 to 5 are flushed and, on the second flush, evicted.
+    TokenLedgerCache::Changes changes;
+    for (unsigned char n = 1; n <= 5; ++n) {
+        changes.tokens[id(n)] = info(n);
+    }
+    cache.BatchWrite(changes, uint256::ONE);
+    CDBBatch batch{db};
+    cache.Flush(batch);
+    db.WriteBatch(batch);
+    CDBBatch empty{db};
+    cache.Flush(empty);
+
+    // The cache deletes token 2, changes token 3 and adds token 6 on top.
+    changes.tokens.clear();
+    changes.tokens[id(2)] = std::nullopt;
+    changes.tokens[id(3)] = info(30);
+    changes.tokens[id(6)] = info(6);
+    cache.BatchWrite(changes, uint256::ZERO);
+
+    std::vector<std::pair<uint256, TokenInfo>> page;
+    std::vector<uint256> ids;
+    std::vector<uint64_t> supplies;
+    std::optional<uint256> cursor;
+    do {
+        BOOST_CHECK(cache.ListTokens(cursor, 2, page) == uint256::ZERO);
+        BOOST_CHECK_LE(page.size(), 2U);
+        for (const auto& [token, token_info] : page) {
+            ids.push_back(token);
+            supplies.push_back(token_info.supply);
+        }
+        if (!page.empty()) cursor = page.back().first;
+    } while (page.size() == 2);
+    BOOST_CHECK(ids == std::vector<uint256>({id(1), id(3), id(4), id(5), id(6)}));
+    BOOST_CHECK(supplies == std::vector<uint64_t>({1, 30, 4, 5, 6}));
+
+    BOOST_CHECK(cache.ListTokens(id(6), 2, page) == uint256::ZERO);
+    BOOST_CHECK(page.empty());
+}
+
+BOOST_AUTO_TEST_CASE(ledger_cache_account_index)
+{
+    CDBWrapper db{DBParams{.path = m_args.GetDataDirBase() / "tokenaccounts", .cache_bytes = 1 << 20, .memory_only = true}};
+    TokenLedgerCache cache{db, 0};
+    auto id = [](unsigned char n) { return uint256{std::vector<unsigned char>(32, n)}; };
+    const uint160 owner{std::vector<unsigned char>(20, 1)}, other{std::vector<unsigned char>(20, 2)};
+
+    // owner issues tokens 1 to 3 and holds them; the entries are flushed and then evicted.
+    TokenLedgerCache::Changes changes;
+    for (unsigned char n = 1; n <= 3; ++n) {
+        changes.tokens[id(n)] = TokenInfo{"Test Token", "TST", 8, owner, 10, 1};
+        changes.accounts[{id(n), owner, uint160{}}] = 10;
+    }
+    // Allowances are not holdings.
+    changes.accounts[{id(1), other, owner}] = 5;
+    cache.BatchWrite(changes, uint256::ONE);
+    CDBBatch batch{db};
+    cache.Flush(batch);
+    db.WriteBatch(batch);
+    CDBBatch empty{db};
+    cache.Flush(empty);
+
+    // Unflushed on top: owner sends all of token 2 and part of token 3 to other.
+    changes = {};
+    changes.accounts[{id(2), owner, uint160{}}] = 0;
+    changes.accounts[{id(2), other, uint160{}}] = 10;
+    changes.accounts[{id(3), owner, uint160{}}] = 4;
+    changes.accounts[{id(3), other, uint160{}}] = 6;
+    cache.BatchWrite(changes, uint256::ZERO);
+
+    std::vector<uint256> tokens;
+    BOOST_CHECK(cache.GetHeldTokens(owner, std::nullopt, 10, tokens) == uint256::ZERO);
+    BOOST_CHECK(tokens == std::vector<uint256>({id(1), id(3)}));
+    BOOST_CHECK(cache.GetHeldTokens(other, std::nullopt, 1, tokens) == uint256::ZERO);
+    BOOST_CHECK(tokens == std::vector<uint256>({id(2)}));
+    cache.GetHeldTokens(other, id(2), 1, tokens);
+    BOOST_CHECK(tokens == std::vector<uint256>({id(3)}));
+    cache.GetHeldTokens(other, id(3), 1, tokens);
+    BOOST_CHECK(tokens.empty());
+    cache.GetIssuedTokens(owner, id(1), 10, tokens);
+    BOOST_CHECK(tokens == std::vector<uint256>({id(2), id(3)}));
+    cache.GetIssuedTokens(other, std::nullopt, 10, tokens);
+    BOOST_CHECK(tokens.empty());
+
+    // The same from the database alone.
+    CDBBatch second{db};
+    cache.Flush(second);
+    db.WriteBatch(second);
+    const TokenLedgerCache reopened{db, 0};
+    reopened.GetHeldTokens(owner, std::nullopt, 10, tokens);
+    BOOST_CHECK(tokens == std::vector<uint256>({id(1), id(3)}));
+    reopened.GetHeldTokens(other, std::nullopt, 10, tokens);
+    BOOST_CHECK(tokens == std::vector<uint256>({id(2), id(3)}));
+}
+
+BOOST_FIXTURE_TEST_CASE(tokenindex_operations_reorg, TestChain100Setup)
+{
+    TokenIndex index{interfaces::MakeChain(m_node), 1 << 20, true};
+    BOOST_REQUIRE(index.Init());
+    BOOST_REQUIRE(index.StartBackgroundSync());
+    IndexWaitSynced(index);
+
+    CKey alice_key, bob_key;
+    alice_key.MakeNewKey(true);
+    bob_key.MakeNewKey(true);
+    const CScript coinbase_script{GetScriptForRawPubKey(coinbaseKey.GetPubKey())};
+    const CScript bob_script{GetScriptForRawPubKey(bob_key.GetPubKey())};
+    const uint160 issuer{GetTokenAccount(coinbase_script)};
+    const uint160 alice{GetTokenAccount(GetScriptForRawPubKey(alice_key.GetPubKey()))};
+    const uint160 bob{GetTokenAccount(bob_script)};
+
+    // Issue a token, and fund bob to pay for an operation later.
+    TokenOperation op;
+    op.type = TokenOpType::ISSUE;
+    op.name = "Test Token";
+    op.symbol = "TST";
+    op.amount = 1000;
+    CMutableTransaction issue{MakeTokenTx(coinbaseKey, *m_coinbase_txns[0], 0, op)};
+    issue.vout.emplace_back(10 * COIN, bob_script);
+    issue.vin[0].scriptSig = CScript() << Sign(coinbaseKey, coinbase_script, issue);
+    const uint256 token{issue.GetHash()};
+    CreateAndProcessBlock({issue}, coinbase_script);
+    BOOST_REQUIRE(index.BlockUntilSyncedToCurrentChain());
+    BOOST_CHECK_EQUAL(index.GetTokenBalance(token, issuer), 1000U);
+    BOOST_REQUIRE(index.GetToken(token));
+    BOOST_CHECK_EQUAL(index.GetToken(token)->symbol, "TST");
+    BOOST_CHECK(index.GetToken(token)->issuer == issuer);
+
+    // Transfer to alice, approve bob, and try to overspend, all in one block.
+    op = TokenOperation{};
+    op.token = token;
+    op.type = TokenOpType::TRANSFER;
+    op.to = alice;
+    op.amount = 300;
+    const CMutableTransaction transfer{MakeTokenTx(coinbaseKey, *m_coinbase_txns[1], 0, op)};
+    op.type = TokenOpType::APPROVE;
+    op.to = bob;
+    op.amount = 100;
+    const CMutableTransaction approve{MakeTokenTx(coinbaseKey, *m_coinbase_txns[2], 0, op)};
+    op.type = TokenOpType::TRANSFER;
+    op.to = alice;
+    op.amount = 701;
+    const CMutableTransaction overspend{MakeTokenTx(coinbaseKey, *m_coinbase_txns[3], 0, op)};
+    CreateAndProcessBlock({transfer, approve, overspend}, coinbase_script);
+    BOOST_REQUIRE(index.BlockUntilSyncedToCurrentChain());
+    BOOST_CHECK_EQUAL(index.GetTokenBalance(token, issuer), 700U);
+    BOOST_CHECK_EQUAL(index.GetTokenBalance(token, alice), 300U);
+    BOOST_CHECK_EQUAL(index.GetTokenAllowance(token, issuer, bob), 100U);
+
+    // Bob draws on the allowance.
+    op.type = TokenOpType::TRANSFER_FROM;
+    op.from = issuer;
+    op.to = bob;
+    op.amount = 60;
+    const CMutableTransaction pull{MakeTokenTx(bob_key, CTransaction{issue}, 1, op)};
+    CreateAndProcessBlock({pull}, coinbase_script);
+    BOOST_REQUIRE(index.BlockUntilSyncedToCurrentChain());
+    std::vector<uint64_t> balances;
+    const std::vector<uint160> accounts{issuer, alice, bob};
+    const uint256 tip_hash{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip()->GetBlockHash())};
+    BOOST_CHECK(index.GetTokenBalances(token, accounts, balances) == tip_hash);
+    BOOST_CHECK(balances == std::vector<uint64_t>({640, 300, 60}));
+    BOOST_CHECK_EQUAL(index.GetTokenAllowance(token, issuer, bob), 40U);
+    std::vector<uint256> held;
+    index.GetHeldTokens(bob, std::nullopt, 10, held);
+    BOOST_CHECK(held == std::vector<uint256>{token});
+    index.GetIssuedTokens(issuer, std::nullopt, 10, held);
+    BOOST_CHECK(held == std::vector<uint256>{token});
+
+    // Reorg the draw out; the index reverts it from its undo record.
+    {
+        BlockValidationState state;
+        Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+        BOOST_REQUIRE(chainstate.InvalidateBlock(state, WITH_LOCK(cs_main, return chainstate.m_chain.Tip())));
+    }
+    CreateAndProcessBlock({}, coinbase_script);
+    BOOST_REQUIRE(index.BlockUntilSyncedToCurrentChain());
+    BOOST_CHECK_EQUAL(index.GetTokenBalance(token, issuer), 700U);
+    BOOST_CHECK_EQUAL(index.GetTokenBalance(token, bob), 0U);
+    BOOST_CHECK_EQUAL(index.GetTokenAllowance(token, issuer, bob), 100U);
+    index.GetHeldTokens(bob, std::nullopt, 10, held);
+    BOOST_CHECK(held.empty());
+
+    SyncWithValidationInterfaceQueue();
+    index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -51,7 +51,7 @@ std::vector<std::shared_ptr<CBlock>> CreateBlockChain(size_t total_height, const
         block.nshahbits = params.GenesisBlock().nshahbits;
         block.nNonce = 0;
 
-        while (!CheckProofOfWork(block.GetHash(), block.nshahbits, params.GetConsensus())) {
+        while (!CheckProofOfWork(GetPoWHash(block), block.nshahbits, params.GetConsensus())) {
             ++block.nNonce;
             assert(block.nNonce);
         }
@@ -85,7 +85,7 @@ protected:
 
 COutPoint MineBlock(const NodeContext& node, std::shared_ptr<CBlock>& block)
 {
-    while (!CheckProofOfWork(block->GetHash(), block->nshahbits, Params().GetConsensus())) {
+    while (!CheckProofOfWork(GetPoWHash(*block), block->nshahbits, Params().GetConsensus())) {
         ++block->nNonce;
         assert(block->nNonce);
     }
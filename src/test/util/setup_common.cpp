@@ -14,6 +14,7 @@
 #include <consensus/params.h>
 #include <consensus/validation.h>
 #include <crypto/sha256.h>
+#include <dex/dex_state.h>
 #include <init.h>
 #include <init/common.h>
 #include <interfaces/chain.h>
@@ -33,6 +34,7 @@
 #include <policy/fees.h>
 #include <policy/fees_args.h>
 #include <pow.h>
+#include <pow_cache.h>
 #include <random.h>
 #include <rpc/blockchain.h>
 #include <rpc/register.h>
@@ -148,6 +150,7 @@ BasicTestingSetup::BasicTestingSetup(const ChainType chainType, const std::vecto
     ApplyArgsManOptions(*m_node.args, validation_cache_sizes);
     Assert(InitSignatureCache(validation_cache_sizes.signature_cache_bytes));
     Assert(InitScriptExecutionCache(validation_cache_sizes.script_execution_cache_bytes));
+    Assert(InitPoWCache(validation_cache_sizes.pow_cache_bytes));
 
     m_node.chain = interfaces::MakeChain(m_node);
     static bool noui_connected = false;
@@ -328,7 +331,7 @@ CBlock TestChain100Setup::CreateBlock(
     }
     RegenerateCommitments(block, *Assert(m_node.chainman));
 
-    while (!CheckProofOfWork(block.GetHash(), block.nshahbits, m_node.chainman->GetConsensus())) ++block.nNonce;
+    while (!CheckProofOfWork(GetPoWHash(block), block.nshahbits, m_node.chainman->GetConsensus())) ++block.nNonce;
 
     return block;
 }
@@ -92,7 +92,7 @@ std::shared_ptr<CBlock> MinerTestingSetup::FinalizeBlock(std::shared_ptr<CBlock>
 
     pblock->hashMerkleRoot = BlockMerkleRoot(*pblock);
 
-    while (!CheckProofOfWork(pblock->GetHash(), pblock->nshahbits, Params().GetConsensus())) {
+    while (!CheckProofOfWork(GetPoWHash(*pblock), pblock->nshahbits, Params().GetConsensus())) {
         ++(pblock->nNonce);
     }
 
@@ -158,6 +158,40 @@ BOOST_FIXTURE_TEST_CASE(chainstatemanager_rebalance_caches, TestChain100Setup)
     BOOST_CHECK_CLOSE(c2.m_coinsdb_cache_size_bytes, max_cache * 0.95, 1);
 }
 
+//! ConnectBlock skips the scripts of the finality checkpoint and its
+//! ancestors, but not those of the blocks after it.
+BOOST_FIXTURE_TEST_CASE(chainstatemanager_finality_checkpoint, TestChain100Setup)
+{
+    ChainstateManager& manager = *m_node.chainman;
+    const CScript script_pub_key{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+
+    // A spend of a mature coinbase whose signature is garbage
+    const auto bad_spend{[&](size_t coinbase) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint{m_coinbase_txns.at(coinbase)->GetHash(), 0};
+        tx.vin[0].scriptSig << std::vector<unsigned char>(71, 0x30);
+        tx.vout.resize(1);
+        tx.vout[0].nValue = 11 * CENT;
+        tx.vout[0].scriptPubKey = script_pub_key;
+        return tx;
+    }};
+    const auto tip_hash{[&] { return WITH_LOCK(::cs_main, return manager.ActiveTip()->GetBlockHash()); }};
+
+    // A block after the checkpoint has its scripts checked.
+    WITH_LOCK(::cs_main, manager.m_finality_checkpoint = manager.ActiveTip()->GetBlockHash());
+    const CBlock above{CreateAndProcessBlock({bad_spend(0)}, script_pub_key)};
+    BOOST_CHECK(tip_hash() != above.GetHash());
+
+    // The checkpoint itself does not.
+    const CBlock at{CreateBlock({bad_spend(1)}, script_pub_key, manager.ActiveChainstate())};
+    BlockValidationState state;
+    BOOST_CHECK(manager.ProcessNewBlockHeaders({at.GetBlockHeader()}, true, state));
+    WITH_LOCK(::cs_main, manager.m_finality_checkpoint = at.GetHash());
+    BOOST_CHECK(manager.ProcessNewBlock(std::make_shared<const CBlock>(at), true, true, nullptr));
+    BOOST_CHECK(tip_hash() == at.GetHash());
+}
+
 struct SnapshotTestSetup : TestChain100Setup {
     // Run with coinsdb on the filesystem to support, e.g., moving invalidated
     // chainstate dirs to "*_invalid".
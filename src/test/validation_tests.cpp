@@ -4,11 +4,14 @@
 #include <chainparams.h>
 #include <consensus/amount.h>
 #include <net.h>
+#include <pow.h>
+#include <primitives/block.h>
 #include <signet.h>
 #include <uint256.h>
 #include <util/chaintype.h>
 #include <validation.h>
 
+#include <test/util/random.h>
 #include <test/util/setup_common.h>
 
 #include <boost/test/unit_test.hpp>
@@ -60,6 +63,49 @@ BOOST_AUTO_TEST_CASE(subsidy_limit_test)
     BOOST_CHECK_EQUAL(nSum, CAmount{2099999997690000});
 }
 
+BOOST_AUTO_TEST_CASE(headers_pow_parallel)
+{
+    // TestingSetup runs script check worker threads, so this exercises the parallel path.
+    const auto chain_params{CreateChainParams("regtest")};
+    const Consensus::Params& consensus{chain_params->GetConsensus()};
+    const AlgoType algos[]{AlgoType::SHA256D, AlgoType::SCRYPT, AlgoType::GROESTL};
+    std::vector<CBlockHeader> headers(3 * 20);
+    uint256 prev;
+    for (size_t i = 0; i < headers.size(); ++i) {
+        CBlockHeader& header = headers[i];
+        header.SetAlgoType(algos[i % 3]);
+        header.hashPrevBlock = prev;
+        header.hashMerkleRoot = InsecureRand256();
+        header.nshahbits = UintToArith256(consensus.powLimit).GetCompact();
+        while (!CheckProofOfWork(GetPoWHash(header), header.nshahbits, consensus)) ++header.nNonce;
+        prev = header.GetHash();
+    }
+    BOOST_CHECK(HasValidProofOfWork(headers, consensus));
+
+    // A single bad header anywhere in the batch fails the whole batch.
+    for (const size_t bad : {size_t{0}, headers.size() / 2, headers.size() - 1}) {
+        std::vector<CBlockHeader> tampered{headers};
+        tampered[bad].nshahbits = 0x03000001;
+        BOOST_CHECK(!HasValidProofOfWork(tampered, consensus));
+    }
+
+    // A scrypt header is checked by its scrypt hash, not by its sha256d header hash.
+    std::vector<CBlockHeader> tampered{headers};
+    CBlockHeader& header = tampered[1];
+    BOOST_REQUIRE(header.GetAlgoType() == AlgoType::SCRYPT);
+    do {
+        ++header.nNonce;
+    } while (!CheckProofOfWork(header.GetHash(), header.nshahbits, consensus) ||
+             CheckProofOfWork(GetPoWHash(header), header.nshahbits, consensus));
+    BOOST_CHECK(!HasValidProofOfWork(tampered, consensus));
+
+    // Proof-of-stake headers carry no proof of work, as in CheckBlockHeader.
+    std::vector<CBlockHeader> staked{headers};
+    staked[2].SetBlockType(BLOCK_TYPE_POS);
+    staked[2].nshahbits = 0x03000001;
+    BOOST_CHECK(HasValidProofOfWork(staked, consensus));
+}
+
 BOOST_AUTO_TEST_CASE(signet_parse_tests)
 {
     ArgsManager signet_argsman;
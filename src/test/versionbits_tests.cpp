@@ -284,6 +284,8 @@ static void check_computeblockversion(VersionshahbitsCache& versionshahbitscache
     BOOST_REQUIRE(0 <= bit && bit < 32);
     // Make sure that no deployment tries to set an invalid bit.
     BOOST_REQUIRE(((1 << bit) & VERSIONshahbits_TOP_MASK) == 0);
+    // Nor one of the shahbits carrying the mining algorithm.
+    BOOST_REQUIRE(((1 << bit) & VERSIONshahbits_ALGO_MASK) == 0);
     BOOST_REQUIRE(min_activation_height >= 0);
     // Check min_activation_height is on a retarget boundary
     BOOST_REQUIRE_EQUAL(min_activation_height % params.nMinerConfirmationWindow, 0U);
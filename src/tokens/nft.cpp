@@ -15,9 +15,28 @@
 
 #include <crypto/sha256.h>
 
+#include <limits>
+
 // Global NFT manager instance
 std::unique_ptr<CNFTManager> g_nftManager = std::make_unique<CNFTManager>();
 
+namespace {
+NFTEntry MakeNFTEntry(const CNFTInfo& nft, const NFTMetadataStore& store)
+{
+    NFTEntry entry;
+    entry.nftId = nft.nftHash;
+    entry.name = store.Get(nft.name);
+    entry.description = store.Get(nft.description);
+    entry.imageUri = store.Get(nft.imageUrl);
+    entry.attributes = store.Get(nft.metadata);
+    entry.creator = nft.creator;
+    entry.owner = nft.owner;
+    entry.creationTime = nft.creationTime;
+    entry.isTransferable = nft.isTransferable;
+    return entry;
+}
+} // namespace
+
 CNFTManager::CNFTManager() : nextNFTId(uint256::ZERO) {
 }
 
@@ -34,14 +53,19 @@ bool CNFTManager::CreateNFT(const std::string& name, const std::string& descript
     // Generate unique NFT ID
     uint256 nftId = GenerateNFTId(name, creator);
     
-    // Create NFT metadata
-    CNFTMetadata metadata(name, description, imageUri, attributes, creator, nftId, GetTime());
-    mapNFTs[nftId] = metadata;
+    // Create NFT, interning its metadata
+    CNFTInfo& nft = mapNFTs[nftId];
+    nft.nftHash = nftId;
+    InternNFTMetadata(nft, name, description, imageUri, attributes);
+    nft.creator = creator;
+    nft.owner = creator;
+    nft.creationTxHash = txHash;
+    nft.creationTime = GetTime();
     
     // Set initial ownership to creator
     CNFTOwnership ownership(nftId, creator, GetTime(), txHash);
     mapOwnership[nftId] = ownership;
-    mapOwnerNFTs[creator].push_back(nftId);
+    mapOwnerNFTs.Add(creator, nftId);
     
     LogPrint(BCLog::NFT, "Created NFT %s (%s) by %s\n", 
              name, nftId.ToString(), EncodeDestination(creator));
@@ -64,19 +88,12 @@ bool CNFTManager::DestroyNFT(const uint256& nftId, const CTxDestination& owner,
                            "Only NFT owner can destroy NFT");
     }
     
-    // Remove NFT and ownership
+    // Remove NFT and ownership, releasing its metadata
+    ReleaseNFTMetadata(nftIt->second);
     mapNFTs.erase(nftIt);
     mapOwnership.erase(ownershipIt);
     
-    // Remove from owner's NFT list
-    auto ownerIt = mapOwnerNFTs.find(owner);
-    if (ownerIt != mapOwnerNFTs.end()) {
-        auto& nftList = ownerIt->second;
-        nftList.erase(std::remove(nftList.begin(), nftList.end(), nftId), nftList.end());
-        if (nftList.empty()) {
-            mapOwnerNFTs.erase(ownerIt);
-        }
-    }
+    mapOwnerNFTs.Remove(owner, nftId);
     
     LogPrint(BCLog::NFT, "Destroyed NFT %s\n", nftId.ToString());
     return true;
@@ -125,28 +142,43 @@ bool CNFTManager::MintNFT(const std::string& name, const std::string& descriptio
     // Generate unique NFT ID
     uint256 nftId = GenerateNFTId(name, to);
     
-    // Create NFT metadata
-    CNFTMetadata metadata(name, description, imageUri, attributes, to, nftId, GetTime());
-    mapNFTs[nftId] = metadata;
+    // Create NFT, interning its metadata
+    CNFTInfo& nft = mapNFTs[nftId];
+    nft.nftHash = nftId;
+    InternNFTMetadata(nft, name, description, imageUri, attributes);
+    nft.creator = to;
+    nft.owner = to;
+    nft.creationTxHash = txHash;
+    nft.creationTime = GetTime();
     
     // Set ownership to recipient
     CNFTOwnership ownership(nftId, to, GetTime(), txHash);
     mapOwnership[nftId] = ownership;
-    mapOwnerNFTs[to].push_back(nftId);
+    mapOwnerNFTs.Add(to, nftId);
     
     LogPrint(BCLog::NFT, "Minted NFT %s (%s) to %s\n", 
              name, nftId.ToString(), EncodeDestination(to));
     return true;
 }
 
-CNFTMetadata CNFTManager::GetNFT(const uint256& nftId) const {
+CNFTInfo CNFTManager::GetNFT(const uint256& nftId) const {
     LOCK(cs_nfts);
     
     auto it = mapNFTs.find(nftId);
     if (it != mapNFTs.end()) {
         return it->second;
     }
-    return CNFTMetadata();
+    return CNFTInfo();
+}
+
+std::optional<NFTEntry> CNFTManager::GetNFTEntry(const uint256& nftId) const {
+    LOCK(cs_nfts);
+    
+    auto it = mapNFTs.find(nftId);
+    if (it == mapNFTs.end()) {
+        return std::nullopt;
+    }
+    return MakeNFTEntry(it->second, m_metadata);
 }
 
 CNFTOwnership CNFTManager::GetNFTOwnership(const uint256& nftId) const {
@@ -172,27 +204,67 @@ CTxDestination CNFTManager::GetNFTOwner(const uint256& nftId) const {
 std::vector<uint256> CNFTManager::GetNFTsByOwner(const CTxDestination& owner) const {
     LOCK(cs_nfts);
     
-    auto it = mapOwnerNFTs.find(owner);
-    if (it != mapOwnerNFTs.end()) {
-        return it->second;
-    }
-    return std::vector<uint256>();
+    return mapOwnerNFTs.Page(owner, std::nullopt, std::numeric_limits<size_t>::max());
 }
 
-std::vector<CNFTMetadata> CNFTManager::GetAllNFTs() const {
+std::vector<CNFTInfo> CNFTManager::GetAllNFTs() const {
     LOCK(cs_nfts);
     
-    std::vector<CNFTMetadata> nfts;
+    std::vector<CNFTInfo> nfts;
     for (const auto& pair : mapNFTs) {
         nfts.push_back(pair.second);
     }
     return nfts;
 }
 
-std::vector<CNFTMetadata> CNFTManager::GetNFTsByCreator(const CTxDestination& creator) const {
+std::string CNFTInfo::GetDisplayName(const NFTMetadataStore& store) const {
+    const std::string& displayName = store.Get(name);
+    return displayName.empty() ? nftHash.ToString() : displayName;
+}
+
+void CNFTManager::InternNFTMetadata(CNFTInfo& nft, const std::string& name, const std::string& description,
+                                    const std::string& imageUrl, const std::string& metadata) {
+    ReleaseNFTMetadata(nft);
+    nft.name = m_metadata.Intern(name);
+    nft.description = m_metadata.Intern(description);
+    nft.imageUrl = m_metadata.Intern(imageUrl);
+    nft.metadata = m_metadata.Intern(metadata);
+}
+
+void CNFTManager::ReleaseNFTMetadata(const CNFTInfo& nft) {
+    m_metadata.Release(nft.name);
+    m_metadata.Release(nft.description);
+    m_metadata.Release(nft.imageUrl);
+    m_metadata.Release(nft.metadata);
+}
+
+std::vector<NFTEntry> CNFTManager::ListNFTs(const std::optional<uint256>& after, size_t limit) const {
+    LOCK(cs_nfts);
+    
+    std::vector<NFTEntry> nfts;
+    for (auto it = after ? mapNFTs.upper_bound(*after) : mapNFTs.begin(); it != mapNFTs.end() && nfts.size() < limit; ++it) {
+        nfts.push_back(MakeNFTEntry(it->second, m_metadata));
+    }
+    return nfts;
+}
+
+std::vector<NFTEntry> CNFTManager::GetNFTsByOwner(const CTxDestination& owner, const std::optional<uint256>& after, size_t limit) const {
     LOCK(cs_nfts);
     
-    std::vector<CNFTMetadata> nfts;
+    std::vector<NFTEntry> nfts;
+    for (const uint256& nftId : mapOwnerNFTs.Page(owner, after, limit)) {
+        auto it = mapNFTs.find(nftId);
+        if (it != mapNFTs.end()) {
+            nfts.push_back(MakeNFTEntry(it->second, m_metadata));
+        }
+    }
+    return nfts;
+}
+
+std::vector<CNFTInfo> CNFTManager::GetNFTsByCreator(const CTxDestination& creator) const {
+    LOCK(cs_nfts);
+    
+    std::vector<CNFTInfo> nfts;
     for (const auto& pair : mapNFTs) {
         if (pair.second.creator == creator) {
             nfts.push_back(pair.second);
@@ -236,19 +308,44 @@ bool CNFTManager::ValidateNFTCreation(const std::string& name, const std::string
 void CNFTManager::Serialize(CAutoFile& file) const {
     LOCK(cs_nfts);
     
-    file << mapNFTs;
+    // Metadata refs are handles into this process's store, so each NFT is
+    // written with its metadata text and interned again on load.
+    WriteCompactSize(file, mapNFTs.size());
+    for (const auto& [nftId, nft] : mapNFTs) {
+        file << nftId << nft.nftHash;
+        file << m_metadata.Get(nft.name) << m_metadata.Get(nft.description);
+        file << m_metadata.Get(nft.imageUrl) << m_metadata.Get(nft.metadata);
+        file << nft.creator << nft.owner << nft.creationTxHash << nft.creationTime;
+        file << nft.isActive << nft.isTransferable << nft.tokenId << nft.collectionHash;
+    }
     file << mapOwnership;
-    file << mapOwnerNFTs;
     file << nextNFTId;
 }
 
 void CNFTManager::Unserialize(CAutoFile& file) {
     LOCK(cs_nfts);
     
-    file >> mapNFTs;
+    mapNFTs.clear();
+    m_metadata = NFTMetadataStore{};
+    const uint64_t count{ReadCompactSize(file)};
+    for (uint64_t i = 0; i < count; ++i) {
+        uint256 nftId;
+        CNFTInfo nft;
+        std::string name, description, imageUrl, metadata;
+        file >> nftId >> nft.nftHash;
+        file >> name >> description >> imageUrl >> metadata;
+        file >> nft.creator >> nft.owner >> nft.creationTxHash >> nft.creationTime;
+        file >> nft.isActive >> nft.isTransferable >> nft.tokenId >> nft.collectionHash;
+        InternNFTMetadata(nft, name, description, imageUrl, metadata);
+        mapNFTs[nftId] = std::move(nft);
+    }
     file >> mapOwnership;
-    file >> mapOwnerNFTs;
     file >> nextNFTId;
+    
+    mapOwnerNFTs.Clear();
+    for (const auto& [nftId, ownership] : mapOwnership) {
+        mapOwnerNFTs.Add(ownership.owner, nftId);
+    }
 }
 
 uint256 CNFTManager::GenerateNFTId(const std::string& name, const CTxDestination& creator) {
@@ -277,18 +374,10 @@ bool CNFTManager::UpdateOwnership(const uint256& nftId, const CTxDestination& ne
     ownershipIt->second.acquisitionTime = GetTime();
     ownershipIt->second.acquisitionTx = txHash;
     
-    // Remove from old owner's list
-    auto oldOwnerIt = mapOwnerNFTs.find(oldOwner);
-    if (oldOwnerIt != mapOwnerNFTs.end()) {
-        auto& nftList = oldOwnerIt->second;
-        nftList.erase(std::remove(nftList.begin(), nftList.end(), nftId), nftList.end());
-        if (nftList.empty()) {
-            mapOwnerNFTs.erase(oldOwnerIt);
-        }
-    }
+    mapNFTs[nftId].owner = newOwner;
     
-    // Add to new owner's list
-    mapOwnerNFTs[newOwner].push_back(nftId);
+    // Move between the owners' NFT sets
+    mapOwnerNFTs.Transfer(nftId, oldOwner, newOwner);
     
     return true;
 }
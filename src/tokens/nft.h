@@ -6,8 +6,11 @@
 
 #include <primitives/transaction.h>
 #include <script/standard.h>
+#include <tokens/nft_metadata.h>
+#include <tokens/nft_owners.h>
 #include <key.h>
 #include <logging.h>
+#include <sync.h>
 #include <util/time.h>
 #include <consensus/amount.h>
 
@@ -15,6 +18,7 @@
 #include <map>
 #include <set>
 #include <memory>
+#include <optional>
 #include <string>
 
 class CWallet;
@@ -41,26 +45,45 @@ struct NFTFeeConfig {
  */
 struct CNFTInfo {
     uint256 nftHash;                 // Unique NFT hash
-    std::string name;                // NFT name
-    std::string description;         // NFT description
-    std::string imageUrl;            // Image URL or IPFS hash
-    std::string metadata;            // Additional metadata (JSON)
+    // Metadata, interned in the NFTMetadataStore of the CNFTManager holding the NFT
+    NFTMetadataRef name{NFT_METADATA_NONE};         // NFT name
+    NFTMetadataRef description{NFT_METADATA_NONE};  // NFT description
+    NFTMetadataRef imageUrl{NFT_METADATA_NONE};     // Image URL or IPFS hash
+    NFTMetadataRef metadata{NFT_METADATA_NONE};     // Additional metadata (JSON)
     CTxDestination creator;          // NFT creator address
     CTxDestination owner;            // Current NFT owner
     uint256 creationTxHash;          // Transaction that created the NFT
     int64_t creationTime;            // When the NFT was created
     bool isActive;                   // Whether NFT is active
+    bool isTransferable;             // Whether NFT can change owner
     uint256 tokenId;                 // Unique token ID within collection
     uint256 collectionHash;          // Collection hash (if part of collection)
     
-    CNFTInfo() : creationTime(0), isActive(true), tokenId(0) {}
+    CNFTInfo() : creationTime(0), isActive(true), isTransferable(true), tokenId(0) {}
     
     uint256 GetHash() const;
     bool IsValid() const;
-    std::string GetDisplayName() const;
+    // The name, or the NFT hash if it has none; store must be locked by its manager
+    std::string GetDisplayName(const NFTMetadataStore& store) const;
     bool IsPartOfCollection() const;
 };
 
+/**
+ * An NFT and its current owner, with its metadata copied out of CNFTManager
+ * so that callers can use it without holding cs_nfts.
+ */
+struct NFTEntry {
+    uint256 nftId;
+    std::string name;
+    std::string description;
+    std::string imageUri;
+    std::string attributes;
+    CTxDestination creator;
+    CTxDestination owner;
+    int64_t creationTime{0};
+    bool isTransferable{true};
+};
+
 /**
  * NFT Collection Information
  * Represents a collection of NFTs
@@ -171,8 +194,13 @@ public:
     
     // NFT queries
     CNFTInfo GetNFT(const uint256& nftHash) const;
+    // An NFT with its metadata resolved, for callers outside cs_nfts
+    std::optional<NFTEntry> GetNFTEntry(const uint256& nftHash) const;
     CNFTCollection GetCollection(const uint256& collectionHash) const;
     std::vector<CNFTInfo> GetNFTsByOwner(const CTxDestination& owner) const;
+    // Paged queries in NFT hash order: up to limit NFTs after the NFT `after`, or from the first without it
+    std::vector<NFTEntry> ListNFTs(const std::optional<uint256>& after, size_t limit) const;
+    std::vector<NFTEntry> GetNFTsByOwner(const CTxDestination& owner, const std::optional<uint256>& after, size_t limit) const;
     std::vector<CNFTInfo> GetNFTsByCreator(const CTxDestination& creator) const;
     std::vector<CNFTInfo> GetNFTsInCollection(const uint256& collectionHash) const;
     std::vector<CNFTCollection> GetCollectionsByCreator(const CTxDestination& creator) const;
@@ -223,15 +251,18 @@ public:
     void LogNFTStats();
 
 private:
+    mutable RecursiveMutex cs_nfts;
+
     // NFT storage
-    std::map<uint256, CNFTInfo> m_nfts;
+    std::map<uint256, CNFTInfo> mapNFTs GUARDED_BY(cs_nfts);
     std::map<uint256, CNFTCollection> m_collections;
-    std::map<CTxDestination, std::vector<uint256>> m_ownerNFTs;
+    NFTOwnerIndex mapOwnerNFTs GUARDED_BY(cs_nfts);  // Derived from mapOwnership, never serialized
     std::map<CTxDestination, std::vector<uint256>> m_creatorNFTs;
     std::map<CTxDestination, std::vector<uint256>> m_creatorCollections;
     std::map<uint256, std::vector<uint256>> m_collectionNFTs;
     std::map<std::pair<uint256, CTxDestination>, CTxDestination> m_nftOwners;
     std::map<std::tuple<uint256, CTxDestination, CTxDestination>, bool> m_nftApprovals;
+    NFTMetadataStore m_metadata GUARDED_BY(cs_nfts);  // Interned NFT metadata, shared across mints
     
     // Configuration and statistics
     NFTFeeConfig m_feeConfig;
@@ -239,6 +270,9 @@ private:
     CAmount m_currentSHAHPrice;  // Current SHAH price in USD cents
     
     // Helper functions
+    void InternNFTMetadata(CNFTInfo& nft, const std::string& name, const std::string& description,
+                           const std::string& imageUrl, const std::string& metadata) EXCLUSIVE_LOCKS_REQUIRED(cs_nfts);
+    void ReleaseNFTMetadata(const CNFTInfo& nft) EXCLUSIVE_LOCKS_REQUIRED(cs_nfts);
     void UpdateNFTIndexes(const CNFTInfo& nft, bool add);
     void RemoveNFTIndexes(const CNFTInfo& nft);
     void UpdateCollectionIndexes(const CNFTCollection& collection, bool add);
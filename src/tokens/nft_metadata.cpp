@@ -0,0 +1,46 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <tokens/nft_metadata.h>
+
+#include <hash.h>
+#include <util/check.h>
+
+NFTMetadataRef NFTMetadataStore::Intern(std::string_view data)
+{
+    if (data.empty()) return NFT_METADATA_NONE;
+    const uint256 hash{Hash(data)};
+    if (const auto it{m_by_hash.find(hash)}; it != m_by_hash.end()) {
+        ++m_blobs[it->second - 1].refs;
+        return it->second;
+    }
+
+    NFTMetadataRef ref;
+    if (m_free.empty()) {
+        m_blobs.push_back(Blob{hash, std::string{data}, 1});
+        ref = m_blobs.size();
+    } else {
+        ref = m_free.back();
+        m_free.pop_back();
+        m_blobs[ref - 1] = Blob{hash, std::string{data}, 1};
+    }
+    m_by_hash.emplace(hash, ref);
+    return ref;
+}
+
+void NFTMetadataStore::Release(NFTMetadataRef ref)
+{
+    if (ref == NFT_METADATA_NONE) return;
+    Blob& blob{m_blobs.at(ref - 1)};
+    if (!Assume(blob.refs > 0) || --blob.refs > 0) return;
+    m_by_hash.erase(blob.hash);
+    // Free the string's memory rather than keep its capacity in the slot.
+    std::string{}.swap(blob.data);
+    m_free.push_back(ref);
+}
+
+const std::string& NFTMetadataStore::Get(NFTMetadataRef ref) const
+{
+    static const std::string empty;
+    return ref == NFT_METADATA_NONE ? empty : m_blobs.at(ref - 1).data;
+}
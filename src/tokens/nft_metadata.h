@@ -0,0 +1,63 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SHAHCOIN_TOKENS_NFT_METADATA_H
+#define SHAHCOIN_TOKENS_NFT_METADATA_H
+
+#include <uint256.h>
+#include <util/hasher.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/** Handle of a string in an NFTMetadataStore. */
+using NFTMetadataRef = uint32_t;
+
+/** The empty string, which is never stored. */
+static constexpr NFTMetadataRef NFT_METADATA_NONE{0};
+
+/**
+ * Content-addressed store of NFT metadata: names, descriptions, image URLs
+ * and attribute JSON.
+ *
+ * Every distinct string is stored once, keyed by its hash, and NFTs refer to
+ * it by a 4-byte NFTMetadataRef. The mints of a collection usually share their
+ * description, image and attributes, which are then stored once for the whole
+ * collection. Strings are reference counted; the last Release() frees one and
+ * its handle is reused.
+ *
+ * Not thread-safe; the owner synchronizes access.
+ */
+class NFTMetadataStore
+{
+public:
+    /** Add a reference to data, storing it if no NFT refers to it yet. */
+    NFTMetadataRef Intern(std::string_view data);
+
+    /** Drop a reference returned by Intern(). */
+    void Release(NFTMetadataRef ref);
+
+    /** The string ref refers to, valid until the next Intern() or Release(). */
+    const std::string& Get(NFTMetadataRef ref) const;
+
+    /** Number of distinct strings stored. */
+    size_t Size() const { return m_by_hash.size(); }
+
+private:
+    struct Blob {
+        uint256 hash;
+        std::string data;
+        uint32_t refs{0};
+    };
+
+    //! Blob of ref r at index r - 1
+    std::vector<Blob> m_blobs;
+    //! Refs of freed blobs, reused first
+    std::vector<NFTMetadataRef> m_free;
+    std::unordered_map<uint256, NFTMetadataRef, SaltedTxidHasher> m_by_hash;
+};
+
+#endif // SHAHCOIN_TOKENS_NFT_METADATA_H
@@ -0,0 +1,38 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <tokens/nft_owners.h>
+
+void NFTOwnerIndex::Add(const CTxDestination& owner, const uint256& nft_id)
+{
+    m_nfts[owner].insert(nft_id);
+}
+
+void NFTOwnerIndex::Remove(const CTxDestination& owner, const uint256& nft_id)
+{
+    const auto it{m_nfts.find(owner)};
+    if (it == m_nfts.end()) return;
+    it->second.erase(nft_id);
+    if (it->second.empty()) m_nfts.erase(it);
+}
+
+bool NFTOwnerIndex::Transfer(const uint256& nft_id, const CTxDestination& from, const CTxDestination& to)
+{
+    const auto it{m_nfts.find(from)};
+    if (it == m_nfts.end() || it->second.erase(nft_id) == 0) return false;
+    if (it->second.empty()) m_nfts.erase(it);
+    m_nfts[to].insert(nft_id);
+    return true;
+}
+
+std::vector<uint256> NFTOwnerIndex::Page(const CTxDestination& owner, const std::optional<uint256>& after, size_t limit) const
+{
+    std::vector<uint256> page;
+    const auto it{m_nfts.find(owner)};
+    if (it == m_nfts.end()) return page;
+    const std::set<uint256>& ids{it->second};
+    for (auto id{after ? ids.upper_bound(*after) : ids.begin()}; id != ids.end() && page.size() < limit; ++id) {
+        page.push_back(*id);
+    }
+    return page;
+}
@@ -0,0 +1,41 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SHAHCOIN_TOKENS_NFT_OWNERS_H
+#define SHAHCOIN_TOKENS_NFT_OWNERS_H
+
+#include <addresstype.h>
+#include <uint256.h>
+
+#include <map>
+#include <optional>
+#include <set>
+#include <vector>
+
+/**
+ * The NFTs each owner holds, in NFT ID order.
+ *
+ * An owner's NFTs can be listed a page at a time, with the last NFT ID of one
+ * page as the cursor of the next. Adding or removing an NFT is O(log n).
+ *
+ * Not thread-safe; the owner synchronizes access.
+ */
+class NFTOwnerIndex
+{
+public:
+    void Add(const CTxDestination& owner, const uint256& nft_id);
+    void Remove(const CTxDestination& owner, const uint256& nft_id);
+    /** Move an NFT from one owner to another. Returns false, changing nothing, if from does not hold it. */
+    bool Transfer(const uint256& nft_id, const CTxDestination& from, const CTxDestination& to);
+
+    /** Up to limit NFTs of owner after the NFT `after`, or from the first without it. */
+    std::vector<uint256> Page(const CTxDestination& owner, const std::optional<uint256>& after, size_t limit) const;
+
+    void Clear() { m_nfts.clear(); }
+
+private:
+    //! Owners without NFTs have no entry
+    std::map<CTxDestination, std::set<uint256>> m_nfts;
+};
+
+#endif // SHAHCOIN_TOKENS_NFT_OWNERS_H
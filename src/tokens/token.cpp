@@ -2,6 +2,8 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <tokens/token.h>
+#include <index/tokenindex.h>
+#include <tokens/token_script.h>
 #include <primitives/transaction.h>
 #include <script/standard.h>
 #include <key.h>
@@ -12,6 +14,7 @@
 #include <util/strencodings.h>
 
 #include <algorithm>
+#include <limits>
 #include <sstream>
 
 // Global token manager instance
@@ -112,10 +115,6 @@ bool CTokenManager::CreateToken(const CTxDestination& creator, const std::string
     
     // Add to storage
     m_tokens[token.tokenHash] = token;
-    UpdateTokenIndexes(token, true);
-    
-    // Set initial balance to creator
-    UpdateTokenBalance(token.tokenHash, creator, totalSupply);
     
     UpdateStats();
     
@@ -137,96 +136,6 @@ bool CTokenManager::ValidateTokenCreation(const CTokenTx& tokenTx)
            ValidateTokenSupply(tokenTx.tokenTotalSupply);
 }
 
-bool CTokenManager::TransferTokens(const uint256& tokenHash, const CTxDestination& from,
-                                  const CTxDestination& to, CAmount amount)
-{
-    if (!IsValidToken(tokenHash)) {
-        return false;
-    }
-    
-    CAmount currentBalance = GetTokenBalance(tokenHash, from);
-    if (currentBalance < amount) {
-        LogPrint(BCLog::TOKENS, "Insufficient token balance: required=%d, available=%d\n",
-                 amount, currentBalance);
-        return false;
-    }
-    
-    // Update balances
-    if (!UpdateTokenBalance(tokenHash, from, currentBalance - amount)) {
-        return false;
-    }
-    
-    CAmount toBalance = GetTokenBalance(tokenHash, to);
-    if (!UpdateTokenBalance(tokenHash, to, toBalance + amount)) {
-        // Revert from balance
-        UpdateTokenBalance(tokenHash, from, currentBalance);
-        return false;
-    }
-    
-    LogPrint(BCLog::TOKENS, "Transferred %d tokens from %s to %s\n",
-             amount, EncodeDestination(from), EncodeDestination(to));
-    
-    return true;
-}
-
-bool CTokenManager::MintTokens(const uint256& tokenHash, const CTxDestination& to, CAmount amount)
-{
-    if (!IsValidToken(tokenHash)) {
-        return false;
-    }
-    
-    CAmount currentBalance = GetTokenBalance(tokenHash, to);
-    if (!UpdateTokenBalance(tokenHash, to, currentBalance + amount)) {
-        return false;
-    }
-    
-    // Update total supply
-    auto it = m_tokens.find(tokenHash);
-    if (it != m_tokens.end()) {
-        it->second.totalSupply += amount;
-    }
-    
-    LogPrint(BCLog::TOKENS, "Minted %d tokens to %s\n", amount, EncodeDestination(to));
-    
-    return true;
-}
-
-bool CTokenManager::BurnTokens(const uint256& tokenHash, const CTxDestination& from, CAmount amount)
-{
-    if (!IsValidToken(tokenHash)) {
-        return false;
-    }
-    
-    CAmount currentBalance = GetTokenBalance(tokenHash, from);
-    if (currentBalance < amount) {
-        return false;
-    }
-    
-    if (!UpdateTokenBalance(tokenHash, from, currentBalance - amount)) {
-        return false;
-    }
-    
-    // Update total supply
-    auto it = m_tokens.find(tokenHash);
-    if (it != m_tokens.end()) {
-        it->second.totalSupply -= amount;
-    }
-    
-    LogPrint(BCLog::TOKENS, "Burned %d tokens from %s\n", amount, EncodeDestination(from));
-    
-    return true;
-}
-
-bool CTokenManager::ApproveTokens(const uint256& tokenHash, const CTxDestination& owner,
-                                 const CTxDestination& spender, CAmount amount)
-{
-    if (!IsValidToken(tokenHash)) {
-        return false;
-    }
-    
-    return UpdateTokenAllowance(tokenHash, owner, spender, amount);
-}
-
 CTokenInfo CTokenManager::GetToken(const uint256& tokenHash) const
 {
     auto it = m_tokens.find(tokenHash);
@@ -239,15 +148,31 @@ CTokenInfo CTokenManager::GetToken(const uint256& tokenHash) const
 std::vector<CTokenInfo> CTokenManager::GetTokensByCreator(const CTxDestination& creator) const
 {
     std::vector<CTokenInfo> tokens;
-    auto it = m_creatorTokens.find(creator);
-    if (it != m_creatorTokens.end()) {
-        for (const auto& tokenHash : it->second) {
-            auto tokenIt = m_tokens.find(tokenHash);
-            if (tokenIt != m_tokens.end()) {
-                tokens.push_back(tokenIt->second);
-            }
+    if (!g_token_index) {
+        return tokens;
+    }
+    // Page through the issuer's range of the account index.
+    static constexpr size_t PAGE_SIZE = 1000;
+    const uint160 account = GetTokenAccount(GetScriptForDestination(creator));
+    std::optional<uint256> after;
+    std::vector<uint256> ids;
+    do {
+        g_token_index->GetIssuedTokens(account, after, PAGE_SIZE, ids);
+        for (const auto& id : ids) {
+            const std::optional<TokenInfo> info = g_token_index->GetToken(id);
+            if (!info) continue;
+            CTokenInfo token;
+            token.tokenHash = id;
+            token.name = info->name;
+            token.symbol = info->symbol;
+            token.decimals = info->decimals;
+            token.totalSupply = static_cast<CAmount>(info->supply);
+            token.creator = creator;
+            token.creationTxHash = id;
+            tokens.push_back(token);
         }
-    }
+        if (!ids.empty()) after = ids.back();
+    } while (ids.size() == PAGE_SIZE);
     return tokens;
 }
 
@@ -264,21 +189,22 @@ std::vector<CTokenInfo> CTokenManager::GetAllTokens() const
 
 CAmount CTokenManager::GetTokenBalance(const uint256& tokenHash, const CTxDestination& address) const
 {
-    auto it = m_tokenBalances.find(std::make_pair(tokenHash, address));
-    if (it != m_tokenBalances.end()) {
-        return it->second;
+    if (!g_token_index) {
+        return 0;
     }
-    return 0;
+    const uint64_t balance = g_token_index->GetTokenBalance(tokenHash, GetTokenAccount(GetScriptForDestination(address)));
+    return static_cast<CAmount>(std::min<uint64_t>(balance, std::numeric_limits<CAmount>::max()));
 }
 
 CAmount CTokenManager::GetTokenAllowance(const uint256& tokenHash, const CTxDestination& owner,
                                         const CTxDestination& spender) const
 {
-    auto it = m_tokenAllowances.find(std::make_tuple(tokenHash, owner, spender));
-    if (it != m_tokenAllowances.end()) {
-        return it->second;
+    if (!g_token_index) {
+        return 0;
     }
-    return 0;
+    const uint64_t allowance = g_token_index->GetTokenAllowance(tokenHash, GetTokenAccount(GetScriptForDestination(owner)),
+                                                                GetTokenAccount(GetScriptForDestination(spender)));
+    return static_cast<CAmount>(std::min<uint64_t>(allowance, std::numeric_limits<CAmount>::max()));
 }
 
 CAmount CTokenManager::CalculateTokenCreationFee() const
@@ -387,21 +313,6 @@ void CTokenManager::LogTokenStats()
 }
 
 // Private helper functions
-void CTokenManager::UpdateTokenIndexes(const CTokenInfo& token, bool add)
-{
-    if (add) {
-        m_creatorTokens[token.creator].push_back(token.tokenHash);
-    } else {
-        auto& tokens = m_creatorTokens[token.creator];
-        tokens.erase(std::remove(tokens.begin(), tokens.end(), token.tokenHash), tokens.end());
-    }
-}
-
-void CTokenManager::RemoveTokenIndexes(const CTokenInfo& token)
-{
-    UpdateTokenIndexes(token, false);
-}
-
 bool CTokenManager::ValidateTokenName(const std::string& name) const
 {
     return !name.empty() && name.length() <= 100;
@@ -447,27 +358,11 @@ void CTokenManager::CleanupInactiveTokens()
     for (const auto& tokenHash : toRemove) {
         auto it = m_tokens.find(tokenHash);
         if (it != m_tokens.end()) {
-            RemoveTokenIndexes(it->second);
             m_tokens.erase(it);
         }
     }
 }
 
-bool CTokenManager::UpdateTokenBalance(const uint256& tokenHash, const CTxDestination& address, CAmount amount)
-{
-    auto key = std::make_pair(tokenHash, address);
-    m_tokenBalances[key] = amount;
-    return true;
-}
-
-bool CTokenManager::UpdateTokenAllowance(const uint256& tokenHash, const CTxDestination& owner,
-                                        const CTxDestination& spender, CAmount amount)
-{
-    auto key = std::make_tuple(tokenHash, owner, spender);
-    m_tokenAllowances[key] = amount;
-    return true;
-}
-
 bool CTokenManager::AddTokenTransaction(CTransaction& tx, const CTokenTx& tokenTx)
 {
     // Create token transaction
@@ -118,18 +118,14 @@ public:
                     const std::string& symbol, uint8_t decimals, CAmount totalSupply);
     bool ValidateTokenCreation(const CTokenTx& tokenTx);
     
-    // Token operations
-    bool TransferTokens(const uint256& tokenHash, const CTxDestination& from,
-                       const CTxDestination& to, CAmount amount);
-    bool MintTokens(const uint256& tokenHash, const CTxDestination& to, CAmount amount);
-    bool BurnTokens(const uint256& tokenHash, const CTxDestination& from, CAmount amount);
-    bool ApproveTokens(const uint256& tokenHash, const CTxDestination& owner,
-                      const CTxDestination& spender, CAmount amount);
+    // Balances and allowances change only through token operations in confirmed
+    // blocks (tokens/token_script.h), applied by TokenIndex.
     
     // Token queries
     CTokenInfo GetToken(const uint256& tokenHash) const;
-    std::vector<CTokenInfo> GetTokensByCreator(const CTxDestination& creator) const;
     std::vector<CTokenInfo> GetAllTokens() const;
+    // Answered by g_token_index, which must be enabled (-tokenindex)
+    std::vector<CTokenInfo> GetTokensByCreator(const CTxDestination& creator) const;
     CAmount GetTokenBalance(const uint256& tokenHash, const CTxDestination& address) const;
     CAmount GetTokenAllowance(const uint256& tokenHash, const CTxDestination& owner,
                              const CTxDestination& spender) const;
@@ -170,9 +166,10 @@ public:
 private:
     // Token storage
     std::map<uint256, CTokenInfo> m_tokens;
-    std::map<CTxDestination, std::vector<uint256>> m_creatorTokens;
-    std::map<std::pair<uint256, CTxDestination>, CAmount> m_tokenBalances;
-    std::map<std::tuple<uint256, CTxDestination, CTxDestination>, CAmount> m_tokenAllowances;
+    // Balances, allowances and the tokens each account holds or issued change
+    // with confirmed token operations (see tokens/token_script.h). They are
+    // kept by TokenIndex (index/tokenindex.h) alongside the chainstate rather
+    // than here.
     
     // Configuration and statistics
     TokenFeeConfig m_feeConfig;
@@ -180,8 +177,6 @@ private:
     CAmount m_currentSHAHPrice;  // Current SHAH price in USD cents
     
     // Helper functions
-    void UpdateTokenIndexes(const CTokenInfo& token, bool add);
-    void RemoveTokenIndexes(const CTokenInfo& token);
     bool ValidateTokenName(const std::string& name) const;
     bool ValidateTokenSymbol(const std::string& symbol) const;
     bool ValidateTokenDecimals(uint8_t decimals) const;
@@ -189,11 +184,6 @@ private:
     void UpdateStats();
     void CleanupInactiveTokens();
     
-    // Balance management
-    bool UpdateTokenBalance(const uint256& tokenHash, const CTxDestination& address, CAmount amount);
-    bool UpdateTokenAllowance(const uint256& tokenHash, const CTxDestination& owner,
-                             const CTxDestination& spender, CAmount amount);
-    
     // Transaction helpers
     bool AddTokenTransaction(CTransaction& tx, const CTokenTx& tokenTx);
     bool ParseTokenTransaction(const CTransaction& tx, CTokenTx& tokenTx) const;
@@ -0,0 +1,50 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <tokens/token_script.h>
+
+#include <hash.h>
+#include <streams.h>
+
+#include <algorithm>
+#include <vector>
+
+//! Marker following OP_RETURN in a token operation output
+static const std::vector<unsigned char> TOKEN_OP_MARKER{'T', 'O', 'K'};
+
+uint160 GetTokenAccount(const CScript& script)
+{
+    return Hash160(script);
+}
+
+CScript GetTokenOperationScript(const TokenOperation& op)
+{
+    DataStream stream{};
+    stream << op;
+    std::vector<unsigned char> data{TOKEN_OP_MARKER};
+    data.insert(data.end(), UCharCast(stream.data()), UCharCast(stream.data() + stream.size()));
+    return CScript() << OP_RETURN << data;
+}
+
+std::optional<TokenOperation> ParseTokenOperation(const CScript& script)
+{
+    CScript::const_iterator pc{script.begin()};
+    opcodetype opcode;
+    std::vector<unsigned char> data;
+    if (!script.GetOp(pc, opcode) || opcode != OP_RETURN) return std::nullopt;
+    if (!script.GetOp(pc, opcode, data) || pc != script.end()) return std::nullopt;
+    if (data.size() <= TOKEN_OP_MARKER.size() || !std::equal(TOKEN_OP_MARKER.begin(), TOKEN_OP_MARKER.end(), data.begin())) {
+        return std::nullopt;
+    }
+
+    SpanReader reader{0, Span{data}.subspan(TOKEN_OP_MARKER.size())};
+    TokenOperation op;
+    try {
+        reader >> op;
+    } catch (const std::ios_base::failure&) {
+        return std::nullopt;
+    }
+    if (!reader.empty()) return std::nullopt;
+    if (op.type < TokenOpType::ISSUE || op.type > TokenOpType::TRANSFER_FROM) return std::nullopt;
+    return op;
+}
@@ -0,0 +1,70 @@
+// Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SHAHCOIN_TOKENS_TOKEN_SCRIPT_H
+#define SHAHCOIN_TOKENS_TOKEN_SCRIPT_H
+
+#include <consensus/consensus.h>
+#include <script/script.h>
+#include <serialize.h>
+#include <uint256.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+enum class TokenOpType : uint8_t {
+    ISSUE = 1,
+    TRANSFER = 2,
+    MINT = 3,
+    BURN = 4,
+    APPROVE = 5,
+    TRANSFER_FROM = 6,
+};
+
+/**
+ * A token operation, carried in an OP_RETURN output of a transaction and
+ * authorized by the script of the transaction's first input (its sender).
+ * Accounts are identified by GetTokenAccount() of an output script.
+ *
+ * ISSUE:         name, symbol, decimals, amount = initial supply; the token id is the txid
+ *                (the supply never exceeds MAX_TOKEN_SUPPLY)
+ * TRANSFER:      token, to, amount
+ * MINT:          token, to, amount; by the issuer only
+ * BURN:          token, amount
+ * APPROVE:       token, to = spender, amount = allowance
+ * TRANSFER_FROM: token, from, to, amount; by a spender that from approved
+ */
+struct TokenOperation {
+    TokenOpType type{TokenOpType::TRANSFER};
+    uint256 token;
+    uint160 from;
+    uint160 to;
+    uint64_t amount{0};
+    std::string name;
+    std::string symbol;
+    uint8_t decimals{0};
+
+    SERIALIZE_METHODS(TokenOperation, obj)
+    {
+        uint8_t type{static_cast<uint8_t>(obj.type)};
+        READWRITE(type);
+        SER_READ(obj, obj.type = static_cast<TokenOpType>(type));
+        if (obj.type == TokenOpType::ISSUE) {
+            READWRITE(LIMITED_STRING(obj.name, MAX_TOKEN_NAME_LENGTH), LIMITED_STRING(obj.symbol, MAX_TOKEN_SYMBOL_LENGTH), obj.decimals);
+        } else {
+            READWRITE(obj.token);
+        }
+        if (obj.type == TokenOpType::TRANSFER_FROM) READWRITE(obj.from);
+        if (obj.type != TokenOpType::ISSUE && obj.type != TokenOpType::BURN) READWRITE(obj.to);
+        READWRITE(VARINT(obj.amount));
+    }
+};
+
+/** The token account that an output script receives to, and that spending from it authorizes. */
+uint160 GetTokenAccount(const CScript& script);
+
+CScript GetTokenOperationScript(const TokenOperation& op);
+std::optional<TokenOperation> ParseTokenOperation(const CScript& script);
+
+#endif // SHAHCOIN_TOKENS_TOKEN_SCRIPT_H
@@ -6,9 +6,11 @@
 #include <tokens/token.h>
 #include <tokens/nft.h>
 #include <dex/dex.h>
+#include <dex/dex_state.h>
 #include <policy/honeypot_filter.h>
 #include <consensus/finality.h>
 #include <stake/cold_staking.h>
+#include <stake/kernel_search.h>
 #include <consensus/hybrid.h>
 #include <consensus/pos_stub.h>
 #include <pow_dispatch.h>
@@ -43,6 +45,7 @@
 #include <policy/rbf.h>
 #include <policy/settings.h>
 #include <pow.h>
+#include <pow_cache.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <random.h>
@@ -73,11 +76,13 @@
 #include <cassert>
 #include <chrono>
 #include <deque>
+#include <functional>
 #include <numeric>
 #include <optional>
 #include <string>
 #include <tuple>
 #include <utility>
+#include <variant>
 
 using kernel::CCoinsStats;
 using kernel::CoinStatsHashType;
@@ -2066,7 +2071,27 @@ DisconnectResult Chainstate::DisconnectBlock(const CBlock& block, const CBlockIn
     return fClean ? DISCONNECT_OK : DISCONNECT_UNCLEAN;
 }
 
-static CCheckQueue<CScriptCheck> scriptcheckqueue(128);
+/**
+ * Closure run by the script check workers: a script check of ConnectBlock, or
+ * other validation work that is spread over the same threads, so that -par
+ * sizes a single pool.
+ */
+class CValidationCheck
+{
+private:
+    std::variant<CScriptCheck, std::function<bool()>> m_check;
+
+public:
+    explicit CValidationCheck(CScriptCheck&& check) : m_check(std::move(check)) {}
+    explicit CValidationCheck(std::function<bool()>&& check) : m_check(std::move(check)) {}
+
+    bool operator()()
+    {
+        return std::visit([](auto& check) { return check(); }, m_check);
+    }
+};
+
+static CCheckQueue<CValidationCheck> scriptcheckqueue(128);
 
 void StartScriptCheckWorkerThreads(int threads_num)
 {
@@ -2078,6 +2103,21 @@ void StopScriptCheckWorkerThreads()
     scriptcheckqueue.StopWorkerThreads();
 }
 
+bool RunValidationChecks(std::vector<std::function<bool()>>&& checks)
+{
+    if (checks.size() <= 1 || !scriptcheckqueue.HasThreads()) {
+        return std::all_of(checks.cbegin(), checks.cend(), [](const auto& check) { return check(); });
+    }
+    std::vector<CValidationCheck> queued;
+    queued.reserve(checks.size());
+    for (auto& check : checks) {
+        queued.emplace_back(std::move(check));
+    }
+    CCheckQueueControl<CValidationCheck> control(&scriptcheckqueue);
+    control.Add(std::move(queued));
+    return control.Wait();
+}
+
 /**
  * Threshold condition checker that triggers when unknown versionshahbits are seen on the network.
  */
@@ -2198,10 +2238,12 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     uint256 hashPrevBlock = pindex->pprev == nullptr ? uint256() : pindex->pprev->GetBlockHash();
     assert(hashPrevBlock == view.GetBestBlock());
 
-    // SHAHCOIN Core: Finality checks
-    if (FinalityUtils::IsFinalityEnabled() && pindex->pprev) {
-        if (!FinalityUtils::IsReorganizationAllowed(pindex->pprev, pindex)) {
-            return error("%s: Finality rules prevent reorganization", __func__);
+    // SHAHCOIN Core: Stake modifier, computed once per block and persisted with its index entry
+    if (!fJustCheck) {
+        const uint64_t stake_modifier{ComputeStakeModifier(pindex->pprev ? pindex->pprev->nStakeModifier : 0, block_hash)};
+        if (pindex->nStakeModifier != stake_modifier) {
+            pindex->nStakeModifier = stake_modifier;
+            m_blockman.m_dirty_blockindex.insert(pindex);
         }
     }
 
@@ -2261,6 +2303,14 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
         }
     }
 
+    // SHAHCOIN Core: Skip scripts below this node's own finality checkpoint
+    if (fScriptChecks && !m_chainman.m_finality_checkpoint.IsNull()) {
+        BlockMap::const_iterator it{m_blockman.m_block_index.find(m_chainman.m_finality_checkpoint)};
+        if (it != m_blockman.m_block_index.end() && it->second.GetAncestor(pindex->nHeight) == pindex) {
+            fScriptChecks = false;
+        }
+    }
+
     const auto time_1{SteadyClock::now()};
     time_check += time_1 - time_start;
     LogPrint(BCLog::BENCH, "    - Sanity checks: %.2fms [%.2fs (%.2fms/blk)]\n",
@@ -2377,7 +2427,7 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     // in multiple threads). Preallocate the vector size so a new allocation
     // doesn't invalidate pointers into the vector, and keep txsdata in scope
     // for as long as `control`.
-    CCheckQueueControl<CScriptCheck> control(fScriptChecks && parallel_script_checks ? &scriptcheckqueue : nullptr);
+    CCheckQueueControl<CValidationCheck> control(fScriptChecks && parallel_script_checks ? &scriptcheckqueue : nullptr);
     std::vector<PrecomputedTransactionData> txsdata(block.vtx.size());
 
     std::vector<int> prevheights;
@@ -2443,7 +2493,7 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
                 return error("ConnectBlock(): CheckInputScripts on %s failed with %s",
                     tx.GetHash().ToString(), state.ToString());
             }
-            control.Add(std::move(vChecks));
+            control.Add(std::vector<CValidationCheck>(std::make_move_iterator(vChecks.begin()), std::make_move_iterator(vChecks.end())));
         }
 
         CTxUndo undoDummy;
@@ -2655,6 +2705,16 @@ bool Chainstate::FlushStateToDisk(
                     return FatalError(m_chainman.GetNotifications(), state, "Failed to write to block index database");
                 }
             }
+            // SHAHCOIN Core: Record the irreversible block, now that its index entry is on disk,
+            // as the finality checkpoint. It only moves forward, also while reindexing.
+            if (g_finalityManager && this == &m_chainman.ActiveChainstate() && !m_chainman.AssumedValidBlock().IsNull()) {
+                const CBlockIndex* irreversible{g_finalityManager->GetIrreversibleBlock()};
+                const CBlockIndex* checkpoint{m_blockman.LookupBlockIndex(m_chainman.m_finality_checkpoint)};
+                if (irreversible && (!checkpoint || irreversible->nHeight > checkpoint->nHeight) &&
+                    m_blockman.WriteFinalityCheckpoint(irreversible->GetBlockHash())) {
+                    m_chainman.m_finality_checkpoint = irreversible->GetBlockHash();
+                }
+            }
             // Finally remove any pruned files
             if (fFlushForPrune) {
                 LOG_TIME_MILLIS_WITH_CATEGORY("unlink pruned files", BCLog::BENCH);
@@ -2676,6 +2736,11 @@ bool Chainstate::FlushStateToDisk(
             if (!CheckDiskSpace(m_chainman.m_options.datadir, 48 * 2 * 2 * CoinsTip().GetCacheSize())) {
                 return FatalError(m_chainman.GetNotifications(), state, "Disk space is too low!", _("Disk space is too low!"));
             }
+            // Flush the DEX state first, so that it is never behind the coins
+            // database; ReconcileDEXState rewinds it if it is ahead.
+            if (m_chainman.m_dex_state && this == &m_chainman.ActiveChainstate() && !m_chainman.m_dex_state->Flush()) {
+                return FatalError(m_chainman.GetNotifications(), state, "Failed to write to DEX state database");
+            }
             // Flush the chainstate (which may refer to block index entries).
             if (!CoinsTip().Flush())
                 return FatalError(m_chainman.GetNotifications(), state, "Failed to write to coin database");
@@ -2777,6 +2842,8 @@ void Chainstate::UpdateTip(const CBlockIndex* pindexNew)
     if (!m_chainman.IsInitialBlockDownload()) {
         const CBlockIndex* pindex = pindexNew;
         for (int bit = 0; bit < VERSIONshahbits_NUM_shahbits; bit++) {
+            // The mining algorithm of every hybrid block is set in these shahbits
+            if ((1 << bit) & VERSIONshahbits_ALGO_MASK) continue;
             WarningshahbitsConditionChecker checker(m_chainman, bit);
             ThresholdState state = checker.GetStateFor(pindex, params.GetConsensus(), m_chainman.m_warningcache.at(bit));
             if (state == ThresholdState::ACTIVE || state == ThresholdState::LOCKED_IN) {
@@ -2823,6 +2890,10 @@ bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTra
         assert(view.GetBestBlock() == pindexDelete->GetBlockHash());
         if (DisconnectBlock(block, pindexDelete, view) != DISCONNECT_OK)
             return error("DisconnectTip(): DisconnectBlock %s failed", pindexDelete->GetBlockHash().ToString());
+        if (m_chainman.m_dex_state && this == &m_chainman.ActiveChainstate() &&
+            !m_chainman.m_dex_state->DisconnectBlock(*pindexDelete)) {
+            return error("DisconnectTip(): DEX state could not disconnect %s", pindexDelete->GetBlockHash().ToString());
+        }
         bool flushed = view.Flush();
         assert(flushed);
     }
@@ -2956,6 +3027,16 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
                  Ticks<MillisecondsDouble>(time_3 - time_2),
                  Ticks<SecondsDouble>(time_connect_total),
                  Ticks<MillisecondsDouble>(time_connect_total) / num_blocks_total);
+        // SHAHCOIN Core: Apply the block's DEX operations, authorized by the coins it spent
+        if (m_chainman.m_dex_state && this == &m_chainman.ActiveChainstate()) {
+            CBlockUndo blockundo;
+            if (HasDEXOperations(blockConnecting) && !m_blockman.UndoReadFromDisk(blockundo, *pindexNew)) {
+                return FatalError(m_chainman.GetNotifications(), state, "Failed to read undo data for DEX state");
+            }
+            if (!m_chainman.m_dex_state->ConnectBlock(blockConnecting, blockundo, *pindexNew)) {
+                return FatalError(m_chainman.GetNotifications(), state, "Failed to update DEX state");
+            }
+        }
         bool flushed = view.Flush();
         assert(flushed);
     }
@@ -2984,6 +3065,11 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
     m_chain.SetTip(*pindexNew);
     UpdateTip(pindexNew);
 
+    // SHAHCOIN Core: Advance the finality watermark
+    if (g_finalityManager && this == &m_chainman.ActiveChainstate()) {
+        g_finalityManager->BlockConnected(m_chain, pindexNew);
+    }
+
     const auto time_6{SteadyClock::now()};
     time_post_connect += time_6 - time_5;
     time_total += time_6 - time_1;
@@ -3097,6 +3183,18 @@ bool Chainstate::ActivateBestChainStep(BlockValidationState& state, CBlockIndex*
     const CBlockIndex* pindexOldTip = m_chain.Tip();
     const CBlockIndex* pindexFork = m_chain.FindFork(pindexMostWork);
 
+    // SHAHCOIN Core: Refuse to reorganize past the finality watermark before
+    // disconnecting anything. The first block of the new branch is marked
+    // invalid, which rules out every candidate built on it.
+    if (FinalityUtils::ConflictsWithFinalized(pindexMostWork)) {
+        CBlockIndex* pindexFirst{pindexMostWork->GetAncestor(pindexFork ? pindexFork->nHeight + 1 : 0)};
+        state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-fork-finalized", "reorganization past the finality watermark");
+        InvalidBlockFound(pindexFirst, state);
+        state = BlockValidationState();
+        fInvalidFound = true;
+        return true;
+    }
+
     // Disconnect active blocks which are no longer in the best chain.
     bool fBlocksDisconnected = false;
     DisconnectedBlockTransactions disconnectpool{MAX_DISCONNECTED_TX_POOL_SIZE * 1000};
@@ -3649,8 +3747,13 @@ void ChainstateManager::ReceivedBlockTransactions(const CBlock& block, CBlockInd
 
 static bool CheckBlockHeader(const CBlockHeader& block, BlockValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true)
 {
-    // Check proof of work matches claimed amount
-    if (fCheckPOW && !CheckProofOfWork(block.GetHash(), block.nshahbits, consensusParams))
+    // SHAHCOIN Core: The version must name a known mining algorithm
+    if (!IsValidAlgoVersion(block.nVersion))
+        return state.Invalid(BlockValidationResult::BLOCK_INVALID_HEADER, "bad-version-algo", "unknown mining algorithm in block version");
+
+    // Check proof of work matches claimed amount. Proof-of-stake headers carry
+    // no proof of work; PoW headers are checked against their algorithm's hash.
+    if (fCheckPOW && block.IsProofOfWork() && !CheckProofOfWorkCached(block, consensusParams))
         return state.Invalid(BlockValidationResult::BLOCK_INVALID_HEADER, "high-hash", "proof of work failed");
 
     return true;
@@ -3676,22 +3779,15 @@ bool CheckBlock(const CBlock& block, BlockValidationState& state, const Consensu
     }
     
     // Hybrid consensus: Derive algorithm for legacy blocks or validate explicit algo
+    // The PoW hash itself was checked by CheckBlockHeader above.
     AlgoType expectedAlgo = SelectNextAlgo(0); // TODO: Get actual height
     if (fCheckPOW && block.IsProofOfWork()) {
-        // For PoW blocks, validate the algorithm and hash
         AlgoType blockAlgo = block.GetAlgoType();
         if (blockAlgo != expectedAlgo) {
             LogPrint(BCLog::VALIDATION, "Block algo mismatch: expected %s, got %s\n", 
                     AlgoName(expectedAlgo), AlgoName(blockAlgo));
             // TODO: Make this strict once algo encoding is implemented
         }
-        
-        // Validate PoW hash using the correct algorithm
-        uint256 powHash = GetPoWHash(block);
-        if (!CheckProofOfWork(powHash, block.nshahbits, consensusParams)) {
-            return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "high-hash", 
-                               "proof of work failed");
-        }
     }
 
     // Signet only: check block solution
@@ -3741,31 +3837,10 @@ bool CheckBlock(const CBlock& block, BlockValidationState& state, const Consensu
             return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, tx_state.GetRejectReason(),
                                  strprintf("Transaction check failed (tx hash %s) %s", tx->GetHash().ToString(), tx_state.GetDebugMessage()));
         }
-        
-        // SHAHCOIN Core: Check for token, NFT, and DEX transactions
-        if (TokenValidation::IsTokenTransaction(*tx)) {
-            if (!TokenValidation::ValidateTokenCreationTx(*tx, CCoinsViewCache(nullptr), tx_state) &&
-                !TokenValidation::ValidateTokenTransferTx(*tx, CCoinsViewCache(nullptr), tx_state)) {
-                return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, tx_state.GetRejectReason(),
-                                   strprintf("Token transaction validation failed (tx hash %s) %s", tx->GetHash().ToString(), tx_state.GetDebugMessage()));
-            }
-        }
-        
-        if (NFTValidation::IsNFTTransaction(*tx)) {
-            if (!NFTValidation::ValidateNFTMintTx(*tx, CCoinsViewCache(nullptr), tx_state) &&
-                !NFTValidation::ValidateNFTTransferTx(*tx, CCoinsViewCache(nullptr), tx_state)) {
-                return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, tx_state.GetRejectReason(),
-                                   strprintf("NFT transaction validation failed (tx hash %s) %s", tx->GetHash().ToString(), tx_state.GetDebugMessage()));
-            }
-        }
-        
-        if (DEXValidation::IsDEXTransaction(*tx)) {
-            if (!DEXValidation::ValidateDEXTx(*tx, CCoinsViewCache(nullptr), tx_state)) {
-                return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, tx_state.GetRejectReason(),
-                                   strprintf("DEX transaction validation failed (tx hash %s) %s", tx->GetHash().ToString(), tx_state.GetDebugMessage()));
-            }
-        }
     }
+    // SHAHCOIN Core: DEX operations depend on the pool state, so they are not
+    // checked here but applied, one pool per check in parallel, when the block
+    // is connected (see DEXStateCache::ConnectBlock).
     unsigned int nSigOps = 0;
     for (const auto& tx : block.vtx)
     {
@@ -3821,8 +3896,21 @@ std::vector<unsigned char> ChainstateManager::GenerateCoinbaseCommitment(CBlock&
 
 bool HasValidProofOfWork(const std::vector<CBlockHeader>& headers, const Consensus::Params& consensusParams)
 {
-    return std::all_of(headers.cbegin(), headers.cend(),
-            [&](const auto& header) { return CheckProofOfWork(header.GetHash(), header.nshahbits, consensusParams);});
+    // Each header is checked against its own algorithm's PoW hash, which for
+    // scrypt and Groestl dominates header sync. The result is the conjunction
+    // over all headers, so it does not depend on the order in which the
+    // workers happen to finish. This is the same rule CheckBlockHeader
+    // applies, so proof-of-stake headers are skipped.
+    //
+    // The batch runs on the script check queue, so a header sync that arrives
+    // while ConnectBlock or DEX pool application holds the queue waits for it.
+    std::vector<std::function<bool()>> checks;
+    checks.reserve(headers.size());
+    for (const CBlockHeader& header : headers) {
+        if (!header.IsProofOfWork()) continue;
+        checks.emplace_back([&header, &consensusParams] { return CheckProofOfWorkCached(header, consensusParams); });
+    }
+    return RunValidationChecks(std::move(checks));
 }
 
 arith_uint256 CalculateHeadersWork(const std::vector<CBlockHeader>& headers)
@@ -3852,7 +3940,7 @@ static bool ContextualCheckBlockHeader(const CBlockHeader& block, BlockValidatio
 
     // Check proof of work
     const Consensus::Params& consensusParams = chainman.GetConsensus();
-    if (block.nshahbits != GetNextWorkRequired(pindexPrev, &block, consensusParams))
+    if (block.nshahbits != GetNextWorkRequiredHybrid(pindexPrev, block, consensusParams))
         return state.Invalid(BlockValidationResult::BLOCK_INVALID_HEADER, "bad-diffshahbits", "incorrect proof of work");
 
     // Check against checkpoints
@@ -4603,6 +4691,60 @@ bool Chainstate::ReplayBlocks()
     return true;
 }
 
+util::Result<void> Chainstate::ReconcileDEXState()
+{
+    AssertLockHeld(::cs_main);
+    DEXStateCache* dex_state{m_chainman.m_dex_state.get()};
+    if (!dex_state) return {};
+    const bilingual_str rebuild{_("Unable to bring the DEX state to the chain tip. You will need to rebuild the database using -reindex-chainstate.")};
+
+    // The DEX state is flushed before the coins database, so after a crash it
+    // may hold blocks that m_chain does not; rewind those from their undo records.
+    const CBlockIndex* pindex{nullptr};
+    while (!dex_state->GetBestBlock().IsNull()) {
+        pindex = m_blockman.LookupBlockIndex(dex_state->GetBestBlock());
+        if (!pindex) {
+            LogPrintf("ERROR: %s: DEX state is at unknown block %s\n", __func__, dex_state->GetBestBlock().ToString());
+            return util::Error{rebuild};
+        }
+        if (m_chain.Contains(pindex)) break;
+        if (!dex_state->DisconnectBlock(*pindex)) return util::Error{rebuild};
+        pindex = nullptr;
+    }
+
+    // Roll forward over blocks it has not seen yet, e.g. on first start with an existing chain.
+    // ConnectBlock keeps the DEX state in step from then on, so this is the only time blocks
+    // are read back, and pruning never removes a block the DEX state still needs. Blocks
+    // that were pruned before, or lie below an assumeutxo snapshot, cannot be replayed.
+    const CBlockIndex* next{pindex ? m_chain.Next(pindex) : m_chain.Genesis()};
+    if (!next) return dex_state->Flush() ? util::Result<void>{} : util::Error{rebuild};
+    for (const CBlockIndex* block{next}; block; block = m_chain.Next(block)) {
+        if (!(block->nStatus & BLOCK_HAVE_DATA)) {
+            return util::Error{strprintf(_("The DEX state must replay blocks %d to %d, but block %d is not on disk "
+                                           "because it was pruned or lies below the assumeutxo snapshot. "
+                                           "Restart with -reindex to download the blocks again and rebuild the DEX state."),
+                                         next->nHeight, m_chain.Height(), block->nHeight)};
+        }
+    }
+
+    LogPrintf("Rolling DEX state forward from height %d to %d\n", next->nHeight, m_chain.Height());
+    for (; next; next = m_chain.Next(next)) {
+        CBlock block;
+        if (!m_blockman.ReadBlockFromDisk(block, *next)) {
+            LogPrintf("ERROR: %s: failed to read block %s\n", __func__, next->GetBlockHash().ToString());
+            return util::Error{rebuild};
+        }
+        CBlockUndo blockundo;
+        if (HasDEXOperations(block) && !m_blockman.UndoReadFromDisk(blockundo, *next)) {
+            LogPrintf("ERROR: %s: failed to read undo data for block %s\n", __func__, next->GetBlockHash().ToString());
+            return util::Error{rebuild};
+        }
+        if (!dex_state->ConnectBlock(block, blockundo, *next)) return util::Error{rebuild};
+    }
+    if (!dex_state->Flush()) return util::Error{rebuild};
+    return {};
+}
+
 bool Chainstate::NeedsRedownload() const
 {
     AssertLockHeld(cs_main);
@@ -4630,6 +4772,15 @@ void Chainstate::ClearBlockIndexCandidates()
 bool ChainstateManager::LoadBlockIndex()
 {
     AssertLockHeld(cs_main);
+    // The finality checkpoint is kept outside the block index database and also
+    // applies while reindexing.
+    if (!AssumedValidBlock().IsNull()) {
+        if (auto checkpoint{m_blockman.ReadFinalityCheckpoint()}) {
+            m_finality_checkpoint = *checkpoint;
+            LogPrintf("Using finality checkpoint %s\n", m_finality_checkpoint.ToString());
+        }
+    }
+
     // Load block index from databases
     bool needs_init = fReindex;
     if (!fReindex) {
@@ -5831,6 +5982,7 @@ void ChainstateManager::MaybeRebalanceCaches()
 
 void ChainstateManager::ResetChainstates()
 {
+    if (g_finalityManager) g_finalityManager->Reset();
     m_ibd_chainstate.reset();
     m_snapshot_chainstate.reset();
     m_active_chainstate = nullptr;
@@ -5859,6 +6011,8 @@ ChainstateManager::~ChainstateManager()
 {
     LOCK(::cs_main);
 
+    // The finality watermark points into this manager's chainstates and block index.
+    if (g_finalityManager) g_finalityManager->Reset();
     m_versionshahbitscache.Clear();
 }
 
@@ -5965,6 +6119,7 @@ bool ChainstateManager::DeleteSnapshotChainstate()
         return false;
     }
     m_active_chainstate = m_ibd_chainstate.get();
+    if (g_finalityManager) g_finalityManager->Reset();
     m_snapshot_chainstate.reset();
     return true;
 }
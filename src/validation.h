@@ -34,6 +34,7 @@
 #include <versionshahbits.h>
 
 #include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
 #include <optional>
@@ -47,6 +48,7 @@
 
 class Chainstate;
 class CTxMemPool;
+class DEXStateCache;
 class ChainstateManager;
 struct ChainTxData;
 class DisconnectedBlockTransactions;
@@ -100,6 +102,14 @@ extern const std::vector<std::string> CHECKLEVEL_DOC;
 void StartScriptCheckWorkerThreads(int threads_num);
 /** Stop all of the script checking worker threads */
 void StopScriptCheckWorkerThreads();
+/**
+ * Run checks on the script check worker threads, and return whether all of
+ * them passed. With a single check or no workers they run on this thread.
+ * Must not be called while this thread runs a ConnectBlock's script checks.
+ * Callers share the queue's control mutex with ConnectBlock, so they wait
+ * for any block being connected on another thread.
+ */
+bool RunValidationChecks(std::vector<std::function<bool()>>&& checks);
 
 CAmount GetBlockSubsidy(int nHeight, const Consensus::Params& consensusParams);
 
@@ -355,7 +365,8 @@ bool TestBlockValidity(BlockValidationState& state,
                        bool fCheckPOW = true,
                        bool fCheckMerkleRoot = true) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
-/** Check with the proof of work on each blockheader matches the value in nshahbits */
+/** Check with the proof of work on each proof-of-work blockheader matches the value in nshahbits.
+ *  Headers are checked in parallel when script check worker threads are running. */
 bool HasValidProofOfWork(const std::vector<CBlockHeader>& headers, const Consensus::Params& consensusParams);
 
 /** Return the sum of the work on a given set of headers */
@@ -691,6 +702,12 @@ public:
     /** Replay blocks that aren't fully applied to the database. */
     bool ReplayBlocks();
 
+    /**
+     * Bring ChainstateManager::m_dex_state to m_chain's tip, rewinding blocks it applied past the
+     * coins database. Fails with an actionable message if blocks it must replay are not on disk.
+     */
+    [[nodiscard]] util::Result<void> ReconcileDEXState() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
     /** Whether the chain state needs to be redownloaded due to lack of witness data */
     [[nodiscard]] bool NeedsRedownload() const EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     /** Ensures we have a genesis block in the block tree, possibly writing one to disk. */
@@ -906,6 +923,22 @@ public:
     bool ShouldCheckBlockIndex() const { return *Assert(m_options.check_block_index); }
     const arith_uint256& MinimumChainWork() const { return *Assert(m_options.minimum_chain_work); }
     const uint256& AssumedValidBlock() const { return *Assert(m_options.assumed_valid_block); }
+
+    /**
+     * The most recent block this node recorded as irreversible (see FinalityConfig), kept
+     * across restarts and reindexes by BlockManager::WriteFinalityCheckpoint. It acts as a
+     * second, node-local assumevalid point: its ancestors had their scripts verified before
+     * it was recorded, so they are not verified again. Null when none is recorded or when
+     * assumevalid is disabled.
+     */
+    uint256 m_finality_checkpoint GUARDED_BY(::cs_main);
+
+    /**
+     * DEX pools and liquidity positions as of the active chain's tip, updated
+     * by ConnectTip/DisconnectTip and flushed together with the coins cache.
+     * Null until CompleteChainstateInitialization opens it.
+     */
+    std::unique_ptr<DEXStateCache> m_dex_state GUARDED_BY(::cs_main);
     kernel::Notifications& GetNotifications() const { return m_options.notifications; };
 
     /**
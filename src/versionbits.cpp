@@ -1,10 +1,13 @@
 // Copyright (C) 2025 The SHAHCOIN Core Developers// Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <consensus/hybrid.h>
 #include <consensus/params.h>
 #include <util/check.h>
 #include <versionshahbits.h>
 
+static_assert(VERSIONshahbits_ALGO_MASK == HYBRID_VERSION_ALGO_MASK);
+
 ThresholdState AbstractThresholdConditionChecker::GetStateFor(const CBlockIndex* pindexPrev, const Consensus::Params& params, ThresholdConditionCache& cache) const
 {
     int nPeriod = Period(params);
@@ -17,6 +17,8 @@ static const int32_t VERSIONshahbits_TOP_shahbits = 0x20000000UL;
 static const int32_t VERSIONshahbits_TOP_MASK = 0xE0000000UL;
 /** Total shahbits available for versionshahbits */
 static const int32_t VERSIONshahbits_NUM_shahbits = 29;
+/** shahbits 25-27 carry the hybrid consensus mining algorithm and are not available to deployments */
+static const int32_t VERSIONshahbits_ALGO_MASK = 0x0E000000UL;
 
 /** BIP 9 defines a finite-state-machine to deploy a softfork in multiple stages.
  *  State transitions happen during retarget period if conditions are met